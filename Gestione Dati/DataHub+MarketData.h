@@ -12,6 +12,12 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+// How historical bars are persisted in Core Data
+typedef NS_ENUM(NSInteger, HistoricalBarStorageMode) {
+    HistoricalBarStorageModeRows = 0,   // One HistoricalBar entity per bar (default)
+    HistoricalBarStorageModeBlob        // One HistoricalBarBlob per symbol/timeframe (compact, one fetch per load)
+};
+
 @interface DataHub (MarketData)
 
 #pragma mark - Market Quotes with Smart Caching
@@ -81,6 +87,15 @@ NS_ASSUME_NONNULL_BEGIN
 // Get cache statistics for debugging
 - (NSDictionary *)getCacheStatistics;
 
+#pragma mark - Historical Storage Mode
+
+/**
+ * Core Data layout for historical bars ("HistoricalBarStorageMode" in user defaults)
+ * In blob mode existing HistoricalBar rows of a symbol/timeframe are converted
+ * to a blob the first time they are loaded.
+ */
+@property (nonatomic, assign) HistoricalBarStorageMode historicalBarStorageMode;
+
 #pragma mark - Market Lists (NEW)
 - (void)getMarketPerformersForList:(NSString *)listType
                          timeframe:(NSString *)timeframe
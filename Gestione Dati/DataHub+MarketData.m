@@ -13,6 +13,14 @@
 #import "HistoricalBar+CoreDataClass.h"
 #import "MarketQuote+CoreDataClass.h"
 #import "CompanyInfo+CoreDataClass.h"
+#import "SharedBarCache.h"
+#import "HistoricalBarMerge.h"
+#import "HistoricalBarBlob+CoreDataClass.h"
+#import "HistoricalBarBlobCodec.h"
+#import "BarSeries.h"
+
+/// Range prefix of DataHub entries in SharedBarCache (the rest is the DataHub cache key)
+static NSString *const kDataHubBarRangePrefix = @"datahub/";
 
 @interface DataHub () <DataManagerDelegate>
 
@@ -33,7 +41,6 @@
 - (void)initializeMarketDataCaches {
     if (!self.quotesCache) {
         self.quotesCache = [NSMutableDictionary dictionary];
-        self.historicalCache = [NSMutableDictionary dictionary];
         self.companyInfoCache = [NSMutableDictionary dictionary];
         self.cacheTimestamps = [NSMutableDictionary dictionary];
         self.activeQuoteRequests = [NSMutableSet set];
@@ -78,6 +85,29 @@
     self.cacheTimestamps[cacheKey] = [NSDate date];
 }
 
+#pragma mark - Historical Bars Cache (SharedBarCache)
+
+- (nullable NSArray<HistoricalBarModel *> *)cachedHistoricalBarsForKey:(NSString *)cacheKey
+                                                                symbol:(NSString *)symbol
+                                                             timeframe:(BarTimeframe)timeframe {
+    return [[SharedBarCache sharedCache] barsForSymbol:symbol
+                                             timeframe:timeframe
+                                                 range:[kDataHubBarRangePrefix stringByAppendingString:cacheKey]];
+}
+
+- (void)storeHistoricalBars:(NSArray<HistoricalBarModel *> *)bars
+                     forKey:(NSString *)cacheKey
+                     symbol:(NSString *)symbol
+                  timeframe:(BarTimeframe)timeframe {
+    [[SharedBarCache sharedCache] setBars:bars
+                                forSymbol:symbol
+                                timeframe:timeframe
+                                    range:[kDataHubBarRangePrefix stringByAppendingString:cacheKey]];
+    @synchronized(self.cacheTimestamps) {
+        [self updateCacheTimestamp:cacheKey];
+    }
+}
+
 
 - (void)ensureSymbolExistsForQuote:(MarketQuoteModel *)quote {
     if (!quote || !quote.symbol) return;
@@ -227,7 +257,7 @@
                           symbol, (long)timeframe, (long)barCount, needExtendedHours ? @"extended" : @"regular"];
     
     // Check cache
-    NSArray<HistoricalBarModel *> *cachedBars = self.historicalCache[cacheKey];
+    NSArray<HistoricalBarModel *> *cachedBars = [self cachedHistoricalBarsForKey:cacheKey symbol:symbol timeframe:timeframe];
     if (cachedBars && ![self isCacheStale:cacheKey dataType:DataCacheTypeHistorical]) {
         completion(cachedBars, YES);
         return;
@@ -254,10 +284,7 @@
         }
         
         // Cache and return fresh data
-        @synchronized(self.historicalCache) {
-            self.historicalCache[cacheKey] = bars ?: @[];
-            [self updateCacheTimestamp:cacheKey];
-        }
+        [self storeHistoricalBars:bars ?: @[] forKey:cacheKey symbol:symbol timeframe:timeframe];
         
         [self saveHistoricalBarsModelToCoreData:bars ?: @[] symbol:symbol timeframe:timeframe];
         [self broadcastHistoricalDataUpdate:bars ?: @[] forSymbol:symbol];
@@ -277,6 +304,11 @@
         return;
     }
     
+    if (self.historicalBarStorageMode == HistoricalBarStorageModeBlob) {
+        [self loadHistoricalBarsFromBlob:symbol timeframe:timeframe barCount:barCount completion:completion];
+        return;
+    }
+    
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
         NSManagedObjectContext *backgroundContext = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
         backgroundContext.parentContext = self.mainContext;
@@ -479,10 +511,7 @@
                                                                      barCount:barCount];
         
         // Update cache with merged data
-        @synchronized(self.historicalCache) {
-            self.historicalCache[cacheKey] = mergedBars;
-            [self updateCacheTimestamp:cacheKey];
-        }
+        [self storeHistoricalBars:mergedBars forKey:cacheKey symbol:symbol timeframe:timeframe];
         
         NSLog(@"✅ DataHub SMART: Updated cache for %@ (%lu total bars, %lu new)",
               symbol, (unsigned long)mergedBars.count, (unsigned long)newBars.count);
@@ -564,25 +593,11 @@
         return [self limitBarsToCount:newBars maxCount:barCount];
     }
     
-    NSMutableArray<HistoricalBarModel *> *allBars = [NSMutableArray array];
-    
-    // 1. Add all cached bars
-    [allBars addObjectsFromArray:cachedBars];
-    
-    // 2. Add new bars with precise duplicate detection
-    for (HistoricalBarModel *newBar in newBars) {
-        if (![self isBarDuplicate:newBar inArray:cachedBars]) {
-            [allBars addObject:newBar];
-        }
-    }
-    
-    // 3. Sort chronologically (oldest to newest)
-    [allBars sortUsingComparator:^NSComparisonResult(HistoricalBarModel *bar1, HistoricalBarModel *bar2) {
-        return [bar1.date compare:bar2.date];
-    }];
-    
-    // 4. Final pass: remove any remaining duplicates after sorting
-    NSArray<HistoricalBarModel *> *finalBars = [self removeDuplicatesFromSortedBars:allBars];
+    // 1-4. Two-pointer merge: cached bars win over new duplicates (30s tolerance), one pass
+    NSArray<HistoricalBarModel *> *finalBars = [HistoricalBarMerge mergeBars:cachedBars
+                                                                     withBars:newBars
+                                                                    tolerance:HistoricalBarMergeDefaultTolerance
+                                                               preferIncoming:NO];
     
     // 5. Limit to requested count
     finalBars = [self limitBarsToCount:finalBars maxCount:barCount];
@@ -593,37 +608,10 @@
     return finalBars;
 }
 
-- (BOOL)isBarDuplicate:(HistoricalBarModel *)bar inArray:(NSArray<HistoricalBarModel *> *)array {
-    for (HistoricalBarModel *existingBar in array) {
-        if ([self areBarsEqual:bar other:existingBar]) {
-            return YES;
-        }
-    }
-    return NO;
-}
-- (BOOL)areBarsEqual:(HistoricalBarModel *)bar1 other:(HistoricalBarModel *)bar2 {
-    if (!bar1.date || !bar2.date) return NO;
-    
-    // ✅ PRECISE: Date comparison with 30-second tolerance for safety
-    NSTimeInterval timeDiff = fabs([bar1.date timeIntervalSinceDate:bar2.date]);
-    return timeDiff < 30.0;
-}
-
 - (NSArray<HistoricalBarModel *> *)removeDuplicatesFromSortedBars:(NSArray<HistoricalBarModel *> *)sortedBars {
     if (sortedBars.count <= 1) return sortedBars;
     
-    NSMutableArray<HistoricalBarModel *> *deduplicatedBars = [NSMutableArray arrayWithObject:sortedBars.firstObject];
-    
-    for (NSInteger i = 1; i < sortedBars.count; i++) {
-        HistoricalBarModel *currentBar = sortedBars[i];
-        HistoricalBarModel *previousBar = deduplicatedBars.lastObject;
-        
-        if (![self areBarsEqual:currentBar other:previousBar]) {
-            [deduplicatedBars addObject:currentBar];
-        }
-    }
-    
-    return [deduplicatedBars copy];
+    return [HistoricalBarMerge deduplicateBars:sortedBars tolerance:HistoricalBarMergeDefaultTolerance];
 }
 
 - (NSArray<HistoricalBarModel *> *)limitBarsToCount:(NSArray<HistoricalBarModel *> *)bars maxCount:(NSInteger)maxCount {
@@ -685,10 +673,7 @@
         }
         
         // Cache and return
-        @synchronized(self.historicalCache) {
-            self.historicalCache[cacheKey] = bars ?: @[];
-            [self updateCacheTimestamp:cacheKey];
-        }
+        [self storeHistoricalBars:bars ?: @[] forKey:cacheKey symbol:symbol timeframe:timeframe];
         
         [self broadcastHistoricalDataUpdate:bars forSymbol:symbol];
         completion(bars ?: @[], YES);
@@ -763,14 +748,12 @@
                           needExtendedHours ? @"ext" : @"reg"];
     
     // 1. Controlla cache
-    @synchronized(self.historicalCache) {
-            NSArray<HistoricalBarModel *> *cachedBars = self.historicalCache[cacheKey];
-            if (cachedBars && ![self isCacheStale:cacheKey dataType:DataCacheTypeHistorical]) {
-                NSLog(@"✅ DataHub: Returning cached date range data (%lu bars)", (unsigned long)cachedBars.count);
-                completion(cachedBars, NO);
-                return;
-            }
-        }
+    NSArray<HistoricalBarModel *> *cachedBars = [self cachedHistoricalBarsForKey:cacheKey symbol:symbol timeframe:timeframe];
+    if (cachedBars && ![self isCacheStale:cacheKey dataType:DataCacheTypeHistorical]) {
+        NSLog(@"✅ DataHub: Returning cached date range data (%lu bars)", (unsigned long)cachedBars.count);
+        completion(cachedBars, NO);
+        return;
+    }
     
     // 2. Fai richiesta diretta a DataManager per date range
     [[DataManager sharedManager] requestHistoricalDataForSymbol:symbol
@@ -793,10 +776,7 @@
                   (unsigned long)bars.count, startDate, endDate, needExtendedHours ? @"YES" : @"NO");
             
             // 3. Salva in cache
-            @synchronized(self.historicalCache) {
-                self.historicalCache[cacheKey] = bars;
-                [self updateCacheTimestamp:cacheKey];
-            }
+            [self storeHistoricalBars:resultBars forKey:cacheKey symbol:symbol timeframe:timeframe];
             
             // 4. Opzionalmente salva in Core Data per future lookup
             if (bars.count > 0) {
@@ -944,8 +924,8 @@
     
     [self initializeMarketDataCaches];
     
-    self.historicalCache[cacheKey] = bars;
-    [self updateCacheTimestamp:cacheKey];
+    HistoricalBarModel *firstBar = bars.firstObject;
+    [self storeHistoricalBars:bars forKey:cacheKey symbol:firstBar.symbol timeframe:firstBar.timeframe];
     
     NSLog(@"DataHub: Cached %lu HistoricalBarModel objects for key %@", (unsigned long)bars.count, cacheKey);
 }
@@ -989,6 +969,11 @@
                               barCount:(NSInteger)barCount
                             completion:(void(^)(NSArray<HistoricalBarModel *> *bars))completion {
     
+    if (self.historicalBarStorageMode == HistoricalBarStorageModeBlob) {
+        [self loadHistoricalBarsFromBlob:symbol timeframe:timeframe barCount:barCount completion:completion];
+        return;
+    }
+    
     [self.mainContext performBlock:^{
         
         // Find Symbol first, then get its HistoricalBars
@@ -1110,7 +1095,8 @@
 }
 
 
-// ✅ FIX: Metodo saveHistoricalBarsModelToCoreData con logging chiarito
+// Scritture coalescenti per symbol/timeframe su un context di background dedicato:
+// upsert per (symbol, timeframe, date), il main context riceve solo le differenze
 
 - (void)saveHistoricalBarsModelToCoreData:(NSArray<HistoricalBarModel *> *)bars
                                    symbol:(NSString *)symbol
@@ -1118,72 +1104,387 @@
     
     if (!bars || bars.count == 0 || !symbol) return;
     
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0), ^{
-        NSManagedObjectContext *backgroundContext = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
-        backgroundContext.parentContext = self.mainContext;
+    NSManagedObjectContext *writerContext = self.historicalBarWriterContext;
+    if (!writerContext) {
+        NSLog(@"⚠️ Core Data store not loaded yet, skipping save of %@ bars", symbol);
+        return;
+    }
+    
+    NSString *normalizedSymbol = symbol.uppercaseString;
+    NSString *writeKey = [NSString stringWithFormat:@"%@|%ld", normalizedSymbol, (long)timeframe];
+    
+    // Una sola scrittura in coda per chiave: le barre più recenti sostituiscono quelle in attesa
+    @synchronized (self.pendingBarWrites) {
+        BOOL alreadyScheduled = (self.pendingBarWrites[writeKey] != nil);
+        self.pendingBarWrites[writeKey] = bars;
+        if (alreadyScheduled) return;
+    }
+    
+    [writerContext performBlock:^{
+        NSArray<HistoricalBarModel *> *pendingBars;
+        @synchronized (self.pendingBarWrites) {
+            pendingBars = self.pendingBarWrites[writeKey];
+            [self.pendingBarWrites removeObjectForKey:writeKey];
+        }
+        if (pendingBars.count == 0) return;
         
-        [backgroundContext performBlock:^{
-            
-            // ✅ STEP 1: Clean existing bars per questo symbol/timeframe
-            [self cleanExistingBarsForSymbol:symbol timeframe:timeframe inContext:backgroundContext];
-            
-            // ✅ STEP 2: Find or create symbol entity
-            Symbol *symbolEntity = [self findOrCreateSymbolWithName:symbol inContext:backgroundContext];
-            
-            // ✅ STEP 3: Save new bars with additional duplicate prevention
-            NSArray<HistoricalBarModel *> *deduplicatedBars = [self removeDuplicatesFromBars:bars];
-            
-            for (HistoricalBarModel *barModel in deduplicatedBars) {
-                [self createCoreDataBarFromModel:barModel
-                                           symbol:symbolEntity
-                                        timeframe:timeframe
-                                        inContext:backgroundContext];
+        if (self.historicalBarStorageMode == HistoricalBarStorageModeBlob) {
+            [self mergeHistoricalBars:pendingBars
+                   intoBlobForSymbol:normalizedSymbol
+                           timeframe:timeframe
+                           inContext:writerContext
+                               error:nil];
+        } else {
+            [self upsertHistoricalBars:pendingBars
+                                symbol:normalizedSymbol
+                             timeframe:timeframe
+                             inContext:writerContext];
+        }
+    }];
+}
+
+static inline int64_t DataHubBarMilliseconds(NSDate *date) {
+    return llround(date.timeIntervalSince1970 * 1000.0);
+}
+
+static inline BOOL DataHubBarNeedsUpdate(HistoricalBar *row, HistoricalBarModel *bar) {
+    return row.open != bar.open || row.high != bar.high || row.low != bar.low ||
+           row.close != bar.close || row.volume != bar.volume;
+}
+
+- (void)upsertHistoricalBars:(NSArray<HistoricalBarModel *> *)bars
+                      symbol:(NSString *)symbol
+                   timeframe:(BarTimeframe)timeframe
+                   inContext:(NSManagedObjectContext *)context {
+    
+    NSArray<HistoricalBarModel *> *incoming = [self removeDuplicatesFromBars:bars];
+    if (incoming.count == 0) return;
+    
+    Symbol *symbolEntity = [self findOrCreateSymbolWithName:symbol inContext:context];
+    if (!symbolEntity) return;
+    
+    // STEP 1: righe esistenti nell'intervallo coperto dalle nuove barre, già ordinate
+    NSFetchRequest *request = [HistoricalBar fetchRequest];
+    request.predicate = [NSPredicate predicateWithFormat:
+                        @"symbol == %@ AND timeframe == %d AND date >= %@ AND date <= %@",
+                        symbolEntity, timeframe, incoming.firstObject.date, incoming.lastObject.date];
+    request.sortDescriptors = @[[NSSortDescriptor sortDescriptorWithKey:@"date" ascending:YES]];
+    request.returnsObjectsAsFaults = NO;
+    
+    NSError *error = nil;
+    NSArray<HistoricalBar *> *existing = [context executeFetchRequest:request error:&error];
+    if (!existing) {
+        NSLog(@"❌ Error fetching existing bars for %@: %@", symbol, error);
+        return;
+    }
+    
+    // STEP 2: confronto a due puntatori sui timestamp (ms)
+    NSMutableArray<HistoricalBar *> *staleRows = [NSMutableArray array];
+    NSUInteger inserted = 0;
+    NSUInteger updated = 0;
+    NSUInteger unchanged = 0;
+    NSUInteger i = 0;
+    NSUInteger j = 0;
+    
+    while (i < existing.count || j < incoming.count) {
+        HistoricalBar *row = i < existing.count ? existing[i] : nil;
+        HistoricalBarModel *bar = j < incoming.count ? incoming[j] : nil;
+        int64_t rowTime = row ? DataHubBarMilliseconds(row.date) : INT64_MAX;
+        int64_t barTime = bar ? DataHubBarMilliseconds(bar.date) : INT64_MAX;
+        
+        if (rowTime == barTime) {
+            if (DataHubBarNeedsUpdate(row, bar)) {
+                row.open = bar.open;
+                row.high = bar.high;
+                row.low = bar.low;
+                row.close = bar.close;
+                row.volume = bar.volume;
+                updated++;
+            } else {
+                unchanged++;
             }
+            i++;
+            j++;
             
-            // ✅ STEP 4: Save background context
-            NSError *saveError = nil;
-            if (![backgroundContext save:&saveError]) {
-                NSLog(@"❌ Error saving historical bars to background context: %@", saveError);
-                
-                // Retry once on conflict
-                if (saveError.code == NSManagedObjectMergeError) {
-                    [backgroundContext rollback];
-                    // Could implement retry logic here if needed
-                }
-                return; // Exit if background save fails
-            } else {
-                NSLog(@"📝 Background context: Prepared %lu deduplicated bars for %@",
-                      (unsigned long)deduplicatedBars.count, symbol);
-                
-                // ✅ STEP 5: Save to parent context (main context) - THIS IS THE REAL SAVE
-                dispatch_async(dispatch_get_main_queue(), ^{
-                    NSError *parentSaveError = nil;
-                    if (![self.mainContext save:&parentSaveError]) {
-                        NSLog(@"❌ Error saving to persistent store: %@", parentSaveError);
-                    } else {
-                        // ✅ UNICO LOG DI SUCCESSO FINALE
-                        NSLog(@"✅ Successfully saved %lu deduplicated bars to Core Data for %@",
-                              (unsigned long)deduplicatedBars.count, symbol);
-                    }
-                });
+            // Duplicati legacy della stessa data: restano solo nella prima riga
+            while (i < existing.count && DataHubBarMilliseconds(existing[i].date) == barTime) {
+                [staleRows addObject:existing[i]];
+                i++;
             }
-        }];
-    });
+        } else if (rowTime < barTime) {
+            // Riga che la sorgente non restituisce più nell'intervallo
+            [staleRows addObject:row];
+            i++;
+        } else {
+            [self createCoreDataBarFromModel:bar symbol:symbolEntity timeframe:timeframe inContext:context];
+            inserted++;
+            j++;
+        }
+    }
+    
+    if (inserted == 0 && updated == 0 && staleRows.count == 0) {
+        NSLog(@"📝 Core Data: %lu bars for %@ already up to date", (unsigned long)unchanged, symbol);
+        [context reset];
+        return;
+    }
+    
+    // STEP 3: righe obsolete eliminate nel context (già caricate dal fetch), così
+    // insert, update e delete finiscono nello stesso save: se fallisce non si perde nulla
+    NSArray<NSManagedObjectID *> *deletedIDs = [staleRows valueForKey:@"objectID"];
+    for (HistoricalBar *row in staleRows) {
+        [context deleteObject:row];
+    }
+    
+    // STEP 4: salvataggio sul coordinator e merge delle sole differenze nel main context
+    NSArray<NSManagedObjectID *> *insertedIDs = nil;
+    NSArray<NSManagedObjectID *> *updatedIDs = nil;
+    if (context.hasChanges) {
+        NSError *permanentError = nil;
+        [context obtainPermanentIDsForObjects:context.insertedObjects.allObjects error:&permanentError];
+        insertedIDs = [context.insertedObjects.allObjects valueForKey:@"objectID"];
+        updatedIDs = [context.updatedObjects.allObjects valueForKey:@"objectID"];
+        
+        NSError *saveError = nil;
+        if (![context save:&saveError]) {
+            NSLog(@"❌ Error saving historical bars for %@: %@", symbol, saveError);
+            [context rollback];
+            return;
+        }
+    }
+    
+    NSDictionary *changes = @{
+        NSInsertedObjectIDsKey: insertedIDs ?: @[],
+        NSUpdatedObjectIDsKey: updatedIDs ?: @[],
+        NSDeletedObjectIDsKey: deletedIDs
+    };
+    if (self.mainContext) {
+        [NSManagedObjectContext mergeChangesFromRemoteContextSave:changes intoContexts:@[self.mainContext]];
+    }
+    
+    // Gli oggetti scritti non servono più: il context resta leggero tra un simbolo e l'altro
+    [context reset];
+    
+    NSLog(@"✅ Core Data upsert %@ (tf %ld): %lu inserted, %lu updated, %lu unchanged, %lu removed",
+          symbol, (long)timeframe, (unsigned long)inserted, (unsigned long)updated,
+          (unsigned long)unchanged, (unsigned long)deletedIDs.count);
 }
 
 
-- (NSArray<HistoricalBarModel *> *)removeDuplicatesFromBars:(NSArray<HistoricalBarModel *> *)bars {
-    if (bars.count <= 1) return bars;
+#pragma mark - Historical Bar Blob Storage
+
+static NSString *const kHistoricalBarStorageModeKey = @"HistoricalBarStorageMode";
+
+- (HistoricalBarStorageMode)historicalBarStorageMode {
+    return [[NSUserDefaults standardUserDefaults] integerForKey:kHistoricalBarStorageModeKey];
+}
+
+- (void)setHistoricalBarStorageMode:(HistoricalBarStorageMode)historicalBarStorageMode {
+    [[NSUserDefaults standardUserDefaults] setInteger:historicalBarStorageMode forKey:kHistoricalBarStorageModeKey];
+    NSLog(@"💾 DataHub: historical bar storage mode → %@",
+          historicalBarStorageMode == HistoricalBarStorageModeBlob ? @"blob" : @"rows");
+}
+
+- (HistoricalBarBlob *)fetchBarBlobForSymbol:(NSString *)symbol
+                                   timeframe:(BarTimeframe)timeframe
+                                   inContext:(NSManagedObjectContext *)context {
     
-    NSMutableArray<HistoricalBarModel *> *deduplicatedBars = [NSMutableArray array];
+    NSFetchRequest *request = [HistoricalBarBlob fetchRequest];
+    request.predicate = [NSPredicate predicateWithFormat:@"symbolName == %@ AND timeframe == %d",
+                         symbol, (int)timeframe];
+    request.fetchLimit = 1;
     
-    for (HistoricalBarModel *bar in bars) {
-        if (![self isBarDuplicate:bar inArray:deduplicatedBars]) {
-            [deduplicatedBars addObject:bar];
+    NSError *error = nil;
+    NSArray<HistoricalBarBlob *> *results = [context executeFetchRequest:request error:&error];
+    if (error) {
+        NSLog(@"❌ Error fetching bar blob for %@: %@", symbol, error);
+    }
+    return results.firstObject;
+}
+
+/// HistoricalBar rows of a symbol/timeframe (storage a righe), sorted by date
+- (NSArray<HistoricalBarModel *> *)fetchBarRowsForSymbol:(NSString *)symbol
+                                               timeframe:(BarTimeframe)timeframe
+                                               inContext:(NSManagedObjectContext *)context {
+    
+    NSFetchRequest *request = [HistoricalBar fetchRequest];
+    request.predicate = [NSPredicate predicateWithFormat:@"symbol.symbol == %@ AND timeframe == %d",
+                         symbol, (int)timeframe];
+    request.sortDescriptors = @[[NSSortDescriptor sortDescriptorWithKey:@"date" ascending:YES]];
+    request.returnsObjectsAsFaults = NO;
+    
+    NSError *error = nil;
+    NSArray<HistoricalBar *> *rows = [context executeFetchRequest:request error:&error];
+    if (error) {
+        NSLog(@"❌ Error fetching bar rows for %@: %@", symbol, error);
+    }
+    
+    NSMutableArray<HistoricalBarModel *> *bars = [NSMutableArray arrayWithCapacity:rows.count];
+    for (HistoricalBar *row in rows) {
+        HistoricalBarModel *bar = [self convertCoreDataBarToRuntimeModel:row];
+        if (bar.date) {
+            [bars addObject:bar];
+        }
+    }
+    return bars;
+}
+
+/**
+ * Merge bars into the blob of a symbol/timeframe and save it
+ * Without a blob, the HistoricalBar rows left by row storage are merged in first
+ * and deleted once the blob is saved.
+ * @return YES if the blob is saved (or already up to date), NO with error otherwise
+ */
+- (BOOL)mergeHistoricalBars:(NSArray<HistoricalBarModel *> *)bars
+          intoBlobForSymbol:(NSString *)symbol
+                  timeframe:(BarTimeframe)timeframe
+                  inContext:(NSManagedObjectContext *)context
+                      error:(NSError **)error {
+    
+    HistoricalBarBlob *blob = [self fetchBarBlobForSymbol:symbol timeframe:timeframe inContext:context];
+    
+    // Storia esistente decodificata in colonne, le barre nuove vincono sui duplicati
+    NSArray<HistoricalBarModel *> *existing = nil;
+    NSUInteger migratedRowCount = 0;
+    if (blob.encodedBars) {
+        existing = [[HistoricalBarBlobCodec decodeData:blob.encodedBars
+                                                symbol:symbol
+                                             timeframe:timeframe
+                                          lastBarCount:0] bars];
+    } else if (!blob) {
+        // Primo blob del simbolo: le righe esistenti non vanno perse
+        existing = [self fetchBarRowsForSymbol:symbol timeframe:timeframe inContext:context];
+        migratedRowCount = existing.count;
+        [context reset];
+    }
+    NSArray<HistoricalBarModel *> *merged = [HistoricalBarMerge mergeBars:existing
+                                                                 withBars:bars
+                                                                tolerance:HistoricalBarMergeDefaultTolerance
+                                                           preferIncoming:YES];
+    NSData *encoded = [HistoricalBarBlobCodec encodeBars:merged];
+    if (!encoded) {
+        NSLog(@"❌ Error encoding bar blob for %@ (%lu bars)", symbol, (unsigned long)merged.count);
+        [context reset];
+        if (error) {
+            *error = [NSError errorWithDomain:@"DataHub"
+                                         code:500
+                                     userInfo:@{NSLocalizedDescriptionKey: [NSString stringWithFormat:@"Unable to encode bars of %@", symbol]}];
         }
+        return NO;
     }
     
-    return [deduplicatedBars copy];
+    if ([blob.encodedBars isEqualToData:encoded]) {
+        NSLog(@"📝 Core Data: blob %@ (tf %ld) already up to date", symbol, (long)timeframe);
+        [context reset];
+        return YES;
+    }
+    
+    if (!blob) {
+        blob = [NSEntityDescription insertNewObjectForEntityForName:@"HistoricalBarBlob"
+                                             inManagedObjectContext:context];
+        blob.symbolName = symbol;
+        blob.timeframe = timeframe;
+    }
+    blob.encodedBars = encoded;
+    blob.formatVersion = HistoricalBarBlobFormatVersion;
+    blob.barCount = (int32_t)merged.count;
+    blob.firstDate = merged.firstObject.date;
+    blob.lastDate = merged.lastObject.date;
+    blob.lastUpdate = [NSDate date];
+    
+    NSError *saveError = nil;
+    if (![context save:&saveError]) {
+        NSLog(@"❌ Error saving bar blob for %@: %@", symbol, saveError);
+        [context rollback];
+        if (error) *error = saveError;
+        return NO;
+    }
+    [context reset];
+    
+    // Le righe si cancellano solo a blob salvato: in caso di errore restano per il prossimo tentativo
+    if (migratedRowCount > 0) {
+        [self cleanExistingBarsForSymbol:symbol timeframe:timeframe inContext:context];
+        NSLog(@"🔄 Core Data: migrated %lu rows of %@ (tf %ld) to blob storage",
+              (unsigned long)migratedRowCount, symbol, (long)timeframe);
+    }
+    
+    NSLog(@"✅ Core Data blob %@ (tf %ld): %lu bars in %.1f KB",
+          symbol, (long)timeframe, (unsigned long)merged.count, encoded.length / 1024.0);
+    return YES;
+}
+
+/**
+ * Convert the HistoricalBar rows of a symbol/timeframe into its blob and delete them
+ * The rows are deleted only once the blob is saved (see mergeHistoricalBars:intoBlobForSymbol:).
+ * @return YES if rows were converted
+ */
+- (BOOL)migrateBarRowsToBlobForSymbol:(NSString *)symbol
+                            timeframe:(BarTimeframe)timeframe
+                            inContext:(NSManagedObjectContext *)context {
+    
+    NSFetchRequest *request = [HistoricalBar fetchRequest];
+    request.predicate = [NSPredicate predicateWithFormat:@"symbol.symbol == %@ AND timeframe == %d",
+                         symbol, (int)timeframe];
+    
+    NSError *error = nil;
+    NSUInteger rowCount = [context countForFetchRequest:request error:&error];
+    if (rowCount == 0 || rowCount == NSNotFound) return NO;
+    
+    // Nessuna barra nuova: il merge carica le righe, salva il blob e poi le cancella
+    NSError *mergeError = nil;
+    if (![self mergeHistoricalBars:@[] intoBlobForSymbol:symbol timeframe:timeframe inContext:context error:&mergeError]) {
+        NSLog(@"⚠️ Core Data: keeping %lu rows of %@ (tf %ld), blob migration failed: %@",
+              (unsigned long)rowCount, symbol, (long)timeframe, mergeError.localizedDescription);
+        return NO;
+    }
+    return YES;
+}
+
+- (void)loadHistoricalBarsFromBlob:(NSString *)symbol
+                         timeframe:(BarTimeframe)timeframe
+                          barCount:(NSInteger)barCount
+                        completion:(void(^)(NSArray<HistoricalBarModel *> *bars))completion {
+    
+    NSManagedObjectContext *writerContext = self.historicalBarWriterContext;
+    if (!writerContext) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(@[]);
+        });
+        return;
+    }
+    
+    NSString *normalizedSymbol = symbol.uppercaseString;
+    
+    // Sulla coda del writer: una lettura vede sempre le scritture già accodate
+    [writerContext performBlock:^{
+        HistoricalBarBlob *blob = [self fetchBarBlobForSymbol:normalizedSymbol timeframe:timeframe inContext:writerContext];
+        if (!blob && [self migrateBarRowsToBlobForSymbol:normalizedSymbol timeframe:timeframe inContext:writerContext]) {
+            blob = [self fetchBarBlobForSymbol:normalizedSymbol timeframe:timeframe inContext:writerContext];
+        }
+        NSData *encoded = blob.encodedBars;
+        [writerContext reset];
+        
+        // Una fetch + decodifica dei soli chunk che coprono le ultime barCount barre
+        BarSeries *series = encoded ? [HistoricalBarBlobCodec decodeData:encoded
+                                                                  symbol:normalizedSymbol
+                                                               timeframe:timeframe
+                                                            lastBarCount:MAX(barCount, 0)] : nil;
+        NSArray<HistoricalBarModel *> *bars = series ? [series bars] : @[];
+        
+        NSLog(@"📦 DataHub: Loaded %lu bars from blob for %@ (timeframe: %ld)",
+              (unsigned long)bars.count, normalizedSymbol, (long)timeframe);
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(bars);
+        });
+    }];
+}
+
+
+- (NSArray<HistoricalBarModel *> *)removeDuplicatesFromBars:(NSArray<HistoricalBarModel *> *)bars {
+    if (bars.count <= 1) return bars;
+    
+    // Ordinamento stabile + un passaggio: il primo di ogni gruppo di duplicati resta
+    return [HistoricalBarMerge deduplicateBars:bars tolerance:HistoricalBarMergeDefaultTolerance];
 }
 
 - (void)createCoreDataBarFromModel:(HistoricalBarModel *)barModel
@@ -1744,10 +2045,8 @@
     // Clear quotes
     [self.quotesCache removeObjectForKey:symbol];
     
-    // Clear historical data
-    NSArray *keysToRemove = [self.historicalCache.allKeys filteredArrayUsingPredicate:
-                            [NSPredicate predicateWithFormat:@"SELF CONTAINS %@", symbol]];
-    [self.historicalCache removeObjectsForKeys:keysToRemove];
+    // Clear historical data (shared cache: every range of the symbol)
+    [[SharedBarCache sharedCache] removeBarsForSymbol:symbol];
     
     // Clear company info
     [self.companyInfoCache removeObjectForKey:symbol];
@@ -1765,7 +2064,8 @@
     
     return @{
         @"quotesCount": @(self.quotesCache.count),
-        @"historicalCacheCount": @(self.historicalCache.count),
+        @"historicalCacheCount": @([SharedBarCache sharedCache].entryCount),
+        @"sharedBarCache": [[SharedBarCache sharedCache] statistics],
         @"companyInfoCount": @(self.companyInfoCache.count),
         @"subscribedSymbolsCount": @(self.subscribedSymbols.count),
         @"activeQuoteRequests": @(self.activeQuoteRequests.count),
@@ -1907,7 +2207,7 @@
     [self initializeMarketDataCaches];
     
     [self.quotesCache removeAllObjects];
-    [self.historicalCache removeAllObjects];
+    [[SharedBarCache sharedCache] removeBarsWithRangePrefix:kDataHubBarRangePrefix];
     [self.companyInfoCache removeAllObjects];
     [self.cacheTimestamps removeAllObjects];
     [self clearMarketListCache];
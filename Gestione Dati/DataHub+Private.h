@@ -46,6 +46,11 @@ typedef NS_ENUM(NSInteger, DataCacheType) {
 @property (nonatomic, strong) NSPersistentContainer *persistentContainer;
 @property (nonatomic, strong) NSManagedObjectContext *mainContext;
 
+// Historical bar persistence: background writer on the store coordinator,
+// latest bars waiting per "SYMBOL|timeframe" (one scheduled write per key)
+@property (nonatomic, strong) NSManagedObjectContext *historicalBarWriterContext;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSArray<HistoricalBarModel *> *> *pendingBarWrites;
+
 // Collections (Core Data entities)
 @property (nonatomic, strong) NSMutableArray<Watchlist *> *watchlists;
 @property (nonatomic, strong) NSMutableArray<Alert *> *alerts;
@@ -58,7 +63,6 @@ typedef NS_ENUM(NSInteger, DataCacheType) {
 
 // FIXED: Runtime model caches (not Core Data entities)
 @property (nonatomic, strong) NSMutableDictionary<NSString *, MarketQuoteModel *> *quotesCache;
-@property (nonatomic, strong) NSMutableDictionary<NSString *, NSArray<HistoricalBarModel *> *> *historicalCache;
 @property (nonatomic, strong) NSMutableDictionary<NSString *, CompanyInfoModel *> *companyInfoCache;
 
 // Market Lists Cache (NEW)
@@ -199,8 +203,6 @@ typedef NS_ENUM(NSInteger, DataCacheType) {
 #pragma mark - Deduplication Utilities (NEW)
 
 // Duplicate detection and removal
-- (BOOL)isBarDuplicate:(HistoricalBarModel *)bar inArray:(NSArray<HistoricalBarModel *> *)array;
-- (BOOL)areBarsEqual:(HistoricalBarModel *)bar1 other:(HistoricalBarModel *)bar2;
 - (NSArray<HistoricalBarModel *> *)removeDuplicatesFromSortedBars:(NSArray<HistoricalBarModel *> *)sortedBars;
 - (NSArray<HistoricalBarModel *> *)limitBarsToCount:(NSArray<HistoricalBarModel *> *)bars maxCount:(NSInteger)maxCount;
 - (NSArray<HistoricalBar *> *)deduplicateCoreDataBars:(NSArray<HistoricalBar *> *)coreDataBars;
@@ -218,6 +220,14 @@ typedef NS_ENUM(NSInteger, DataCacheType) {
                          timeframe:(BarTimeframe)timeframe
                          inContext:(NSManagedObjectContext *)context;
 
+// Upsert by (symbol, timeframe, date) over the date range of bars:
+// unchanged rows untouched, changed rows updated, missing rows inserted,
+// rows no longer returned in the range deleted, all in a single save
+- (void)upsertHistoricalBars:(NSArray<HistoricalBarModel *> *)bars
+                      symbol:(NSString *)symbol
+                   timeframe:(BarTimeframe)timeframe
+                   inContext:(NSManagedObjectContext *)context;
+
 
 - (void)checkAlertsOptimized;
 - (void)checkAllAlertsWithBulkQuotes:(NSDictionary<NSString *, MarketQuoteModel *> *)bulkQuotes;
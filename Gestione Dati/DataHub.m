@@ -73,6 +73,7 @@ NSString *const DataHubDataLoadedNotification = @"DataHubDataLoadedNotification"
         _tradingModels = [NSMutableArray array];
         _cache = [NSMutableDictionary dictionary];
         _pendingRequests = [NSMutableDictionary dictionary];
+        _pendingBarWrites = [NSMutableDictionary dictionary];
 
         // NEW: Initialize market data caches
         [self initializeMarketDataCaches];
@@ -83,7 +84,6 @@ NSString *const DataHubDataLoadedNotification = @"DataHubDataLoadedNotification"
 - (void)initializeMarketDataCaches {
     if (!_quotesCache) {
         _quotesCache = [NSMutableDictionary dictionary];
-        _historicalCache = [NSMutableDictionary dictionary];
         _companyInfoCache = [NSMutableDictionary dictionary];
         _cacheTimestamps = [NSMutableDictionary dictionary];
         _activeQuoteRequests = [NSMutableSet set];
@@ -118,6 +118,12 @@ NSString *const DataHubDataLoadedNotification = @"DataHubDataLoadedNotification"
             NSLog(@"Core Data stack loaded successfully");
             self.mainContext.mergePolicy = NSMergeByPropertyObjectTrumpMergePolicy;
 
+            // Writer dedicato alle barre storiche: scrive sul coordinator senza passare dal main context
+            self.historicalBarWriterContext = [self.persistentContainer newBackgroundContext];
+            self.historicalBarWriterContext.mergePolicy = NSMergeByPropertyObjectTrumpMergePolicy;
+            self.historicalBarWriterContext.undoManager = nil;
+            self.historicalBarWriterContext.name = @"HistoricalBarWriter";
+
             // ✅ NUOVO: Setup sistema archiviazione automatica
             [self setupAutomaticArchiving];
         }
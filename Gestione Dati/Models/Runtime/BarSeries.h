@@ -0,0 +1,121 @@
+//
+//  BarSeries.h
+//  TradingApp
+//
+//  Columnar (struct-of-arrays) OHLCV storage for hot paths
+//  One contiguous buffer per series instead of one HistoricalBarModel per bar.
+//  Bridges zero-copy to the NSArray<HistoricalBarModel *> API so screeners,
+//  indicators and backtests can adopt it incrementally.
+//
+
+#import <Foundation/Foundation.h>
+#import "RuntimeModels.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Writable column pointers, only handed out while a series is being filled
+typedef struct {
+    NSTimeInterval *time;      // seconds since 1970
+    double *open;
+    double *high;
+    double *low;
+    double *close;
+    double *adjustedClose;
+    int64_t *volume;
+} BarSeriesMutableColumns;
+
+@class BarSeries;
+
+/// Implemented by NSArray views that are backed by a BarSeries
+@protocol BarSeriesBacked <NSObject>
+- (BarSeries *)barSeries;
+@optional
+/// Bars materialized (and retained) by the view so far
+- (NSUInteger)materializedBarCount;
+@end
+
+@interface BarSeries : NSObject <NSCopying>
+
+#pragma mark - Properties
+
+@property (nonatomic, readonly) NSString *symbol;
+@property (nonatomic, readonly) BarTimeframe timeframe;
+
+/// Number of bars (index 0 = oldest, count - 1 = most recent)
+@property (nonatomic, readonly) NSInteger count;
+
+/// Read-only columns. Valid as long as the series (or any slice of it) is alive.
+@property (nonatomic, readonly) const NSTimeInterval *time;
+@property (nonatomic, readonly) const double *open;
+@property (nonatomic, readonly) const double *high;
+@property (nonatomic, readonly) const double *low;
+@property (nonatomic, readonly) const double *close;
+@property (nonatomic, readonly) const double *adjustedClose;
+@property (nonatomic, readonly) const int64_t *volume;
+
+/// Approximate heap footprint of the column storage
+@property (nonatomic, readonly) NSUInteger byteSize;
+
+#pragma mark - Creation
+
+/**
+ * Build a series from bar objects (one copy of the values)
+ * If bars is already a bridge array returned by -bars, its series is returned as-is.
+ */
++ (instancetype)seriesWithBars:(NSArray<HistoricalBarModel *> *)bars;
+
+/**
+ * Allocate a series and let the caller fill the columns in place
+ * @param count Number of bars
+ * @param fillBlock Writes count values into every column (oldest → newest)
+ */
++ (instancetype)seriesWithSymbol:(NSString *)symbol
+                       timeframe:(BarTimeframe)timeframe
+                           count:(NSInteger)count
+                     fillColumns:(void (NS_NOESCAPE ^)(BarSeriesMutableColumns columns))fillBlock;
+
+/**
+ * Wrap an existing column buffer (e.g. a memory-mapped file) without copying
+ * @param storage Buffer containing the columns; retained by the series
+ * @param offsets Byte offsets of time, open, high, low, close, adjustedClose, volume (7 values)
+ */
++ (nullable instancetype)seriesWithSymbol:(NSString *)symbol
+                                timeframe:(BarTimeframe)timeframe
+                                    count:(NSInteger)count
+                                  storage:(NSData *)storage
+                            columnOffsets:(const NSUInteger *)offsets;
+
+#pragma mark - Views
+
+/// Zero-copy view over a range of bars (shares storage)
+- (BarSeries *)sliceWithRange:(NSRange)range;
+
+/**
+ * Index of the last bar whose time is <= the given time (binary search)
+ * @return Index, or -1 if every bar is after time
+ */
+- (NSInteger)indexOfLastBarOnOrBeforeTime:(NSTimeInterval)time;
+
+#pragma mark - HistoricalBarModel Bridge
+
+/// Materialize a single bar
+- (HistoricalBarModel *)barAtIndex:(NSInteger)index;
+
+/**
+ * NSArray view of the series. Bars are materialized lazily on first access
+ * and then reused; -subarrayWithRange: on the returned array stays zero-copy.
+ */
+- (NSArray<HistoricalBarModel *> *)bars;
+
+/// Series backing an array returned by -bars (or any BarSeriesBacked view), nil for a regular NSArray
++ (nullable BarSeries *)backingSeriesOfBars:(NSArray<HistoricalBarModel *> *)bars;
+
+/**
+ * HistoricalBarModel objects an array returned by -bars has materialized so far
+ * Grows as the array is indexed; 0 for a regular NSArray.
+ */
++ (NSUInteger)materializedBarCountOfBars:(NSArray<HistoricalBarModel *> *)bars;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,294 @@
+//
+//  BarSeries.m
+//  TradingApp
+//
+
+#import "BarSeries.h"
+
+/// Columns in storage order
+static const NSInteger kBarSeriesColumnCount = 7;
+
+#pragma mark - Bridge Array
+
+/// NSArray facade over a BarSeries: materializes HistoricalBarModel on demand
+@interface BarSeriesArray : NSArray <BarSeriesBacked>
+@property (nonatomic, strong, readonly) BarSeries *series;
+- (instancetype)initWithSeries:(BarSeries *)series;
+@end
+
+@implementation BarSeriesArray {
+    NSPointerArray *_materializedBars;
+    NSUInteger _materializedCount;
+}
+
+- (instancetype)initWithSeries:(BarSeries *)series {
+    self = [super init];
+    if (self) {
+        _series = series;
+        _materializedBars = [NSPointerArray strongObjectsPointerArray];
+        _materializedBars.count = series.count;
+    }
+    return self;
+}
+
+- (NSUInteger)count {
+    return (NSUInteger)_series.count;
+}
+
+- (id)objectAtIndex:(NSUInteger)index {
+    if (index >= (NSUInteger)_series.count) {
+        [NSException raise:NSRangeException
+                    format:@"BarSeriesArray: index %lu beyond bounds [0 .. %ld]",
+                           (unsigned long)index, (long)_series.count - 1];
+    }
+
+    @synchronized (self) {
+        HistoricalBarModel *bar = (__bridge HistoricalBarModel *)[_materializedBars pointerAtIndex:index];
+        if (!bar) {
+            bar = [_series barAtIndex:index];
+            [_materializedBars replacePointerAtIndex:index withPointer:(__bridge void *)bar];
+            _materializedCount++;
+        }
+        return bar;
+    }
+}
+
+- (NSArray *)subarrayWithRange:(NSRange)range {
+    if (NSMaxRange(range) > (NSUInteger)_series.count) {
+        [NSException raise:NSRangeException
+                    format:@"BarSeriesArray: range %@ beyond bounds [0 .. %ld]",
+                           NSStringFromRange(range), (long)_series.count - 1];
+    }
+    return [[_series sliceWithRange:range] bars];
+}
+
+- (BarSeries *)barSeries {
+    return _series;
+}
+
+- (NSUInteger)materializedBarCount {
+    @synchronized (self) {
+        return _materializedCount;
+    }
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    return self;
+}
+
+@end
+
+#pragma mark - BarSeries
+
+@implementation BarSeries {
+    NSData *_storage;
+}
+
+- (instancetype)initWithSymbol:(NSString *)symbol
+                     timeframe:(BarTimeframe)timeframe
+                         count:(NSInteger)count
+                       storage:(NSData *)storage
+                          time:(const NSTimeInterval *)time
+                          open:(const double *)open
+                          high:(const double *)high
+                           low:(const double *)low
+                         close:(const double *)close
+                 adjustedClose:(const double *)adjustedClose
+                        volume:(const int64_t *)volume {
+    self = [super init];
+    if (self) {
+        _symbol = [symbol copy] ?: @"";
+        _timeframe = timeframe;
+        _count = count;
+        _storage = storage;
+        _time = time;
+        _open = open;
+        _high = high;
+        _low = low;
+        _close = close;
+        _adjustedClose = adjustedClose;
+        _volume = volume;
+    }
+    return self;
+}
+
+#pragma mark - Creation
+
++ (instancetype)seriesWithBars:(NSArray<HistoricalBarModel *> *)bars {
+    BarSeries *backing = [self backingSeriesOfBars:bars];
+    if (backing) {
+        return backing;
+    }
+
+    HistoricalBarModel *firstBar = bars.firstObject;
+    NSInteger count = bars.count;
+
+    return [self seriesWithSymbol:firstBar.symbol ?: @""
+                        timeframe:firstBar ? firstBar.timeframe : BarTimeframeDaily
+                            count:count
+                      fillColumns:^(BarSeriesMutableColumns columns) {
+        NSInteger i = 0;
+        for (HistoricalBarModel *bar in bars) {
+            columns.time[i] = bar.date.timeIntervalSince1970;
+            columns.open[i] = bar.open;
+            columns.high[i] = bar.high;
+            columns.low[i] = bar.low;
+            columns.close[i] = bar.close;
+            columns.adjustedClose[i] = bar.adjustedClose;
+            columns.volume[i] = bar.volume;
+            i++;
+        }
+    }];
+}
+
++ (instancetype)seriesWithSymbol:(NSString *)symbol
+                       timeframe:(BarTimeframe)timeframe
+                           count:(NSInteger)count
+                     fillColumns:(void (NS_NOESCAPE ^)(BarSeriesMutableColumns columns))fillBlock {
+
+    count = MAX(count, 0);
+    NSMutableData *storage = [NSMutableData dataWithLength:(NSUInteger)count * kBarSeriesColumnCount * sizeof(double)];
+    double *base = storage.mutableBytes;
+
+    BarSeriesMutableColumns columns;
+    columns.time = base;
+    columns.open = base + count;
+    columns.high = base + count * 2;
+    columns.low = base + count * 3;
+    columns.close = base + count * 4;
+    columns.adjustedClose = base + count * 5;
+    columns.volume = (int64_t *)(base + count * 6);
+
+    if (fillBlock && count > 0) {
+        fillBlock(columns);
+    }
+
+    return [[self alloc] initWithSymbol:symbol
+                              timeframe:timeframe
+                                  count:count
+                                storage:storage
+                                   time:columns.time
+                                   open:columns.open
+                                   high:columns.high
+                                    low:columns.low
+                                  close:columns.close
+                          adjustedClose:columns.adjustedClose
+                                 volume:columns.volume];
+}
+
++ (nullable instancetype)seriesWithSymbol:(NSString *)symbol
+                                timeframe:(BarTimeframe)timeframe
+                                    count:(NSInteger)count
+                                  storage:(NSData *)storage
+                            columnOffsets:(const NSUInteger *)offsets {
+
+    NSUInteger columnBytes = (NSUInteger)MAX(count, 0) * sizeof(double);
+    for (NSInteger c = 0; c < kBarSeriesColumnCount; c++) {
+        if (offsets[c] % sizeof(double) != 0 || offsets[c] + columnBytes > storage.length) {
+            NSLog(@"⚠️ BarSeries: column %ld out of storage bounds for %@", (long)c, symbol);
+            return nil;
+        }
+    }
+
+    const uint8_t *base = storage.bytes;
+    return [[self alloc] initWithSymbol:symbol
+                              timeframe:timeframe
+                                  count:MAX(count, 0)
+                                storage:storage
+                                   time:(const NSTimeInterval *)(base + offsets[0])
+                                   open:(const double *)(base + offsets[1])
+                                   high:(const double *)(base + offsets[2])
+                                    low:(const double *)(base + offsets[3])
+                                  close:(const double *)(base + offsets[4])
+                          adjustedClose:(const double *)(base + offsets[5])
+                                 volume:(const int64_t *)(base + offsets[6])];
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    return self;  // Immutable
+}
+
+- (NSUInteger)byteSize {
+    return (NSUInteger)self.count * kBarSeriesColumnCount * sizeof(double);
+}
+
+#pragma mark - Views
+
+- (BarSeries *)sliceWithRange:(NSRange)range {
+    NSAssert(NSMaxRange(range) <= (NSUInteger)self.count, @"BarSeries slice out of bounds");
+
+    if (range.location == 0 && range.length == (NSUInteger)self.count) {
+        return self;
+    }
+
+    NSUInteger offset = range.location;
+    return [[BarSeries alloc] initWithSymbol:self.symbol
+                                   timeframe:self.timeframe
+                                       count:range.length
+                                     storage:_storage
+                                        time:self.time + offset
+                                        open:self.open + offset
+                                        high:self.high + offset
+                                         low:self.low + offset
+                                       close:self.close + offset
+                               adjustedClose:self.adjustedClose + offset
+                                      volume:self.volume + offset];
+}
+
+- (NSInteger)indexOfLastBarOnOrBeforeTime:(NSTimeInterval)time {
+    // upper_bound: primo indice con time > target, poi -1
+    NSInteger low = 0;
+    NSInteger high = self.count;
+    const NSTimeInterval *times = self.time;
+
+    while (low < high) {
+        NSInteger mid = low + (high - low) / 2;
+        if (times[mid] <= time) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low - 1;
+}
+
+#pragma mark - HistoricalBarModel Bridge
+
+- (HistoricalBarModel *)barAtIndex:(NSInteger)index {
+    NSAssert(index >= 0 && index < self.count, @"BarSeries index out of bounds");
+
+    HistoricalBarModel *bar = [[HistoricalBarModel alloc] init];
+    bar.symbol = self.symbol;
+    bar.date = [NSDate dateWithTimeIntervalSince1970:self.time[index]];
+    bar.open = self.open[index];
+    bar.high = self.high[index];
+    bar.low = self.low[index];
+    bar.close = self.close[index];
+    bar.adjustedClose = self.adjustedClose[index];
+    bar.volume = self.volume[index];
+    bar.timeframe = self.timeframe;
+    bar.isPaddingBar = NO;
+    return bar;
+}
+
+- (NSArray<HistoricalBarModel *> *)bars {
+    return [[BarSeriesArray alloc] initWithSeries:self];
+}
+
++ (nullable BarSeries *)backingSeriesOfBars:(NSArray<HistoricalBarModel *> *)bars {
+    if ([bars conformsToProtocol:@protocol(BarSeriesBacked)]) {
+        return [(id<BarSeriesBacked>)bars barSeries];
+    }
+    return nil;
+}
+
++ (NSUInteger)materializedBarCountOfBars:(NSArray<HistoricalBarModel *> *)bars {
+    if ([bars conformsToProtocol:@protocol(BarSeriesBacked)] &&
+        [bars respondsToSelector:@selector(materializedBarCount)]) {
+        return [(id<BarSeriesBacked>)bars materializedBarCount];
+    }
+    return 0;
+}
+
+@end
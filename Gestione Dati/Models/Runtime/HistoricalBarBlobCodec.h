@@ -0,0 +1,47 @@
+//
+//  HistoricalBarBlobCodec.h
+//  TradingApp
+//
+//  Compact binary form of a whole (symbol, timeframe) history, stored by
+//  DataHub as one Core Data attribute instead of one HistoricalBar per bar.
+//  Bars are split into fixed-size chunks; inside a chunk timestamps, prices
+//  and volumes are delta-encoded as zigzag varints (prices as exact decimal
+//  fixed-point when possible, raw doubles otherwise). A chunk table lets the
+//  decoder read only the most recent bars.
+//
+
+#import <Foundation/Foundation.h>
+#import "RuntimeModels.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class BarSeries;
+
+/// Format version written in the blob header
+extern const uint16_t HistoricalBarBlobFormatVersion;
+
+@interface HistoricalBarBlobCodec : NSObject
+
+/**
+ * Encode bars (oldest → newest, already deduplicated)
+ * Lossless: every double decodes to the same value.
+ * @return Blob data, or nil if bars is empty
+ */
++ (nullable NSData *)encodeBars:(NSArray<HistoricalBarModel *> *)bars;
+
+/**
+ * Decode a blob into a columnar series
+ * @param lastBarCount Most recent bars wanted (0 = all); only the chunks covering them are decoded
+ * @return Series, or nil if the data is not a valid blob
+ */
++ (nullable BarSeries *)decodeData:(NSData *)data
+                            symbol:(NSString *)symbol
+                         timeframe:(BarTimeframe)timeframe
+                      lastBarCount:(NSInteger)lastBarCount;
+
+/// Number of bars in a blob (header only), or -1 if invalid
++ (NSInteger)barCountOfData:(NSData *)data;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,373 @@
+//
+//  HistoricalBarBlobCodec.m
+//  TradingApp
+//
+
+#import "HistoricalBarBlobCodec.h"
+#import "BarSeries.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+const uint16_t HistoricalBarBlobFormatVersion = 1;
+
+static const uint32_t kBlobMagic = 0x424C4248;          // "HBLB" little-endian
+static const uint16_t kBlobChunkBars = 256;
+static const NSUInteger kBlobHeaderSize = 16;           // magic, version, chunkBars, barCount, chunkCount
+static const NSUInteger kBlobChunkEntrySize = 24;       // firstTime, count, offset, length, reserved
+
+/// Flag del chunk: prezzi come double grezzi / timestamp non rappresentabili in ms
+static const uint8_t kBlobChunkRawPrices = 1 << 0;
+static const uint8_t kBlobChunkRawTimes = 1 << 1;
+
+static const int kBlobMaxScaleDigits = 8;
+static const double kBlobMaxExactInteger = 9007199254740992.0;     // 2^53
+
+#pragma mark - Varint helpers
+
+static inline uint64_t BlobZigZag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t BlobUnZigZag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/// Differenza con wrap-around: sempre reversibile anche per valori estremi
+static inline int64_t BlobDelta(int64_t value, int64_t previous) {
+    return (int64_t)((uint64_t)value - (uint64_t)previous);
+}
+
+static inline int64_t BlobUndelta(int64_t delta, int64_t previous) {
+    return (int64_t)((uint64_t)previous + (uint64_t)delta);
+}
+
+static inline uint8_t *BlobWriteVarint(uint8_t *cursor, uint64_t value) {
+    while (value >= 0x80) {
+        *cursor++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *cursor++ = (uint8_t)value;
+    return cursor;
+}
+
+static inline BOOL BlobReadVarint(const uint8_t **cursor, const uint8_t *end, uint64_t *value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && *cursor < end; shift += 7) {
+        uint8_t byte = *(*cursor)++;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return YES;
+        }
+    }
+    return NO;
+}
+
+static inline BOOL BlobReadSigned(const uint8_t **cursor, const uint8_t *end, int64_t *value) {
+    uint64_t raw;
+    if (!BlobReadVarint(cursor, end, &raw)) return NO;
+    *value = BlobUnZigZag(raw);
+    return YES;
+}
+
+static inline uint8_t *BlobWriteBytes(uint8_t *cursor, const void *bytes, size_t length) {
+    memcpy(cursor, bytes, length);
+    return cursor + length;
+}
+
+static inline BOOL BlobReadBytes(const uint8_t **cursor, const uint8_t *end, void *bytes, size_t length) {
+    if ((size_t)(end - *cursor) < length) return NO;
+    memcpy(bytes, *cursor, length);
+    *cursor += length;
+    return YES;
+}
+
+static inline int64_t BlobMilliseconds(NSTimeInterval seconds) {
+    return llround(seconds * 1000.0);
+}
+
+static const double kBlobPowersOfTen[kBlobMaxScaleDigits + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8
+};
+
+#pragma mark - Chunk encoding
+
+/**
+ * Smallest number of decimal digits that represents every price of the chunk exactly
+ * @return Digits, or -1 if some price needs raw storage
+ */
+static int BlobScaleDigits(BarSeries *series, NSInteger start, NSInteger count) {
+    const double *columns[5] = { series.open, series.high, series.low, series.close, series.adjustedClose };
+
+    for (int digits = 0; digits <= kBlobMaxScaleDigits; digits++) {
+        double scale = kBlobPowersOfTen[digits];
+        BOOL exact = YES;
+        for (int c = 0; c < 5 && exact; c++) {
+            const double *column = columns[c];
+            for (NSInteger i = start; i < start + count; i++) {
+                double scaled = column[i] * scale;
+                if (!(fabs(scaled) < kBlobMaxExactInteger) || (double)llround(scaled) / scale != column[i]) {
+                    exact = NO;
+                    break;
+                }
+            }
+        }
+        if (exact) return digits;
+    }
+    return -1;
+}
+
+static uint8_t *BlobEncodeChunk(uint8_t *cursor, BarSeries *series, NSInteger start, NSInteger count, int64_t firstTime) {
+    const NSTimeInterval *time = series.time;
+    const double *open = series.open;
+    const double *high = series.high;
+    const double *low = series.low;
+    const double *close = series.close;
+    const double *adjustedClose = series.adjustedClose;
+    const int64_t *volume = series.volume;
+
+    BOOL rawTimes = NO;
+    for (NSInteger i = start; i < start + count; i++) {
+        if ((double)BlobMilliseconds(time[i]) / 1000.0 != time[i]) {
+            rawTimes = YES;
+            break;
+        }
+    }
+    int digits = BlobScaleDigits(series, start, count);
+
+    uint8_t flags = (digits < 0 ? kBlobChunkRawPrices : 0) | (rawTimes ? kBlobChunkRawTimes : 0);
+    *cursor++ = flags;
+    *cursor++ = (uint8_t)MAX(digits, 0);
+
+    double scale = kBlobPowersOfTen[MAX(digits, 0)];
+    int64_t previousTime = firstTime;
+    int64_t previousClose = 0;
+    int64_t previousVolume = 0;
+
+    for (NSInteger i = start; i < start + count; i++) {
+        if (rawTimes) {
+            cursor = BlobWriteBytes(cursor, &time[i], sizeof(double));
+        } else {
+            int64_t ms = BlobMilliseconds(time[i]);
+            cursor = BlobWriteVarint(cursor, BlobZigZag(BlobDelta(ms, previousTime)));
+            previousTime = ms;
+        }
+
+        if (digits < 0) {
+            double prices[5] = { open[i], high[i], low[i], close[i], adjustedClose[i] };
+            cursor = BlobWriteBytes(cursor, prices, sizeof(prices));
+        } else {
+            // Close rispetto alla barra precedente, gli altri prezzi rispetto al close della barra
+            int64_t c = llround(close[i] * scale);
+            cursor = BlobWriteVarint(cursor, BlobZigZag(BlobDelta(c, previousClose)));
+            cursor = BlobWriteVarint(cursor, BlobZigZag(BlobDelta(llround(open[i] * scale), c)));
+            cursor = BlobWriteVarint(cursor, BlobZigZag(BlobDelta(llround(high[i] * scale), c)));
+            cursor = BlobWriteVarint(cursor, BlobZigZag(BlobDelta(llround(low[i] * scale), c)));
+            cursor = BlobWriteVarint(cursor, BlobZigZag(BlobDelta(llround(adjustedClose[i] * scale), c)));
+            previousClose = c;
+        }
+
+        cursor = BlobWriteVarint(cursor, BlobZigZag(BlobDelta(volume[i], previousVolume)));
+        previousVolume = volume[i];
+    }
+    return cursor;
+}
+
+#pragma mark - Chunk decoding
+
+static BOOL BlobDecodeChunk(const uint8_t *cursor, const uint8_t *end, NSInteger count,
+                            int64_t firstTime, BarSeriesMutableColumns columns, NSInteger offset) {
+    if (end - cursor < 2) return NO;
+    uint8_t flags = *cursor++;
+    uint8_t digits = *cursor++;
+    if (digits > kBlobMaxScaleDigits) return NO;
+
+    BOOL rawPrices = (flags & kBlobChunkRawPrices) != 0;
+    BOOL rawTimes = (flags & kBlobChunkRawTimes) != 0;
+    double scale = kBlobPowersOfTen[digits];
+    int64_t previousTime = firstTime;
+    int64_t previousClose = 0;
+    int64_t previousVolume = 0;
+
+    for (NSInteger k = 0; k < count; k++) {
+        NSInteger i = offset + k;
+
+        if (rawTimes) {
+            if (!BlobReadBytes(&cursor, end, &columns.time[i], sizeof(double))) return NO;
+        } else {
+            int64_t delta;
+            if (!BlobReadSigned(&cursor, end, &delta)) return NO;
+            previousTime = BlobUndelta(delta, previousTime);
+            columns.time[i] = (double)previousTime / 1000.0;
+        }
+
+        if (rawPrices) {
+            double prices[5];
+            if (!BlobReadBytes(&cursor, end, prices, sizeof(prices))) return NO;
+            columns.open[i] = prices[0];
+            columns.high[i] = prices[1];
+            columns.low[i] = prices[2];
+            columns.close[i] = prices[3];
+            columns.adjustedClose[i] = prices[4];
+        } else {
+            int64_t deltas[5];
+            for (int d = 0; d < 5; d++) {
+                if (!BlobReadSigned(&cursor, end, &deltas[d])) return NO;
+            }
+            int64_t c = BlobUndelta(deltas[0], previousClose);
+            columns.close[i] = (double)c / scale;
+            columns.open[i] = (double)BlobUndelta(deltas[1], c) / scale;
+            columns.high[i] = (double)BlobUndelta(deltas[2], c) / scale;
+            columns.low[i] = (double)BlobUndelta(deltas[3], c) / scale;
+            columns.adjustedClose[i] = (double)BlobUndelta(deltas[4], c) / scale;
+            previousClose = c;
+        }
+
+        int64_t volumeDelta;
+        if (!BlobReadSigned(&cursor, end, &volumeDelta)) return NO;
+        previousVolume = BlobUndelta(volumeDelta, previousVolume);
+        columns.volume[i] = previousVolume;
+    }
+    return YES;
+}
+
+#pragma mark - Header
+
+typedef struct {
+    int64_t firstTime;
+    uint32_t count;
+    uint32_t offset;
+    uint32_t length;
+} HistoricalBarBlobChunk;
+
+static BOOL BlobReadHeader(NSData *data, uint32_t *barCount, uint32_t *chunkCount) {
+    if (data.length < kBlobHeaderSize) return NO;
+
+    const uint8_t *bytes = data.bytes;
+    uint32_t magic;
+    uint16_t version;
+    memcpy(&magic, bytes, 4);
+    memcpy(&version, bytes + 4, 2);
+    memcpy(barCount, bytes + 8, 4);
+    memcpy(chunkCount, bytes + 12, 4);
+
+    if (magic != kBlobMagic || version != HistoricalBarBlobFormatVersion) return NO;
+    return data.length >= kBlobHeaderSize + (NSUInteger)*chunkCount * kBlobChunkEntrySize;
+}
+
+static HistoricalBarBlobChunk BlobChunkAtIndex(NSData *data, uint32_t index) {
+    const uint8_t *entry = (const uint8_t *)data.bytes + kBlobHeaderSize + (NSUInteger)index * kBlobChunkEntrySize;
+    HistoricalBarBlobChunk chunk;
+    memcpy(&chunk.firstTime, entry, 8);
+    memcpy(&chunk.count, entry + 8, 4);
+    memcpy(&chunk.offset, entry + 12, 4);
+    memcpy(&chunk.length, entry + 16, 4);
+    return chunk;
+}
+
+@implementation HistoricalBarBlobCodec
+
++ (NSData *)encodeBars:(NSArray<HistoricalBarModel *> *)bars {
+    if (bars.count == 0) return nil;
+
+    BarSeries *series = [BarSeries seriesWithBars:bars];
+    NSInteger count = series.count;
+    uint32_t chunkCount = (uint32_t)((count + kBlobChunkBars - 1) / kBlobChunkBars);
+    NSUInteger payloadOffset = kBlobHeaderSize + (NSUInteger)chunkCount * kBlobChunkEntrySize;
+
+    // Caso peggiore per barra: timestamp e volume varint (10 byte) + 5 prezzi varint (10 byte)
+    NSUInteger capacity = payloadOffset + (NSUInteger)chunkCount * 2 + (NSUInteger)count * (10 + 5 * 10 + 10);
+    NSMutableData *data = [NSMutableData dataWithLength:capacity];
+    uint8_t *bytes = data.mutableBytes;
+
+    uint32_t magic = kBlobMagic;
+    uint16_t version = HistoricalBarBlobFormatVersion;
+    uint16_t chunkBars = kBlobChunkBars;
+    uint32_t barCount = (uint32_t)count;
+    memcpy(bytes, &magic, 4);
+    memcpy(bytes + 4, &version, 2);
+    memcpy(bytes + 6, &chunkBars, 2);
+    memcpy(bytes + 8, &barCount, 4);
+    memcpy(bytes + 12, &chunkCount, 4);
+
+    uint8_t *cursor = bytes + payloadOffset;
+    for (uint32_t c = 0; c < chunkCount; c++) {
+        NSInteger start = (NSInteger)c * kBlobChunkBars;
+        NSInteger chunkLength = MIN((NSInteger)kBlobChunkBars, count - start);
+        int64_t firstTime = BlobMilliseconds(series.time[start]);
+
+        uint8_t *chunkStart = cursor;
+        cursor = BlobEncodeChunk(cursor, series, start, chunkLength, firstTime);
+
+        uint32_t entryCount = (uint32_t)chunkLength;
+        uint32_t offset = (uint32_t)(chunkStart - bytes);
+        uint32_t length = (uint32_t)(cursor - chunkStart);
+        uint32_t reserved = 0;
+        uint8_t *entry = bytes + kBlobHeaderSize + (NSUInteger)c * kBlobChunkEntrySize;
+        memcpy(entry, &firstTime, 8);
+        memcpy(entry + 8, &entryCount, 4);
+        memcpy(entry + 12, &offset, 4);
+        memcpy(entry + 16, &length, 4);
+        memcpy(entry + 20, &reserved, 4);
+    }
+
+    data.length = (NSUInteger)(cursor - bytes);
+    return [data copy];
+}
+
++ (BarSeries *)decodeData:(NSData *)data
+                   symbol:(NSString *)symbol
+                timeframe:(BarTimeframe)timeframe
+             lastBarCount:(NSInteger)lastBarCount {
+    uint32_t barCount = 0;
+    uint32_t chunkCount = 0;
+    if (!data || !BlobReadHeader(data, &barCount, &chunkCount)) return nil;
+
+    // Chunk da decodificare: dal fondo finché non coprono le barre richieste
+    NSInteger wanted = (lastBarCount > 0) ? MIN(lastBarCount, (NSInteger)barCount) : (NSInteger)barCount;
+    uint32_t firstChunk = chunkCount;
+    NSInteger covered = 0;
+    while (firstChunk > 0 && covered < wanted) {
+        firstChunk--;
+        covered += BlobChunkAtIndex(data, firstChunk).count;
+    }
+
+    const uint8_t *bytes = data.bytes;
+    __block BOOL valid = YES;
+    BarSeries *series = [BarSeries seriesWithSymbol:symbol
+                                          timeframe:timeframe
+                                              count:covered
+                                        fillColumns:^(BarSeriesMutableColumns columns) {
+        NSInteger offset = 0;
+        for (uint32_t c = firstChunk; c < chunkCount && valid; c++) {
+            HistoricalBarBlobChunk chunk = BlobChunkAtIndex(data, c);
+            if ((NSUInteger)chunk.offset + chunk.length > data.length || offset + chunk.count > covered) {
+                valid = NO;
+                break;
+            }
+            valid = BlobDecodeChunk(bytes + chunk.offset, bytes + chunk.offset + chunk.length,
+                                    chunk.count, chunk.firstTime, columns, offset);
+            offset += chunk.count;
+        }
+        valid = valid && offset == covered;
+    }];
+
+    if (!valid) {
+        NSLog(@"❌ HistoricalBarBlobCodec: corrupted blob for %@", symbol);
+        return nil;
+    }
+    if (covered > wanted) {
+        series = [series sliceWithRange:NSMakeRange(covered - wanted, wanted)];
+    }
+    return series;
+}
+
++ (NSInteger)barCountOfData:(NSData *)data {
+    uint32_t barCount = 0;
+    uint32_t chunkCount = 0;
+    if (!data || !BlobReadHeader(data, &barCount, &chunkCount)) return -1;
+    return barCount;
+}
+
+@end
@@ -0,0 +1,54 @@
+//
+//  HistoricalBarMerge.h
+//  TradingApp
+//
+//  Linear-time merge and deduplication of bar arrays.
+//  Dates are turned once into integer millisecond timestamps (read straight
+//  from the columns for BarSeries-backed arrays); sorted inputs are then
+//  merged with two pointers, duplicates dropped in the same pass.
+//
+
+#import <Foundation/Foundation.h>
+#import "RuntimeModels.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Bars closer than this are the same bar (DataHub's historical rule)
+extern const NSTimeInterval HistoricalBarMergeDefaultTolerance;
+
+@interface HistoricalBarMerge : NSObject
+
+/**
+ * Union of two bar arrays in chronological order, without duplicates
+ * @param tolerance Bars whose dates differ by less than this are duplicates (0 = identical dates only)
+ * @param preferIncoming On a duplicate keep the incoming bar instead of the existing one
+ * @return Merged bars. Bars without a date are dropped.
+ *
+ * @discussion
+ * O(n + m) when both inputs are sorted (the common case, checked in one pass);
+ * an unsorted input is stably sorted first. Within one input the first of
+ * several duplicates is kept.
+ */
++ (NSArray<HistoricalBarModel *> *)mergeBars:(nullable NSArray<HistoricalBarModel *> *)existingBars
+                                    withBars:(nullable NSArray<HistoricalBarModel *> *)incomingBars
+                                   tolerance:(NSTimeInterval)tolerance
+                              preferIncoming:(BOOL)preferIncoming;
+
+/**
+ * Bars in chronological order with duplicates removed (first occurrence kept)
+ * Returns the input itself when it is sorted and has no duplicates.
+ */
++ (NSArray<HistoricalBarModel *> *)deduplicateBars:(nullable NSArray<HistoricalBarModel *> *)bars
+                                         tolerance:(NSTimeInterval)tolerance;
+
+/**
+ * Index of the bar matching date within tolerance, or NSNotFound (binary search)
+ * @param bars Bars in chronological order
+ */
++ (NSUInteger)indexOfBarAtDate:(NSDate *)date
+                        inBars:(NSArray<HistoricalBarModel *> *)bars
+                     tolerance:(NSTimeInterval)tolerance;
+
+@end
+
+NS_ASSUME_NONNULL_END
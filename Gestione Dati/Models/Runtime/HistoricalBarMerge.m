@@ -0,0 +1,202 @@
+//
+//  HistoricalBarMerge.m
+//  TradingApp
+//
+
+#import "HistoricalBarMerge.h"
+#import "BarSeries.h"
+#include <stdlib.h>
+
+const NSTimeInterval HistoricalBarMergeDefaultTolerance = 30.0;
+
+/// Timestamp (ms) and position of one bar in its source array
+typedef struct {
+    int64_t time;
+    NSUInteger index;
+} HistoricalBarMergeKey;
+
+static int HistoricalBarMergeCompareKeys(const void *a, const void *b) {
+    int64_t ta = ((const HistoricalBarMergeKey *)a)->time;
+    int64_t tb = ((const HistoricalBarMergeKey *)b)->time;
+    return (ta > tb) - (ta < tb);
+}
+
+static inline int64_t HistoricalBarMergeMilliseconds(NSTimeInterval seconds) {
+    return llround(seconds * 1000.0);
+}
+
+/// |a - b| < tolerance, or identical timestamps when tolerance is 0
+static inline BOOL HistoricalBarMergeSameBar(int64_t a, int64_t b, int64_t toleranceMs) {
+    int64_t delta = a > b ? a - b : b - a;
+    return delta == 0 || delta < toleranceMs;
+}
+
+/**
+ * Keys of every dated bar in chronological order
+ * @param sorted Set to YES if the array was already in order (no sort performed)
+ */
+static NSMutableData *HistoricalBarMergeKeys(NSArray<HistoricalBarModel *> *bars, BOOL *sorted) {
+    NSUInteger count = bars.count;
+    NSMutableData *data = [NSMutableData dataWithLength:count * sizeof(HistoricalBarMergeKey)];
+    HistoricalBarMergeKey *keys = data.mutableBytes;
+    NSUInteger written = 0;
+    BOOL inOrder = YES;
+
+    // Array colonnare: i timestamp si leggono dalla colonna, nessun oggetto materializzato
+    BarSeries *series = [BarSeries backingSeriesOfBars:bars];
+    if (series) {
+        const NSTimeInterval *time = series.time;
+        for (NSUInteger i = 0; i < count; i++) {
+            keys[written] = (HistoricalBarMergeKey){ HistoricalBarMergeMilliseconds(time[i]), i };
+            inOrder = inOrder && (written == 0 || keys[written].time >= keys[written - 1].time);
+            written++;
+        }
+    } else {
+        NSUInteger i = 0;
+        for (HistoricalBarModel *bar in bars) {
+            NSDate *date = bar.date;
+            if (date) {
+                keys[written] = (HistoricalBarMergeKey){ HistoricalBarMergeMilliseconds(date.timeIntervalSince1970), i };
+                inOrder = inOrder && (written == 0 || keys[written].time >= keys[written - 1].time);
+                written++;
+            }
+            i++;
+        }
+    }
+
+    data.length = written * sizeof(HistoricalBarMergeKey);
+    if (!inOrder) {
+        // mergesort è stabile: a parità di data resta il primo
+        mergesort(data.mutableBytes, written, sizeof(HistoricalBarMergeKey), HistoricalBarMergeCompareKeys);
+    }
+    if (sorted) *sorted = inOrder;
+    return data;
+}
+
+@implementation HistoricalBarMerge
+
++ (NSArray<HistoricalBarModel *> *)mergeBars:(NSArray<HistoricalBarModel *> *)existingBars
+                                    withBars:(NSArray<HistoricalBarModel *> *)incomingBars
+                                   tolerance:(NSTimeInterval)tolerance
+                              preferIncoming:(BOOL)preferIncoming {
+    if (incomingBars.count == 0) {
+        return [self deduplicateBars:existingBars tolerance:tolerance];
+    }
+    if (existingBars.count == 0) {
+        return [self deduplicateBars:incomingBars tolerance:tolerance];
+    }
+
+    NSData *existingData = HistoricalBarMergeKeys(existingBars, NULL);
+    NSData *incomingData = HistoricalBarMergeKeys(incomingBars, NULL);
+    const HistoricalBarMergeKey *existing = existingData.bytes;
+    const HistoricalBarMergeKey *incoming = incomingData.bytes;
+    NSUInteger existingCount = existingData.length / sizeof(HistoricalBarMergeKey);
+    NSUInteger incomingCount = incomingData.length / sizeof(HistoricalBarMergeKey);
+    int64_t toleranceMs = HistoricalBarMergeMilliseconds(tolerance);
+
+    NSMutableArray<HistoricalBarModel *> *merged = [NSMutableArray arrayWithCapacity:existingCount + incomingCount];
+    int64_t lastTime = 0;
+    BOOL hasLast = NO;
+    NSUInteger i = 0;
+    NSUInteger j = 0;
+
+    while (i < existingCount || j < incomingCount) {
+        HistoricalBarModel *candidate;
+        int64_t time;
+
+        if (j >= incomingCount || (i < existingCount && existing[i].time <= incoming[j].time)) {
+            time = existing[i].time;
+            candidate = existingBars[existing[i].index];
+            // Stessa barra nell'altro array: ne resta una sola
+            if (j < incomingCount && HistoricalBarMergeSameBar(time, incoming[j].time, toleranceMs)) {
+                if (preferIncoming) {
+                    time = incoming[j].time;
+                    candidate = incomingBars[incoming[j].index];
+                }
+                j++;
+            }
+            i++;
+        } else {
+            time = incoming[j].time;
+            candidate = incomingBars[incoming[j].index];
+            if (i < existingCount && HistoricalBarMergeSameBar(time, existing[i].time, toleranceMs)) {
+                if (!preferIncoming) {
+                    time = existing[i].time;
+                    candidate = existingBars[existing[i].index];
+                }
+                i++;
+            }
+            j++;
+        }
+
+        // Duplicati interni allo stesso array
+        if (hasLast && HistoricalBarMergeSameBar(time, lastTime, toleranceMs)) {
+            continue;
+        }
+        [merged addObject:candidate];
+        lastTime = time;
+        hasLast = YES;
+    }
+
+    return [merged copy];
+}
+
++ (NSArray<HistoricalBarModel *> *)deduplicateBars:(NSArray<HistoricalBarModel *> *)bars
+                                         tolerance:(NSTimeInterval)tolerance {
+    if (bars.count == 0) return @[];
+
+    BOOL sorted = NO;
+    NSData *keyData = HistoricalBarMergeKeys(bars, &sorted);
+    const HistoricalBarMergeKey *keys = keyData.bytes;
+    NSUInteger count = keyData.length / sizeof(HistoricalBarMergeKey);
+    int64_t toleranceMs = HistoricalBarMergeMilliseconds(tolerance);
+
+    NSMutableArray<HistoricalBarModel *> *unique = [NSMutableArray arrayWithCapacity:count];
+    int64_t lastTime = 0;
+    for (NSUInteger k = 0; k < count; k++) {
+        if (k > 0 && HistoricalBarMergeSameBar(keys[k].time, lastTime, toleranceMs)) {
+            continue;
+        }
+        [unique addObject:bars[keys[k].index]];
+        lastTime = keys[k].time;
+    }
+
+    // Già ordinato e senza duplicati: nessuna copia
+    if (sorted && unique.count == bars.count) {
+        return bars;
+    }
+    return [unique copy];
+}
+
++ (NSUInteger)indexOfBarAtDate:(NSDate *)date
+                        inBars:(NSArray<HistoricalBarModel *> *)bars
+                     tolerance:(NSTimeInterval)tolerance {
+    if (!date || bars.count == 0) return NSNotFound;
+
+    int64_t target = HistoricalBarMergeMilliseconds(date.timeIntervalSince1970);
+    int64_t toleranceMs = HistoricalBarMergeMilliseconds(tolerance);
+    BarSeries *series = [BarSeries backingSeriesOfBars:bars];
+
+    // Primo indice con time >= target - tolleranza
+    NSUInteger low = 0;
+    NSUInteger high = bars.count;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        NSTimeInterval seconds = series ? series.time[mid] : bars[mid].date.timeIntervalSince1970;
+        if (HistoricalBarMergeMilliseconds(seconds) < target - toleranceMs) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    for (NSUInteger k = low; k < bars.count; k++) {
+        NSTimeInterval seconds = series ? series.time[k] : bars[k].date.timeIntervalSince1970;
+        int64_t time = HistoricalBarMergeMilliseconds(seconds);
+        if (HistoricalBarMergeSameBar(time, target, toleranceMs)) return k;
+        if (time > target) break;
+    }
+    return NSNotFound;
+}
+
+@end
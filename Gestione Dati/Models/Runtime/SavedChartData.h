@@ -133,12 +133,17 @@ includesExtendedHours:(BOOL)includesExtendedHours;
 /// Convert to dictionary for binary plist storage
 - (NSDictionary *)toDictionary;
 
-/// Create SavedChartData from binary plist file
-/// @param filePath Path to the binary plist file
+/// Create SavedChartData from file (binary container, or legacy LZFSE/plain binary plist)
+/// @param filePath Path to the saved file
 + (nullable instancetype)loadFromFile:(NSString *)filePath;
 
-/// Save to binary plist file
-/// @param filePath Path where to save the binary plist
+/// Metadata of a binary container file (everything but the bars, plus "barCount")
+/// Reads only the fixed header and the metadata block. Returns nil for legacy files.
+/// @param filePath Path to the saved file
++ (nullable NSDictionary *)headerMetadataFromFile:(NSString *)filePath;
+
+/// Save as binary container: fixed header, metadata plist, LZFSE-compressed delta columns
+/// @param filePath Path where to save the file
 /// @param error Error pointer for any save issues
 - (BOOL)saveToFile:(NSString *)filePath error:(NSError **)error;
 
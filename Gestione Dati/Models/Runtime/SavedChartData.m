@@ -11,6 +11,9 @@
 #import "ChartWidget+SaveData.h"
 #import "SavedChartData+FilenameParsing.h"
 #import "SavedChartData+FilenameUpdate.h"
+#import "SavedChartData+SegmentLog.h"
+#import "HistoricalBarMerge.h"
+#import "BarSeries.h"
 
 
 // Forward declaration to access private properties
@@ -23,6 +26,105 @@
 @property (nonatomic, assign) BOOL isCompressed;
 @end
 
+#pragma mark - Binary Container Layout
+
+/*
+ * Container v3 (little-endian):
+ *   header (80 byte) | metadati (binary plist, senza barre) | colonne compresse LZFSE
+ * Colonne, barCount parole da 8 byte ciascuna, in questo ordine:
+ *   time   delta in ms (o XOR dei bit del double se non rappresentabile in ms)
+ *   open, high, low, close   XOR dei bit con il valore precedente
+ *   volume delta
+ */
+static const uint32_t kContainerMagic = 0x42444353;        // "SCDB"
+static const uint16_t kContainerVersion = 3;
+static const NSUInteger kContainerHeaderSize = 80;
+static const NSUInteger kContainerColumnCount = 6;
+static const uint16_t kContainerFlagRawTime = 1 << 0;
+static const size_t kContainerStreamChunk = 64 * 1024;
+static const uint32_t kContainerMaxMetadataLength = 1024 * 1024;
+
+typedef struct {
+    uint16_t flags;
+    uint32_t metadataLength;
+    uint32_t barCount;
+    uint64_t uncompressedSize;
+    uint64_t compressedSize;
+    uint64_t columnOffsets[6];                       // Relativi all'inizio delle colonne decompresse
+} SavedChartDataContainerHeader;
+
+static BOOL SavedChartDataReadContainerHeader(NSData *data, SavedChartDataContainerHeader *header) {
+    if (data.length < kContainerHeaderSize) return NO;
+    
+    const uint8_t *bytes = data.bytes;
+    uint32_t magic;
+    uint16_t version;
+    memcpy(&magic, bytes, 4);
+    memcpy(&version, bytes + 4, 2);
+    if (magic != kContainerMagic || version != kContainerVersion) return NO;
+    
+    memcpy(&header->flags, bytes + 6, 2);
+    memcpy(&header->metadataLength, bytes + 8, 4);
+    memcpy(&header->barCount, bytes + 12, 4);
+    memcpy(&header->uncompressedSize, bytes + 16, 8);
+    memcpy(&header->compressedSize, bytes + 24, 8);
+    memcpy(header->columnOffsets, bytes + 32, sizeof(header->columnOffsets));
+    
+    uint64_t expectedSize = (uint64_t)header->barCount * kContainerColumnCount * sizeof(uint64_t);
+    return header->uncompressedSize == expectedSize &&
+           (uint64_t)kContainerHeaderSize + header->metadataLength + header->compressedSize <= data.length;
+}
+
+static void SavedChartDataWriteContainerHeader(uint8_t *bytes, const SavedChartDataContainerHeader *header) {
+    uint32_t magic = kContainerMagic;
+    uint16_t version = kContainerVersion;
+    memcpy(bytes, &magic, 4);
+    memcpy(bytes + 4, &version, 2);
+    memcpy(bytes + 6, &header->flags, 2);
+    memcpy(bytes + 8, &header->metadataLength, 4);
+    memcpy(bytes + 12, &header->barCount, 4);
+    memcpy(bytes + 16, &header->uncompressedSize, 8);
+    memcpy(bytes + 24, &header->compressedSize, 8);
+    memcpy(bytes + 32, header->columnOffsets, sizeof(header->columnOffsets));
+}
+
+/**
+ * Feed bytes to an encode stream, growing output as needed
+ * @param used Bytes of output already written (updated)
+ */
+static BOOL SavedChartDataStreamEncode(compression_stream *stream, NSMutableData *output, NSUInteger *used,
+                                       const void *bytes, size_t length, BOOL finalize) {
+    stream->src_ptr = bytes;
+    stream->src_size = length;
+    
+    while (YES) {
+        if (output.length - *used < kContainerStreamChunk) {
+            output.length += MAX(kContainerStreamChunk, output.length / 2);
+        }
+        stream->dst_ptr = (uint8_t *)output.mutableBytes + *used;
+        stream->dst_size = output.length - *used;
+        
+        compression_status status = compression_stream_process(stream, finalize ? COMPRESSION_STREAM_FINALIZE : 0);
+        *used = output.length - stream->dst_size;
+        
+        if (status == COMPRESSION_STATUS_ERROR) return NO;
+        if (status == COMPRESSION_STATUS_END) return YES;
+        if (!finalize && stream->src_size == 0) return YES;
+    }
+}
+
+static inline uint64_t SavedChartDataBits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline double SavedChartDataDouble(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
 @implementation SavedChartData
 
 #pragma mark - Initialization
@@ -162,18 +264,11 @@
         return NO;
     }
     
-    // Find overlap point
+    // Find overlap point (binary search, new bars are chronological)
     NSDate *lastExistingDate = self.endDate;
-    NSInteger overlapIndex = -1;
-    
-    for (NSInteger i = 0; i < newBars.count; i++) {
-        if ([newBars[i].date isEqualToDate:lastExistingDate]) {
-            overlapIndex = i;
-            break;
-        }
-    }
+    NSUInteger overlapIndex = [HistoricalBarMerge indexOfBarAtDate:lastExistingDate inBars:newBars tolerance:0];
     
-    if (overlapIndex == -1) {
+    if (overlapIndex == NSNotFound) {
         NSLog(@"❌ Merge failed: No overlap found between existing data and new bars");
         return NO;
     }
@@ -183,12 +278,14 @@
         NSRange newBarsRange = NSMakeRange(overlapIndex + 1, newBars.count - overlapIndex - 1);
         NSArray<HistoricalBarModel *> *barsToAdd = [newBars subarrayWithRange:newBarsRange];
         
-        // Merge with existing data
-        NSMutableArray<HistoricalBarModel *> *mergedBars = [self.historicalBars mutableCopy];
-        [mergedBars addObjectsFromArray:barsToAdd];
+        // Merge with existing data (single pass, drops repeated bars in the new batch)
+        NSArray<HistoricalBarModel *> *mergedBars = [HistoricalBarMerge mergeBars:self.historicalBars
+                                                                         withBars:barsToAdd
+                                                                        tolerance:0
+                                                                   preferIncoming:NO];
         
         // Update properties
-        _historicalBars = [mergedBars copy];
+        _historicalBars = mergedBars;
         _endDate = _historicalBars.lastObject.date;
         _lastUpdateDate = [NSDate date];
         _lastSuccessfulUpdate = [NSDate date];
@@ -260,26 +357,11 @@
         return NO;
     }
     
-    // Combine bars from both snapshots
-    NSMutableArray<HistoricalBarModel *> *allBars = [NSMutableArray array];
-    [allBars addObjectsFromArray:self.historicalBars];
-    [allBars addObjectsFromArray:otherSnapshot.historicalBars];
-    
-    // Sort by date
-    [allBars sortUsingComparator:^NSComparisonResult(HistoricalBarModel *bar1, HistoricalBarModel *bar2) {
-        return [bar1.date compare:bar2.date];
-    }];
-    
-    // Remove duplicates (keep first occurrence)
-    NSMutableArray<HistoricalBarModel *> *uniqueBars = [NSMutableArray array];
-    NSDate *lastDate = nil;
-    
-    for (HistoricalBarModel *bar in allBars) {
-        if (!lastDate || ![bar.date isEqualToDate:lastDate]) {
-            [uniqueBars addObject:bar];
-            lastDate = bar.date;
-        }
-    }
+    // Combine bars from both snapshots, sorted by date, duplicates removed (keep this snapshot's bar)
+    NSArray<HistoricalBarModel *> *uniqueBars = [HistoricalBarMerge mergeBars:self.historicalBars
+                                                                     withBars:otherSnapshot.historicalBars
+                                                                    tolerance:0
+                                                               preferIncoming:NO];
     
     if (uniqueBars.count == 0) {
         if (error) {
@@ -292,7 +374,7 @@
     }
     
     // Update properties with merged data
-    _historicalBars = [uniqueBars copy];
+    _historicalBars = uniqueBars;
     _startDate = uniqueBars.firstObject.date;
     _endDate = uniqueBars.lastObject.date;
     _lastUpdateDate = [NSDate date];
@@ -338,22 +420,7 @@ includesExtendedHours:(BOOL)includesExtendedHours {
 #pragma mark - Serialization
 
 - (NSDictionary *)toDictionary {
-    NSMutableDictionary *dict = [NSMutableDictionary dictionary];
-    
-    dict[@"chartID"] = self.chartID;
-    dict[@"symbol"] = self.symbol;
-    dict[@"timeframe"] = @(self.timeframe);
-    dict[@"dataType"] = @(self.dataType);
-    dict[@"startDate"] = self.startDate;
-    dict[@"endDate"] = self.endDate;
-    dict[@"creationDate"] = self.creationDate;
-    dict[@"includesExtendedHours"] = @(self.includesExtendedHours);
-    dict[@"hasGaps"] = @(self.hasGaps);
-    
-    if (self.lastUpdateDate) dict[@"lastUpdateDate"] = self.lastUpdateDate;
-    if (self.lastSuccessfulUpdate) dict[@"lastSuccessfulUpdate"] = self.lastSuccessfulUpdate;
-    if (self.nextScheduledUpdate) dict[@"nextScheduledUpdate"] = self.nextScheduledUpdate;
-    if (self.notes) dict[@"notes"] = self.notes;
+    NSMutableDictionary *dict = [self metadataDictionary];
     
     // Serialize historical bars
     if (self.historicalBars) {
@@ -374,16 +441,39 @@ includesExtendedHours:(BOOL)includesExtendedHours {
     }
     
     // Add metadata
-    dict[@"barCount"] = @(self.barCount);
     dict[@"version"] = @"2.0"; // 🎯 BUMP VERSION per indicare supporto compressione
     dict[@"compressionFormat"] = @"LZFSE"; // Metadata per tracking
     
     return [dict copy];
 }
 
+/// Tutto tranne le barre (metadati del container binario e del dizionario plist)
+- (NSMutableDictionary *)metadataDictionary {
+    NSMutableDictionary *dict = [NSMutableDictionary dictionary];
+    
+    dict[@"chartID"] = self.chartID;
+    dict[@"symbol"] = self.symbol;
+    dict[@"timeframe"] = @(self.timeframe);
+    dict[@"dataType"] = @(self.dataType);
+    dict[@"startDate"] = self.startDate;
+    dict[@"endDate"] = self.endDate;
+    dict[@"creationDate"] = self.creationDate;
+    dict[@"includesExtendedHours"] = @(self.includesExtendedHours);
+    dict[@"hasGaps"] = @(self.hasGaps);
+    
+    if (self.lastUpdateDate) dict[@"lastUpdateDate"] = self.lastUpdateDate;
+    if (self.lastSuccessfulUpdate) dict[@"lastSuccessfulUpdate"] = self.lastSuccessfulUpdate;
+    if (self.nextScheduledUpdate) dict[@"nextScheduledUpdate"] = self.nextScheduledUpdate;
+    if (self.notes) dict[@"notes"] = self.notes;
+    
+    dict[@"barCount"] = @(self.barCount);
+    
+    return dict;
+}
+
 
 + (instancetype)loadFromFile:(NSString *)filePath {
-    NSData *fileData = [NSData dataWithContentsOfFile:filePath];
+    NSData *fileData = [NSData dataWithContentsOfFile:filePath options:NSDataReadingMappedIfSafe error:nil];
     if (!fileData) {
         NSLog(@"❌ Failed to load data from file: %@", filePath);
         return nil;
@@ -392,14 +482,25 @@ includesExtendedHours:(BOOL)includesExtendedHours {
     NSString *filename = [filePath lastPathComponent];
     NSLog(@"📂 Loading SavedChartData from: %@ (%.1f KB)", filename, fileData.length / 1024.0);
     
-    // 🗜️ TRY TO DECOMPRESS (LZFSE format detection)
-    NSData *plistData = [self decompressData:fileData];
-    BOOL wasCompressed = (plistData != nil);
+    // 📦 Container binario: i metadati sono in chiaro, le colonne si decodificano dopo le correzioni
+    SavedChartDataContainerHeader header;
+    BOOL isContainer = SavedChartDataReadContainerHeader(fileData, &header);
+    NSData *plistData = nil;
+    BOOL wasCompressed = NO;
     
-    if (!plistData) {
-        // Fallback: try as uncompressed data (backward compatibility)
-        NSLog(@"ℹ️ File not compressed, trying direct plist deserialization...");
-        plistData = fileData;
+    if (isContainer) {
+        plistData = [fileData subdataWithRange:NSMakeRange(kContainerHeaderSize, header.metadataLength)];
+        wasCompressed = YES;
+    } else {
+        // 🗜️ TRY TO DECOMPRESS (LZFSE format detection)
+        plistData = [self decompressData:fileData];
+        wasCompressed = (plistData != nil);
+        
+        if (!plistData) {
+            // Fallback: try as uncompressed data (backward compatibility)
+            NSLog(@"ℹ️ File not compressed, trying direct plist deserialization...");
+            plistData = fileData;
+        }
     }
     
     // Deserialize plist
@@ -503,9 +604,27 @@ includesExtendedHours:(BOOL)includesExtendedHours {
     // ✅ STEP 4: Create SavedChartData with corrected metadata
     SavedChartData *savedData = [[self alloc] initWithDictionary:[correctedDictionary copy]];
     
+    // Colonne decodificate con symbol/timeframe già corretti
+    if (savedData && isContainer) {
+        BarSeries *series = [self barSeriesFromContainerData:fileData
+                                                      header:header
+                                                      symbol:savedData.symbol
+                                                   timeframe:savedData.timeframe];
+        if (!series) {
+            NSLog(@"❌ Corrupted bar columns in %@", filename);
+            return nil;
+        }
+        savedData.historicalBars = [series bars];
+    }
+    
     if (savedData) {
         savedData.isCompressed = wasCompressed;
         
+        // 🧾 Continuous: segmenti appesi dopo l'ultima riscrittura del file
+        if (savedData.dataType == SavedChartDataTypeContinuous) {
+            [savedData replaySegmentLogForFile:filePath];
+        }
+        
         // ✅ STEP 5: Log results
         if (hadInconsistencies) {
             NSLog(@"✅ Loaded SavedChartData with CORRECTED metadata: %@ [%@] %ld bars",
@@ -516,7 +635,10 @@ includesExtendedHours:(BOOL)includesExtendedHours {
                   savedData.symbol, savedData.timeframeDescription, (long)savedData.barCount);
         }
         
-        if (wasCompressed) {
+        if (isContainer) {
+            NSLog(@"   📦 Columns: %.1f KB → %.1f KB",
+                  header.compressedSize / 1024.0, header.uncompressedSize / 1024.0);
+        } else if (wasCompressed) {
             CGFloat compressionRatio = (CGFloat)fileData.length / (CGFloat)plistData.length;
             NSLog(@"   📦 Decompressed: %.1f KB → %.1f KB (%.1fx expansion)",
                   fileData.length / 1024.0,
@@ -557,11 +679,11 @@ includesExtendedHours:(BOOL)includesExtendedHours {
 }
 
 - (NSInteger)estimatedFileSize {
-    // Base estimate: 80 bytes per bar + overhead
-    NSInteger uncompressedSize = self.barCount * 80 + 1024;
+    // Container binario: 6 colonne da 8 byte per barra + metadati
+    NSInteger uncompressedSize = self.barCount * kContainerColumnCount * sizeof(uint64_t) + 1024;
     
-    // LZFSE typically achieves 60-80% compression on financial data
-    NSInteger compressedSize = uncompressedSize * 0.3; // Assume 70% compression
+    // Le colonne delta/XOR si comprimono a circa il 40% con LZFSE
+    NSInteger compressedSize = uncompressedSize * 0.4;
     
     return compressedSize;
 }
@@ -682,36 +804,147 @@ includesExtendedHours:(BOOL)includesExtendedHours {
 
 #pragma mark - Compression Helpers
 
-- (NSData *)compressData:(NSData *)inputData error:(NSError **)error {
-    if (!inputData || inputData.length == 0) {
-        if (error) {
-            *error = [NSError errorWithDomain:@"SavedChartData"
-                                         code:1004
-                                     userInfo:@{NSLocalizedDescriptionKey: @"No data to compress"}];
++ (NSData *)decompressData:(NSData *)compressedData {
+    if (!compressedData || compressedData.length == 0) {
+        return nil;
+    }
+    
+    // Try to detect LZFSE magic bytes
+    const uint8_t *bytes = (const uint8_t *)compressedData.bytes;
+    if (compressedData.length < 4) {
+        return nil; // Too small to be LZFSE
+    }
+    
+    // Check for LZFSE magic bytes
+    BOOL isLZFSE = (bytes[0] == 'b' && bytes[1] == 'v' && bytes[2] == 'x' &&
+                    (bytes[3] == '-' || bytes[3] == '2'));
+    
+    if (!isLZFSE) {
+        return nil; // Not LZFSE compressed
+    }
+    
+    // File legacy: la dimensione decompressa non è nota, lo stream cresce l'output in un solo passaggio
+    compression_stream stream;
+    if (compression_stream_init(&stream, COMPRESSION_STREAM_DECODE, COMPRESSION_LZFSE) != COMPRESSION_STATUS_OK) {
+        return nil;
+    }
+    stream.src_ptr = bytes;
+    stream.src_size = compressedData.length;
+    
+    NSMutableData *output = [NSMutableData dataWithLength:compressedData.length * 4];
+    NSUInteger used = 0;
+    compression_status status = COMPRESSION_STATUS_OK;
+    
+    while (status == COMPRESSION_STATUS_OK) {
+        if (output.length - used < kContainerStreamChunk) {
+            output.length += MAX(kContainerStreamChunk, output.length / 2);
+        }
+        stream.dst_ptr = (uint8_t *)output.mutableBytes + used;
+        stream.dst_size = output.length - used;
+        
+        size_t sourceBefore = stream.src_size;
+        status = compression_stream_process(&stream, 0);
+        NSUInteger produced = (output.length - used) - stream.dst_size;
+        used += produced;
+        
+        // Input esaurito senza fine stream: file troncato
+        if (status == COMPRESSION_STATUS_OK && produced == 0 && stream.src_size == sourceBefore) {
+            status = COMPRESSION_STATUS_ERROR;
         }
+    }
+    compression_stream_destroy(&stream);
+    
+    if (status != COMPRESSION_STATUS_END) {
+        NSLog(@"❌ LZFSE decompression failed");
         return nil;
     }
     
-    // Calculate buffer size (Apple recommends source size + 64KB for LZFSE)
-    size_t bufferSize = inputData.length + 65536;
-    void *compressedBuffer = malloc(bufferSize);
+    output.length = used;
+    return output;
+}
+
+#pragma mark - Binary Container
+
+/// Header + metadati + colonne compresse, scritti in un solo passaggio sulle colonne
+- (NSData *)binaryContainerDataWithError:(NSError **)error {
+    NSMutableDictionary *metadata = [self metadataDictionary];
+    metadata[@"version"] = @"3.0";
+    metadata[@"compressionFormat"] = @"LZFSE-columns";
+    
+    NSData *metadataData = [NSPropertyListSerialization dataWithPropertyList:metadata
+                                                                      format:NSPropertyListBinaryFormat_v1_0
+                                                                     options:0
+                                                                       error:error];
+    if (!metadataData) return nil;
+    
+    // Zero-copy se le barre sono già colonnari, altrimenti una sola copia
+    BarSeries *series = self.historicalBars.count > 0 ? [BarSeries seriesWithBars:self.historicalBars] : nil;
+    NSInteger count = series.count;
+    
+    SavedChartDataContainerHeader header = {0};
+    header.metadataLength = (uint32_t)metadataData.length;
+    header.barCount = (uint32_t)count;
+    header.uncompressedSize = (uint64_t)count * kContainerColumnCount * sizeof(uint64_t);
+    for (NSUInteger c = 0; c < kContainerColumnCount; c++) {
+        header.columnOffsets[c] = (uint64_t)c * count * sizeof(uint64_t);
+    }
     
-    if (!compressedBuffer) {
+    const NSTimeInterval *time = series.time;
+    for (NSInteger i = 0; i < count; i++) {
+        if ((double)llround(time[i] * 1000.0) / 1000.0 != time[i]) {
+            header.flags |= kContainerFlagRawTime;
+            break;
+        }
+    }
+    
+    NSUInteger used = kContainerHeaderSize + metadataData.length;
+    NSMutableData *output = [NSMutableData dataWithLength:used + (NSUInteger)(header.uncompressedSize / 2) + kContainerStreamChunk];
+    memcpy((uint8_t *)output.mutableBytes + kContainerHeaderSize, metadataData.bytes, metadataData.length);
+    NSUInteger columnsStart = used;
+    
+    compression_stream stream;
+    if (compression_stream_init(&stream, COMPRESSION_STREAM_ENCODE, COMPRESSION_LZFSE) != COMPRESSION_STATUS_OK) {
         if (error) {
             *error = [NSError errorWithDomain:@"SavedChartData"
                                          code:1005
-                                     userInfo:@{NSLocalizedDescriptionKey: @"Failed to allocate compression buffer"}];
+                                     userInfo:@{NSLocalizedDescriptionKey: @"Failed to initialize compression stream"}];
         }
         return nil;
     }
     
-    // Perform LZFSE compression
-    size_t compressedSize = compression_encode_buffer(compressedBuffer, bufferSize,
-                                                      inputData.bytes, inputData.length,
-                                                      NULL, COMPRESSION_LZFSE);
+    // Trasformazione delta/XOR a blocchi in un buffer fisso, poi dritta nello stream
+    uint64_t words[kContainerStreamChunk / sizeof(uint64_t)];
+    const size_t wordsPerBlock = sizeof(words) / sizeof(uint64_t);
+    const double *prices[4] = { series.open, series.high, series.low, series.close };
+    BOOL rawTime = (header.flags & kContainerFlagRawTime) != 0;
+    BOOL ok = YES;
+    
+    for (NSUInteger c = 0; c < kContainerColumnCount && ok; c++) {
+        uint64_t previous = 0;
+        for (NSInteger start = 0; start < count && ok; start += wordsPerBlock) {
+            NSInteger blockLength = MIN((NSInteger)wordsPerBlock, count - start);
+            for (NSInteger k = 0; k < blockLength; k++) {
+                NSInteger i = start + k;
+                uint64_t value;
+                if (c == 0) {
+                    value = rawTime ? SavedChartDataBits(time[i]) : (uint64_t)llround(time[i] * 1000.0);
+                    words[k] = rawTime ? (value ^ previous) : (value - previous);
+                } else if (c <= 4) {
+                    value = SavedChartDataBits(prices[c - 1][i]);
+                    words[k] = value ^ previous;
+                } else {
+                    value = (uint64_t)series.volume[i];
+                    words[k] = value - previous;
+                }
+                previous = value;
+            }
+            ok = SavedChartDataStreamEncode(&stream, output, &used, words, blockLength * sizeof(uint64_t), NO);
+        }
+    }
+    ok = ok && SavedChartDataStreamEncode(&stream, output, &used, NULL, 0, YES);
+    compression_stream_destroy(&stream);
     
-    if (compressedSize == 0) {
-        free(compressedBuffer);
+    if (!ok) {
         if (error) {
             *error = [NSError errorWithDomain:@"SavedChartData"
                                          code:1006
@@ -720,105 +953,150 @@ includesExtendedHours:(BOOL)includesExtendedHours {
         return nil;
     }
     
-    // Create NSData with compressed result
-    NSData *compressedData = [NSData dataWithBytes:compressedBuffer length:compressedSize];
-    free(compressedBuffer);
-    
-    return compressedData;
+    header.compressedSize = used - columnsStart;
+    SavedChartDataWriteContainerHeader(output.mutableBytes, &header);
+    output.length = used;
+    return output;
 }
 
-+ (NSData *)decompressData:(NSData *)compressedData {
-    if (!compressedData || compressedData.length == 0) {
++ (NSDictionary *)headerMetadataFromFile:(NSString *)filePath {
+    NSFileHandle *handle = [NSFileHandle fileHandleForReadingAtPath:filePath];
+    if (!handle) return nil;
+    
+    // Header fisso, poi solo i metadati: le colonne compresse non vengono lette
+    NSData *headerData = [handle readDataUpToLength:kContainerHeaderSize error:nil];
+    if (headerData.length < kContainerHeaderSize) {
+        [handle closeFile];
         return nil;
     }
     
-    // Try to detect LZFSE magic bytes
-    const uint8_t *bytes = (const uint8_t *)compressedData.bytes;
-    if (compressedData.length < 4) {
-        return nil; // Too small to be LZFSE
+    const uint8_t *bytes = headerData.bytes;
+    uint32_t magic;
+    uint16_t version;
+    uint32_t metadataLength;
+    uint32_t barCount;
+    memcpy(&magic, bytes, 4);
+    memcpy(&version, bytes + 4, 2);
+    memcpy(&metadataLength, bytes + 8, 4);
+    memcpy(&barCount, bytes + 12, 4);
+    
+    if (magic != kContainerMagic || version != kContainerVersion || metadataLength > kContainerMaxMetadataLength) {
+        [handle closeFile];
+        return nil;
     }
     
-    // Check for LZFSE magic bytes
-    BOOL isLZFSE = (bytes[0] == 'b' && bytes[1] == 'v' && bytes[2] == 'x' &&
-                    (bytes[3] == '-' || bytes[3] == '2'));
+    NSData *metadataData = [handle readDataUpToLength:metadataLength error:nil];
+    [handle closeFile];
+    if (metadataData.length != metadataLength) return nil;
     
-    if (!isLZFSE) {
-        return nil; // Not LZFSE compressed
+    NSDictionary *metadata = [NSPropertyListSerialization propertyListWithData:metadataData
+                                                                       options:NSPropertyListImmutable
+                                                                        format:NULL
+                                                                         error:nil];
+    if (![metadata isKindOfClass:[NSDictionary class]]) return nil;
+    
+    NSMutableDictionary *result = [metadata mutableCopy];
+    result[@"barCount"] = @(barCount);
+    return [result copy];
+}
+
+/// Colonne decompresse direttamente nella BarSeries, poi delta/XOR invertiti sul posto
++ (BarSeries *)barSeriesFromContainerData:(NSData *)data
+                                   header:(SavedChartDataContainerHeader)header
+                                   symbol:(NSString *)symbol
+                                timeframe:(BarTimeframe)timeframe {
+    NSInteger count = header.barCount;
+    if (count == 0) {
+        return [BarSeries seriesWithSymbol:symbol timeframe:timeframe count:0 fillColumns:^(BarSeriesMutableColumns columns) {}];
     }
     
-    // Estimate decompressed size (start with 4x compressed size)
-    size_t estimatedSize = compressedData.length * 4;
-    size_t maxAttempts = 3;
+    __block compression_stream stream;
+    if (compression_stream_init(&stream, COMPRESSION_STREAM_DECODE, COMPRESSION_LZFSE) != COMPRESSION_STATUS_OK) {
+        return nil;
+    }
+    stream.src_ptr = (const uint8_t *)data.bytes + kContainerHeaderSize + header.metadataLength;
+    stream.src_size = (size_t)header.compressedSize;
     
-    for (size_t attempt = 0; attempt < maxAttempts; attempt++) {
-        void *decompressedBuffer = malloc(estimatedSize);
-        if (!decompressedBuffer) {
-            return nil;
-        }
-        
-        size_t decompressedSize = compression_decode_buffer(decompressedBuffer, estimatedSize,
-                                                            compressedData.bytes, compressedData.length,
-                                                            NULL, COMPRESSION_LZFSE);
+    BOOL rawTime = (header.flags & kContainerFlagRawTime) != 0;
+    __block BOOL ok = YES;
+    
+    BarSeries *series = [BarSeries seriesWithSymbol:symbol timeframe:timeframe count:count fillColumns:^(BarSeriesMutableColumns columns) {
+        void *targets[6] = { columns.time, columns.open, columns.high, columns.low, columns.close, columns.volume };
         
-        if (decompressedSize > 0) {
-            // Success!
-            NSData *decompressedData = [NSData dataWithBytes:decompressedBuffer length:decompressedSize];
-            free(decompressedBuffer);
-            return decompressedData;
+        // Le colonne sono in ordine nel flusso: ognuna riempie il proprio buffer finale
+        for (NSUInteger c = 0; c < kContainerColumnCount && ok; c++) {
+            if (header.columnOffsets[c] != (uint64_t)c * count * sizeof(uint64_t)) {
+                ok = NO;
+                break;
+            }
+            stream.dst_ptr = targets[c];
+            stream.dst_size = count * sizeof(uint64_t);
+            while (stream.dst_size > 0) {
+                size_t remaining = stream.dst_size;
+                compression_status status = compression_stream_process(&stream, 0);
+                if (status == COMPRESSION_STATUS_ERROR ||
+                    (stream.dst_size == remaining && (status == COMPRESSION_STATUS_END || stream.src_size == 0))) {
+                    ok = NO;
+                    break;
+                }
+            }
         }
+        if (!ok) return;
         
-        free(decompressedBuffer);
+        uint64_t previous = 0;
+        for (NSInteger i = 0; i < count; i++) {
+            uint64_t word = SavedChartDataBits(columns.time[i]);
+            if (rawTime) {
+                previous ^= word;
+                columns.time[i] = SavedChartDataDouble(previous);
+            } else {
+                previous += word;
+                columns.time[i] = (double)(int64_t)previous / 1000.0;
+            }
+        }
         
-        // If decompression failed, try with larger buffer
-        estimatedSize *= 2;
+        double *prices[4] = { columns.open, columns.high, columns.low, columns.close };
+        for (NSUInteger p = 0; p < 4; p++) {
+            previous = 0;
+            for (NSInteger i = 0; i < count; i++) {
+                previous ^= SavedChartDataBits(prices[p][i]);
+                prices[p][i] = SavedChartDataDouble(previous);
+            }
+        }
         
-        if (estimatedSize > 100 * 1024 * 1024) { // Cap at 100MB
-            break;
+        previous = 0;
+        for (NSInteger i = 0; i < count; i++) {
+            previous += (uint64_t)columns.volume[i];
+            columns.volume[i] = (int64_t)previous;
+            columns.adjustedClose[i] = 0.0;
         }
-    }
+    }];
+    compression_stream_destroy(&stream);
     
-    NSLog(@"❌ LZFSE decompression failed after %zu attempts", maxAttempts);
-    return nil;
+    return ok ? series : nil;
 }
 
 
 - (BOOL)saveToFile:(NSString *)filePath error:(NSError **)error {
-    NSDictionary *dictionary = [self toDictionary];
-    
-    // Serialize to binary plist
-    NSData *plistData = [NSPropertyListSerialization dataWithPropertyList:dictionary
-                                                                   format:NSPropertyListBinaryFormat_v1_0
-                                                                  options:0
-                                                                    error:error];
-    if (!plistData) {
-        NSLog(@"❌ Failed to serialize SavedChartData to binary plist: %@", error ? (*error).localizedDescription : @"Unknown error");
-        return NO;
-    }
-    
-    // 🗜️ COMPRESS WITH LZFSE
-    NSData *compressedData = [self compressData:plistData error:error];
-    if (!compressedData) {
-        NSLog(@"❌ Failed to compress SavedChartData: %@", error ? (*error).localizedDescription : @"Compression failed");
+    NSData *containerData = [self binaryContainerDataWithError:error];
+    if (!containerData) {
+        NSLog(@"❌ Failed to encode SavedChartData: %@", error ? (*error).localizedDescription : @"Unknown error");
         return NO;
     }
     
-    // Write compressed data to file
-    BOOL success = [compressedData writeToFile:filePath atomically:YES];
+    BOOL success = [containerData writeToFile:filePath atomically:YES];
     
     if (success) {
-        CGFloat compressionRatio = (CGFloat)compressedData.length / (CGFloat)plistData.length;
-        NSLog(@"✅ SavedChartData saved with LZFSE compression: %@", filePath);
+        NSLog(@"✅ SavedChartData saved: %@", filePath);
         NSLog(@"   Symbol: %@, Type: %@, Bars: %ld",
               self.symbol,
               self.dataType == SavedChartDataTypeSnapshot ? @"SNAPSHOT" : @"CONTINUOUS",
               (long)self.barCount);
-        NSLog(@"   📦 Size: %.1f KB → %.1f KB (%.1f%% compression, %.1fx smaller)",
-              plistData.length / 1024.0,
-              compressedData.length / 1024.0,
-              (1.0 - compressionRatio) * 100.0,
-              1.0 / compressionRatio);
+        NSLog(@"   📦 Size: %.1f KB (%.1f bytes/bar)",
+              containerData.length / 1024.0,
+              self.barCount > 0 ? (double)containerData.length / self.barCount : 0.0);
     } else {
-        NSLog(@"❌ Failed to write compressed SavedChartData to file: %@", filePath);
+        NSLog(@"❌ Failed to write SavedChartData to file: %@", filePath);
         if (error && !*error) {
             *error = [NSError errorWithDomain:@"SavedChartData"
                                          code:1003
@@ -0,0 +1,81 @@
+//
+//  SharedBarCache.h
+//  TradingApp
+//
+//  Process-wide cache of historical bars with a byte budget.
+//  Entries are keyed by (symbol, timeframe, range) and evicted least
+//  recently used first once the budget is exceeded. ScoreTable, the Stooq
+//  loader and DataHub all store their bars here instead of private dictionaries.
+//
+
+#import <Foundation/Foundation.h>
+#import "CommonTypes.h"
+#import "RuntimeModels.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Range of the most recent bars, length decided by the producer (validated by the consumer)
+extern NSString *const SharedBarCacheRangeLatest;
+
+@interface SharedBarCache : NSObject
+
++ (instancetype)sharedCache;
+
+#pragma mark - Configuration
+
+/**
+ * Maximum estimated bytes held (default 512 MB, "SharedBarCacheBudgetMB" in user defaults)
+ * Lowering it evicts immediately. Under system memory pressure the cache is halved.
+ */
+@property (atomic, assign) NSUInteger byteBudget;
+
+#pragma mark - Access
+
+/**
+ * Cached bars, or nil (counts a hit or a miss)
+ * @param range Opaque description of the bars covered, e.g. @"count:500:regular"
+ */
+- (nullable NSArray<HistoricalBarModel *> *)barsForSymbol:(NSString *)symbol
+                                                timeframe:(BarTimeframe)timeframe
+                                                    range:(NSString *)range;
+
+/**
+ * Store bars (replaces the entry with the same key)
+ * @discussion
+ * Cost is the column storage of a BarSeries bridge plus the bars it has
+ * materialized, or an estimate per HistoricalBarModel. A bridge is re-charged
+ * on every hit (and under memory pressure), so bars materialized after insertion
+ * count against the budget. The same array stored under several keys is charged once.
+ * Arrays larger than the whole budget are not cached.
+ */
+- (void)setBars:(NSArray<HistoricalBarModel *> *)bars
+      forSymbol:(NSString *)symbol
+      timeframe:(BarTimeframe)timeframe
+          range:(NSString *)range;
+
+- (void)removeBarsForSymbol:(NSString *)symbol timeframe:(BarTimeframe)timeframe range:(NSString *)range;
+
+/// Every timeframe and range of a symbol
+- (void)removeBarsForSymbol:(NSString *)symbol;
+
+/// Every entry whose range starts with prefix (e.g. all the entries of one producer)
+- (void)removeBarsWithRangePrefix:(NSString *)prefix;
+
+- (void)removeAllBars;
+
+#pragma mark - Statistics
+
+@property (atomic, readonly) NSUInteger hitCount;
+@property (atomic, readonly) NSUInteger missCount;
+@property (atomic, readonly) NSUInteger evictionCount;
+@property (atomic, readonly) NSUInteger currentBytes;
+@property (atomic, readonly) NSUInteger entryCount;
+
+/// Snapshot of the counters above plus byteBudget and hit rate
+- (NSDictionary<NSString *, NSNumber *> *)statistics;
+
+- (void)resetStatistics;
+
+@end
+
+NS_ASSUME_NONNULL_END
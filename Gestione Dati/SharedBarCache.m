@@ -0,0 +1,393 @@
+//
+//  SharedBarCache.m
+//  TradingApp
+//
+
+#import "SharedBarCache.h"
+#import "BarSeries.h"
+
+NSString *const SharedBarCacheRangeLatest = @"latest";
+
+static NSString *const kSharedBarCacheBudgetDefaultsKey = @"SharedBarCacheBudgetMB";
+static const NSUInteger kSharedBarCacheDefaultBudgetMB = 512;
+
+/// Stima per HistoricalBarModel materializzato (oggetto + NSDate + stringhe condivise)
+static const NSUInteger kSharedBarCacheBytesPerModel = 160;
+
+#pragma mark - Entry
+
+/// Nodo della lista LRU (head = più recente)
+@interface SharedBarCacheEntry : NSObject
+@property (nonatomic, copy) NSString *key;
+@property (nonatomic, copy) NSString *symbol;
+@property (nonatomic, copy) NSString *range;
+@property (nonatomic, strong) NSArray<HistoricalBarModel *> *bars;
+@property (nonatomic, strong, nullable) SharedBarCacheEntry *next;
+@property (nonatomic, weak, nullable) SharedBarCacheEntry *previous;
+@end
+
+@implementation SharedBarCacheEntry
+@end
+
+#pragma mark - Cache
+
+@implementation SharedBarCache {
+    NSMutableDictionary<NSString *, SharedBarCacheEntry *> *_entries;
+    NSMutableDictionary<NSString *, NSMutableSet<NSString *> *> *_keysBySymbol;
+    NSMapTable<NSArray *, NSNumber *> *_arrayReferences;    // Array (identità) → numero di entry che lo usano
+    NSMapTable<NSArray *, NSNumber *> *_arrayCosts;         // Array (identità) → byte addebitati in _currentBytes
+    SharedBarCacheEntry *_head;
+    SharedBarCacheEntry *_tail;
+    NSUInteger _byteBudget;
+    NSUInteger _currentBytes;
+    NSUInteger _hitCount;
+    NSUInteger _missCount;
+    NSUInteger _evictionCount;
+    dispatch_source_t _memoryPressureSource;
+}
+
++ (instancetype)sharedCache {
+    static SharedBarCache *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[self alloc] init];
+    });
+    return sharedInstance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _entries = [NSMutableDictionary dictionary];
+        _keysBySymbol = [NSMutableDictionary dictionary];
+        _arrayReferences = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsObjectPointerPersonality | NSPointerFunctionsStrongMemory
+                                                 valueOptions:NSPointerFunctionsStrongMemory];
+        _arrayCosts = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsObjectPointerPersonality | NSPointerFunctionsStrongMemory
+                                            valueOptions:NSPointerFunctionsStrongMemory];
+
+        NSInteger budgetMB = [[NSUserDefaults standardUserDefaults] integerForKey:kSharedBarCacheBudgetDefaultsKey];
+        _byteBudget = (budgetMB > 0 ? (NSUInteger)budgetMB : kSharedBarCacheDefaultBudgetMB) * 1024 * 1024;
+
+        [self observeMemoryPressure];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_memoryPressureSource) {
+        dispatch_source_cancel(_memoryPressureSource);
+    }
+}
+
+- (void)observeMemoryPressure {
+    _memoryPressureSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_MEMORYPRESSURE, 0,
+                                                   DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL,
+                                                   dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+    __weak typeof(self) weakSelf = self;
+    dispatch_source_set_event_handler(_memoryPressureSource, ^{
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (!strongSelf) return;
+
+        @synchronized (strongSelf) {
+            [strongSelf rechargeAllArrays];
+            NSUInteger before = strongSelf->_currentBytes;
+            [strongSelf evictToBytes:before / 2];
+            NSLog(@"⚠️ SharedBarCache: memory pressure, trimmed %.1f MB → %.1f MB",
+                  before / (1024.0 * 1024.0), strongSelf->_currentBytes / (1024.0 * 1024.0));
+        }
+    });
+    dispatch_resume(_memoryPressureSource);
+}
+
+#pragma mark - Configuration
+
+- (NSUInteger)byteBudget {
+    @synchronized (self) {
+        return _byteBudget;
+    }
+}
+
+- (void)setByteBudget:(NSUInteger)byteBudget {
+    @synchronized (self) {
+        _byteBudget = byteBudget;
+        [self evictToBytes:byteBudget];
+    }
+}
+
+#pragma mark - Keys & Cost
+
++ (NSString *)keyForSymbol:(NSString *)symbol timeframe:(BarTimeframe)timeframe range:(NSString *)range {
+    return [NSString stringWithFormat:@"%@|%ld|%@", symbol, (long)timeframe, range];
+}
+
++ (NSUInteger)costOfBars:(NSArray<HistoricalBarModel *> *)bars {
+    BarSeries *series = [BarSeries backingSeriesOfBars:bars];
+    if (series) {
+        // Colonne + i modelli che il bridge ha già materializzato (e trattiene)
+        return series.byteSize + [BarSeries materializedBarCountOfBars:bars] * kSharedBarCacheBytesPerModel;
+    }
+    return bars.count * kSharedBarCacheBytesPerModel;
+}
+
+#pragma mark - LRU List (caller holds the lock)
+
+- (void)unlinkEntry:(SharedBarCacheEntry *)entry {
+    SharedBarCacheEntry *previous = entry.previous;
+    SharedBarCacheEntry *next = entry.next;
+
+    if (previous) {
+        previous.next = next;
+    } else {
+        _head = next;
+    }
+    if (next) {
+        next.previous = previous;
+    } else {
+        _tail = previous;
+    }
+    entry.next = nil;
+    entry.previous = nil;
+}
+
+- (void)linkEntryAtHead:(SharedBarCacheEntry *)entry {
+    entry.next = _head;
+    entry.previous = nil;
+    _head.previous = entry;
+    _head = entry;
+    if (!_tail) {
+        _tail = entry;
+    }
+}
+
+/// Add a reference to bars; the cost is charged only for the first one
+- (void)retainArray:(NSArray *)bars {
+    NSUInteger references = [[_arrayReferences objectForKey:bars] unsignedIntegerValue];
+    if (references == 0) {
+        NSUInteger cost = [SharedBarCache costOfBars:bars];
+        [_arrayCosts setObject:@(cost) forKey:bars];
+        _currentBytes += cost;
+    }
+    [_arrayReferences setObject:@(references + 1) forKey:bars];
+}
+
+- (void)releaseArray:(NSArray *)bars {
+    NSUInteger references = [[_arrayReferences objectForKey:bars] unsignedIntegerValue];
+    if (references <= 1) {
+        // Si scala quanto era stato addebitato, non il costo attuale
+        NSUInteger cost = [[_arrayCosts objectForKey:bars] unsignedIntegerValue];
+        [_arrayReferences removeObjectForKey:bars];
+        [_arrayCosts removeObjectForKey:bars];
+        _currentBytes = _currentBytes > cost ? _currentBytes - cost : 0;
+    } else {
+        [_arrayReferences setObject:@(references - 1) forKey:bars];
+    }
+}
+
+/**
+ * Update the charge of a cached array to its current cost
+ * A BarSeries bridge grows as bars are materialized after insertion.
+ */
+- (void)rechargeArray:(NSArray *)bars {
+    NSNumber *charged = [_arrayCosts objectForKey:bars];
+    if (!charged || ![BarSeries backingSeriesOfBars:bars]) return;
+
+    NSUInteger cost = [SharedBarCache costOfBars:bars];
+    NSUInteger previous = charged.unsignedIntegerValue;
+    if (cost == previous) return;
+
+    _currentBytes = _currentBytes + cost > previous ? _currentBytes + cost - previous : 0;
+    [_arrayCosts setObject:@(cost) forKey:bars];
+}
+
+- (void)rechargeAllArrays {
+    for (NSArray *bars in [[_arrayCosts keyEnumerator] allObjects]) {
+        [self rechargeArray:bars];
+    }
+}
+
+- (void)removeEntry:(SharedBarCacheEntry *)entry {
+    [self unlinkEntry:entry];
+    [_entries removeObjectForKey:entry.key];
+
+    NSMutableSet<NSString *> *keys = _keysBySymbol[entry.symbol];
+    [keys removeObject:entry.key];
+    if (keys.count == 0) {
+        [_keysBySymbol removeObjectForKey:entry.symbol];
+    }
+
+    [self releaseArray:entry.bars];
+}
+
+- (void)evictToBytes:(NSUInteger)limit {
+    while (_currentBytes > limit && _tail) {
+        [self removeEntry:_tail];
+        _evictionCount++;
+    }
+}
+
+#pragma mark - Access
+
+- (NSArray<HistoricalBarModel *> *)barsForSymbol:(NSString *)symbol
+                                       timeframe:(BarTimeframe)timeframe
+                                           range:(NSString *)range {
+    if (!symbol || !range) return nil;
+
+    NSString *key = [SharedBarCache keyForSymbol:symbol timeframe:timeframe range:range];
+    @synchronized (self) {
+        SharedBarCacheEntry *entry = _entries[key];
+        if (!entry) {
+            _missCount++;
+            return nil;
+        }
+
+        _hitCount++;
+        if (entry != _head) {
+            [self unlinkEntry:entry];
+            [self linkEntryAtHead:entry];
+        }
+
+        // Le barre materializzate dagli accessi precedenti entrano ora nel budget
+        NSArray<HistoricalBarModel *> *bars = entry.bars;
+        NSUInteger before = _currentBytes;
+        [self rechargeArray:bars];
+        if (_currentBytes > before) {
+            [self evictToBytes:_byteBudget];
+        }
+        return bars;
+    }
+}
+
+- (void)setBars:(NSArray<HistoricalBarModel *> *)bars
+      forSymbol:(NSString *)symbol
+      timeframe:(BarTimeframe)timeframe
+          range:(NSString *)range {
+    if (!bars || !symbol || !range) return;
+
+    NSString *key = [SharedBarCache keyForSymbol:symbol timeframe:timeframe range:range];
+    NSUInteger cost = [SharedBarCache costOfBars:bars];
+
+    @synchronized (self) {
+        SharedBarCacheEntry *existing = _entries[key];
+        if (existing) {
+            [self removeEntry:existing];
+        }
+
+        if (cost > _byteBudget) {
+            return;
+        }
+
+        SharedBarCacheEntry *entry = [[SharedBarCacheEntry alloc] init];
+        entry.key = key;
+        entry.symbol = symbol;
+        entry.range = range;
+        entry.bars = bars;
+
+        _entries[key] = entry;
+        NSMutableSet<NSString *> *keys = _keysBySymbol[symbol];
+        if (!keys) {
+            keys = [NSMutableSet set];
+            _keysBySymbol[symbol] = keys;
+        }
+        [keys addObject:key];
+
+        [self linkEntryAtHead:entry];
+        [self retainArray:bars];
+        [self evictToBytes:_byteBudget];
+    }
+}
+
+#pragma mark - Removal
+
+- (void)removeBarsForSymbol:(NSString *)symbol timeframe:(BarTimeframe)timeframe range:(NSString *)range {
+    if (!symbol || !range) return;
+
+    NSString *key = [SharedBarCache keyForSymbol:symbol timeframe:timeframe range:range];
+    @synchronized (self) {
+        SharedBarCacheEntry *entry = _entries[key];
+        if (entry) {
+            [self removeEntry:entry];
+        }
+    }
+}
+
+- (void)removeBarsForSymbol:(NSString *)symbol {
+    if (!symbol) return;
+
+    @synchronized (self) {
+        for (NSString *key in [_keysBySymbol[symbol] allObjects]) {
+            [self removeEntry:_entries[key]];
+        }
+    }
+}
+
+- (void)removeBarsWithRangePrefix:(NSString *)prefix {
+    @synchronized (self) {
+        for (SharedBarCacheEntry *entry in _entries.allValues) {
+            if ([entry.range hasPrefix:prefix]) {
+                [self removeEntry:entry];
+            }
+        }
+    }
+}
+
+- (void)removeAllBars {
+    @synchronized (self) {
+        // La lista va spezzata nodo per nodo: una catena di next strong lunga
+        // migliaia di entry verrebbe altrimenti rilasciata per ricorsione
+        while (_tail) {
+            [self unlinkEntry:_tail];
+        }
+        [_entries removeAllObjects];
+        [_keysBySymbol removeAllObjects];
+        [_arrayReferences removeAllObjects];
+        [_arrayCosts removeAllObjects];
+        _currentBytes = 0;
+    }
+}
+
+#pragma mark - Statistics
+
+- (NSUInteger)hitCount {
+    @synchronized (self) { return _hitCount; }
+}
+
+- (NSUInteger)missCount {
+    @synchronized (self) { return _missCount; }
+}
+
+- (NSUInteger)evictionCount {
+    @synchronized (self) { return _evictionCount; }
+}
+
+- (NSUInteger)currentBytes {
+    @synchronized (self) { return _currentBytes; }
+}
+
+- (NSUInteger)entryCount {
+    @synchronized (self) { return _entries.count; }
+}
+
+- (NSDictionary<NSString *, NSNumber *> *)statistics {
+    @synchronized (self) {
+        NSUInteger lookups = _hitCount + _missCount;
+        return @{
+            @"hits": @(_hitCount),
+            @"misses": @(_missCount),
+            @"evictions": @(_evictionCount),
+            @"hitRate": @(lookups > 0 ? (double)_hitCount / lookups : 0.0),
+            @"entries": @(_entries.count),
+            @"currentBytes": @(_currentBytes),
+            @"byteBudget": @(_byteBudget)
+        };
+    }
+}
+
+- (void)resetStatistics {
+    @synchronized (self) {
+        _hitCount = 0;
+        _missCount = 0;
+        _evictionCount = 0;
+    }
+}
+
+@end
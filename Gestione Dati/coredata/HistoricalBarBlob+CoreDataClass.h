@@ -0,0 +1,20 @@
+//
+//  HistoricalBarBlob+CoreDataClass.h
+//  mafia_AI
+//
+//  Whole (symbol, timeframe) history as one encoded attribute
+//  (see HistoricalBarBlobCodec), used by DataHub's blob storage mode
+//
+
+#import <Foundation/Foundation.h>
+#import <CoreData/CoreData.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface HistoricalBarBlob : NSManagedObject
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#import "HistoricalBarBlob+CoreDataProperties.h"
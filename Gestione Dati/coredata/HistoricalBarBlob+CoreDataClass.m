@@ -0,0 +1,10 @@
+//
+//  HistoricalBarBlob+CoreDataClass.m
+//  mafia_AI
+//
+
+#import "HistoricalBarBlob+CoreDataClass.h"
+
+@implementation HistoricalBarBlob
+
+@end
@@ -0,0 +1,26 @@
+//
+//  HistoricalBarBlob+CoreDataProperties.h
+//  mafia_AI
+//
+
+#import "HistoricalBarBlob+CoreDataClass.h"
+
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface HistoricalBarBlob (CoreDataProperties)
+
++ (NSFetchRequest<HistoricalBarBlob *> *)fetchRequest NS_SWIFT_NAME(fetchRequest());
+
+@property (nonatomic) int32_t barCount;
+@property (nullable, nonatomic, retain) NSData *encodedBars;
+@property (nullable, nonatomic, copy) NSDate *firstDate;
+@property (nonatomic) int16_t formatVersion;
+@property (nullable, nonatomic, copy) NSDate *lastDate;
+@property (nullable, nonatomic, copy) NSDate *lastUpdate;
+@property (nullable, nonatomic, copy) NSString *symbolName;
+@property (nonatomic) int16_t timeframe;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,23 @@
+//
+//  HistoricalBarBlob+CoreDataProperties.m
+//  mafia_AI
+//
+
+#import "HistoricalBarBlob+CoreDataProperties.h"
+
+@implementation HistoricalBarBlob (CoreDataProperties)
+
++ (NSFetchRequest<HistoricalBarBlob *> *)fetchRequest {
+	return [NSFetchRequest fetchRequestWithEntityName:@"HistoricalBarBlob"];
+}
+
+@dynamic barCount;
+@dynamic encodedBars;
+@dynamic firstDate;
+@dynamic formatVersion;
+@dynamic lastDate;
+@dynamic lastUpdate;
+@dynamic symbolName;
+@dynamic timeframe;
+
+@end
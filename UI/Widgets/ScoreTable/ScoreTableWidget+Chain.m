@@ -8,6 +8,7 @@
 #import "ScoreTableWidget.h"
 #import "ChainDataValidator.h"
 #import "DataRequirementCalculator.h"
+#import "SharedBarCache.h"
 
 @implementation ScoreTableWidget (Chain)
 
@@ -50,7 +51,11 @@
         
         if (isValid) {
             validData[symbol] = bars;
-            self.symbolDataCache[symbol] = bars;  // Cache it
+            // Cache it
+            [[SharedBarCache sharedCache] setBars:bars
+                                        forSymbol:symbol
+                                        timeframe:requirements.timeframe
+                                            range:SharedBarCacheRangeLatest];
             NSLog(@"✅ %@ - Valid from chain (%lu bars)", symbol, (unsigned long)bars.count);
         } else {
             [needsMoreData addObject:symbol];
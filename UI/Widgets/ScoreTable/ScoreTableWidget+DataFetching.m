@@ -13,6 +13,7 @@
 #import "DataRequirementCalculator.h"
 #import "ChainDataValidator.h"
 #import "ScoreTableWidget_Private.h"
+#import "SharedBarCache.h"
 
 @implementation ScoreTableWidget (DataFetching)
 
@@ -113,7 +114,9 @@
         NSLog(@"🔍 PHASE 1: Checking cache for %lu symbols...", (unsigned long)symbols.count);
         
         for (NSString *symbol in symbols) {
-            NSArray<HistoricalBarModel *> *cachedData = self.symbolDataCache[symbol];
+            NSArray<HistoricalBarModel *> *cachedData = [[SharedBarCache sharedCache] barsForSymbol:symbol
+                                                                                           timeframe:requirements.timeframe
+                                                                                               range:SharedBarCacheRangeLatest];
             
             if (cachedData && [self isDataValid:cachedData forRequirements:requirements]) {
                 NSLog(@"✅ Cache hit: %@", symbol);
@@ -141,6 +144,11 @@
             // ✅ FIX: Use requirements.minimumBars instead of requirements.timeframe
             [self.stooqManager loadDataForSymbols:missingSymbols
                                           minBars:requirements.minimumBars
+                                         progress:^(NSInteger completedSymbols, NSInteger totalSymbols) {
+                self.progressBar.doubleValue = (double)completedSymbols / (double)totalSymbols * 100.0;
+                self.statusLabel.stringValue = [NSString stringWithFormat:@"Loading data... %ld/%ld",
+                                                (long)completedSymbols, (long)totalSymbols];
+            }
                                        completion:^(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *stooqData, NSError *stooqError) {
                 
                 if (self.isCancelled) {
@@ -162,7 +170,10 @@
                     
                     // Cache Stooq results
                     for (NSString *symbol in stooqData.allKeys) {
-                        self.symbolDataCache[symbol] = stooqData[symbol];
+                        [[SharedBarCache sharedCache] setBars:stooqData[symbol]
+                                                    forSymbol:symbol
+                                                    timeframe:requirements.timeframe
+                                                        range:SharedBarCacheRangeLatest];
                     }
                     
                     NSLog(@"✅ Stooq: Got data for %lu/%lu symbols",
@@ -205,7 +216,10 @@
                                 NSLog(@"✅ DataHub: Got valid data for %@ (fallback)", symbol);
                                 @synchronized (resultData) {
                                     resultData[symbol] = bars;
-                                    self.symbolDataCache[symbol] = bars;
+                                    [[SharedBarCache sharedCache] setBars:bars
+                                                                forSymbol:symbol
+                                                                timeframe:requirements.timeframe
+                                                                    range:SharedBarCacheRangeLatest];
                                 }
                             } else {
                                 NSLog(@"❌ DataHub: No valid data for %@", symbol);
@@ -271,7 +285,10 @@
                         NSLog(@"✅ DataHub: Got valid data for %@", symbol);
                         @synchronized (resultData) {
                             resultData[symbol] = bars;
-                            self.symbolDataCache[symbol] = bars;
+                            [[SharedBarCache sharedCache] setBars:bars
+                                                        forSymbol:symbol
+                                                        timeframe:requirements.timeframe
+                                                            range:SharedBarCacheRangeLatest];
                         }
                     }
                     
@@ -390,8 +407,10 @@
         return;
     }
     
-    // Clear cache to force refresh
-    [self.symbolDataCache removeAllObjects];
+    // Clear cache to force refresh (every range: Stooq and DataHub entries are reloaded too)
+    for (NSString *symbol in self.currentSymbols) {
+        [[SharedBarCache sharedCache] removeBarsForSymbol:symbol];
+    }
     
     [self loadSymbolsAndCalculateScores:self.currentSymbols];
 }
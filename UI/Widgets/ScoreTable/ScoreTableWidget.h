@@ -38,7 +38,6 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, strong) NSMutableArray<ScoreResult *> *scoreResults;
 @property (nonatomic, strong) ScoringStrategy *currentStrategy;
-@property (nonatomic, strong) NSMutableDictionary<NSString *, NSArray<HistoricalBarModel *> *> *symbolDataCache;
 
 #pragma mark - External Managers
 
@@ -24,7 +24,6 @@
     if (self) {
         self.scoreResults = [NSMutableArray array];
         self.currentSymbols = [NSMutableArray array];
-        self.symbolDataCache = [NSMutableDictionary dictionary];
         self.isCalculating = NO;
         
         [self initializeStooqDataManager];
@@ -422,6 +421,7 @@
 - (IBAction)cancelCalculation:(id)sender {
     NSLog(@"❌ User cancelled calculation");
     self.isCancelled = YES;
+    [self.stooqManager cancelLoading];
     
     [self hideLoadingUI];
     self.statusLabel.stringValue = @"Cancelled";
@@ -4,6 +4,7 @@
 //
 
 #import "UNRIndicator.h"
+#import "IndicatorCalculationEngine.h"
 
 @implementation UNRIndicator
 
@@ -27,12 +28,9 @@
     }
     
     // Calculate MA values for all bars
-    NSArray<NSNumber *> *maValues = [self calculateMA:maType period:maPeriod forBars:bars];
-    
-    if (!maValues || maValues.count < bars.count) {
-        NSLog(@"⚠️ UNR: MA calculation failed for %@", symbol);
-        return 0.0;
-    }
+    NSMutableData *maData = [NSMutableData dataWithLength:bars.count * sizeof(double)];
+    double *maValues = maData.mutableBytes;
+    [self calculateMA:maType period:maPeriod forBars:bars output:maValues];
     
     // Search for UNR patterns in last N days
     NSInteger searchStart = bars.count - lookbackDays;
@@ -41,7 +39,7 @@
     
     for (NSInteger i = searchStart; i < bars.count; i++) {
         HistoricalBarModel *bar = bars[i];
-        CGFloat maValue = [maValues[i] doubleValue];
+        CGFloat maValue = maValues[i];
         
         // Check same-bar UNR (low <= MA AND close >= MA)
         if (bar.low <= maValue && bar.close >= maValue) {
@@ -63,7 +61,7 @@
         // Check next-bar UNR (low <= MA today, close >= MA tomorrow)
         if (i < bars.count - 1) {
             HistoricalBarModel *nextBar = bars[i + 1];
-            CGFloat nextMAValue = [maValues[i + 1] doubleValue];
+            CGFloat nextMAValue = maValues[i + 1];
             
             if (bar.low <= maValue && nextBar.close >= nextMAValue) {
                 NSInteger barsFromPresent = bars.count - 1 - i;
@@ -94,70 +92,63 @@
 
 #pragma mark - MA Calculation
 
-- (NSArray<NSNumber *> *)calculateMA:(NSString *)type
-                              period:(NSInteger)period
-                             forBars:(NSArray<HistoricalBarModel *> *)bars {
+/// MA of closes into a buffer of bars.count doubles (0.0 until enough bars)
+- (void)calculateMA:(NSString *)type
+             period:(NSInteger)period
+            forBars:(NSArray<HistoricalBarModel *> *)bars
+             output:(double *)output {
+    
+    NSInteger count = bars.count;
+    NSMutableData *closeData = [NSMutableData dataWithLength:count * sizeof(double)];
+    double *closes = closeData.mutableBytes;
+    [IndicatorCalculationEngine extractPriceSeries:bars priceType:@"close" output:closes];
     
     if ([type isEqualToString:@"EMA"]) {
-        return [self calculateEMA:period forBars:bars];
+        [self calculateEMA:period closes:closes count:count output:output];
     } else {
-        return [self calculateSMA:period forBars:bars];
+        [self calculateSMA:period closes:closes count:count output:output];
     }
 }
 
-- (NSArray<NSNumber *> *)calculateSMA:(NSInteger)period
-                              forBars:(NSArray<HistoricalBarModel *> *)bars {
+- (void)calculateSMA:(NSInteger)period
+              closes:(const double *)closes
+               count:(NSInteger)count
+              output:(double *)output {
     
-    NSMutableArray<NSNumber *> *smaValues = [NSMutableArray array];
+    [IndicatorCalculationEngine smaSeries:closes count:count period:period output:output];
     
-    for (NSInteger i = 0; i < bars.count; i++) {
-        if (i < period - 1) {
-            // Not enough data yet
-            [smaValues addObject:@(0.0)];
-            continue;
-        }
-        
-        // Calculate SMA
-        CGFloat sum = 0.0;
-        for (NSInteger j = i - period + 1; j <= i; j++) {
-            sum += bars[j].close;
-        }
-        CGFloat sma = sum / period;
-        [smaValues addObject:@(sma)];
+    // Not enough data yet
+    for (NSInteger i = 0; i < period - 1 && i < count; i++) {
+        output[i] = 0.0;
     }
-    
-    return [smaValues copy];
 }
 
-- (NSArray<NSNumber *> *)calculateEMA:(NSInteger)period
-                              forBars:(NSArray<HistoricalBarModel *> *)bars {
+- (void)calculateEMA:(NSInteger)period
+              closes:(const double *)closes
+               count:(NSInteger)count
+              output:(double *)output {
     
-    NSMutableArray<NSNumber *> *emaValues = [NSMutableArray array];
-    CGFloat multiplier = 2.0 / (period + 1.0);
+    double multiplier = 2.0 / (period + 1.0);
     
     // First EMA = SMA of first period bars
-    CGFloat sum = 0.0;
-    for (NSInteger i = 0; i < period; i++) {
-        if (i < bars.count) {
-            sum += bars[i].close;
-            [emaValues addObject:@(0.0)]; // Placeholder
-        }
+    double sum = 0.0;
+    for (NSInteger i = 0; i < period && i < count; i++) {
+        sum += closes[i];
+        output[i] = 0.0; // Placeholder
     }
     
-    if (bars.count < period) {
-        return [emaValues copy];
+    if (count < period) {
+        return;
     }
     
-    CGFloat ema = sum / period;
-    emaValues[period - 1] = @(ema);
+    double ema = sum / period;
+    output[period - 1] = ema;
     
     // Calculate subsequent EMAs
-    for (NSInteger i = period; i < bars.count; i++) {
-        ema = (bars[i].close - ema) * multiplier + ema;
-        [emaValues addObject:@(ema)];
+    for (NSInteger i = period; i < count; i++) {
+        ema = (closes[i] - ema) * multiplier + ema;
+        output[i] = ema;
     }
-    
-    return [emaValues copy];
 }
 
 #pragma mark - Protocol Implementation
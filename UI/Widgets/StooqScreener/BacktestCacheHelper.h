@@ -8,6 +8,7 @@
 
 #import <Foundation/Foundation.h>
 #import "RuntimeModels.h"
+#import "BarSeries.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -31,8 +32,11 @@ NS_ASSUME_NONNULL_BEGIN
  * This allows screeners to run as if they were executing on that specific
  * date, with no knowledge of future data.
  *
- * Performance: O(n) where n = number of bars per symbol (typically < 300)
- * Memory: Creates new arrays, but shares underlying HistoricalBarModel objects
+ * Performance: O(log n) per symbol (binary search on bar dates)
+ * Memory: Returns a BacktestCacheView, no bar arrays are copied
+ *
+ * For day-by-day loops build a BacktestCacheIndex once and use
+ * -viewAtDate:advancingFrom: instead (see BacktestCacheView.h).
  */
 + (NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)sliceCache:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)masterCache
                                                                  upToDate:(NSDate *)referenceDate;
@@ -49,6 +53,26 @@ NS_ASSUME_NONNULL_BEGIN
                                                                   fromDate:(NSDate *)startDate
                                                                     toDate:(NSDate *)endDate;
 
+#pragma mark - Columnar Conversion
+
+/**
+ * Convert a bar cache to columnar series
+ * Arrays already backed by a BarSeries are unwrapped without copying.
+ *
+ * @param cache symbol → array of HistoricalBarModel
+ * @return symbol → BarSeries
+ */
++ (NSDictionary<NSString *, BarSeries *> *)seriesCacheFromCache:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cache;
+
+/**
+ * Bridge a series cache back to the NSArray API expected by screeners
+ * The returned arrays are zero-copy views (bars are materialized on access).
+ *
+ * @param seriesCache symbol → BarSeries
+ * @return symbol → array of HistoricalBarModel
+ */
++ (NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)barCacheFromSeriesCache:(NSDictionary<NSString *, BarSeries *> *)seriesCache;
+
 #pragma mark - Cache Statistics
 
 /**
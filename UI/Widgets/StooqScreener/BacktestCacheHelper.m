@@ -6,6 +6,7 @@
 //
 
 #import "BacktestCacheHelper.h"
+#import "BacktestCacheView.h"
 
 @implementation BacktestCacheHelper
 
@@ -23,40 +24,8 @@
         return @{};
     }
     
-    NSMutableDictionary<NSString *, NSArray<HistoricalBarModel *> *> *slicedCache =
-        [NSMutableDictionary dictionaryWithCapacity:masterCache.count];
-    
-    for (NSString *symbol in masterCache) {
-        @autoreleasepool {
-            NSArray<HistoricalBarModel *> *allBars = masterCache[symbol];
-            
-            if (!allBars || allBars.count == 0) {
-                continue;
-            }
-            
-            // Find last valid index (binary search would be faster, but array is small)
-            NSInteger lastValidIndex = -1;
-            for (NSInteger i = 0; i < allBars.count; i++) {
-                HistoricalBarModel *bar = allBars[i];
-                
-                if ([bar.date compare:referenceDate] == NSOrderedDescending) {
-                    // This bar is AFTER reference date - stop here
-                    break;
-                }
-                
-                lastValidIndex = i;
-            }
-            
-            // If we found at least one valid bar, add to sliced cache
-            if (lastValidIndex >= 0) {
-                NSArray<HistoricalBarModel *> *validBars =
-                    [allBars subarrayWithRange:NSMakeRange(0, lastValidIndex + 1)];
-                slicedCache[symbol] = validBars;
-            }
-        }
-    }
-    
-    return [slicedCache copy];
+    BacktestCacheIndex *index = [[BacktestCacheIndex alloc] initWithMasterCache:masterCache];
+    return [index viewAtDate:referenceDate];
 }
 
 + (NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)sliceCache:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)masterCache
@@ -101,6 +70,37 @@
     return [slicedCache copy];
 }
 
+#pragma mark - Columnar Conversion
+
++ (NSDictionary<NSString *, BarSeries *> *)seriesCacheFromCache:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cache {
+    
+    NSMutableDictionary<NSString *, BarSeries *> *seriesCache =
+        [NSMutableDictionary dictionaryWithCapacity:cache.count];
+    
+    for (NSString *symbol in cache) {
+        @autoreleasepool {
+            NSArray<HistoricalBarModel *> *bars = cache[symbol];
+            if (bars.count == 0) continue;
+            
+            seriesCache[symbol] = [BarSeries seriesWithBars:bars];
+        }
+    }
+    
+    return [seriesCache copy];
+}
+
++ (NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)barCacheFromSeriesCache:(NSDictionary<NSString *, BarSeries *> *)seriesCache {
+    
+    NSMutableDictionary<NSString *, NSArray<HistoricalBarModel *> *> *barCache =
+        [NSMutableDictionary dictionaryWithCapacity:seriesCache.count];
+    
+    for (NSString *symbol in seriesCache) {
+        barCache[symbol] = [seriesCache[symbol] bars];
+    }
+    
+    return [barCache copy];
+}
+
 #pragma mark - Cache Statistics
 
 + (NSInteger)symbolCountAtDate:(NSDate *)referenceDate
@@ -0,0 +1,78 @@
+//
+//  BacktestCacheView.h
+//  TradingApp
+//
+//  Zero-copy date-windowed views over a backtest master cache.
+//  The index extracts bar timestamps once per backtest; each daily view is
+//  just one end-index per symbol, so slicing a day costs O(symbols).
+//
+
+#import <Foundation/Foundation.h>
+#import "RuntimeModels.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class BacktestCacheView;
+
+#pragma mark - Cache Index
+
+/**
+ * Immutable timestamp index over a master cache (build once per backtest)
+ * Thread-safe: views can be created concurrently from any queue.
+ */
+@interface BacktestCacheIndex : NSObject
+
+/// Master cache this index was built from
+@property (nonatomic, strong, readonly) NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *masterCache;
+
+/// Symbols with at least one bar
+@property (nonatomic, readonly) NSInteger symbolCount;
+
+- (instancetype)initWithMasterCache:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)masterCache;
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * View of the cache as it was at referenceDate (bars with date <= referenceDate)
+ * End indices are found with a binary search per symbol.
+ */
+- (BacktestCacheView *)viewAtDate:(NSDate *)referenceDate;
+
+/**
+ * Same as viewAtDate:, but when previousView is earlier than referenceDate
+ * the end indices are advanced incrementally from it (typical day-by-day loop).
+ */
+- (BacktestCacheView *)viewAtDate:(NSDate *)referenceDate
+                    advancingFrom:(nullable BacktestCacheView *)previousView;
+
+@end
+
+#pragma mark - Cache View
+
+/**
+ * Dictionary symbol → bars up to referenceDate
+ *
+ * @discussion
+ * Drop-in replacement for the dictionary returned by
+ * +[BacktestCacheHelper sliceCache:upToDate:]: screeners read it through the
+ * usual NSDictionary/NSArray API. Values are windows over the master arrays,
+ * nothing is copied. Symbols without bars at referenceDate are not listed.
+ */
+@interface BacktestCacheView : NSDictionary<NSString *, NSArray<HistoricalBarModel *> *>
+
+@property (nonatomic, strong, readonly) NSDate *referenceDate;
+@property (nonatomic, strong, readonly) BacktestCacheIndex *cacheIndex;
+
+/**
+ * Number of bars visible for a symbol at referenceDate (0 if none / unknown)
+ */
+- (NSInteger)visibleBarCountForSymbol:(NSString *)symbol;
+
+/**
+ * Symbols whose signal bit at their last visible bar is set, in key order
+ * @param signals symbol → bitset over the master bars (see ScreenerSignalTestBit)
+ */
+- (NSArray<NSString *> *)symbolsPassingSignals:(NSDictionary<NSString *, NSData *> *)signals;
+
+@end
+
+NS_ASSUME_NONNULL_END
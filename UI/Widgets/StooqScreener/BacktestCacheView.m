@@ -0,0 +1,306 @@
+//
+//  BacktestCacheView.m
+//  TradingApp
+//
+
+#import "BacktestCacheView.h"
+#import "BarSeries.h"
+#import "BaseScreener.h"
+
+#pragma mark - Window Array
+
+/// First `length` elements of a master array, forwarding to it (no copy)
+@interface BacktestCacheWindowArray : NSArray <BarSeriesBacked>
+- (instancetype)initWithMasterBars:(NSArray<HistoricalBarModel *> *)masterBars
+                            series:(nullable BarSeries *)series
+                            length:(NSUInteger)length;
+@end
+
+@implementation BacktestCacheWindowArray {
+    NSArray<HistoricalBarModel *> *_masterBars;
+    BarSeries *_series;   // nil if the master is a plain NSArray
+    NSUInteger _length;
+}
+
+- (instancetype)initWithMasterBars:(NSArray<HistoricalBarModel *> *)masterBars
+                            series:(BarSeries *)series
+                            length:(NSUInteger)length {
+    self = [super init];
+    if (self) {
+        _masterBars = masterBars;
+        _series = series;
+        _length = length;
+    }
+    return self;
+}
+
+- (NSUInteger)count {
+    return _length;
+}
+
+- (id)objectAtIndex:(NSUInteger)index {
+    if (index >= _length) {
+        [NSException raise:NSRangeException
+                    format:@"BacktestCacheWindowArray: index %lu beyond bounds [0 .. %ld]",
+                           (unsigned long)index, (long)_length - 1];
+    }
+    // Il master (bridge array) riusa le barre già materializzate
+    return [_masterBars objectAtIndex:index];
+}
+
+- (NSArray *)subarrayWithRange:(NSRange)range {
+    if (NSMaxRange(range) > _length) {
+        [NSException raise:NSRangeException
+                    format:@"BacktestCacheWindowArray: range %@ beyond bounds [0 .. %ld]",
+                           NSStringFromRange(range), (long)_length - 1];
+    }
+    return [_masterBars subarrayWithRange:range];
+}
+
+- (BOOL)conformsToProtocol:(Protocol *)protocol {
+    // Solo i master colonnari hanno una serie da esporre
+    if (protocol == @protocol(BarSeriesBacked)) {
+        return _series != nil;
+    }
+    return [super conformsToProtocol:protocol];
+}
+
+- (BarSeries *)barSeries {
+    return [_series sliceWithRange:NSMakeRange(0, _length)];
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    return self;
+}
+
+@end
+
+#pragma mark - Cache Index
+
+@interface BacktestCacheIndex ()
+@property (nonatomic, strong) NSArray<NSString *> *symbols;
+@property (nonatomic, strong) NSArray<NSArray<HistoricalBarModel *> *> *barArrays;
+@property (nonatomic, strong) NSArray<id> *seriesList;                        // BarSeries or NSNull
+@property (nonatomic, strong) NSArray<NSData *> *timeColumns;                  // NSTimeInterval per bar
+@property (nonatomic, strong) NSDictionary<NSString *, NSNumber *> *positionBySymbol;
+- (nullable NSArray<HistoricalBarModel *> *)barsAtPosition:(NSInteger)position length:(NSInteger)length;
+@end
+
+@interface BacktestCacheView ()
+- (instancetype)initWithIndex:(BacktestCacheIndex *)index
+                referenceDate:(NSDate *)referenceDate
+                    endCounts:(NSData *)endCounts;
+@property (nonatomic, strong, readonly) NSData *endCounts;                    // NSInteger per symbol
+@end
+
+@implementation BacktestCacheIndex
+
+- (instancetype)initWithMasterCache:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)masterCache {
+    self = [super init];
+    if (self) {
+        _masterCache = [masterCache copy] ?: @{};
+
+        NSMutableArray<NSString *> *symbols = [NSMutableArray arrayWithCapacity:_masterCache.count];
+        NSMutableArray *barArrays = [NSMutableArray arrayWithCapacity:_masterCache.count];
+        NSMutableArray *seriesList = [NSMutableArray arrayWithCapacity:_masterCache.count];
+        NSMutableArray<NSData *> *timeColumns = [NSMutableArray arrayWithCapacity:_masterCache.count];
+        NSMutableDictionary<NSString *, NSNumber *> *positions = [NSMutableDictionary dictionaryWithCapacity:_masterCache.count];
+
+        for (NSString *symbol in _masterCache) {
+            @autoreleasepool {
+                NSArray<HistoricalBarModel *> *bars = _masterCache[symbol];
+                if (bars.count == 0) continue;
+
+                BarSeries *series = [BarSeries backingSeriesOfBars:bars];
+                NSData *times;
+
+                if (series) {
+                    // Colonna time già contigua: nessuna copia
+                    times = [NSData dataWithBytesNoCopy:(void *)series.time
+                                                 length:(NSUInteger)series.count * sizeof(NSTimeInterval)
+                                           freeWhenDone:NO];
+                } else {
+                    NSMutableData *extracted = [NSMutableData dataWithLength:bars.count * sizeof(NSTimeInterval)];
+                    NSTimeInterval *out = extracted.mutableBytes;
+                    NSInteger i = 0;
+                    for (HistoricalBarModel *bar in bars) {
+                        out[i++] = bar.date.timeIntervalSince1970;
+                    }
+                    times = extracted;
+                }
+
+                positions[symbol] = @(symbols.count);
+                [symbols addObject:symbol];
+                [barArrays addObject:bars];
+                [seriesList addObject:series ?: [NSNull null]];
+                [timeColumns addObject:times];
+            }
+        }
+
+        _symbols = [symbols copy];
+        _barArrays = [barArrays copy];
+        _seriesList = [seriesList copy];
+        _timeColumns = [timeColumns copy];
+        _positionBySymbol = [positions copy];
+    }
+    return self;
+}
+
+- (NSInteger)symbolCount {
+    return self.symbols.count;
+}
+
+#pragma mark - Views
+
+- (BacktestCacheView *)viewAtDate:(NSDate *)referenceDate {
+    return [self viewAtDate:referenceDate advancingFrom:nil];
+}
+
+- (BacktestCacheView *)viewAtDate:(NSDate *)referenceDate
+                    advancingFrom:(BacktestCacheView *)previousView {
+
+    NSInteger symbolCount = self.symbols.count;
+    NSMutableData *endCounts = [NSMutableData dataWithLength:symbolCount * sizeof(NSInteger)];
+    NSInteger *ends = endCounts.mutableBytes;
+    NSTimeInterval reference = referenceDate.timeIntervalSince1970;
+
+    // Avanzamento incrementale valido solo in avanti e sullo stesso indice
+    BOOL canAdvance = previousView && previousView.cacheIndex == self &&
+                      previousView.referenceDate.timeIntervalSince1970 <= reference;
+    const NSInteger *previousEnds = canAdvance ? previousView.endCounts.bytes : NULL;
+
+    for (NSInteger s = 0; s < symbolCount; s++) {
+        NSData *timeColumn = self.timeColumns[s];
+        const NSTimeInterval *times = timeColumn.bytes;
+        NSInteger count = timeColumn.length / sizeof(NSTimeInterval);
+
+        if (previousEnds) {
+            NSInteger end = previousEnds[s];
+            while (end < count && times[end] <= reference) {
+                end++;
+            }
+            ends[s] = end;
+        } else {
+            // upper_bound: primo indice con time > reference
+            NSInteger low = 0;
+            NSInteger high = count;
+            while (low < high) {
+                NSInteger mid = low + (high - low) / 2;
+                if (times[mid] <= reference) {
+                    low = mid + 1;
+                } else {
+                    high = mid;
+                }
+            }
+            ends[s] = low;
+        }
+    }
+
+    return [[BacktestCacheView alloc] initWithIndex:self
+                                      referenceDate:referenceDate
+                                          endCounts:endCounts];
+}
+
+#pragma mark - Private
+
+- (NSArray<HistoricalBarModel *> *)barsAtPosition:(NSInteger)position length:(NSInteger)length {
+    if (length <= 0) return nil;
+
+    NSArray<HistoricalBarModel *> *bars = self.barArrays[position];
+    if ((NSUInteger)length == bars.count) {
+        return bars;
+    }
+
+    id series = self.seriesList[position];
+    return [[BacktestCacheWindowArray alloc] initWithMasterBars:bars
+                                                         series:(series == [NSNull null] ? nil : series)
+                                                         length:(NSUInteger)length];
+}
+
+@end
+
+#pragma mark - Cache View
+
+@implementation BacktestCacheView {
+    NSArray<NSString *> *_activeSymbols;
+}
+
+- (instancetype)initWithIndex:(BacktestCacheIndex *)index
+                referenceDate:(NSDate *)referenceDate
+                    endCounts:(NSData *)endCounts {
+    self = [super init];
+    if (self) {
+        _cacheIndex = index;
+        _referenceDate = referenceDate;
+        _endCounts = endCounts;
+    }
+    return self;
+}
+
+- (NSArray<NSString *> *)activeSymbols {
+    @synchronized (self) {
+        if (!_activeSymbols) {
+            const NSInteger *ends = self.endCounts.bytes;
+            NSArray<NSString *> *symbols = self.cacheIndex.symbols;
+            NSMutableArray<NSString *> *active = [NSMutableArray arrayWithCapacity:symbols.count];
+
+            for (NSInteger s = 0; s < (NSInteger)symbols.count; s++) {
+                if (ends[s] > 0) {
+                    [active addObject:symbols[s]];
+                }
+            }
+            _activeSymbols = [active copy];
+        }
+        return _activeSymbols;
+    }
+}
+
+- (NSInteger)visibleBarCountForSymbol:(NSString *)symbol {
+    NSNumber *position = self.cacheIndex.positionBySymbol[symbol];
+    if (!position) return 0;
+
+    const NSInteger *ends = self.endCounts.bytes;
+    return ends[position.integerValue];
+}
+
+- (NSArray<NSString *> *)symbolsPassingSignals:(NSDictionary<NSString *, NSData *> *)signals {
+    const NSInteger *ends = self.endCounts.bytes;
+    NSArray<NSString *> *symbols = self.cacheIndex.symbols;
+    NSMutableArray<NSString *> *passing = [NSMutableArray array];
+
+    for (NSInteger s = 0; s < (NSInteger)symbols.count; s++) {
+        if (ends[s] == 0) continue;
+
+        NSData *bits = signals[symbols[s]];
+        if (bits && ScreenerSignalTestBit(bits.bytes, ends[s] - 1)) {
+            [passing addObject:symbols[s]];
+        }
+    }
+    return [passing copy];
+}
+
+#pragma mark - NSDictionary Primitives
+
+- (NSUInteger)count {
+    return self.activeSymbols.count;
+}
+
+- (id)objectForKey:(id)key {
+    if (![key isKindOfClass:[NSString class]]) return nil;
+
+    NSNumber *position = self.cacheIndex.positionBySymbol[key];
+    if (!position) return nil;
+
+    const NSInteger *ends = self.endCounts.bytes;
+    return [self.cacheIndex barsAtPosition:position.integerValue length:ends[position.integerValue]];
+}
+
+- (NSEnumerator *)keyEnumerator {
+    return [self.activeSymbols objectEnumerator];
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    return self;  // Immutable
+}
+
+@end
@@ -126,6 +126,9 @@ NS_ASSUME_NONNULL_BEGIN
 /// Total execution time for entire backtest
 @property (nonatomic, assign) NSTimeInterval totalExecutionTime;
 
+/// Holding period (calendar days) used for the performance statistics (0 = not calculated)
+@property (nonatomic, assign) NSInteger statisticsHoldingPeriod;
+
 #pragma mark - Convenience Methods
 
 /**
@@ -155,6 +158,22 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (nullable HistoricalBarModel *)benchmarkBarForDate:(NSDate *)date;
 
+#pragma mark - Performance Statistics
+
+/**
+ * Fill winRate / avgGain / avgLoss / tradeCount / winLossRatio of all daily results
+ * @param priceData Master cache with price data (must extend past endDate + holdingPeriod
+ *                  for the last days to have exits)
+ * @param holdingPeriod Calendar days between entry and exit
+ *
+ * @discussion
+ * Date tables are built once for the screened symbols and every result is
+ * computed in the same pass (see BacktestReturnEngine), so all metrics are
+ * available when the session is displayed.
+ */
+- (void)calculateStatisticsWithPriceData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)priceData
+                           holdingPeriod:(NSInteger)holdingPeriod;
+
 #pragma mark - Persistence
 
 /**
@@ -4,6 +4,7 @@
 //
 
 #import "BacktestModels.h"
+#import "BacktestReturnEngine.h"
 
 #pragma mark - DailyBacktestResult Implementation
 
@@ -41,7 +42,9 @@
 
 #pragma mark - BacktestSession Implementation
 
-@implementation BacktestSession
+@implementation BacktestSession {
+    NSDictionary<NSDate *, NSArray<DailyBacktestResult *> *> *_resultsByDate;  // Lazy, reset with dailyResults
+}
 
 + (BOOL)supportsSecureCoding {
     return YES;
@@ -71,6 +74,7 @@
     [coder encodeObject:self.models forKey:@"models"];
     [coder encodeObject:self.dailyResults forKey:@"dailyResults"];
     [coder encodeDouble:self.totalExecutionTime forKey:@"totalExecutionTime"];
+    [coder encodeInteger:self.statisticsHoldingPeriod forKey:@"statisticsHoldingPeriod"];
 }
 
 - (nullable instancetype)initWithCoder:(NSCoder *)coder {
@@ -88,10 +92,20 @@
         _dailyResults = [coder decodeObjectOfClasses:[NSSet setWithObjects:[NSArray class], [DailyBacktestResult class], nil]
                                               forKey:@"dailyResults"];
         _totalExecutionTime = [coder decodeDoubleForKey:@"totalExecutionTime"];
+        _statisticsHoldingPeriod = [coder decodeIntegerForKey:@"statisticsHoldingPeriod"];
     }
     return self;
 }
 
+#pragma mark - Accessors
+
+- (void)setDailyResults:(NSArray<DailyBacktestResult *> *)dailyResults {
+    @synchronized (self) {
+        _dailyResults = dailyResults;
+        _resultsByDate = nil;
+    }
+}
+
 #pragma mark - Computed Properties
 
 - (NSInteger)tradingDaysCount {
@@ -107,10 +121,23 @@
 }
 
 - (NSArray<DailyBacktestResult *> *)resultsForDate:(NSDate *)date {
-    NSPredicate *predicate = [NSPredicate predicateWithBlock:^BOOL(DailyBacktestResult *result, NSDictionary *bindings) {
-        return [result.date compare:date] == NSOrderedSame;
-    }];
-    return [self.dailyResults filteredArrayUsingPredicate:predicate];
+    // Indice per data costruito una volta: i grafici lo interrogano per ogni giorno
+    @synchronized (self) {
+        if (!_resultsByDate) {
+            NSMutableDictionary<NSDate *, NSMutableArray<DailyBacktestResult *> *> *index = [NSMutableDictionary dictionary];
+            for (DailyBacktestResult *result in _dailyResults) {
+                if (!result.date) continue;
+                NSMutableArray *bucket = index[result.date];
+                if (!bucket) {
+                    bucket = [NSMutableArray array];
+                    index[result.date] = bucket;
+                }
+                [bucket addObject:result];
+            }
+            _resultsByDate = [index copy];
+        }
+        return _resultsByDate[date] ?: @[];
+    }
 }
 
 - (NSArray<NSDate *> *)allDates {
@@ -135,6 +162,25 @@
     return nil;
 }
 
+#pragma mark - Performance Statistics
+
+- (void)calculateStatisticsWithPriceData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)priceData
+                           holdingPeriod:(NSInteger)holdingPeriod {
+    
+    // Solo i simboli effettivamente selezionati in almeno un giorno
+    NSMutableSet<NSString *> *screened = [NSMutableSet set];
+    for (DailyBacktestResult *result in self.dailyResults) {
+        for (ScreenedSymbol *symbol in result.screenedSymbols) {
+            [screened addObject:symbol.symbol];
+        }
+    }
+    
+    BacktestReturnEngine *engine = [[BacktestReturnEngine alloc] initWithPriceData:priceData
+                                                                           symbols:screened.allObjects];
+    [engine applyStatisticsToResults:self.dailyResults holdingPeriod:holdingPeriod];
+    self.statisticsHoldingPeriod = holdingPeriod;
+}
+
 #pragma mark - Persistence
 
 - (BOOL)saveToPath:(NSString *)path error:(NSError **)error {
@@ -212,43 +258,11 @@
         return 0.0;
     }
     
-    NSCalendar *calendar = [NSCalendar currentCalendar];
-    NSDate *exitDate = [calendar dateByAddingUnit:NSCalendarUnitDay
-                                             value:holdingPeriod
-                                            toDate:startDate
-                                           options:0];
-    
-    NSInteger winners = 0;
-    NSInteger totalTrades = 0;
-    
-    for (NSString *symbol in symbols) {
-        NSArray<HistoricalBarModel *> *bars = priceData[symbol];
-        if (!bars || bars.count < 2) continue;
-        
-        // Find entry bar (at or after startDate)
-        HistoricalBarModel *entryBar = [self findBarOnOrAfter:startDate inBars:bars];
-        if (!entryBar) continue;
-        
-        // Find exit bar (at or after exitDate)
-        HistoricalBarModel *exitBar = [self findBarOnOrAfter:exitDate inBars:bars];
-        if (!exitBar) continue;
-        
-        // Calculate return
-        double entryPrice = entryBar.close;
-        double exitPrice = exitBar.close;
-        double returnPercent = ((exitPrice - entryPrice) / entryPrice) * 100.0;
-        
-        if (returnPercent > 0) {
-            winners++;
-        }
-        totalTrades++;
-    }
-    
-    if (totalTrades == 0) {
-        return 0.0;
-    }
-    
-    return (CGFloat)(winners * 100.0 / totalTrades);
+    BacktestReturnEngine *engine = [[BacktestReturnEngine alloc] initWithPriceData:priceData symbols:symbols];
+    BacktestReturnStats stats = [engine statisticsForSymbols:symbols
+                                                   startDate:startDate
+                                               holdingPeriod:holdingPeriod];
+    return (CGFloat)stats.winRate;
 }
 
 + (NSDictionary<NSString *, NSNumber *> *)calculateReturnsForSymbols:(NSArray<NSString *> *)symbols
@@ -260,70 +274,14 @@
         return @{@"avgGain": @0.0, @"avgLoss": @0.0};
     }
     
-    NSCalendar *calendar = [NSCalendar currentCalendar];
-    NSDate *exitDate = [calendar dateByAddingUnit:NSCalendarUnitDay
-                                             value:holdingPeriod
-                                            toDate:startDate
-                                           options:0];
-    
-    NSMutableArray *gains = [NSMutableArray array];
-    NSMutableArray *losses = [NSMutableArray array];
-    
-    for (NSString *symbol in symbols) {
-        NSArray<HistoricalBarModel *> *bars = priceData[symbol];
-        if (!bars || bars.count < 2) continue;
-        
-        HistoricalBarModel *entryBar = [self findBarOnOrAfter:startDate inBars:bars];
-        if (!entryBar) continue;
-        
-        HistoricalBarModel *exitBar = [self findBarOnOrAfter:exitDate inBars:bars];
-        if (!exitBar) continue;
-        
-        double returnPercent = ((exitBar.close - entryBar.close) / entryBar.close) * 100.0;
-        
-        if (returnPercent > 0) {
-            [gains addObject:@(returnPercent)];
-        } else {
-            [losses addObject:@(returnPercent)];
-        }
-    }
-    
-    // Calculate averages
-    double avgGain = 0.0;
-    if (gains.count > 0) {
-        double sum = 0.0;
-        for (NSNumber *num in gains) {
-            sum += num.doubleValue;
-        }
-        avgGain = sum / gains.count;
-    }
-    
-    double avgLoss = 0.0;
-    if (losses.count > 0) {
-        double sum = 0.0;
-        for (NSNumber *num in losses) {
-            sum += num.doubleValue;
-        }
-        avgLoss = sum / losses.count;
-    }
-    
+    BacktestReturnEngine *engine = [[BacktestReturnEngine alloc] initWithPriceData:priceData symbols:symbols];
+    BacktestReturnStats stats = [engine statisticsForSymbols:symbols
+                                                   startDate:startDate
+                                               holdingPeriod:holdingPeriod];
     return @{
-        @"avgGain": @(avgGain),
-        @"avgLoss": @(avgLoss)
+        @"avgGain": @(stats.avgGain),
+        @"avgLoss": @(stats.avgLoss)
     };
 }
 
-#pragma mark - Helper Methods
-
-+ (nullable HistoricalBarModel *)findBarOnOrAfter:(NSDate *)date
-                                           inBars:(NSArray<HistoricalBarModel *> *)bars {
-    
-    for (HistoricalBarModel *bar in bars) {
-        if ([bar.date compare:date] != NSOrderedAscending) {
-            return bar;
-        }
-    }
-    return nil;
-}
-
 @end
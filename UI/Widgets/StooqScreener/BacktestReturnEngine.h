@@ -0,0 +1,69 @@
+//
+//  BacktestReturnEngine.h
+//  TradingApp
+//
+//  Forward-return statistics for backtest results.
+//  Per-symbol date/close columns are extracted once; each lookup is a
+//  binary search and returns are reduced from a plain double buffer.
+//
+
+#import <Foundation/Foundation.h>
+#import "RuntimeModels.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class DailyBacktestResult;
+
+/// Aggregate of the N-day returns of a set of symbols
+typedef struct {
+    NSInteger tradeCount;   // Symbols with both an entry and an exit bar
+    NSInteger winners;      // Return > 0
+    double winRate;         // 0-100
+    double avgGain;         // Mean of positive returns (%)
+    double avgLoss;         // Mean of non-positive returns (%, <= 0)
+    double winLossRatio;    // winners / losers (winners if no losers)
+} BacktestReturnStats;
+
+/**
+ * Immutable date-index tables over a price cache (build once per session)
+ * Thread-safe: all lookups only read the tables.
+ *
+ * @discussion
+ * Same rules as BacktestStatisticsCalculator: entry is the first bar on or
+ * after startDate, exit the first bar on or after startDate + holdingPeriod
+ * calendar days, return = exit.close / entry.close - 1 in percent.
+ */
+@interface BacktestReturnEngine : NSObject
+
+- (instancetype)initWithPriceData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)priceData;
+
+/// Index only `symbols` (cheaper when priceData is much larger than the set screened)
+- (instancetype)initWithPriceData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)priceData
+                          symbols:(nullable NSArray<NSString *> *)symbols;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * N-day returns for the symbols that have both entry and exit bars
+ * @param output Buffer of at least symbols.count doubles
+ * @return Number of returns written
+ */
+- (NSInteger)forwardReturnsForSymbols:(NSArray<NSString *> *)symbols
+                            startDate:(NSDate *)startDate
+                        holdingPeriod:(NSInteger)holdingPeriod
+                               output:(double *)output;
+
+- (BacktestReturnStats)statisticsForSymbols:(NSArray<NSString *> *)symbols
+                                  startDate:(NSDate *)startDate
+                              holdingPeriod:(NSInteger)holdingPeriod;
+
+/**
+ * Fill winRate / avgGain / avgLoss / tradeCount / winLossRatio of every result
+ * Results are processed concurrently; the exit date is computed once per day.
+ */
+- (void)applyStatisticsToResults:(NSArray<DailyBacktestResult *> *)results
+                   holdingPeriod:(NSInteger)holdingPeriod;
+
+@end
+
+NS_ASSUME_NONNULL_END
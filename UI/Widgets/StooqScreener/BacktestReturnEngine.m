@@ -0,0 +1,213 @@
+//
+//  BacktestReturnEngine.m
+//  TradingApp
+//
+
+#import "BacktestReturnEngine.h"
+#import "BacktestModels.h"
+#import "BarSeries.h"
+
+/// Colonne di un simbolo (puntatori validi finché vivono gli owner)
+typedef struct {
+    const NSTimeInterval *time;
+    const double *close;
+    NSInteger count;
+} BacktestReturnTable;
+
+/// First index with time >= reference (count if none)
+static NSInteger BacktestReturnLowerBound(const NSTimeInterval *times, NSInteger low, NSInteger count,
+                                          NSTimeInterval reference) {
+    NSInteger high = count;
+    while (low < high) {
+        NSInteger mid = low + (high - low) / 2;
+        if (times[mid] < reference) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static BacktestReturnStats BacktestReturnStatsFromReturns(const double *returns, NSInteger count) {
+    BacktestReturnStats stats = {0};
+    if (count == 0) return stats;
+
+    double gainSum = 0.0;
+    double lossSum = 0.0;
+    NSInteger winners = 0;
+
+    for (NSInteger i = 0; i < count; i++) {
+        double r = returns[i];
+        BOOL win = r > 0;
+        winners += win;
+        gainSum += win ? r : 0.0;
+        lossSum += win ? 0.0 : r;
+    }
+
+    NSInteger losers = count - winners;
+    stats.tradeCount = count;
+    stats.winners = winners;
+    stats.winRate = winners * 100.0 / count;
+    stats.avgGain = winners > 0 ? gainSum / winners : 0.0;
+    stats.avgLoss = losers > 0 ? lossSum / losers : 0.0;
+    stats.winLossRatio = losers > 0 ? (double)winners / losers : (double)winners;
+    return stats;
+}
+
+@implementation BacktestReturnEngine {
+    NSDictionary<NSString *, NSNumber *> *_positionBySymbol;
+    NSMutableData *_tables;        // BacktestReturnTable per symbol
+    NSArray *_columnOwners;        // BarSeries / NSData referenced by _tables
+}
+
+- (instancetype)initWithPriceData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)priceData {
+    return [self initWithPriceData:priceData symbols:nil];
+}
+
+- (instancetype)initWithPriceData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)priceData
+                          symbols:(NSArray<NSString *> *)symbols {
+    self = [super init];
+    if (self) {
+        NSArray<NSString *> *keys = symbols ?: priceData.allKeys;
+        NSMutableDictionary<NSString *, NSNumber *> *positions = [NSMutableDictionary dictionaryWithCapacity:keys.count];
+        NSMutableArray *owners = [NSMutableArray arrayWithCapacity:keys.count];
+        _tables = [NSMutableData dataWithCapacity:keys.count * sizeof(BacktestReturnTable)];
+
+        for (NSString *symbol in keys) {
+            @autoreleasepool {
+                NSArray<HistoricalBarModel *> *bars = priceData[symbol];
+                if (bars.count < 2 || positions[symbol]) continue;
+
+                BacktestReturnTable table = { .count = (NSInteger)bars.count };
+                BarSeries *series = [BarSeries backingSeriesOfBars:bars];
+
+                if (series) {
+                    // Colonne già contigue: nessuna copia
+                    table.time = series.time;
+                    table.close = series.close;
+                    [owners addObject:series];
+                } else {
+                    NSMutableData *columns = [NSMutableData dataWithLength:bars.count * 2 * sizeof(double)];
+                    NSTimeInterval *times = columns.mutableBytes;
+                    double *closes = times + bars.count;
+                    NSInteger i = 0;
+                    for (HistoricalBarModel *bar in bars) {
+                        times[i] = bar.date.timeIntervalSince1970;
+                        closes[i] = bar.close;
+                        i++;
+                    }
+                    table.time = times;
+                    table.close = closes;
+                    [owners addObject:columns];
+                }
+
+                positions[symbol] = @(_tables.length / sizeof(BacktestReturnTable));
+                [_tables appendBytes:&table length:sizeof(table)];
+            }
+        }
+
+        _positionBySymbol = [positions copy];
+        _columnOwners = [owners copy];
+    }
+    return self;
+}
+
+#pragma mark - Returns
+
+- (NSTimeInterval)exitTimeForStartDate:(NSDate *)startDate holdingPeriod:(NSInteger)holdingPeriod {
+    NSDate *exitDate = [[NSCalendar currentCalendar] dateByAddingUnit:NSCalendarUnitDay
+                                                                value:holdingPeriod
+                                                               toDate:startDate
+                                                              options:0];
+    return exitDate.timeIntervalSince1970;
+}
+
+- (NSInteger)returnsForSymbols:(NSArray<NSString *> *)symbols
+                     entryTime:(NSTimeInterval)entryTime
+                      exitTime:(NSTimeInterval)exitTime
+                        output:(double *)output {
+    const BacktestReturnTable *tables = _tables.bytes;
+    NSInteger written = 0;
+
+    for (NSString *symbol in symbols) {
+        NSNumber *position = _positionBySymbol[symbol];
+        if (!position) continue;
+
+        const BacktestReturnTable *table = &tables[position.integerValue];
+        NSInteger entry = BacktestReturnLowerBound(table->time, 0, table->count, entryTime);
+        if (entry >= table->count) continue;
+
+        // Con holding period >= 0 l'uscita non precede l'ingresso: si cerca da lì in avanti
+        NSInteger from = (exitTime >= entryTime) ? entry : 0;
+        NSInteger exit = BacktestReturnLowerBound(table->time, from, table->count, exitTime);
+        if (exit >= table->count) continue;
+
+        double entryPrice = table->close[entry];
+        output[written++] = ((table->close[exit] - entryPrice) / entryPrice) * 100.0;
+    }
+    return written;
+}
+
+- (NSInteger)forwardReturnsForSymbols:(NSArray<NSString *> *)symbols
+                            startDate:(NSDate *)startDate
+                        holdingPeriod:(NSInteger)holdingPeriod
+                               output:(double *)output {
+    return [self returnsForSymbols:symbols
+                         entryTime:startDate.timeIntervalSince1970
+                          exitTime:[self exitTimeForStartDate:startDate holdingPeriod:holdingPeriod]
+                            output:output];
+}
+
+- (BacktestReturnStats)statisticsForSymbols:(NSArray<NSString *> *)symbols
+                                  startDate:(NSDate *)startDate
+                              holdingPeriod:(NSInteger)holdingPeriod {
+    if (symbols.count == 0) {
+        return (BacktestReturnStats){0};
+    }
+
+    NSMutableData *returns = [NSMutableData dataWithLength:symbols.count * sizeof(double)];
+    NSInteger count = [self forwardReturnsForSymbols:symbols
+                                           startDate:startDate
+                                       holdingPeriod:holdingPeriod
+                                              output:returns.mutableBytes];
+    return BacktestReturnStatsFromReturns(returns.bytes, count);
+}
+
+#pragma mark - Results
+
+- (void)applyStatisticsToResults:(NSArray<DailyBacktestResult *> *)results
+                   holdingPeriod:(NSInteger)holdingPeriod {
+    NSInteger resultCount = results.count;
+    if (resultCount == 0) return;
+
+    // NSCalendar una volta per giorno, non per risultato
+    NSMutableDictionary<NSDate *, NSNumber *> *exitTimes = [NSMutableDictionary dictionary];
+    for (DailyBacktestResult *result in results) {
+        if (!exitTimes[result.date]) {
+            exitTimes[result.date] = @([self exitTimeForStartDate:result.date holdingPeriod:holdingPeriod]);
+        }
+    }
+
+    dispatch_apply(resultCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t index) {
+        @autoreleasepool {
+            DailyBacktestResult *result = results[index];
+            NSArray<NSString *> *symbols = [result.screenedSymbols valueForKey:@"symbol"];
+
+            NSMutableData *returns = [NSMutableData dataWithLength:symbols.count * sizeof(double)];
+            NSInteger count = [self returnsForSymbols:symbols
+                                            entryTime:result.date.timeIntervalSince1970
+                                             exitTime:exitTimes[result.date].doubleValue
+                                               output:returns.mutableBytes];
+            BacktestReturnStats stats = BacktestReturnStatsFromReturns(returns.bytes, count);
+
+            result.winRate = stats.winRate;
+            result.avgGain = stats.avgGain;
+            result.avgLoss = stats.avgLoss;
+            result.tradeCount = stats.tradeCount;
+            result.winLossRatio = stats.winLossRatio;
+        }
+    });
+}
+
+@end
@@ -75,6 +75,29 @@ NS_ASSUME_NONNULL_BEGIN
 /// Current progress (0.0 - 1.0)
 @property (nonatomic, readonly) double progress;
 
+/**
+ * Execute trading days concurrently on all cores (default NO)
+ * Results are still returned in date order; didStartDate: callbacks may
+ * arrive out of order. Must be set before runBacktestForModels:...
+ */
+@property (nonatomic, assign) BOOL parallelExecution;
+
+/**
+ * Holding period in calendar days for win rate / avg gain / avg loss
+ * statistics (default 5, 0 = skip statistics)
+ * Days whose exit falls past the master cache have no trades.
+ */
+@property (nonatomic, assign) NSInteger holdingPeriod;
+
+/**
+ * Evaluate models whose screeners all support whole-history signals in one
+ * pass per symbol instead of once per day (default YES)
+ * Each step yields a per-bar bitset over the master cache; a day's result is
+ * the AND of the step bits at each symbol's last visible bar. Other models
+ * keep the day-by-day execution. Must be set before runBacktestForModels:...
+ */
+@property (nonatomic, assign) BOOL signalSeriesEnabled;
+
 #pragma mark - Initialization
 
 - (instancetype)init;
@@ -94,10 +117,12 @@ NS_ASSUME_NONNULL_BEGIN
  * This method assumes masterCache contains data from (startDate - maxBars) to endDate.
  * It will:
  * 1. Generate all trading dates in range
- * 2. For each date, slice the cache to that date
- * 3. Execute all models with the sliced cache
+ * 2. Precompute whole-history signals for eligible models (signalSeriesEnabled)
+ * 3. For each date, slice the cache to that date and execute all models on it
+ *    (signal models just read their bits; days run concurrently if parallelExecution)
  * 4. Collect results into a BacktestSession
- * 5. Call delegate with completion or error
+ * 5. Calculate forward-return statistics for holdingPeriod (one pass for all results)
+ * 6. Call delegate with completion or error
  *
  * Execution happens on background queue. All delegate callbacks are on main queue.
  */
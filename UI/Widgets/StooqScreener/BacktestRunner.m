@@ -5,6 +5,7 @@
 
 #import "BacktestRunner.h"
 #import "BacktestCacheHelper.h"
+#import "BacktestCacheView.h"
 #import "ScreenerRegistry.h"
 #import "BaseScreener.h"
 #import <Cocoa/Cocoa.h>
@@ -16,6 +17,9 @@
 @property (nonatomic, strong) dispatch_queue_t backtestQueue;
 @property (nonatomic, strong) NSDate *executionStartTime;
 
+/// modelID → symbol → signal bitset, for models evaluated over the whole history
+@property (nonatomic, strong) NSDictionary<NSString *, NSDictionary<NSString *, NSData *> *> *modelSignals;
+
 @end
 
 @implementation BacktestRunner
@@ -28,6 +32,8 @@
         _backtestQueue = dispatch_queue_create("com.tradingapp.backtest", DISPATCH_QUEUE_SERIAL);
         _running = NO;
         _currentProgress = 0.0;
+        _holdingPeriod = 5;
+        _signalSeriesEnabled = YES;
     }
     return self;
 }
@@ -153,9 +159,72 @@
     });
     
     // STEP 5: Execute backtest
+    // Timestamp index built once; each day is a zero-copy view advanced from the previous one
+    BacktestCacheIndex *cacheIndex = [[BacktestCacheIndex alloc] initWithMasterCache:masterCache];
+    
+    if (self.signalSeriesEnabled) {
+        [self notifyPreparation:@"Computing screener signals..."];
+        self.modelSignals = [self signalsForModels:models masterCache:cacheIndex.masterCache];
+    } else {
+        self.modelSignals = @{};
+    }
+    
+    NSArray<DailyBacktestResult *> *allResults = self.parallelExecution
+        ? [self executeDaysConcurrently:tradingDates models:models cacheIndex:cacheIndex]
+        : [self executeDaysSequentially:tradingDates models:models cacheIndex:cacheIndex];
+    
+    if (!allResults) {
+        [self notifyCancel];
+        return;
+    }
+    
+    // STEP 6: Create session
+    NSTimeInterval totalTime = [[NSDate date] timeIntervalSinceDate:self.executionStartTime];
+    
+    BacktestSession *session = [[BacktestSession alloc] init];
+    session.startDate = startDate;
+    session.endDate = endDate;
+    session.benchmarkSymbol = benchmarkSymbol;
+    session.benchmarkBars = benchmarkBars;
+    session.models = models;
+    session.dailyResults = allResults;
+    session.totalExecutionTime = totalTime;
+    session.modelColors = modelColors;
+    
+    // STEP 7: Forward-return statistics (all metrics ready before display)
+    if (self.holdingPeriod > 0) {
+        [self notifyPreparation:@"Calculating statistics..."];
+        [session calculateStatisticsWithPriceData:masterCache holdingPeriod:self.holdingPeriod];
+    }
+    
+    NSLog(@"✅ BacktestRunner: Completed successfully");
+    NSLog(@"   Total results: %lu", (unsigned long)allResults.count);
+    NSLog(@"   Execution time: %.2fs", totalTime);
+    
+    // Mark as done
+    @synchronized (self) {
+        _running = NO;
+    }
+    
+    // Notify completion
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if ([self.delegate respondsToSelector:@selector(backtestRunner:didFinishWithSession:)]) {
+            [self.delegate backtestRunner:self didFinishWithSession:session];
+        }
+    });
+}
+
+#pragma mark - Day Execution
+
+/// Returns results in date order, or nil if cancelled
+- (nullable NSArray<DailyBacktestResult *> *)executeDaysSequentially:(NSArray<NSDate *> *)tradingDates
+                                                              models:(NSArray<ScreenerModel *> *)models
+                                                          cacheIndex:(BacktestCacheIndex *)cacheIndex {
+    
     NSMutableArray<DailyBacktestResult *> *allResults = [NSMutableArray array];
     NSInteger totalIterations = tradingDates.count * models.count;
     NSInteger currentIteration = 0;
+    BacktestCacheView *previousView = nil;
     
     for (NSInteger dayIndex = 0; dayIndex < tradingDates.count; dayIndex++) {
         NSDate *currentDate = tradingDates[dayIndex];
@@ -164,22 +233,14 @@
         if (!self.isRunning) {
             NSLog(@"⚠️ BacktestRunner: Cancelled at day %ld/%lu",
                   (long)(dayIndex + 1), (unsigned long)tradingDates.count);
-            [self notifyCancel];
-            return;
+            return nil;
         }
         
-        // Notify date start
-        dispatch_async(dispatch_get_main_queue(), ^{
-            if ([self.delegate respondsToSelector:@selector(backtestRunner:didStartDate:dayNumber:totalDays:)]) {
-                [self.delegate backtestRunner:self
-                                 didStartDate:currentDate
-                                    dayNumber:dayIndex + 1
-                                    totalDays:tradingDates.count];
-            }
-        });
+        [self notifyStartDate:currentDate dayNumber:dayIndex + 1 totalDays:tradingDates.count];
         
         // Slice cache to this date
-        NSDictionary *dateCache = [BacktestCacheHelper sliceCache:masterCache upToDate:currentDate];
+        BacktestCacheView *dateCache = [cacheIndex viewAtDate:currentDate advancingFrom:previousView];
+        previousView = dateCache;
         
         if (dateCache.count == 0) {
             NSLog(@"⚠️ No data available for date %@, skipping", currentDate);
@@ -195,74 +256,141 @@
             
             // Check cancellation again
             if (!self.isRunning) {
-                [self notifyCancel];
-                return;
+                return nil;
             }
             
-            NSDate *modelStartTime = [NSDate date];
-            
-            // Execute model (reuse existing execution logic)
-            NSArray<NSString *> *screenedSymbols = [self executeModel:model
-                                                          withUniverse:dateCache.allKeys
-                                                                 cache:dateCache];
+            [allResults addObject:[self runModel:model onDate:currentDate cache:dateCache]];
             
-            NSTimeInterval modelTime = [[NSDate date] timeIntervalSinceDate:modelStartTime];
+            // Update progress
+            currentIteration++;
+            [self updateProgress:(double)currentIteration / (double)totalIterations];
+        }
+    }
+    
+    return [allResults copy];
+}
+
+/// Days are independent given the master cache: fan them out on all cores.
+/// Returns results in date order, or nil if cancelled
+- (nullable NSArray<DailyBacktestResult *> *)executeDaysConcurrently:(NSArray<NSDate *> *)tradingDates
+                                                              models:(NSArray<ScreenerModel *> *)models
+                                                          cacheIndex:(BacktestCacheIndex *)cacheIndex {
+    
+    NSInteger dayCount = tradingDates.count;
+    NSInteger totalIterations = dayCount * models.count;
+    
+    // Uno slot per giorno: il riassemblaggio in ordine di data è gratuito
+    NSMutableArray *daySlots = [NSMutableArray arrayWithCapacity:dayCount];
+    for (NSInteger i = 0; i < dayCount; i++) {
+        [daySlots addObject:[NSNull null]];
+    }
+    
+    NSObject *progressLock = [[NSObject alloc] init];
+    __block NSInteger currentIteration = 0;
+    __block BOOL wasCancelled = NO;
+    
+    NSLog(@"⚡ BacktestRunner: Executing %ld days concurrently", (long)dayCount);
+    
+    // dispatch_apply bilancia il carico tra i core (work stealing)
+    dispatch_apply(dayCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t dayIndex) {
+        @autoreleasepool {
+            if (!self.isRunning) {
+                @synchronized (progressLock) {
+                    wasCancelled = YES;
+                }
+                return;
+            }
             
-            // Create result
-            NSArray<ScreenedSymbol *> *screenedSymbolObjects = [self createScreenedSymbolsArray:screenedSymbols];
+            NSDate *currentDate = tradingDates[dayIndex];
+            [self notifyStartDate:currentDate dayNumber:dayIndex + 1 totalDays:dayCount];
             
-            DailyBacktestResult *result = [DailyBacktestResult resultWithDate:currentDate
-                                                                     modelName:model.displayName
-                                                                       modelID:model.modelID
-                                                               screenedSymbols:screenedSymbolObjects];
-            result.executionTime = modelTime;
+            BacktestCacheView *dateCache = [cacheIndex viewAtDate:currentDate];
+            if (dateCache.count == 0) {
+                NSLog(@"⚠️ No data available for date %@, skipping", currentDate);
+                return;
+            }
             
-            [allResults addObject:result];
+            NSMutableArray<DailyBacktestResult *> *dayResults = [NSMutableArray arrayWithCapacity:models.count];
             
-            // Notify model completion
-            dispatch_async(dispatch_get_main_queue(), ^{
-                if ([self.delegate respondsToSelector:@selector(backtestRunner:didCompleteModel:onDate:symbolCount:)]) {
-                    [self.delegate backtestRunner:self
-                                 didCompleteModel:model.displayName
-                                           onDate:currentDate
-                                      symbolCount:screenedSymbols.count];
+            for (ScreenerModel *model in models) {
+                if (!self.isRunning) {
+                    @synchronized (progressLock) {
+                        wasCancelled = YES;
+                    }
+                    return;
                 }
-            });
+                
+                [dayResults addObject:[self runModel:model onDate:currentDate cache:dateCache]];
+                
+                NSInteger completed;
+                @synchronized (progressLock) {
+                    completed = ++currentIteration;
+                }
+                [self updateProgress:(double)completed / (double)totalIterations];
+            }
             
-            // Update progress
-            currentIteration++;
-            [self updateProgress:(double)currentIteration / (double)totalIterations];
+            @synchronized (daySlots) {
+                daySlots[dayIndex] = dayResults;
+            }
         }
+    });
+    
+    if (wasCancelled) {
+        NSLog(@"⚠️ BacktestRunner: Cancelled during concurrent execution");
+        return nil;
     }
     
-    // STEP 6: Create session
-    NSTimeInterval totalTime = [[NSDate date] timeIntervalSinceDate:self.executionStartTime];
+    NSMutableArray<DailyBacktestResult *> *allResults = [NSMutableArray arrayWithCapacity:totalIterations];
+    for (id dayResults in daySlots) {
+        if (dayResults != [NSNull null]) {
+            [allResults addObjectsFromArray:dayResults];
+        }
+    }
     
-    BacktestSession *session = [[BacktestSession alloc] init];
-    session.startDate = startDate;
-    session.endDate = endDate;
-    session.benchmarkSymbol = benchmarkSymbol;
-    session.benchmarkBars = benchmarkBars;
-    session.models = models;
-    session.dailyResults = [allResults copy];
-    session.totalExecutionTime = totalTime;
-    session.modelColors = modelColors;
+    return [allResults copy];
+}
+
+- (DailyBacktestResult *)runModel:(ScreenerModel *)model
+                           onDate:(NSDate *)currentDate
+                            cache:(NSDictionary *)dateCache {
+    
+    NSDate *modelStartTime = [NSDate date];
+    
+    // Modelli a segnali: basta leggere i bit del giorno
+    NSDictionary<NSString *, NSData *> *signals = model.modelID ? self.modelSignals[model.modelID] : nil;
+    NSArray<NSString *> *screenedSymbols;
+    
+    if (signals && [dateCache isKindOfClass:[BacktestCacheView class]]) {
+        screenedSymbols = [(BacktestCacheView *)dateCache symbolsPassingSignals:signals];
+    } else {
+        // Execute model (reuse existing execution logic)
+        screenedSymbols = [self executeModel:model
+                                withUniverse:dateCache.allKeys
+                                       cache:dateCache];
+    }
     
-    NSLog(@"✅ BacktestRunner: Completed successfully");
-    NSLog(@"   Total results: %lu", (unsigned long)allResults.count);
-    NSLog(@"   Execution time: %.2fs", totalTime);
+    NSTimeInterval modelTime = [[NSDate date] timeIntervalSinceDate:modelStartTime];
     
-    // Mark as done
-    @synchronized (self) {
-        _running = NO;
-    }
+    // Create result
+    NSArray<ScreenedSymbol *> *screenedSymbolObjects = [self createScreenedSymbolsArray:screenedSymbols];
     
-    // Notify completion
+    DailyBacktestResult *result = [DailyBacktestResult resultWithDate:currentDate
+                                                             modelName:model.displayName
+                                                               modelID:model.modelID
+                                                       screenedSymbols:screenedSymbolObjects];
+    result.executionTime = modelTime;
+    
+    // Notify model completion
     dispatch_async(dispatch_get_main_queue(), ^{
-        if ([self.delegate respondsToSelector:@selector(backtestRunner:didFinishWithSession:)]) {
-            [self.delegate backtestRunner:self didFinishWithSession:session];
+        if ([self.delegate respondsToSelector:@selector(backtestRunner:didCompleteModel:onDate:symbolCount:)]) {
+            [self.delegate backtestRunner:self
+                         didCompleteModel:model.displayName
+                                   onDate:currentDate
+                              symbolCount:screenedSymbols.count];
         }
     });
+    
+    return result;
 }
 
 #pragma mark - Model Execution (Reuses existing screener logic)
@@ -274,16 +402,14 @@
     NSArray<NSString *> *currentSymbols = universe;
     
     for (ScreenerStep *step in model.steps) {
-        BaseScreener *screener = [[ScreenerRegistry sharedRegistry] screenerWithID:step.screenerID];
+        BaseScreener *screener = [[ScreenerRegistry sharedRegistry] screenerWithID:step.screenerID
+                                                                         parameters:step.parameters];
         
         if (!screener) {
             NSLog(@"⚠️ Screener not found: %@", step.screenerID);
             continue;
         }
         
-        // Set parameters
-        screener.parameters = step.parameters;
-        
         // Determine input
         NSArray<NSString *> *inputSymbols = [step.inputSource isEqualToString:@"universe"]
             ? universe
@@ -296,6 +422,90 @@
     return currentSymbols;
 }
 
+#pragma mark - Whole-History Signals
+
+- (NSDictionary<NSString *, NSDictionary<NSString *, NSData *> *> *)signalsForModels:(NSArray<ScreenerModel *> *)models
+                                                                          masterCache:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)masterCache {
+    NSMutableDictionary *modelSignals = [NSMutableDictionary dictionary];
+    
+    for (ScreenerModel *model in models) {
+        if (!model.modelID || modelSignals[model.modelID]) continue;
+        
+        NSDate *start = [NSDate date];
+        NSDictionary<NSString *, NSData *> *signals = [self signalsForModel:model masterCache:masterCache];
+        if (signals) {
+            modelSignals[model.modelID] = signals;
+            NSLog(@"⚡ BacktestRunner: %@ evaluated over full history in %.2fs (%lu symbols with signals)",
+                  model.displayName, [[NSDate date] timeIntervalSinceDate:start], (unsigned long)signals.count);
+        }
+    }
+    
+    return [modelSignals copy];
+}
+
+/**
+ * AND of the step bitsets, mirroring executeModel:withUniverse:cache:
+ * @return symbol → bitset, or nil if a step does not support signal series
+ */
+- (nullable NSDictionary<NSString *, NSData *> *)signalsForModel:(ScreenerModel *)model
+                                                      masterCache:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)masterCache {
+    
+    // Come executeModel: gli screener mancanti vengono saltati, e uno step con
+    // input "universe" azzera la catena: contano solo gli step da lì in poi
+    NSMutableArray<BaseScreener *> *screeners = [NSMutableArray array];
+    for (ScreenerStep *step in model.steps) {
+        BaseScreener *screener = [[ScreenerRegistry sharedRegistry] screenerWithID:step.screenerID
+                                                                         parameters:step.parameters];
+        if (!screener) continue;
+        
+        if ([step.inputSource isEqualToString:@"universe"]) {
+            [screeners removeAllObjects];
+        }
+        [screeners addObject:screener];
+    }
+    
+    if (screeners.count == 0) return nil;
+    for (BaseScreener *screener in screeners) {
+        if (!screener.supportsSignalSeries) return nil;
+    }
+    
+    NSArray<NSString *> *symbols = masterCache.allKeys;
+    NSMutableDictionary<NSString *, NSData *> *combined = nil;
+    
+    for (BaseScreener *screener in screeners) {
+        NSDictionary<NSString *, NSData *> *stepSignals = [screener signalsForSymbols:symbols cachedData:masterCache];
+        NSMutableDictionary<NSString *, NSData *> *next = [NSMutableDictionary dictionaryWithCapacity:stepSignals.count];
+        
+        for (NSString *symbol in stepSignals) {
+            NSData *stepBits = stepSignals[symbol];
+            NSData *previousBits = combined[symbol];
+            if (combined && !previousBits) continue;
+            
+            NSMutableData *bits = [stepBits mutableCopy];
+            uint64_t *words = bits.mutableBytes;
+            const uint64_t *previousWords = previousBits.bytes;
+            NSUInteger wordCount = bits.length / sizeof(uint64_t);
+            uint64_t any = 0;
+            
+            for (NSUInteger w = 0; w < wordCount; w++) {
+                if (previousWords) words[w] &= previousWords[w];
+                any |= words[w];
+            }
+            
+            // Simboli senza alcun segnale escono dalla catena
+            if (any) {
+                next[symbol] = bits;
+            }
+        }
+        
+        combined = next;
+        symbols = combined.allKeys;
+        if (symbols.count == 0) break;
+    }
+    
+    return [combined copy];
+}
+
 - (NSArray<ScreenedSymbol *> *)createScreenedSymbolsArray:(NSArray<NSString *> *)symbols {
     NSMutableArray *result = [NSMutableArray arrayWithCapacity:symbols.count];
     
@@ -358,6 +568,17 @@
     });
 }
 
+- (void)notifyStartDate:(NSDate *)date dayNumber:(NSInteger)dayNumber totalDays:(NSInteger)totalDays {
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if ([self.delegate respondsToSelector:@selector(backtestRunner:didStartDate:dayNumber:totalDays:)]) {
+            [self.delegate backtestRunner:self
+                             didStartDate:date
+                                dayNumber:dayNumber
+                                totalDays:totalDays];
+        }
+    });
+}
+
 - (void)notifyCancel {
     dispatch_async(dispatch_get_main_queue(), ^{
         if ([self.delegate respondsToSelector:@selector(backtestRunnerDidCancel:)]) {
@@ -373,7 +594,8 @@
     
     for (ScreenerModel *model in models) {
         for (ScreenerStep *step in model.steps) {
-            BaseScreener *screener = [[ScreenerRegistry sharedRegistry] screenerWithID:step.screenerID];
+            BaseScreener *screener = [[ScreenerRegistry sharedRegistry] screenerWithID:step.screenerID
+                                                                             parameters:step.parameters];
             if (screener && screener.minBarsRequired > maxBars) {
                 maxBars = screener.minBarsRequired;
             }
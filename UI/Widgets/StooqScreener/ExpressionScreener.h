@@ -0,0 +1,33 @@
+//
+//  ExpressionScreener.h
+//  TradingApp
+//
+//  Screener defined by a JSON definition instead of code.
+//  Definition keys:
+//    screenerID   Unique identifier (required)
+//    displayName  Name shown in the UI (defaults to screenerID)
+//    description  Description text
+//    parameters   Default parameters, referenced as $name in conditions
+//    conditions   Array of condition strings, all must hold (or "condition": one string)
+//  See ScreenerExpression.h for the condition language.
+//
+
+#import "BaseScreener.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface ExpressionScreener : BaseScreener
+
+/**
+ * Create a screener from a definition
+ * The conditions are compiled with the default parameters to validate them.
+ * @return Screener, or nil with error if the definition is invalid
+ */
++ (nullable instancetype)screenerWithDefinition:(NSDictionary *)definition error:(NSError **)error;
+
+/// Definition this screener was created from
+@property (nonatomic, readonly, copy) NSDictionary *definition;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,170 @@
+//
+//  ExpressionScreener.m
+//  TradingApp
+//
+
+#import "ExpressionScreener.h"
+#import "ScreenerExpression.h"
+
+@interface ExpressionScreener ()
+@property (nonatomic, readwrite, copy) NSDictionary *definition;
+@property (nonatomic, copy) NSArray<NSString *> *conditions;
+@end
+
+@implementation ExpressionScreener {
+    ScreenerExpressionProgram *_program;    // Compilato alla prima richiesta con i parametri correnti
+    BOOL _compileFailed;
+}
+
+#pragma mark - Initialization
+
+#if DEBUG
++ (void)initialize {
+    if (self != [ExpressionScreener class]) return;
+    
+    // Una definizione con una condizione non valida dopo una valida va rifiutata per intero
+    NSDictionary *invalid = @{@"screenerID": @"debug_invalid_second_condition",
+                              @"conditions": @[@"close > 1", @"sma(close"]};
+    NSAssert([self screenerWithDefinition:invalid error:nil] == nil,
+             @"ExpressionScreener accepted a definition with an invalid condition");
+}
+#endif
+
++ (instancetype)screenerWithDefinition:(NSDictionary *)definition error:(NSError **)error {
+    NSString *screenerID = definition[@"screenerID"];
+    id conditions = definition[@"conditions"] ?: definition[@"condition"];
+    if ([conditions isKindOfClass:[NSString class]]) {
+        conditions = @[conditions];
+    }
+    
+    if (![screenerID isKindOfClass:[NSString class]] || screenerID.length == 0 ||
+        ![conditions isKindOfClass:[NSArray class]] || [conditions count] == 0) {
+        if (error) {
+            *error = [NSError errorWithDomain:@"ExpressionScreener"
+                                         code:1
+                                     userInfo:@{NSLocalizedDescriptionKey: @"Definition needs a screenerID and at least one condition"}];
+        }
+        return nil;
+    }
+    
+    for (id condition in conditions) {
+        if (![condition isKindOfClass:[NSString class]]) {
+            if (error) {
+                *error = [NSError errorWithDomain:@"ExpressionScreener"
+                                             code:2
+                                         userInfo:@{NSLocalizedDescriptionKey: @"Conditions must be strings"}];
+            }
+            return nil;
+        }
+    }
+    
+    ExpressionScreener *screener = [[self alloc] init];
+    screener.definition = definition;
+    screener.conditions = conditions;
+    
+    // Validazione con i parametri di default
+    if (![ScreenerExpressionProgram programWithConditions:conditions
+                                               parameters:screener.defaultParameters
+                                                    error:error]) {
+        return nil;
+    }
+    
+    return screener;
+}
+
+- (BaseScreener *)instanceWithParameters:(NSDictionary *)parameters {
+    ExpressionScreener *screener = [[ExpressionScreener alloc] initWithParameters:parameters];
+    screener.definition = self.definition;
+    screener.conditions = self.conditions;
+    return screener;
+}
+
+#pragma mark - BaseScreener Overrides
+
+- (NSString *)screenerID {
+    return self.definition[@"screenerID"] ?: [super screenerID];
+}
+
+- (NSString *)displayName {
+    return self.definition[@"displayName"] ?: self.screenerID;
+}
+
+- (NSString *)descriptionText {
+    return self.definition[@"description"] ?: [self.conditions componentsJoinedByString:@" and "];
+}
+
+- (NSDictionary *)defaultParameters {
+    NSDictionary *defaults = self.definition[@"parameters"];
+    return [defaults isKindOfClass:[NSDictionary class]] ? defaults : @{};
+}
+
+- (void)setParameters:(NSDictionary *)parameters {
+    [super setParameters:parameters];
+    @synchronized (self) {
+        _program = nil;
+        _compileFailed = NO;
+    }
+}
+
+- (NSInteger)minBarsRequired {
+    ScreenerExpressionProgram *program = [self program];
+    return program ? program.minBarsRequired : 1;
+}
+
+#pragma mark - Program
+
+- (nullable ScreenerExpressionProgram *)program {
+    @synchronized (self) {
+        if (!_program && !_compileFailed) {
+            NSMutableDictionary *parameters = [self.defaultParameters mutableCopy];
+            [parameters addEntriesFromDictionary:self.parameters ?: @{}];
+            
+            NSError *error;
+            _program = [ScreenerExpressionProgram programWithConditions:self.conditions
+                                                             parameters:parameters
+                                                                  error:&error];
+            if (!_program) {
+                _compileFailed = YES;
+                NSLog(@"❌ ExpressionScreener %@: %@", self.screenerID, error.localizedDescription);
+            }
+        }
+        return _program;
+    }
+}
+
+#pragma mark - Execution
+
+- (void)prepareForExecution {
+    [self program];
+}
+
+// Dopo prepareForExecution _program non cambia più: letto senza lock dai thread di valutazione
+- (BOOL)evaluateSymbol:(NSString *)symbol bars:(NSArray<HistoricalBarModel *> *)bars {
+    ScreenerExpressionProgram *program = _program;
+    if (!program) return NO;
+    
+    BarSeries *series = [BarSeries backingSeriesOfBars:bars];
+    if (!series) {
+        // Array di modelli: si copiano solo le barre che il programma legge
+        NSInteger window = program.needsFullHistory ? bars.count : MIN((NSInteger)bars.count, program.lookback + 1);
+        series = [BarSeries seriesWithBars:[bars subarrayWithRange:NSMakeRange(bars.count - window, window)]];
+    }
+    return [program evaluateLastBarOfSeries:series];
+}
+
+#pragma mark - Whole-History Signals
+
+- (BOOL)supportsSignalSeries {
+    return YES;
+}
+
+- (NSData *)signalsForSymbol:(NSString *)symbol series:(BarSeries *)series {
+    NSMutableData *signals = [NSMutableData dataWithLength:ScreenerSignalWordCount(series.count) * sizeof(uint64_t)];
+    ScreenerExpressionProgram *program = _program;
+    if (program) {
+        [program evaluateSeries:series signals:signals.mutableBytes fromIndex:program.minBarsRequired - 1];
+    }
+    return signals;
+}
+
+@end
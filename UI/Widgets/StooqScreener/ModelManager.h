@@ -8,6 +8,8 @@
 #import <Foundation/Foundation.h>
 #import "ScreenerModel.h"
 
+@class ExpressionScreener;
+
 NS_ASSUME_NONNULL_BEGIN
 
 @interface ModelManager : NSObject
@@ -41,6 +43,18 @@ NS_ASSUME_NONNULL_BEGIN
 /// Refresh models from disk
 - (void)refreshModels;
 
+#pragma mark - Expression Screeners
+
+/// Directory with declarative screener definitions (*.json, see ExpressionScreener)
++ (NSString *)screenerDefinitionsDirectory;
+
+/// Compile every definition on disk and register it in ScreenerRegistry
+/// Called by refreshModels before the models are loaded, so steps can reference them.
+/// Definitions using a built-in screener ID are skipped; expression screeners
+/// no longer on disk are unregistered.
+/// @return Screeners that compiled successfully
+- (NSArray<ExpressionScreener *> *)loadScreenerDefinitions;
+
 #pragma mark - Available Models
 
 /// All loaded models
@@ -4,6 +4,8 @@
 //
 
 #import "ModelManager.h"
+#import "ExpressionScreener.h"
+#import "ScreenerRegistry.h"
 
 @interface ModelManager ()
 @property (nonatomic, strong) NSMutableArray<ScreenerModel *> *models;
@@ -144,6 +146,7 @@
 }
 
 - (void)refreshModels {
+    [self loadScreenerDefinitions];
     NSArray *loadedModels = [self loadAllModels];
     
     [self.models removeAllObjects];
@@ -155,6 +158,70 @@
     }
 }
 
+#pragma mark - Expression Screeners
+
++ (NSString *)screenerDefinitionsDirectory {
+    NSString *modelsDir = [self modelsDirectory];
+    return [[modelsDir stringByDeletingLastPathComponent] stringByAppendingPathComponent:@"ScreenerDefinitions"];
+}
+
+- (NSArray<ExpressionScreener *> *)loadScreenerDefinitions {
+    ScreenerRegistry *registry = [ScreenerRegistry sharedRegistry];
+    NSString *dir = [ModelManager screenerDefinitionsDirectory];
+    NSArray *files = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:dir error:nil];
+    
+    NSMutableArray<ExpressionScreener *> *screeners = [NSMutableArray array];
+    NSMutableSet<NSString *> *loadedIDs = [NSMutableSet set];
+    
+    for (NSString *filename in files) {
+        if (![filename hasSuffix:@".json"]) continue;
+        
+        NSString *filePath = [dir stringByAppendingPathComponent:filename];
+        NSData *data = [NSData dataWithContentsOfFile:filePath];
+        NSError *error;
+        id json = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:&error] : nil;
+        
+        // Un file può contenere una definizione o un array di definizioni
+        NSArray *definitions = [json isKindOfClass:[NSArray class]] ? json : (json ? @[json] : @[]);
+        if (definitions.count == 0) {
+            NSLog(@"⚠️ Failed to read screener definitions from %@: %@", filename, error.localizedDescription);
+            continue;
+        }
+        
+        for (id definition in definitions) {
+            ExpressionScreener *screener = nil;
+            error = nil;
+            if ([definition isKindOfClass:[NSDictionary class]]) {
+                screener = [ExpressionScreener screenerWithDefinition:definition error:&error];
+            }
+            
+            if (screener && [registry isBuiltInScreener:screener.screenerID]) {
+                NSLog(@"⚠️ Screener definition in %@ ignored: ID '%@' is a built-in screener",
+                      filename, screener.screenerID);
+            } else if (screener) {
+                [screeners addObject:screener];
+                [loadedIDs addObject:screener.screenerID];
+            } else {
+                NSLog(@"⚠️ Invalid screener definition in %@: %@", filename,
+                      error.localizedDescription ?: @"not a JSON object");
+            }
+        }
+    }
+    
+    // Definizioni rimosse dal disco: via dal registry prima di registrare le nuove
+    for (BaseScreener *registered in [registry allScreeners]) {
+        if ([registered isKindOfClass:[ExpressionScreener class]] && ![loadedIDs containsObject:registered.screenerID]) {
+            [registry unregisterScreenerWithID:registered.screenerID];
+        }
+    }
+    for (ExpressionScreener *screener in screeners) {
+        [registry registerScreener:screener];
+    }
+    
+    NSLog(@"🧮 Loaded %lu expression screeners", (unsigned long)screeners.count);
+    return [screeners copy];
+}
+
 #pragma mark - Available Models
 
 - (NSArray<ScreenerModel *> *)allModels {
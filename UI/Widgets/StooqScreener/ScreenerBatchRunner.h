@@ -13,6 +13,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 @class ScreenerBatchRunner;
 
+/// User defaults key (BOOL) behind optimizeStepOrder
+extern NSString *const ScreenerBatchRunnerOptimizeStepOrderKey;
+
 // ============================================================================
 // BATCH RUNNER DELEGATE
 // ============================================================================
@@ -26,6 +29,9 @@ NS_ASSUME_NONNULL_BEGIN
 /// Called when data loading starts
 - (void)batchRunner:(ScreenerBatchRunner *)runner didStartLoadingDataForSymbols:(NSInteger)symbolCount;
 
+/// Called as the data manager parses the universe (completed/total symbols)
+- (void)batchRunner:(ScreenerBatchRunner *)runner didLoadDataForSymbols:(NSInteger)completedCount total:(NSInteger)totalCount;
+
 /// Called when data loading completes
 - (void)batchRunner:(ScreenerBatchRunner *)runner didFinishLoadingData:(NSDictionary *)cache;
 
@@ -58,6 +64,14 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, strong) StooqDataManager *dataManager;
 @property (nonatomic, readonly) BOOL isRunning;
 
+/**
+ * Reorder chains of "previous" filter steps by recorded cost and pass rate
+ * (ScreenerStepStatistics) so cheap, selective steps run first.
+ * Final symbols are unchanged; only the order of the step results differs.
+ * Stored in user defaults (ScreenerBatchRunnerOptimizeStepOrderKey), default NO.
+ */
+@property (nonatomic, assign) BOOL optimizeStepOrder;
+
 #pragma mark - Initialization
 
 - (instancetype)initWithDataManager:(StooqDataManager *)dataManager;
@@ -7,7 +7,22 @@
 #import "ScreenerRegistry.h"
 #import "BaseScreener.h"
 #import "ScreenedSymbol.h"
+#import "ScreenerIndicatorMemo.h"
+#import "ScreenerStepStatistics.h"
 
+NSString *const ScreenerBatchRunnerOptimizeStepOrderKey = @"ScreenerOptimizeStepOrder";
+
+/// Nodo del grafo degli step: uno per ogni (input, screener, parametri) distinto tra i modelli
+@interface ScreenerStepNode : NSObject
+@property (nonatomic, copy) NSString *key;
+@property (nonatomic, strong) ScreenerStep *step;
+@property (nonatomic, strong, nullable) ScreenerStepNode *parent;   // nil = universo
+@property (nonatomic, assign) NSInteger depth;
+@property (nonatomic, strong, nullable) StepResult *result;         // nil = non eseguito (input vuoto / cancel)
+@end
+
+@implementation ScreenerStepNode
+@end
 
 @interface ScreenerBatchRunner ()
 @property (nonatomic, assign) BOOL isRunning;
@@ -28,6 +43,16 @@
     return self;
 }
 
+#pragma mark - Settings
+
+- (BOOL)optimizeStepOrder {
+    return [[NSUserDefaults standardUserDefaults] boolForKey:ScreenerBatchRunnerOptimizeStepOrderKey];
+}
+
+- (void)setOptimizeStepOrder:(BOOL)optimizeStepOrder {
+    [[NSUserDefaults standardUserDefaults] setBool:optimizeStepOrder forKey:ScreenerBatchRunnerOptimizeStepOrderKey];
+}
+
 #pragma mark - Execution
 
 - (void)executeModels:(NSArray<ScreenerModel *> *)models
@@ -105,6 +130,11 @@
         
         [self.dataManager loadDataForSymbols:finalUniverse
                                      minBars:maxBarsRequired
+                                    progress:^(NSInteger completedSymbols, NSInteger totalSymbols) {
+            if ([self.delegate respondsToSelector:@selector(batchRunner:didLoadDataForSymbols:total:)]) {
+                [self.delegate batchRunner:self didLoadDataForSymbols:completedSymbols total:totalSymbols];
+            }
+        }
                                   completion:^(NSDictionary<NSString *,NSArray<HistoricalBarModel *> *> *cache, NSError *error) {
             cachedData = cache;
             dispatch_semaphore_signal(dataSemaphore);
@@ -125,43 +155,27 @@
         
         NSLog(@"✅ Data loaded: %lu symbols with sufficient data", (unsigned long)cachedData.count);
         
-        // Step 4: Execute each model sequentially
-        NSMutableDictionary<NSString *, ModelResult *> *results = [NSMutableDictionary dictionary];
-        NSInteger completedModels = 0;
-        
+        // Step 4: Execute all models as one graph of steps
+        // Step identici (stesso input, screener e parametri) sono eseguiti una volta sola;
+        // gli indicatori (SMA, EMA, ATR) sono calcolati una volta per simbolo e condivisi tra step e modelli
         for (ScreenerModel *model in models) {
-            if (self.isCancelled) break;
-            
             dispatch_async(dispatch_get_main_queue(), ^{
                 if ([self.delegate respondsToSelector:@selector(batchRunner:didStartModel:)]) {
                     [self.delegate batchRunner:self didStartModel:model];
                 }
             });
-            
-            ModelResult *result = [self executeModelSync:model
-                                                 universe:[cachedData allKeys]
-                                               cachedData:cachedData];
-            
-            if (result) {
-                results[model.modelID] = result;
-                
-                dispatch_async(dispatch_get_main_queue(), ^{
-                    if ([self.delegate respondsToSelector:@selector(batchRunner:didFinishModel:)]) {
-                        [self.delegate batchRunner:self didFinishModel:result];
-                    }
-                });
-            }
-            
-            completedModels++;
-            double progress = (double)completedModels / (double)models.count;
-            
-            dispatch_async(dispatch_get_main_queue(), ^{
-                if ([self.delegate respondsToSelector:@selector(batchRunner:didUpdateProgress:)]) {
-                    [self.delegate batchRunner:self didUpdateProgress:progress];
-                }
-            });
         }
         
+        ScreenerIndicatorMemo *indicatorMemo = [[ScreenerIndicatorMemo alloc] init];
+        NSDictionary<NSString *, ModelResult *> *results = [self executeModelsSync:models
+                                                                          universe:[cachedData allKeys]
+                                                                        cachedData:cachedData
+                                                                     indicatorMemo:indicatorMemo
+                                                                     reportResults:YES];
+        
+        NSLog(@"🧠 Indicator memo: %ld columns computed, %ld reused",
+              (long)indicatorMemo.computedCount, (long)indicatorMemo.hitCount);
+        
         // Step 5: Finish
         [self finishWithResults:results error:nil completion:completion];
     });
@@ -173,7 +187,12 @@
           completion:(void (^)(ModelResult *, NSError *))completion {
     
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-        ModelResult *result = [self executeModelSync:model universe:universe cachedData:cachedData];
+        NSDictionary<NSString *, ModelResult *> *results = [self executeModelsSync:@[model]
+                                                                          universe:universe
+                                                                        cachedData:cachedData
+                                                                     indicatorMemo:[[ScreenerIndicatorMemo alloc] init]
+                                                                     reportResults:NO];
+        ModelResult *result = results[model.modelID];
         
         dispatch_async(dispatch_get_main_queue(), ^{
             completion(result, nil);
@@ -184,6 +203,7 @@
 - (void)cancel {
     NSLog(@"🛑 Batch runner cancelled");
     self.isCancelled = YES;
+    [self.dataManager cancelLoading];
 }
 
 #pragma mark - Private Helpers
@@ -194,10 +214,9 @@
     
     for (ScreenerModel *model in models) {
         for (ScreenerStep *step in model.steps) {
-            BaseScreener *screener = [registry screenerWithID:step.screenerID];
+            // minBarsRequired può dipendere dai parametri
+            BaseScreener *screener = [registry screenerWithID:step.screenerID parameters:step.parameters];
             if (screener) {
-                // Set parameters before asking for minBarsRequired
-                screener.parameters = step.parameters;
                 NSInteger required = screener.minBarsRequired;
                 if (required > maxBars) {
                     maxBars = required;
@@ -209,72 +228,300 @@
     return maxBars > 0 ? maxBars : 100;  // Default to 100 if nothing found
 }
 
-- (ModelResult *)executeModelSync:(ScreenerModel *)model
-                         universe:(NSArray<NSString *> *)universe
-                       cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cachedData {
+#pragma mark - Step Graph
+
+/**
+ * Build the step graph of all models
+ * A step reading the universe is a root, a step reading "previous" is a child of the
+ * node of the previous step: models sharing a prefix share its nodes.
+ * @param modelNodes Filled with modelID → one node per step (NSNull for unknown screeners)
+ * @return Nodes grouped by depth, each level only depends on the levels before it
+ */
+- (NSArray<NSArray<ScreenerStepNode *> *> *)buildStepGraphForModels:(NSArray<ScreenerModel *> *)models
+                                                        modelNodes:(NSMutableDictionary<NSString *, NSArray *> *)modelNodes {
+    ScreenerRegistry *registry = [ScreenerRegistry sharedRegistry];
+    NSMutableDictionary<NSString *, ScreenerStepNode *> *nodesByKey = [NSMutableDictionary dictionary];
+    NSMutableArray<NSMutableArray<ScreenerStepNode *> *> *levels = [NSMutableArray array];
+    NSInteger stepCount = 0;
     
-    NSDate *startTime = [NSDate date];
-    NSLog(@"▶️  Executing model: %@ (%@)", model.displayName, model.modelID);
+    for (ScreenerModel *model in models) {
+        NSMutableArray *nodes = [NSMutableArray arrayWithCapacity:model.steps.count];
+        ScreenerStepNode *previous = nil;
+        
+        for (NSInteger stepIdx = 0; stepIdx < model.steps.count; stepIdx++) {
+            ScreenerStep *step = model.steps[stepIdx];
+            stepCount++;
+            
+            if (![registry screenerWithID:step.screenerID]) {
+                [nodes addObject:[NSNull null]];   // saltato: il successivo legge ancora da previous
+                continue;
+            }
+            
+            BOOL fromPrevious = [step.inputSource isEqualToString:@"previous"] && stepIdx > 0;
+            ScreenerStepNode *parent = fromPrevious ? previous : nil;
+            NSString *key = [NSString stringWithFormat:@"%@\n%@", parent.key ?: @"", step.canonicalKey];
+            
+            ScreenerStepNode *node = nodesByKey[key];
+            if (!node) {
+                node = [[ScreenerStepNode alloc] init];
+                node.key = key;
+                node.step = step;
+                node.parent = parent;
+                node.depth = parent ? parent.depth + 1 : 0;
+                nodesByKey[key] = node;
+                
+                if (levels.count <= node.depth) {
+                    [levels addObject:[NSMutableArray array]];
+                }
+                [levels[node.depth] addObject:node];
+            }
+            
+            [nodes addObject:node];
+            previous = node;
+        }
+        
+        modelNodes[model.modelID] = [nodes copy];
+    }
     
-    ModelResult *result = [[ModelResult alloc] init];
-    result.modelID = model.modelID;
-    result.modelName = model.displayName;
-    result.initialUniverseSize = universe.count;
+    NSLog(@"🕸️ Step graph: %ld steps → %lu nodes in %lu levels",
+          (long)stepCount, (unsigned long)nodesByKey.count, (unsigned long)levels.count);
+    return [levels copy];
+}
+
+- (void)executeStepNode:(ScreenerStepNode *)node
+               universe:(NSArray<NSString *> *)universe
+             cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cachedData
+          indicatorMemo:(ScreenerIndicatorMemo *)indicatorMemo {
     
-    NSMutableArray<StepResult *> *stepResults = [NSMutableArray array];
-    ScreenerRegistry *registry = [ScreenerRegistry sharedRegistry];
+    // Input: output del nodo padre, o l'universo per le radici
+    NSArray<NSString *> *input = node.parent ? node.parent.result.symbols : universe;
+    if (input.count == 0 || self.isCancelled) return;
     
-    NSArray<NSString *> *currentInput = universe;
+    NSDate *stepStartTime = [NSDate date];
     
-    // Execute each step sequentially
-    for (NSInteger stepIdx = 0; stepIdx < model.steps.count; stepIdx++) {
-        ScreenerStep *step = model.steps[stepIdx];
+    // Own instance, bound to this step's parameters: nodes run concurrently
+    ScreenerStep *step = node.step;
+    BaseScreener *screener = [[ScreenerRegistry sharedRegistry] screenerWithID:step.screenerID parameters:step.parameters];
+    screener.indicatorMemo = indicatorMemo;
+    
+    NSArray<NSString *> *output = [screener executeOnSymbols:input cachedData:cachedData];
+    
+    StepResult *stepResult = [[StepResult alloc] init];
+    stepResult.screenerID = screener.screenerID;
+    stepResult.screenerName = screener.displayName;
+    stepResult.symbols = output;
+    stepResult.inputCount = input.count;
+    stepResult.executionTime = [[NSDate date] timeIntervalSinceDate:stepStartTime];
+    node.result = stepResult;
+    
+    [[ScreenerStepStatistics sharedStatistics] recordStep:step
+                                               inputCount:input.count
+                                              outputCount:output.count
+                                            executionTime:stepResult.executionTime];
+    
+    NSLog(@"  ✓ Node %@ (depth %ld): %ld → %lu symbols (%.2fs)",
+          screener.displayName,
+          (long)node.depth,
+          (long)input.count,
+          (unsigned long)output.count,
+          stepResult.executionTime);
+}
+
+/**
+ * Execute models through the shared step graph
+ * Nodes of one level run concurrently; each node's output is kept and read by its children.
+ * @param reportResults YES to send didFinishModel / progress to the delegate
+ */
+- (NSDictionary<NSString *, ModelResult *> *)executeModelsSync:(NSArray<ScreenerModel *> *)models
+                                                      universe:(NSArray<NSString *> *)universe
+                                                    cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cachedData
+                                                 indicatorMemo:(ScreenerIndicatorMemo *)indicatorMemo
+                                                 reportResults:(BOOL)reportResults {
+    
+    if (self.optimizeStepOrder) {
+        models = [self modelsWithOptimizedStepOrder:models];
+    }
+    
+    NSMutableDictionary<NSString *, NSArray *> *modelNodes = [NSMutableDictionary dictionary];
+    NSArray<NSArray<ScreenerStepNode *> *> *levels = [self buildStepGraphForModels:models modelNodes:modelNodes];
+    
+    NSInteger nodeCount = 0;
+    for (NSArray<ScreenerStepNode *> *level in levels) {
+        nodeCount += level.count;
+    }
+    NSInteger completedNodes = 0;
+    
+    for (NSArray<ScreenerStepNode *> *level in levels) {
+        if (self.isCancelled) break;
         
-        NSDate *stepStartTime = [NSDate date];
+        dispatch_apply(level.count, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+            [self executeStepNode:level[i] universe:universe cachedData:cachedData indicatorMemo:indicatorMemo];
+        });
         
-        // Determine input for this step
-        if ([step.inputSource isEqualToString:@"previous"] && stepIdx > 0) {
-            currentInput = stepResults[stepIdx - 1].symbols;
-        } else {
-            currentInput = universe;
+        completedNodes += level.count;
+        if (reportResults) {
+            double progress = nodeCount > 0 ? (double)completedNodes / (double)nodeCount : 1.0;
+            dispatch_async(dispatch_get_main_queue(), ^{
+                if ([self.delegate respondsToSelector:@selector(batchRunner:didUpdateProgress:)]) {
+                    [self.delegate batchRunner:self didUpdateProgress:progress];
+                }
+            });
         }
+    }
+    
+    [[ScreenerStepStatistics sharedStatistics] save];
+    
+    NSMutableDictionary<NSString *, ModelResult *> *results = [NSMutableDictionary dictionary];
+    for (ScreenerModel *model in models) {
+        if (self.isCancelled) break;
         
-        if (currentInput.count == 0) {
-            NSLog(@"⚠️ Step %ld (%@): No input symbols, skipping", (long)stepIdx, step.screenerID);
-            break;
+        ModelResult *result = [self resultForModel:model
+                                             nodes:modelNodes[model.modelID]
+                                          universe:universe
+                                        cachedData:cachedData];
+        results[model.modelID] = result;
+        
+        if (reportResults) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                if ([self.delegate respondsToSelector:@selector(batchRunner:didFinishModel:)]) {
+                    [self.delegate batchRunner:self didFinishModel:result];
+                }
+            });
+        }
+    }
+    
+    return [results copy];
+}
+
+#pragma mark - Step Ordering
+
+/// Step spostabile: filtro per simbolo con statistiche registrate
+- (BOOL)isReorderableStep:(ScreenerStep *)step {
+    BaseScreener *screener = [[ScreenerRegistry sharedRegistry] screenerWithID:step.screenerID];
+    return screener.isSymbolFilter && [[ScreenerStepStatistics sharedStatistics] hasStatisticsForStep:step];
+}
+
+/**
+ * Steps with every reorderable chain sorted by rank
+ * A chain is a step followed by "previous" steps: its output is the intersection of
+ * the filters on the chain input, whatever the order. The first step of the sorted
+ * chain takes the chain's input source. A chain followed by a step reading the
+ * universe is kept as is: an empty intermediate result would stop the model earlier.
+ */
+- (NSArray<ScreenerStep *> *)optimizedStepOrder:(NSArray<ScreenerStep *> *)steps {
+    ScreenerStepStatistics *statistics = [ScreenerStepStatistics sharedStatistics];
+    NSMutableArray<ScreenerStep *> *ordered = [NSMutableArray arrayWithCapacity:steps.count];
+    NSInteger chainStart = 0;
+    
+    while (chainStart < (NSInteger)steps.count) {
+        NSInteger chainEnd = chainStart + 1;
+        if ([self isReorderableStep:steps[chainStart]]) {
+            while (chainEnd < (NSInteger)steps.count &&
+                   [steps[chainEnd].inputSource isEqualToString:@"previous"] &&
+                   [self isReorderableStep:steps[chainEnd]]) {
+                chainEnd++;
+            }
         }
         
-        // Get screener
-        BaseScreener *screener = [registry screenerWithID:step.screenerID];
-        if (!screener) {
-            NSLog(@"❌ Screener not found: %@", step.screenerID);
+        NSArray<ScreenerStep *> *chain = [steps subarrayWithRange:NSMakeRange(chainStart, chainEnd - chainStart)];
+        BOOL followedByUniverse = chainEnd < (NSInteger)steps.count &&
+                                  ![steps[chainEnd].inputSource isEqualToString:@"previous"];
+        
+        NSArray<ScreenerStep *> *sorted = chain;
+        if (chain.count > 1 && !followedByUniverse) {
+            sorted = [chain sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(ScreenerStep *a, ScreenerStep *b) {
+                return [@([statistics rankForStep:a]) compare:@([statistics rankForStep:b])];
+            }];
+        }
+        
+        if ([sorted isEqualToArray:chain]) {
+            [ordered addObjectsFromArray:chain];
+        } else {
+            for (NSInteger i = 0; i < (NSInteger)sorted.count; i++) {
+                ScreenerStep *step = sorted[i];
+                NSString *inputSource = (i == 0) ? chain.firstObject.inputSource : @"previous";
+                [ordered addObject:[ScreenerStep stepWithScreenerID:step.screenerID
+                                                        inputSource:inputSource
+                                                         parameters:step.parameters]];
+            }
+        }
+        
+        chainStart = chainEnd;
+    }
+    
+    return [ordered copy];
+}
+
+- (NSArray<ScreenerModel *> *)modelsWithOptimizedStepOrder:(NSArray<ScreenerModel *> *)models {
+    NSMutableArray<ScreenerModel *> *planned = [NSMutableArray arrayWithCapacity:models.count];
+    
+    for (ScreenerModel *model in models) {
+        NSArray<ScreenerStep *> *steps = [self optimizedStepOrder:model.steps];
+        if ([steps isEqualToArray:model.steps]) {
+            [planned addObject:model];
             continue;
         }
         
-        // Set parameters
-        screener.parameters = step.parameters;
+        // Copia: il modello salvato dall'utente non cambia
+        ScreenerModel *reordered = [ScreenerModel modelWithID:model.modelID
+                                                  displayName:model.displayName
+                                                        steps:steps];
+        reordered.modelDescription = model.modelDescription;
+        [planned addObject:reordered];
         
-        // Execute screener
-        NSArray<NSString *> *output = [screener executeOnSymbols:currentInput cachedData:cachedData];
+        NSLog(@"🔀 %@: steps reordered by cost/selectivity: %@", model.displayName,
+              [[steps valueForKey:@"screenerID"] componentsJoinedByString:@" → "]);
+    }
+    
+    return [planned copy];
+}
+
+/// Risultato di un modello dai nodi già eseguiti del suo percorso nel grafo
+- (ModelResult *)resultForModel:(ScreenerModel *)model
+                          nodes:(NSArray *)nodes
+                       universe:(NSArray<NSString *> *)universe
+                     cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cachedData {
+    
+    NSLog(@"▶️  Model: %@ (%@)", model.displayName, model.modelID);
+    
+    ModelResult *result = [[ModelResult alloc] init];
+    result.modelID = model.modelID;
+    result.modelName = model.displayName;
+    result.initialUniverseSize = universe.count;
+    
+    NSMutableArray<StepResult *> *stepResults = [NSMutableArray array];
+    NSTimeInterval totalTime = 0.0;
+    
+    for (NSInteger stepIdx = 0; stepIdx < nodes.count; stepIdx++) {
+        ScreenerStep *step = model.steps[stepIdx];
         
-        NSTimeInterval stepDuration = [[NSDate date] timeIntervalSinceDate:stepStartTime];
+        if (nodes[stepIdx] == [NSNull null]) {
+            NSLog(@"❌ Screener not found: %@", step.screenerID);
+            continue;
+        }
         
-        // Create step result
-        StepResult *stepResult = [[StepResult alloc] init];
-        stepResult.screenerID = screener.screenerID;
-        stepResult.screenerName = screener.displayName;
-        stepResult.symbols = output;
-        stepResult.inputCount = currentInput.count;
-        stepResult.executionTime = stepDuration;
+        // Nodo non eseguito: input vuoto, il modello si ferma qui
+        StepResult *nodeResult = ((ScreenerStepNode *)nodes[stepIdx]).result;
+        if (!nodeResult) {
+            NSLog(@"⚠️ Step %ld (%@): No input symbols, skipping", (long)stepIdx, step.screenerID);
+            break;
+        }
         
+        // Copia per modello: il nodo può essere condiviso
+        StepResult *stepResult = [[StepResult alloc] init];
+        stepResult.screenerID = nodeResult.screenerID;
+        stepResult.screenerName = nodeResult.screenerName;
+        stepResult.symbols = nodeResult.symbols;
+        stepResult.inputCount = nodeResult.inputCount;
+        stepResult.executionTime = nodeResult.executionTime;
         [stepResults addObject:stepResult];
+        totalTime += stepResult.executionTime;
         
-        NSLog(@"  ✓ Step %ld (%@): %ld → %lu symbols (%.2fs)",
+        NSLog(@"  ✓ Step %ld (%@): %ld → %lu symbols",
               (long)stepIdx + 1,
-              screener.displayName,
-              (long)currentInput.count,
-              (unsigned long)output.count,
-              stepDuration);
+              stepResult.screenerName,
+              (long)stepResult.inputCount,
+              (unsigned long)stepResult.symbols.count);
     }
     
     // Set final results
@@ -310,7 +557,7 @@
     }
     
     result.screenedSymbols = [screenedSymbols copy];
-    result.totalExecutionTime = [[NSDate date] timeIntervalSinceDate:startTime];
+    result.totalExecutionTime = totalTime;
     
     return result;
 }
@@ -0,0 +1,73 @@
+//
+//  ScreenerExpression.h
+//  TradingApp
+//
+//  Small expression language for bar-relative screener conditions, compiled
+//  once into flat bytecode and evaluated column by column over a BarSeries.
+//
+//  Grammar (bars oldest → newest, [k] = k bars ago):
+//    condition  := or
+//    or         := and (("or" | "||") and)*
+//    and        := not (("and" | "&&") not)*
+//    not        := ("not" | "!") not | compare
+//    compare    := sum (("<" | "<=" | ">" | ">=" | "==" | "!=") sum)?
+//    sum        := product (("+" | "-") product)*
+//    product    := unary (("*" | "/") unary)*
+//    unary      := "-" unary | postfix
+//    postfix    := primary ("[" constant "]")*
+//    primary    := number | $parameter | field | function "(" args ")" | "(" condition ")"
+//    field      := open | high | low | close | volume
+//    function   := sma(x, n) | ema(x, n) | highest(x, n) | lowest(x, n) | atr(n)
+//                  | abs(x) | min(x, y) | max(x, y)
+//
+//  Periods and offsets must be constant (numbers or $parameters).
+//  Example: close[2] > close[3] * (1 + $gain / 100) and volume < volume[2]
+//
+
+#import <Foundation/Foundation.h>
+#import "BarSeries.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface ScreenerExpressionProgram : NSObject
+
+/**
+ * Compile conditions (ANDed) into one program
+ * Identical subexpressions are computed once; constant subexpressions are folded.
+ * @param conditions Condition strings
+ * @param parameters Values for $name references
+ * @return Program, or nil with error if any condition has a syntax error / unknown name
+ */
++ (nullable instancetype)programWithConditions:(NSArray<NSString *> *)conditions
+                                    parameters:(NSDictionary<NSString *, id> *)parameters
+                                         error:(NSError **)error;
+
+/// Bars before the evaluated one that the program reads
+@property (nonatomic, readonly) NSInteger lookback;
+
+/// YES if a recursive average (ema) makes the result depend on the whole history
+@property (nonatomic, readonly) BOOL needsFullHistory;
+
+/// Bars needed for a defined result at the last bar
+@property (nonatomic, readonly) NSInteger minBarsRequired;
+
+/// Instructions after common-subexpression elimination
+@property (nonatomic, readonly) NSInteger instructionCount;
+
+/**
+ * Result at the last bar of series
+ * Only the trailing lookback window is evaluated (whole series if needsFullHistory).
+ * Thread-safe.
+ */
+- (BOOL)evaluateLastBarOfSeries:(BarSeries *)series;
+
+/**
+ * Result at every bar in one pass
+ * @param bits Bitset of ScreenerSignalWordCount(series.count) words, bits set where the condition holds
+ * @param firstIndex Bars before this index are left clear
+ */
+- (void)evaluateSeries:(BarSeries *)series signals:(uint64_t *)bits fromIndex:(NSInteger)firstIndex;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,687 @@
+//
+//  ScreenerExpression.m
+//  TradingApp
+//
+
+#import "ScreenerExpression.h"
+#import "BaseScreener.h"
+#import "TechnicalIndicatorHelper.h"
+#include <math.h>
+
+typedef NS_ENUM(uint8_t, ScreenerExpressionOp) {
+    ScreenerExpressionOpConstant,
+    ScreenerExpressionOpField,
+    ScreenerExpressionOpShift,
+    ScreenerExpressionOpAdd,
+    ScreenerExpressionOpSubtract,
+    ScreenerExpressionOpMultiply,
+    ScreenerExpressionOpDivide,
+    ScreenerExpressionOpNegate,
+    ScreenerExpressionOpLess,
+    ScreenerExpressionOpLessEqual,
+    ScreenerExpressionOpGreater,
+    ScreenerExpressionOpGreaterEqual,
+    ScreenerExpressionOpEqual,
+    ScreenerExpressionOpNotEqual,
+    ScreenerExpressionOpAnd,
+    ScreenerExpressionOpOr,
+    ScreenerExpressionOpNot,
+    ScreenerExpressionOpAbs,
+    ScreenerExpressionOpMin,
+    ScreenerExpressionOpMax,
+    ScreenerExpressionOpSMA,
+    ScreenerExpressionOpEMA,
+    ScreenerExpressionOpHighest,
+    ScreenerExpressionOpLowest,
+    ScreenerExpressionOpATR
+};
+
+/// Un'istruzione scrive la colonna del proprio registro (= indice dell'istruzione)
+typedef struct {
+    ScreenerExpressionOp op;
+    NSInteger a;            // Registri operandi (-1 = nessuno)
+    NSInteger b;
+    NSInteger period;       // Periodo, offset o campo
+    double constant;
+    NSInteger lookback;     // Barre precedenti lette per un valore definito
+    BOOL fullHistory;
+} ScreenerExpressionInstruction;
+
+static inline BOOL ScreenerExpressionTruth(double value) {
+    return value != 0.0 && !isnan(value);
+}
+
+#pragma mark - Compiler
+
+/// Recursive-descent parser emitting instructions directly (one pass, with CSE)
+@interface ScreenerExpressionCompiler : NSObject
+@property (nonatomic, strong) NSMutableData *instructions;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *registersByKey;
+@property (nonatomic, strong) NSDictionary<NSString *, id> *parameters;
+@property (nonatomic, strong, nullable) NSError *error;
+@end
+
+@implementation ScreenerExpressionCompiler {
+    const char *_source;
+    NSInteger _position;
+    NSString *_condition;
+}
+
+- (instancetype)initWithParameters:(NSDictionary<NSString *, id> *)parameters {
+    self = [super init];
+    if (self) {
+        _instructions = [NSMutableData data];
+        _registersByKey = [NSMutableDictionary dictionary];
+        _parameters = parameters ?: @{};
+    }
+    return self;
+}
+
+- (const ScreenerExpressionInstruction *)instructionAt:(NSInteger)reg {
+    return (const ScreenerExpressionInstruction *)self.instructions.bytes + reg;
+}
+
+- (BOOL)isConstant:(NSInteger)reg {
+    return [self instructionAt:reg]->op == ScreenerExpressionOpConstant;
+}
+
+- (NSInteger)fail:(NSString *)message {
+    if (!self.error) {
+        NSString *description = [NSString stringWithFormat:@"%@ at position %ld in \"%@\"",
+                                 message, (long)_position, _condition];
+        self.error = [NSError errorWithDomain:@"ScreenerExpression"
+                                         code:1
+                                     userInfo:@{NSLocalizedDescriptionKey: description}];
+    }
+    return -1;
+}
+
+#pragma mark Emission
+
+/// Existing register for an identical instruction, or a new one
+- (NSInteger)emit:(ScreenerExpressionInstruction)instruction {
+    NSString *key = [NSString stringWithFormat:@"%d|%ld|%ld|%ld|%.17g",
+                     instruction.op, (long)instruction.a, (long)instruction.b,
+                     (long)instruction.period, instruction.constant];
+    NSNumber *existing = self.registersByKey[key];
+    if (existing) {
+        return existing.integerValue;
+    }
+
+    const ScreenerExpressionInstruction *a = instruction.a >= 0 ? [self instructionAt:instruction.a] : NULL;
+    const ScreenerExpressionInstruction *b = instruction.b >= 0 ? [self instructionAt:instruction.b] : NULL;
+    NSInteger operandLookback = MAX(a ? a->lookback : 0, b ? b->lookback : 0);
+    BOOL fullHistory = (a && a->fullHistory) || (b && b->fullHistory);
+
+    switch (instruction.op) {
+        case ScreenerExpressionOpShift:
+            instruction.lookback = operandLookback + instruction.period;
+            break;
+        case ScreenerExpressionOpSMA:
+        case ScreenerExpressionOpHighest:
+        case ScreenerExpressionOpLowest:
+            instruction.lookback = operandLookback + instruction.period - 1;
+            break;
+        case ScreenerExpressionOpEMA:
+            instruction.lookback = operandLookback + instruction.period - 1;
+            fullHistory = YES;
+            break;
+        case ScreenerExpressionOpATR:
+            instruction.lookback = instruction.period;
+            break;
+        default:
+            instruction.lookback = operandLookback;
+            break;
+    }
+    instruction.fullHistory = fullHistory;
+
+    NSInteger reg = self.instructions.length / sizeof(ScreenerExpressionInstruction);
+    [self.instructions appendBytes:&instruction length:sizeof(instruction)];
+    self.registersByKey[key] = @(reg);
+    return reg;
+}
+
+- (NSInteger)emitConstant:(double)value {
+    return [self emit:(ScreenerExpressionInstruction){ ScreenerExpressionOpConstant, -1, -1, 0, value }];
+}
+
+- (NSInteger)emitOp:(ScreenerExpressionOp)op a:(NSInteger)a b:(NSInteger)b {
+    if (a < 0 || (b < 0 && op != ScreenerExpressionOpNegate && op != ScreenerExpressionOpNot && op != ScreenerExpressionOpAbs)) {
+        return -1;
+    }
+
+    // Costanti piegate in compilazione
+    if ([self isConstant:a] && (b < 0 || [self isConstant:b])) {
+        double x = [self instructionAt:a]->constant;
+        double y = b >= 0 ? [self instructionAt:b]->constant : 0.0;
+        double result = 0.0;
+        switch (op) {
+            case ScreenerExpressionOpAdd: result = x + y; break;
+            case ScreenerExpressionOpSubtract: result = x - y; break;
+            case ScreenerExpressionOpMultiply: result = x * y; break;
+            case ScreenerExpressionOpDivide: result = x / y; break;
+            case ScreenerExpressionOpNegate: result = -x; break;
+            case ScreenerExpressionOpLess: result = x < y; break;
+            case ScreenerExpressionOpLessEqual: result = x <= y; break;
+            case ScreenerExpressionOpGreater: result = x > y; break;
+            case ScreenerExpressionOpGreaterEqual: result = x >= y; break;
+            case ScreenerExpressionOpEqual: result = x == y; break;
+            case ScreenerExpressionOpNotEqual: result = x != y; break;
+            case ScreenerExpressionOpAnd: result = ScreenerExpressionTruth(x) && ScreenerExpressionTruth(y); break;
+            case ScreenerExpressionOpOr: result = ScreenerExpressionTruth(x) || ScreenerExpressionTruth(y); break;
+            case ScreenerExpressionOpNot: result = !ScreenerExpressionTruth(x); break;
+            case ScreenerExpressionOpAbs: result = fabs(x); break;
+            case ScreenerExpressionOpMin: result = fmin(x, y); break;
+            case ScreenerExpressionOpMax: result = fmax(x, y); break;
+            default: break;
+        }
+        return [self emitConstant:result];
+    }
+
+    // Operandi commutativi in ordine canonico: a+b e b+a condividono il registro
+    if (b >= 0 && a > b && (op == ScreenerExpressionOpAdd || op == ScreenerExpressionOpMultiply ||
+                            op == ScreenerExpressionOpAnd || op == ScreenerExpressionOpOr ||
+                            op == ScreenerExpressionOpMin || op == ScreenerExpressionOpMax ||
+                            op == ScreenerExpressionOpEqual || op == ScreenerExpressionOpNotEqual)) {
+        NSInteger swap = a;
+        a = b;
+        b = swap;
+    }
+
+    return [self emit:(ScreenerExpressionInstruction){ op, a, b, 0, 0.0 }];
+}
+
+- (NSInteger)emitShift:(NSInteger)reg by:(NSInteger)offset {
+    if (reg < 0) return -1;
+    if (offset == 0 || [self isConstant:reg]) return reg;
+
+    // x[a][b] = x[a+b]
+    const ScreenerExpressionInstruction *instruction = [self instructionAt:reg];
+    if (instruction->op == ScreenerExpressionOpShift) {
+        return [self emit:(ScreenerExpressionInstruction){ ScreenerExpressionOpShift, instruction->a, -1, instruction->period + offset, 0.0 }];
+    }
+    return [self emit:(ScreenerExpressionInstruction){ ScreenerExpressionOpShift, reg, -1, offset, 0.0 }];
+}
+
+#pragma mark Tokens
+
+- (void)skipSpaces {
+    while (_source[_position] == ' ' || _source[_position] == '\t' || _source[_position] == '\n') {
+        _position++;
+    }
+}
+
+/// Consume a symbol token if it comes next
+- (BOOL)accept:(const char *)token {
+    [self skipSpaces];
+    size_t length = strlen(token);
+    if (strncmp(_source + _position, token, length) != 0) return NO;
+
+    // Le parole chiave non devono essere prefisso di un identificatore
+    if (isalpha((unsigned char)token[0])) {
+        char next = _source[_position + length];
+        if (isalnum((unsigned char)next) || next == '_') return NO;
+    }
+    _position += length;
+    return YES;
+}
+
+- (nullable NSString *)identifier {
+    [self skipSpaces];
+    NSInteger start = _position;
+    while (isalnum((unsigned char)_source[_position]) || _source[_position] == '_') {
+        _position++;
+    }
+    if (_position == start || isdigit((unsigned char)_source[start])) {
+        _position = start;
+        return nil;
+    }
+    return [[NSString alloc] initWithBytes:_source + start length:_position - start encoding:NSUTF8StringEncoding];
+}
+
+/// Constant integer argument (period / offset)
+- (NSInteger)integerFromRegister:(NSInteger)reg minimum:(NSInteger)minimum {
+    if (reg < 0) return -1;
+    if (![self isConstant:reg]) {
+        [self fail:@"Periods and offsets must be constant"];
+        return -1;
+    }
+    double value = [self instructionAt:reg]->constant;
+    if (value != floor(value) || value < minimum || value > 100000) {
+        [self fail:[NSString stringWithFormat:@"Invalid period/offset %g", value]];
+        return -1;
+    }
+    return (NSInteger)value;
+}
+
+#pragma mark Grammar
+
+- (NSInteger)compileCondition:(NSString *)condition {
+    _condition = condition;
+    _source = condition.UTF8String;
+    _position = 0;
+
+    NSInteger reg = [self parseOr];
+    if (reg >= 0) {
+        [self skipSpaces];
+        if (_source[_position] != '\0') {
+            return [self fail:@"Unexpected input"];
+        }
+    }
+    return reg;
+}
+
+- (NSInteger)parseOr {
+    NSInteger reg = [self parseAnd];
+    while (reg >= 0 && ([self accept:"||"] || [self accept:"or"])) {
+        reg = [self emitOp:ScreenerExpressionOpOr a:reg b:[self parseAnd]];
+    }
+    return reg;
+}
+
+- (NSInteger)parseAnd {
+    NSInteger reg = [self parseNot];
+    while (reg >= 0 && ([self accept:"&&"] || [self accept:"and"])) {
+        reg = [self emitOp:ScreenerExpressionOpAnd a:reg b:[self parseNot]];
+    }
+    return reg;
+}
+
+- (NSInteger)parseNot {
+    [self skipSpaces];
+    BOOL bang = _source[_position] == '!' && _source[_position + 1] != '=';
+    if (bang) _position++;
+
+    if (bang || [self accept:"not"]) {
+        return [self emitOp:ScreenerExpressionOpNot a:[self parseNot] b:-1];
+    }
+    return [self parseCompare];
+}
+
+- (NSInteger)parseCompare {
+    NSInteger reg = [self parseSum];
+    if (reg < 0) return -1;
+
+    ScreenerExpressionOp op;
+    if ([self accept:"<="]) op = ScreenerExpressionOpLessEqual;
+    else if ([self accept:">="]) op = ScreenerExpressionOpGreaterEqual;
+    else if ([self accept:"=="]) op = ScreenerExpressionOpEqual;
+    else if ([self accept:"!="]) op = ScreenerExpressionOpNotEqual;
+    else if ([self accept:"<"]) op = ScreenerExpressionOpLess;
+    else if ([self accept:">"]) op = ScreenerExpressionOpGreater;
+    else return reg;
+
+    return [self emitOp:op a:reg b:[self parseSum]];
+}
+
+- (NSInteger)parseSum {
+    NSInteger reg = [self parseProduct];
+    while (reg >= 0) {
+        if ([self accept:"+"]) {
+            reg = [self emitOp:ScreenerExpressionOpAdd a:reg b:[self parseProduct]];
+        } else if ([self accept:"-"]) {
+            reg = [self emitOp:ScreenerExpressionOpSubtract a:reg b:[self parseProduct]];
+        } else {
+            break;
+        }
+    }
+    return reg;
+}
+
+- (NSInteger)parseProduct {
+    NSInteger reg = [self parseUnary];
+    while (reg >= 0) {
+        if ([self accept:"*"]) {
+            reg = [self emitOp:ScreenerExpressionOpMultiply a:reg b:[self parseUnary]];
+        } else if ([self accept:"/"]) {
+            reg = [self emitOp:ScreenerExpressionOpDivide a:reg b:[self parseUnary]];
+        } else {
+            break;
+        }
+    }
+    return reg;
+}
+
+- (NSInteger)parseUnary {
+    if ([self accept:"-"]) {
+        return [self emitOp:ScreenerExpressionOpNegate a:[self parseUnary] b:-1];
+    }
+    return [self parsePostfix];
+}
+
+- (NSInteger)parsePostfix {
+    NSInteger reg = [self parsePrimary];
+    while (reg >= 0 && [self accept:"["]) {
+        NSInteger offset = [self integerFromRegister:[self parseSum] minimum:0];
+        if (offset < 0) return -1;
+        if (![self accept:"]"]) return [self fail:@"Expected ]"];
+        reg = [self emitShift:reg by:offset];
+    }
+    return reg;
+}
+
+- (NSInteger)parsePrimary {
+    [self skipSpaces];
+    const char *start = _source + _position;
+
+    // Numero
+    if (isdigit((unsigned char)*start) || (*start == '.' && isdigit((unsigned char)start[1]))) {
+        char *end;
+        double value = strtod(start, &end);
+        _position += end - start;
+        return [self emitConstant:value];
+    }
+
+    // $parametro
+    if ([self accept:"$"]) {
+        NSString *name = [self identifier];
+        if (!name) return [self fail:@"Expected parameter name"];
+        id value = self.parameters[name];
+        if (![value respondsToSelector:@selector(doubleValue)]) {
+            return [self fail:[NSString stringWithFormat:@"Unknown parameter $%@", name]];
+        }
+        return [self emitConstant:[value doubleValue]];
+    }
+
+    if ([self accept:"("]) {
+        NSInteger reg = [self parseOr];
+        if (reg >= 0 && ![self accept:")"]) return [self fail:@"Expected )"];
+        return reg;
+    }
+
+    NSString *name = [self identifier];
+    if (!name) return [self fail:@"Expected value"];
+
+    IndicatorBarField field = IndicatorBarFieldFromKey(name);
+    if (field <= IndicatorBarFieldVolume) {
+        return [self emit:(ScreenerExpressionInstruction){ ScreenerExpressionOpField, -1, -1, field, 0.0 }];
+    }
+
+    return [self parseFunction:name];
+}
+
+- (NSInteger)parseFunction:(NSString *)name {
+    static NSDictionary<NSString *, NSNumber *> *functions;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        functions = @{
+            @"sma": @(ScreenerExpressionOpSMA),
+            @"ema": @(ScreenerExpressionOpEMA),
+            @"highest": @(ScreenerExpressionOpHighest),
+            @"lowest": @(ScreenerExpressionOpLowest),
+            @"atr": @(ScreenerExpressionOpATR),
+            @"abs": @(ScreenerExpressionOpAbs),
+            @"min": @(ScreenerExpressionOpMin),
+            @"max": @(ScreenerExpressionOpMax)
+        };
+    });
+
+    NSNumber *opNumber = functions[name.lowercaseString];
+    if (!opNumber) return [self fail:[NSString stringWithFormat:@"Unknown name %@", name]];
+    if (![self accept:"("]) return [self fail:@"Expected ("];
+
+    ScreenerExpressionOp op = (ScreenerExpressionOp)opNumber.integerValue;
+    NSInteger reg;
+
+    switch (op) {
+        case ScreenerExpressionOpATR: {
+            NSInteger period = [self integerFromRegister:[self parseSum] minimum:1];
+            if (period < 0) return -1;
+            reg = [self emit:(ScreenerExpressionInstruction){ op, -1, -1, period, 0.0 }];
+            break;
+        }
+        case ScreenerExpressionOpAbs:
+            reg = [self emitOp:op a:[self parseSum] b:-1];
+            break;
+        case ScreenerExpressionOpMin:
+        case ScreenerExpressionOpMax: {
+            NSInteger a = [self parseSum];
+            if (a < 0) return -1;
+            if (![self accept:","]) return [self fail:@"Expected ,"];
+            reg = [self emitOp:op a:a b:[self parseSum]];
+            break;
+        }
+        default: {
+            NSInteger a = [self parseSum];
+            if (a < 0) return -1;
+            if (![self accept:","]) return [self fail:@"Expected ,"];
+            NSInteger period = [self integerFromRegister:[self parseSum] minimum:1];
+            if (period < 0) return -1;
+            reg = [self isConstant:a] ? a : [self emit:(ScreenerExpressionInstruction){ op, a, -1, period, 0.0 }];
+            break;
+        }
+    }
+
+    if (reg >= 0 && ![self accept:")"]) return [self fail:@"Expected )"];
+    return reg;
+}
+
+@end
+
+#pragma mark - Kernels
+
+/// First index with a defined (non-NaN) value
+static NSInteger ScreenerExpressionFirstDefined(const double *values, NSInteger count) {
+    NSInteger i = 0;
+    while (i < count && isnan(values[i])) i++;
+    return i;
+}
+
+static void ScreenerExpressionFillUndefined(double *output, NSInteger count) {
+    for (NSInteger i = 0; i < count; i++) output[i] = NAN;
+}
+
+/// Rolling max (sign = 1) or min (sign = -1) with a monotonic deque, O(n)
+static void ScreenerExpressionRollingExtreme(const double *values, NSInteger count, NSInteger period,
+                                             double sign, NSInteger *deque, double *output) {
+    NSInteger first = ScreenerExpressionFirstDefined(values, count);
+    ScreenerExpressionFillUndefined(output, MIN(count, first + period - 1));
+
+    NSInteger head = 0;
+    NSInteger tail = 0;
+    for (NSInteger i = first; i < count; i++) {
+        while (tail > head && sign * values[deque[tail - 1]] <= sign * values[i]) tail--;
+        deque[tail++] = i;
+        if (deque[head] <= i - period) head++;
+        if (i >= first + period - 1) output[i] = values[deque[head]];
+    }
+}
+
+#pragma mark - Program
+
+@implementation ScreenerExpressionProgram {
+    NSData *_instructions;
+    NSInteger _result;
+}
+
++ (instancetype)programWithConditions:(NSArray<NSString *> *)conditions
+                           parameters:(NSDictionary<NSString *, id> *)parameters
+                                error:(NSError **)error {
+    ScreenerExpressionCompiler *compiler = [[ScreenerExpressionCompiler alloc] initWithParameters:parameters];
+    NSInteger result = -1;
+
+    for (NSString *condition in conditions) {
+        NSInteger reg = [compiler compileCondition:condition];
+        if (reg < 0) {
+            // Una condizione non valida invalida tutto: niente AND parziale delle precedenti
+            result = -1;
+            break;
+        }
+        result = result < 0 ? reg : [compiler emitOp:ScreenerExpressionOpAnd a:result b:reg];
+    }
+
+    if (result < 0) {
+        if (error) {
+            *error = compiler.error ?: [NSError errorWithDomain:@"ScreenerExpression"
+                                                           code:2
+                                                       userInfo:@{NSLocalizedDescriptionKey: @"No conditions"}];
+        }
+        return nil;
+    }
+
+    ScreenerExpressionProgram *program = [[self alloc] init];
+    program->_instructions = [compiler.instructions copy];
+    program->_result = result;
+    return program;
+}
+
+- (const ScreenerExpressionInstruction *)resultInstruction {
+    return (const ScreenerExpressionInstruction *)_instructions.bytes + _result;
+}
+
+- (NSInteger)lookback {
+    return self.resultInstruction->lookback;
+}
+
+- (BOOL)needsFullHistory {
+    return self.resultInstruction->fullHistory;
+}
+
+- (NSInteger)minBarsRequired {
+    return self.lookback + 1;
+}
+
+- (NSInteger)instructionCount {
+    return _instructions.length / sizeof(ScreenerExpressionInstruction);
+}
+
+#pragma mark Evaluation
+
+/**
+ * Run every instruction over the whole series, one column per register
+ * @return Result column (count values), valid while storage is alive
+ */
+- (const double *)executeOnSeries:(BarSeries *)series storage:(NSMutableData *)storage {
+    NSInteger count = series.count;
+    NSInteger instructionCount = self.instructionCount;
+    const ScreenerExpressionInstruction *program = _instructions.bytes;
+
+    // Colonne dei registri + volume in double + scratch per il deque
+    storage.length = ((instructionCount + 1) * count) * sizeof(double) + count * sizeof(NSInteger);
+    double *columns = storage.mutableBytes;
+    double *volume = columns + instructionCount * count;
+    NSInteger *deque = (NSInteger *)(volume + count);
+    const double **registers = (const double **)calloc(instructionCount, sizeof(double *));
+
+    const int64_t *rawVolume = series.volume;
+    BOOL volumeLoaded = NO;
+
+    for (NSInteger r = 0; r < instructionCount; r++) {
+        const ScreenerExpressionInstruction *ins = &program[r];
+        double *out = columns + r * count;
+        const double *a = ins->a >= 0 ? registers[ins->a] : NULL;
+        const double *b = ins->b >= 0 ? registers[ins->b] : NULL;
+        registers[r] = out;
+
+        switch (ins->op) {
+            case ScreenerExpressionOpConstant:
+                for (NSInteger i = 0; i < count; i++) out[i] = ins->constant;
+                break;
+
+            case ScreenerExpressionOpField:
+                // Le colonne della serie si leggono senza copia
+                switch ((IndicatorBarField)ins->period) {
+                    case IndicatorBarFieldOpen: registers[r] = series.open; break;
+                    case IndicatorBarFieldHigh: registers[r] = series.high; break;
+                    case IndicatorBarFieldLow: registers[r] = series.low; break;
+                    case IndicatorBarFieldClose: registers[r] = series.close; break;
+                    default:
+                        if (!volumeLoaded) {
+                            for (NSInteger i = 0; i < count; i++) volume[i] = (double)rawVolume[i];
+                            volumeLoaded = YES;
+                        }
+                        registers[r] = volume;
+                        break;
+                }
+                break;
+
+            case ScreenerExpressionOpShift: {
+                NSInteger k = MIN(ins->period, count);
+                ScreenerExpressionFillUndefined(out, k);
+                for (NSInteger i = k; i < count; i++) out[i] = a[i - k];
+                break;
+            }
+
+            case ScreenerExpressionOpAdd: for (NSInteger i = 0; i < count; i++) out[i] = a[i] + b[i]; break;
+            case ScreenerExpressionOpSubtract: for (NSInteger i = 0; i < count; i++) out[i] = a[i] - b[i]; break;
+            case ScreenerExpressionOpMultiply: for (NSInteger i = 0; i < count; i++) out[i] = a[i] * b[i]; break;
+            case ScreenerExpressionOpDivide: for (NSInteger i = 0; i < count; i++) out[i] = a[i] / b[i]; break;
+            case ScreenerExpressionOpNegate: for (NSInteger i = 0; i < count; i++) out[i] = -a[i]; break;
+            case ScreenerExpressionOpLess: for (NSInteger i = 0; i < count; i++) out[i] = a[i] < b[i]; break;
+            case ScreenerExpressionOpLessEqual: for (NSInteger i = 0; i < count; i++) out[i] = a[i] <= b[i]; break;
+            case ScreenerExpressionOpGreater: for (NSInteger i = 0; i < count; i++) out[i] = a[i] > b[i]; break;
+            case ScreenerExpressionOpGreaterEqual: for (NSInteger i = 0; i < count; i++) out[i] = a[i] >= b[i]; break;
+            case ScreenerExpressionOpEqual: for (NSInteger i = 0; i < count; i++) out[i] = a[i] == b[i]; break;
+            case ScreenerExpressionOpNotEqual: for (NSInteger i = 0; i < count; i++) out[i] = a[i] != b[i] && !isnan(a[i]) && !isnan(b[i]); break;
+            case ScreenerExpressionOpAnd: for (NSInteger i = 0; i < count; i++) out[i] = ScreenerExpressionTruth(a[i]) && ScreenerExpressionTruth(b[i]); break;
+            case ScreenerExpressionOpOr: for (NSInteger i = 0; i < count; i++) out[i] = ScreenerExpressionTruth(a[i]) || ScreenerExpressionTruth(b[i]); break;
+            case ScreenerExpressionOpNot: for (NSInteger i = 0; i < count; i++) out[i] = !ScreenerExpressionTruth(a[i]); break;
+            case ScreenerExpressionOpAbs: for (NSInteger i = 0; i < count; i++) out[i] = fabs(a[i]); break;
+            case ScreenerExpressionOpMin: for (NSInteger i = 0; i < count; i++) out[i] = fmin(a[i], b[i]); break;
+            case ScreenerExpressionOpMax: for (NSInteger i = 0; i < count; i++) out[i] = fmax(a[i], b[i]); break;
+
+            case ScreenerExpressionOpSMA:
+            case ScreenerExpressionOpEMA: {
+                // Le medie partono dal primo valore definito (offset, medie annidate)
+                NSInteger first = ScreenerExpressionFirstDefined(a, count);
+                if (ins->op == ScreenerExpressionOpSMA) {
+                    [TechnicalIndicatorHelper smaSeries:a + first count:count - first period:ins->period output:out + first];
+                } else {
+                    [TechnicalIndicatorHelper emaSeries:a + first count:count - first period:ins->period output:out + first];
+                }
+                ScreenerExpressionFillUndefined(out, MIN(count, first + ins->period - 1));
+                break;
+            }
+
+            case ScreenerExpressionOpHighest:
+                ScreenerExpressionRollingExtreme(a, count, ins->period, 1.0, deque, out);
+                break;
+
+            case ScreenerExpressionOpLowest:
+                ScreenerExpressionRollingExtreme(a, count, ins->period, -1.0, deque, out);
+                break;
+
+            case ScreenerExpressionOpATR:
+                [TechnicalIndicatorHelper atrSeriesWithHigh:series.high
+                                                        low:series.low
+                                                      close:series.close
+                                                      count:count
+                                                     period:ins->period
+                                                     output:out];
+                ScreenerExpressionFillUndefined(out, MIN(count, ins->period - 1));
+                break;
+        }
+    }
+
+    const double *result = registers[_result];
+    free(registers);
+    return result;
+}
+
+- (BOOL)evaluateLastBarOfSeries:(BarSeries *)series {
+    NSInteger count = series.count;
+    if (count == 0) return NO;
+
+    // Solo la finestra che il risultato legge, salvo medie ricorsive
+    NSInteger window = self.needsFullHistory ? count : MIN(count, self.lookback + 1);
+    BarSeries *tail = window == count ? series : [series sliceWithRange:NSMakeRange(count - window, window)];
+
+    NSMutableData *storage = [NSMutableData data];
+    const double *result = [self executeOnSeries:tail storage:storage];
+    return ScreenerExpressionTruth(result[window - 1]);
+}
+
+- (void)evaluateSeries:(BarSeries *)series signals:(uint64_t *)bits fromIndex:(NSInteger)firstIndex {
+    NSInteger count = series.count;
+    if (count == 0) return;
+
+    NSMutableData *storage = [NSMutableData data];
+    const double *result = [self executeOnSeries:series storage:storage];
+    for (NSInteger i = MAX(firstIndex, 0); i < count; i++) {
+        if (ScreenerExpressionTruth(result[i])) {
+            ScreenerSignalSetBit(bits, i);
+        }
+    }
+}
+
+@end
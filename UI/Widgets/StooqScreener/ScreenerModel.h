@@ -34,6 +34,9 @@ NS_ASSUME_NONNULL_BEGIN
 - (NSDictionary *)toDictionary;
 + (instancetype)fromDictionary:(NSDictionary *)dict;
 
+/// Screener ID + parameters with sorted keys: equal for steps that filter the same way
+- (NSString *)canonicalKey;
+
 @end
 
 // ============================================================================
@@ -40,6 +40,16 @@
     return step;
 }
 
+- (NSString *)canonicalKey {
+    NSDictionary *parameters = self.parameters ?: @{};
+    NSString *parametersKey = nil;
+    if ([NSJSONSerialization isValidJSONObject:parameters]) {
+        NSData *data = [NSJSONSerialization dataWithJSONObject:parameters options:NSJSONWritingSortedKeys error:nil];
+        parametersKey = data ? [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] : nil;
+    }
+    return [NSString stringWithFormat:@"%@%@", self.screenerID, parametersKey ?: parameters.description];
+}
+
 @end
 
 // ============================================================================
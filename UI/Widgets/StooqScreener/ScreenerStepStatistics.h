@@ -0,0 +1,52 @@
+//
+//  ScreenerStepStatistics.h
+//  TradingApp
+//
+//  Cost and pass-rate history of screener steps, used to order filter chains
+//  so that cheap, selective steps run first. One entry per step canonicalKey
+//  (screener ID + parameters), smoothed over runs and persisted in user defaults.
+//  Only the most recently run steps are kept (least recently run dropped on save).
+//
+
+#import <Foundation/Foundation.h>
+#import "ScreenerModel.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface ScreenerStepStatistics : NSObject
+
++ (instancetype)sharedStatistics;
+
+/**
+ * Record one execution of a step
+ * Steps with no input are ignored. Thread-safe.
+ */
+- (void)recordStep:(ScreenerStep *)step
+        inputCount:(NSInteger)inputCount
+       outputCount:(NSInteger)outputCount
+     executionTime:(NSTimeInterval)executionTime;
+
+/// YES if the step was recorded at least once
+- (BOOL)hasStatisticsForStep:(ScreenerStep *)step;
+
+/// Average seconds per input symbol
+- (double)costPerSymbolForStep:(ScreenerStep *)step;
+
+/// Average fraction of input symbols that pass (0.0 - 1.0)
+- (double)passRateForStep:(ScreenerStep *)step;
+
+/**
+ * Position key for ordering commutative filters (lower runs first)
+ * cost / (1 - passRate): expected time spent per symbol removed.
+ */
+- (double)rankForStep:(ScreenerStep *)step;
+
+/// Write recorded statistics to user defaults, pruned to the most recently run steps
+- (void)save;
+
+/// Forget everything
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,133 @@
+//
+//  ScreenerStepStatistics.m
+//  TradingApp
+//
+
+#import "ScreenerStepStatistics.h"
+
+static NSString *const kStepStatisticsDefaultsKey = @"ScreenerStepStatistics";
+
+/// Peso dell'ultima esecuzione nella media (le run recenti contano di più)
+static const double kStepStatisticsSmoothing = 0.3;
+
+/// Step ricordati al massimo: ogni combinazione di parametri provata crea una entry
+static const NSUInteger kStepStatisticsMaxEntries = 500;
+
+@implementation ScreenerStepStatistics {
+    NSMutableDictionary<NSString *, NSDictionary *> *_entries;   // key → {cost, passRate, runs, lastRun}
+    BOOL _dirty;
+}
+
++ (instancetype)sharedStatistics {
+    static ScreenerStepStatistics *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[ScreenerStepStatistics alloc] init];
+    });
+    return sharedInstance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        NSDictionary *stored = [[NSUserDefaults standardUserDefaults] dictionaryForKey:kStepStatisticsDefaultsKey];
+        _entries = stored ? [stored mutableCopy] : [NSMutableDictionary dictionary];
+        _dirty = [self pruneEntries];
+    }
+    return self;
+}
+
+#pragma mark - Recording
+
+- (void)recordStep:(ScreenerStep *)step
+        inputCount:(NSInteger)inputCount
+       outputCount:(NSInteger)outputCount
+     executionTime:(NSTimeInterval)executionTime {
+    if (inputCount <= 0) return;
+
+    NSString *key = step.canonicalKey;
+    double cost = executionTime / (double)inputCount;
+    double passRate = MIN(1.0, (double)outputCount / (double)inputCount);
+
+    @synchronized (self) {
+        NSDictionary *entry = _entries[key];
+        NSInteger runs = [entry[@"runs"] integerValue];
+        if (entry) {
+            cost = [entry[@"cost"] doubleValue] * (1.0 - kStepStatisticsSmoothing) + cost * kStepStatisticsSmoothing;
+            passRate = [entry[@"passRate"] doubleValue] * (1.0 - kStepStatisticsSmoothing) + passRate * kStepStatisticsSmoothing;
+        }
+        _entries[key] = @{@"cost": @(cost), @"passRate": @(passRate), @"runs": @(runs + 1),
+                          @"lastRun": @([NSDate timeIntervalSinceReferenceDate])};
+        _dirty = YES;
+    }
+}
+
+#pragma mark - Queries
+
+- (nullable NSDictionary *)entryForStep:(ScreenerStep *)step {
+    NSString *key = step.canonicalKey;
+    @synchronized (self) {
+        return _entries[key];
+    }
+}
+
+- (BOOL)hasStatisticsForStep:(ScreenerStep *)step {
+    return [self entryForStep:step] != nil;
+}
+
+- (double)costPerSymbolForStep:(ScreenerStep *)step {
+    return [[self entryForStep:step][@"cost"] doubleValue];
+}
+
+- (double)passRateForStep:(ScreenerStep *)step {
+    NSDictionary *entry = [self entryForStep:step];
+    return entry ? [entry[@"passRate"] doubleValue] : 1.0;
+}
+
+- (double)rankForStep:(ScreenerStep *)step {
+    NSDictionary *entry = [self entryForStep:step];
+    if (!entry) return DBL_MAX;
+
+    // Un filtro che non scarta nulla va in fondo
+    double removed = 1.0 - [entry[@"passRate"] doubleValue];
+    return removed > 0.0 ? [entry[@"cost"] doubleValue] / removed : DBL_MAX;
+}
+
+#pragma mark - Persistence
+
+/**
+ * Drop the least recently run steps beyond kStepStatisticsMaxEntries
+ * Caller holds the lock. Entries without lastRun (older format) go first.
+ * @return YES if something was removed
+ */
+- (BOOL)pruneEntries {
+    if (_entries.count <= kStepStatisticsMaxEntries) return NO;
+    
+    NSArray<NSString *> *keys = [_entries keysSortedByValueUsingComparator:^NSComparisonResult(NSDictionary *a, NSDictionary *b) {
+        return [@([a[@"lastRun"] doubleValue]) compare:@([b[@"lastRun"] doubleValue])];
+    }];
+    NSUInteger excess = _entries.count - kStepStatisticsMaxEntries;
+    [_entries removeObjectsForKeys:[keys subarrayWithRange:NSMakeRange(0, excess)]];
+    return YES;
+}
+
+- (void)save {
+    NSDictionary *snapshot;
+    @synchronized (self) {
+        if (!_dirty) return;
+        [self pruneEntries];
+        snapshot = [_entries copy];
+        _dirty = NO;
+    }
+    [[NSUserDefaults standardUserDefaults] setObject:snapshot forKey:kStepStatisticsDefaultsKey];
+}
+
+- (void)reset {
+    @synchronized (self) {
+        [_entries removeAllObjects];
+        _dirty = NO;
+    }
+    [[NSUserDefaults standardUserDefaults] removeObjectForKey:kStepStatisticsDefaultsKey];
+}
+
+@end
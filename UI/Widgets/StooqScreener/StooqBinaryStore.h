@@ -0,0 +1,68 @@
+//
+//  StooqBinaryStore.h
+//  TradingApp
+//
+//  Persistent binary columnar copy of the Stooq text database.
+//  One pack file per exchange directory: a header, one column block per
+//  symbol (time/open/high/low/close/adjClose/volume) and an index of
+//  entries. Packs are memory-mapped and handed out as zero-copy BarSeries.
+//
+
+#import <Foundation/Foundation.h>
+#import "BarSeries.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface StooqBinaryStore : NSObject
+
+/// Directory holding the pack files
+@property (nonatomic, readonly) NSString *directory;
+
+- (instancetype)initWithDirectory:(NSString *)directory;
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Application Support location of the store for a Stooq data directory
++ (NSString *)defaultDirectoryForDataDirectory:(NSString *)dataDirectory;
+
+#pragma mark - Reading
+
+/**
+ * All bars of a CSV file as stored in its exchange pack
+ * @param sourcePath CSV the entry was built from (entries are keyed by file name).
+ *                   If its size or modification date changed since ingestion nil is returned.
+ * @param symbol Symbol given to the returned series
+ * @return Series backed by the mapped pack, or nil if missing/stale
+ *
+ * @discussion Thread-safe. Packs are mapped on first use and shared.
+ */
+- (nullable BarSeries *)seriesForSourceFile:(NSString *)sourcePath
+                                   exchange:(NSString *)exchange
+                                     symbol:(NSString *)symbol;
+
+#pragma mark - Conversion
+
+/**
+ * Build or refresh the pack of one exchange
+ * @param sourceFiles Every CSV file of the exchange
+ * @param reingestedCount Set to the number of CSV files actually parsed (optional)
+ * @return NO if the pack could not be written
+ *
+ * @discussion
+ * Incremental: entries whose CSV still has the recorded size and modification
+ * date are copied from the current pack, only changed or new files are
+ * parsed. Files no longer in sourceFiles are dropped. The new pack is
+ * written to a temporary file and renamed over the old one, so series
+ * handed out earlier stay valid. When no file changed and the file set is
+ * the one already packed, nothing is written. Synchronous - call from a background queue.
+ */
+- (BOOL)updateExchange:(NSString *)exchange
+           sourceFiles:(NSArray<NSString *> *)sourceFiles
+       reingestedCount:(nullable NSInteger *)reingestedCount
+                 error:(NSError **)error;
+
+/// Unmap every pack (they are mapped again on next access)
+- (void)closeAllPacks;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,440 @@
+//
+//  StooqBinaryStore.m
+//  TradingApp
+//
+//  Layout di un pack (little-endian, tutto allineato a 8 byte):
+//    StooqBinaryHeader
+//    blocchi colonna, uno per simbolo: time[n] open[n] high[n] low[n] close[n] adjClose[n] volume[n]
+//    StooqBinaryEntry[entryCount]
+//    nomi dei file CSV (UTF-8, non terminati)
+//
+
+#import "StooqBinaryStore.h"
+#import "StooqCSVReader.h"
+#import <sys/stat.h>
+
+static const uint32_t kStooqBinaryMagic = 0x43425153;   // "SQBC"
+static const uint32_t kStooqBinaryVersion = 1;
+static const NSInteger kStooqBinaryColumnCount = 7;
+
+/// Files parsed concurrently before their blocks are appended to the pack
+static const NSInteger kStooqBinaryWriteChunkSize = 64;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t entryCount;
+    uint64_t entriesOffset;
+    uint64_t namesOffset;
+    uint64_t namesLength;
+    char timeZone[64];          // Time zone used to turn dates into the time column
+} StooqBinaryHeader;
+
+typedef struct {
+    uint64_t nameOffset;        // CSV file name, relative to namesOffset
+    uint64_t nameLength;
+    uint64_t dataOffset;        // Column block
+    int64_t barCount;
+    int64_t sourceSize;         // CSV size at ingestion
+    double sourceModified;      // CSV mtime at ingestion (seconds since 1970)
+    StooqDate firstDate;
+    StooqDate lastDate;
+} StooqBinaryEntry;
+
+_Static_assert(sizeof(StooqBinaryHeader) % 8 == 0, "pack header must keep column blocks aligned");
+_Static_assert(sizeof(StooqBinaryEntry) % 8 == 0, "pack entries must stay aligned");
+
+#pragma mark - Helpers
+
+static NSString *StooqBinaryTimeZoneName(void) {
+    return [NSTimeZone localTimeZone].name ?: @"";
+}
+
+static BOOL StooqBinaryStatFile(NSString *path, int64_t *size, double *modified) {
+    struct stat info;
+    if (stat(path.fileSystemRepresentation, &info) != 0) {
+        return NO;
+    }
+    *size = (int64_t)info.st_size;
+    *modified = (double)info.st_mtimespec.tv_sec + (double)info.st_mtimespec.tv_nsec / 1e9;
+    return YES;
+}
+
+static NSError *StooqBinaryError(NSInteger code, NSString *description) {
+    return [NSError errorWithDomain:@"StooqBinaryStore"
+                               code:code
+                           userInfo:@{NSLocalizedDescriptionKey: description}];
+}
+
+#pragma mark - Pack
+
+/// One mapped pack file (immutable once opened)
+@interface StooqBinaryPack : NSObject
+@property (nonatomic, strong, readonly) NSData *mapped;
+@property (nonatomic, strong, readonly) NSDictionary<NSString *, NSNumber *> *entryIndexByName;
++ (nullable instancetype)packAtPath:(NSString *)path;
+- (const StooqBinaryEntry *)entryForName:(NSString *)name;
+@end
+
+@implementation StooqBinaryPack
+
++ (instancetype)packAtPath:(NSString *)path {
+    NSData *mapped = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedAlways error:nil];
+    if (mapped.length < sizeof(StooqBinaryHeader)) return nil;
+
+    const StooqBinaryHeader *header = mapped.bytes;
+    if (header->magic != kStooqBinaryMagic || header->version != kStooqBinaryVersion) {
+        NSLog(@"⚠️ StooqBinaryStore: ignoring pack with unknown format %@", path.lastPathComponent);
+        return nil;
+    }
+
+    // Le colonne time dipendono dal fuso: pack di un altro fuso vanno ricostruiti
+    char timeZone[sizeof(header->timeZone) + 1] = {0};
+    memcpy(timeZone, header->timeZone, sizeof(header->timeZone));
+    if (![@(timeZone) isEqualToString:StooqBinaryTimeZoneName()]) {
+        NSLog(@"⚠️ StooqBinaryStore: pack %@ built for time zone %s, ignoring", path.lastPathComponent, timeZone);
+        return nil;
+    }
+
+    uint64_t length = mapped.length;
+    if (header->entriesOffset + header->entryCount * sizeof(StooqBinaryEntry) > length ||
+        header->namesOffset + header->namesLength > length) {
+        NSLog(@"⚠️ StooqBinaryStore: truncated pack %@", path.lastPathComponent);
+        return nil;
+    }
+
+    const StooqBinaryEntry *entries = (const StooqBinaryEntry *)((const uint8_t *)mapped.bytes + header->entriesOffset);
+    const char *names = (const char *)mapped.bytes + header->namesOffset;
+    NSMutableDictionary<NSString *, NSNumber *> *index = [NSMutableDictionary dictionaryWithCapacity:(NSUInteger)header->entryCount];
+
+    for (uint64_t i = 0; i < header->entryCount; i++) {
+        const StooqBinaryEntry *entry = &entries[i];
+        uint64_t blockLength = (uint64_t)MAX(entry->barCount, 0) * kStooqBinaryColumnCount * sizeof(double);
+        if (entry->nameOffset + entry->nameLength > header->namesLength ||
+            entry->dataOffset % sizeof(double) != 0 ||
+            entry->dataOffset + blockLength > length) {
+            continue;
+        }
+
+        NSString *name = [[NSString alloc] initWithBytes:names + entry->nameOffset
+                                                    length:(NSUInteger)entry->nameLength
+                                                  encoding:NSUTF8StringEncoding];
+        if (name) {
+            index[name] = @(i);
+        }
+    }
+
+    StooqBinaryPack *pack = [[StooqBinaryPack alloc] init];
+    pack->_mapped = mapped;
+    pack->_entryIndexByName = [index copy];
+    return pack;
+}
+
+- (const StooqBinaryEntry *)entryForName:(NSString *)name {
+    NSNumber *position = self.entryIndexByName[name];
+    if (!position) return NULL;
+
+    const StooqBinaryHeader *header = self.mapped.bytes;
+    const StooqBinaryEntry *entries = (const StooqBinaryEntry *)((const uint8_t *)self.mapped.bytes + header->entriesOffset);
+    return &entries[position.unsignedIntegerValue];
+}
+
+@end
+
+#pragma mark - Store
+
+@interface StooqBinaryStore ()
+@property (nonatomic, strong) NSMutableDictionary<NSString *, id> *packs;   // exchange → pack or NSNull (missing)
+@end
+
+@implementation StooqBinaryStore
+
+- (instancetype)initWithDirectory:(NSString *)directory {
+    self = [super init];
+    if (self) {
+        _directory = [directory copy];
+        _packs = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
++ (NSString *)defaultDirectoryForDataDirectory:(NSString *)dataDirectory {
+    // FNV-1a del path: stabile tra esecuzioni, una cartella per database
+    NSString *standardized = dataDirectory.stringByStandardizingPath ?: @"";
+    const char *bytes = standardized.UTF8String;
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char *p = bytes; *p; p++) {
+        hash ^= (uint8_t)*p;
+        hash *= 1099511628211ULL;
+    }
+
+    NSArray *paths = NSSearchPathForDirectoriesInDomains(NSApplicationSupportDirectory, NSUserDomainMask, YES);
+    NSString *folder = [NSString stringWithFormat:@"%@-%016llx", standardized.lastPathComponent, hash];
+    return [[paths.firstObject stringByAppendingPathComponent:@"TradingApp/StooqBinaryCache"]
+            stringByAppendingPathComponent:folder];
+}
+
+- (NSString *)packPathForExchange:(NSString *)exchange {
+    NSString *name = [[exchange stringByReplacingOccurrencesOfString:@"/" withString:@"_"] lowercaseString];
+    return [self.directory stringByAppendingPathComponent:[name stringByAppendingPathExtension:@"sqbc"]];
+}
+
+- (nullable StooqBinaryPack *)packForExchange:(NSString *)exchange {
+    @synchronized (self.packs) {
+        id pack = self.packs[exchange];
+        if (!pack) {
+            pack = [StooqBinaryPack packAtPath:[self packPathForExchange:exchange]] ?: [NSNull null];
+            self.packs[exchange] = pack;
+        }
+        return pack == [NSNull null] ? nil : pack;
+    }
+}
+
+- (void)closeAllPacks {
+    @synchronized (self.packs) {
+        [self.packs removeAllObjects];
+    }
+}
+
+#pragma mark - Reading
+
+- (nullable BarSeries *)seriesForSourceFile:(NSString *)sourcePath
+                                   exchange:(NSString *)exchange
+                                     symbol:(NSString *)symbol {
+    StooqBinaryPack *pack = [self packForExchange:exchange];
+    const StooqBinaryEntry *entry = [pack entryForName:sourcePath.lastPathComponent];
+    if (!entry) return nil;
+
+    int64_t size = 0;
+    double modified = 0;
+    if (!StooqBinaryStatFile(sourcePath, &size, &modified) ||
+        size != entry->sourceSize || modified != entry->sourceModified) {
+        return nil;  // CSV aggiornato dopo la conversione
+    }
+
+    NSUInteger columnBytes = (NSUInteger)entry->barCount * sizeof(double);
+    NSUInteger offsets[kStooqBinaryColumnCount];
+    for (NSInteger c = 0; c < kStooqBinaryColumnCount; c++) {
+        offsets[c] = (NSUInteger)entry->dataOffset + c * columnBytes;
+    }
+
+    return [BarSeries seriesWithSymbol:symbol
+                             timeframe:BarTimeframeDaily
+                                 count:(NSInteger)entry->barCount
+                               storage:pack.mapped
+                         columnOffsets:offsets];
+}
+
+#pragma mark - Conversion
+
+/// Parse a CSV into a column block; fills the dates of the entry
+- (nullable NSData *)columnBlockFromCSVAtPath:(NSString *)path entry:(StooqBinaryEntry *)entry {
+    StooqDate firstDate = 0;
+    StooqDate lastDate = 0;
+    if (![StooqCSVReader dateRangeOfFileAtPath:path firstDate:&firstDate lastDate:&lastDate]) {
+        return nil;
+    }
+
+    NSData *rawBars = [StooqCSVReader barsFromFileAtPath:path targetDate:lastDate maxBars:0];
+    NSInteger count = rawBars.length / sizeof(StooqRawBar);
+    if (count == 0) return nil;
+
+    const StooqRawBar *raw = rawBars.bytes;
+    NSMutableData *block = [NSMutableData dataWithLength:count * kStooqBinaryColumnCount * sizeof(double)];
+    double *columns = block.mutableBytes;
+    NSTimeInterval *time = columns;
+    double *open = columns + count;
+    double *high = open + count;
+    double *low = high + count;
+    double *close = low + count;
+    double *adjustedClose = close + count;
+    int64_t *volume = (int64_t *)(adjustedClose + count);
+
+    for (NSInteger i = 0; i < count; i++) {
+        time[i] = [StooqCSVReader dateFromStooqDate:raw[i].date].timeIntervalSince1970;
+        open[i] = raw[i].open;
+        high[i] = raw[i].high;
+        low[i] = raw[i].low;
+        close[i] = raw[i].close;
+        adjustedClose[i] = raw[i].close;
+        volume[i] = raw[i].volume;
+    }
+
+    entry->barCount = count;
+    entry->firstDate = raw[0].date;
+    entry->lastDate = raw[count - 1].date;
+    return block;
+}
+
+/// YES if pack holds exactly sourceFiles, each with the size and modification date recorded (only stat, no parsing)
+- (BOOL)pack:(nullable StooqBinaryPack *)pack isCurrentForSourceFiles:(NSArray<NSString *> *)sourceFiles {
+    if (!pack || pack.entryIndexByName.count != sourceFiles.count) return NO;
+
+    for (NSString *path in sourceFiles) {
+        const StooqBinaryEntry *entry = [pack entryForName:path.lastPathComponent];
+        int64_t size = 0;
+        double modified = 0;
+        if (!entry || !StooqBinaryStatFile(path, &size, &modified) ||
+            entry->sourceSize != size || entry->sourceModified != modified) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+- (BOOL)updateExchange:(NSString *)exchange
+           sourceFiles:(NSArray<NSString *> *)sourceFiles
+       reingestedCount:(NSInteger *)reingestedCount
+                 error:(NSError **)error {
+
+    NSFileManager *fm = [NSFileManager defaultManager];
+    if (![fm createDirectoryAtPath:self.directory withIntermediateDirectories:YES attributes:nil error:error]) {
+        return NO;
+    }
+
+    StooqBinaryPack *oldPack = [self packForExchange:exchange];
+
+    // Database invariato (il caso di ogni avvio): niente pack nuovo, niente copia dei blocchi
+    if ([self pack:oldPack isCurrentForSourceFiles:sourceFiles]) {
+        NSLog(@"💾 StooqBinaryStore: %@ up to date (%lu files)", exchange, (unsigned long)sourceFiles.count);
+        if (reingestedCount) *reingestedCount = 0;
+        return YES;
+    }
+    NSArray<NSString *> *paths = [sourceFiles sortedArrayUsingSelector:@selector(compare:)];
+    NSInteger fileCount = paths.count;
+
+    NSString *packPath = [self packPathForExchange:exchange];
+    // Temporanei rimasti da un'interruzione: solo quelli vecchi, un writer attivo li ha appena creati
+    NSString *tempPrefix = [packPath.lastPathComponent stringByAppendingString:@"."];
+    for (NSString *name in [fm contentsOfDirectoryAtPath:self.directory error:nil]) {
+        if (![name hasPrefix:tempPrefix] || ![name hasSuffix:@".tmp"]) continue;
+        NSString *stalePath = [self.directory stringByAppendingPathComponent:name];
+        NSDate *modified = [[fm attributesOfItemAtPath:stalePath error:nil] fileModificationDate];
+        if (modified && -[modified timeIntervalSinceNow] > 24 * 3600) {
+            [fm removeItemAtPath:stalePath error:nil];
+        }
+    }
+
+    // Nome temporaneo unico: un altro writer non può rimuovere o sovrascrivere questo file
+    NSString *tempName = [NSString stringWithFormat:@"%@.%@.tmp", packPath.lastPathComponent, [NSUUID UUID].UUIDString];
+    NSString *tempPath = [self.directory stringByAppendingPathComponent:tempName];
+    if (![fm createFileAtPath:tempPath contents:nil attributes:nil]) {
+        if (error) *error = StooqBinaryError(2001, [NSString stringWithFormat:@"Cannot create %@", tempPath]);
+        return NO;
+    }
+
+    NSFileHandle *handle = [NSFileHandle fileHandleForWritingAtPath:tempPath];
+    if (!handle) {
+        [fm removeItemAtPath:tempPath error:nil];
+        if (error) *error = StooqBinaryError(2001, [NSString stringWithFormat:@"Cannot open %@", tempPath]);
+        return NO;
+    }
+    StooqBinaryHeader header = {0};
+    NSMutableData *entries = [NSMutableData dataWithCapacity:fileCount * sizeof(StooqBinaryEntry)];
+    NSMutableData *names = [NSMutableData data];
+    uint64_t writeOffset = sizeof(StooqBinaryHeader);
+    __block NSInteger reingested = 0;
+    BOOL ok = [handle writeData:[NSData dataWithBytes:&header length:sizeof(header)] error:error];
+
+    for (NSInteger chunkStart = 0; ok && chunkStart < fileCount; chunkStart += kStooqBinaryWriteChunkSize) {
+        @autoreleasepool {
+            NSInteger chunkLength = MIN(kStooqBinaryWriteChunkSize, fileCount - chunkStart);
+            NSMutableData *chunkEntries = [NSMutableData dataWithLength:chunkLength * sizeof(StooqBinaryEntry)];
+            StooqBinaryEntry *slots = chunkEntries.mutableBytes;
+            NSMutableArray *blocks = [NSMutableArray arrayWithCapacity:chunkLength];
+            for (NSInteger i = 0; i < chunkLength; i++) {
+                [blocks addObject:[NSNull null]];
+            }
+
+            // Parsing in parallelo, scrittura sequenziale: l'ordine del pack resta deterministico
+            dispatch_apply(chunkLength, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^(size_t i) {
+                @autoreleasepool {
+                    NSString *path = paths[chunkStart + i];
+                    StooqBinaryEntry *entry = &slots[i];
+
+                    if (!StooqBinaryStatFile(path, &entry->sourceSize, &entry->sourceModified)) {
+                        return;
+                    }
+
+                    NSData *block = nil;
+                    const StooqBinaryEntry *previous = [oldPack entryForName:path.lastPathComponent];
+                    if (previous && previous->sourceSize == entry->sourceSize &&
+                        previous->sourceModified == entry->sourceModified) {
+                        // CSV invariato: il blocco si copia dal pack attuale
+                        NSUInteger length = (NSUInteger)previous->barCount * kStooqBinaryColumnCount * sizeof(double);
+                        block = [oldPack.mapped subdataWithRange:NSMakeRange((NSUInteger)previous->dataOffset, length)];
+                        entry->barCount = previous->barCount;
+                        entry->firstDate = previous->firstDate;
+                        entry->lastDate = previous->lastDate;
+                    } else {
+                        block = [self columnBlockFromCSVAtPath:path entry:entry];
+                        @synchronized (blocks) {
+                            reingested++;
+                        }
+                    }
+
+                    if (block) {
+                        @synchronized (blocks) {
+                            blocks[i] = block;
+                        }
+                    }
+                }
+            });
+
+            for (NSInteger i = 0; ok && i < chunkLength; i++) {
+                NSData *block = blocks[i];
+                if ((id)block == [NSNull null]) continue;
+
+                NSData *nameData = [paths[chunkStart + i].lastPathComponent dataUsingEncoding:NSUTF8StringEncoding];
+                StooqBinaryEntry entry = slots[i];
+                entry.nameOffset = names.length;
+                entry.nameLength = nameData.length;
+                entry.dataOffset = writeOffset;
+
+                ok = [handle writeData:block error:error];
+                writeOffset += block.length;
+                [names appendData:nameData];
+                [entries appendBytes:&entry length:sizeof(entry)];
+            }
+        }
+    }
+
+    if (ok) {
+        header.magic = kStooqBinaryMagic;
+        header.version = kStooqBinaryVersion;
+        header.entryCount = entries.length / sizeof(StooqBinaryEntry);
+        header.entriesOffset = writeOffset;
+        header.namesOffset = writeOffset + entries.length;
+        header.namesLength = names.length;
+        strncpy(header.timeZone, StooqBinaryTimeZoneName().UTF8String, sizeof(header.timeZone) - 1);
+
+        ok = [handle writeData:entries error:error] &&
+             [handle writeData:names error:error] &&
+             [handle seekToOffset:0 error:error] &&
+             [handle writeData:[NSData dataWithBytes:&header length:sizeof(header)] error:error];
+    }
+    ok = [handle closeAndReturnError:ok ? error : nil] && ok;
+
+    // rename() atomico: chi ha già mappato il vecchio pack continua a leggerlo
+    if (ok && rename(tempPath.fileSystemRepresentation, packPath.fileSystemRepresentation) != 0) {
+        if (error) *error = StooqBinaryError(2002, [NSString stringWithFormat:@"Cannot replace %@", packPath]);
+        ok = NO;
+    }
+
+    if (!ok) {
+        [fm removeItemAtPath:tempPath error:nil];
+        return NO;
+    }
+
+    @synchronized (self.packs) {
+        [self.packs removeObjectForKey:exchange];
+    }
+
+    NSLog(@"💾 StooqBinaryStore: %@ → %ld files (%ld re-ingested), %.1f MB",
+          exchange, (long)header.entryCount, (long)reingested, writeOffset / (1024.0 * 1024.0));
+
+    if (reingestedCount) *reingestedCount = reingested;
+    return YES;
+}
+
+@end
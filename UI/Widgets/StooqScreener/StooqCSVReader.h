@@ -0,0 +1,72 @@
+//
+//  StooqCSVReader.h
+//  TradingApp
+//
+//  Zero-copy reader for Stooq CSV files.
+//  Maps the file in memory, seeks backwards from EOF and parses numbers
+//  directly from the byte buffer (no per-line NSString / NSArray).
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Date in Stooq format as integer (e.g. 20250131)
+typedef int32_t StooqDate;
+
+/// One parsed bar, stored contiguously inside the NSData returned by the reader
+typedef struct {
+    StooqDate date;
+    double open;
+    double high;
+    double low;
+    double close;
+    int64_t volume;
+} StooqRawBar;
+
+@interface StooqCSVReader : NSObject
+
+#pragma mark - Reading
+
+/**
+ * Read the tail of a Stooq CSV file
+ * Format: <TICKER>,<PER>,<DATE>,<TIME>,<OPEN>,<HIGH>,<LOW>,<CLOSE>,<VOL>,<OPENINT>
+ *
+ * @param filePath Path to CSV file
+ * @param targetDate Last bar to include. The file must contain exactly this date.
+ * @param maxBars Maximum bars to read backwards from targetDate (0 = all)
+ * @return NSData holding StooqRawBar structs in chronological order (oldest → newest),
+ *         or nil if the file cannot be read, ends before targetDate or does not contain it
+ *
+ * @discussion
+ * Only the lines between targetDate and the oldest requested bar are touched:
+ * the rest of the file is never paged in. Bars failing OHLC validation are
+ * skipped exactly like the old NSString-based parser did.
+ */
++ (nullable NSData *)barsFromFileAtPath:(NSString *)filePath
+                             targetDate:(StooqDate)targetDate
+                                maxBars:(NSInteger)maxBars;
+
+/**
+ * Read first and last bar date of a file without parsing prices
+ * @return YES if both dates were found
+ */
++ (BOOL)dateRangeOfFileAtPath:(NSString *)filePath
+                    firstDate:(StooqDate *)firstDate
+                     lastDate:(StooqDate *)lastDate;
+
+#pragma mark - Date Conversion
+
+/// NSDate → YYYYMMDD in the current calendar
++ (StooqDate)stooqDateFromDate:(NSDate *)date;
+
+/**
+ * YYYYMMDD → NSDate (start of day in the current calendar)
+ * Results are cached process-wide: every symbol shares the same NSDate instances.
+ * Thread-safe.
+ */
++ (NSDate *)dateFromStooqDate:(StooqDate)stooqDate;
+
+@end
+
+NS_ASSUME_NONNULL_END
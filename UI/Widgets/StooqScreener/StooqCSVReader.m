@@ -0,0 +1,325 @@
+//
+//  StooqCSVReader.m
+//  TradingApp
+//
+//  NOTA: il file viene letto all'indietro partendo da EOF.
+//  Si leggono solo le righe necessarie (target date + maxBars precedenti).
+//
+
+#import "StooqCSVReader.h"
+
+// Stooq rows have 10 fields, we never need more
+static const NSInteger kStooqMaxFields = 10;
+
+static const double kStooqPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#pragma mark - Byte Buffer Helpers
+
+/// Move *cursor back to the previous line. Returns NO at the beginning of the buffer.
+static inline BOOL StooqPreviousLine(const char *base, const char **cursor,
+                                     const char **lineStart, const char **lineEnd) {
+    const char *end = *cursor;
+    if (end <= base) return NO;
+
+    const char *start = end;
+    while (start > base && start[-1] != '\n') {
+        start--;
+    }
+
+    *lineStart = start;
+    *lineEnd = end;
+    *cursor = (start > base) ? start - 1 : base;  // skip '\n'
+    return YES;
+}
+
+/// Move *cursor forward to the next line. Returns NO at the end of the buffer.
+static inline BOOL StooqNextLine(const char *limit, const char **cursor,
+                                 const char **lineStart, const char **lineEnd) {
+    const char *start = *cursor;
+    if (start >= limit) return NO;
+
+    const char *newline = memchr(start, '\n', limit - start);
+    const char *end = newline ?: limit;
+
+    *lineStart = start;
+    *lineEnd = end;
+    *cursor = newline ? newline + 1 : limit;
+    return YES;
+}
+
+static inline BOOL StooqIsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline void StooqTrim(const char **start, const char **end) {
+    while (*start < *end && StooqIsSpace(**start)) (*start)++;
+    while (*end > *start && StooqIsSpace((*end)[-1])) (*end)--;
+}
+
+/// Split on ',' (same semantics as componentsSeparatedByString:). Returns total field count.
+static inline NSInteger StooqSplitFields(const char *start, const char *end,
+                                         const char **fieldStart, const char **fieldEnd) {
+    NSInteger count = 0;
+    const char *field = start;
+
+    for (const char *p = start; p <= end; p++) {
+        if (p == end || *p == ',') {
+            if (count < kStooqMaxFields) {
+                fieldStart[count] = field;
+                fieldEnd[count] = p;
+            }
+            count++;
+            field = p + 1;
+        }
+    }
+    return count;
+}
+
+/// YYYYMMDD → int. Requires exactly 8 digits.
+static inline BOOL StooqParseDate(const char *start, const char *end, StooqDate *outDate) {
+    if (end - start != 8) return NO;
+
+    StooqDate value = 0;
+    for (const char *p = start; p < end; p++) {
+        if (*p < '0' || *p > '9') return NO;
+        value = value * 10 + (*p - '0');
+    }
+    *outDate = value;
+    return YES;
+}
+
+/// Decimal number parser working on [start, end) without NUL terminator.
+/// Mantissa is accumulated as an integer and scaled once, so values up to
+/// 15-16 significant digits round exactly like strtod.
+static inline double StooqParseDouble(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+
+    BOOL negative = NO;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        if (significantDigits < 19) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            if (mantissa > 0) significantDigits++;
+        } else {
+            exponent++;
+        }
+    }
+
+    if (p < end && *p == '.') {
+        p++;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            if (significantDigits < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                if (mantissa > 0) significantDigits++;
+                exponent--;
+            }
+        }
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        BOOL negativeExp = NO;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negativeExp = (*p == '-');
+            p++;
+        }
+        int exp = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            if (exp < 10000) exp = exp * 10 + (*p - '0');
+        }
+        exponent += negativeExp ? -exp : exp;
+    }
+
+    double value = (double)mantissa;
+    if (exponent < 0) {
+        value = (-exponent <= 22) ? value / kStooqPow10[-exponent] : value * pow(10.0, exponent);
+    } else if (exponent > 0) {
+        value = (exponent <= 22) ? value * kStooqPow10[exponent] : value * pow(10.0, exponent);
+    }
+
+    return negative ? -value : value;
+}
+
+/// Same validation rules as the original NSString parser
+static inline BOOL StooqIsValidBar(const StooqRawBar *bar) {
+    if (bar->open <= 0 || bar->high <= 0 || bar->low <= 0 || bar->close <= 0) {
+        return NO;
+    }
+    if (bar->high < bar->low || bar->open < bar->low || bar->close < bar->low ||
+        bar->high < bar->open || bar->high < bar->close) {
+        return NO;
+    }
+    return YES;
+}
+
+typedef NS_ENUM(NSInteger, StooqTailState) {
+    StooqTailStateFindLastBar = 0,   // Ultima riga valida del file
+    StooqTailStateFindTarget,        // Riga con ESATTAMENTE la target date
+    StooqTailStateParse              // Parsing indietro per maxBars
+};
+
+@implementation StooqCSVReader
+
+#pragma mark - Reading
+
++ (nullable NSData *)barsFromFileAtPath:(NSString *)filePath
+                             targetDate:(StooqDate)targetDate
+                                maxBars:(NSInteger)maxBars {
+
+    NSError *error;
+    NSData *fileData = [NSData dataWithContentsOfFile:filePath
+                                              options:NSDataReadingMappedAlways
+                                                error:&error];
+    if (!fileData) {
+        NSLog(@"⚠️ Could not map file %@: %@", filePath, error.localizedDescription);
+        return nil;
+    }
+
+    const char *base = fileData.bytes;
+    const char *cursor = base + fileData.length;
+    const char *lineStart, *lineEnd;
+    const char *fieldStart[kStooqMaxFields];
+    const char *fieldEnd[kStooqMaxFields];
+
+    NSUInteger capacity = maxBars > 0 ? (NSUInteger)maxBars : 1024;
+    NSMutableData *output = [NSMutableData dataWithCapacity:capacity * sizeof(StooqRawBar)];
+    NSInteger parsedCount = 0;
+    StooqTailState state = StooqTailStateFindLastBar;
+
+    while (StooqPreviousLine(base, &cursor, &lineStart, &lineEnd)) {
+        if (state == StooqTailStateParse && maxBars > 0 && parsedCount >= maxBars) {
+            break;
+        }
+
+        StooqTrim(&lineStart, &lineEnd);
+        if (lineStart == lineEnd || *lineStart == '<') continue;  // empty or <TICKER> header
+
+        NSInteger fieldCount = StooqSplitFields(lineStart, lineEnd, fieldStart, fieldEnd);
+        if (fieldCount < 3) continue;
+
+        StooqDate date;
+        if (!StooqParseDate(fieldStart[2], fieldEnd[2], &date)) continue;
+
+        if (state == StooqTailStateFindLastBar) {
+            // Ultima barra < target → file troppo vecchio
+            if (date < targetDate) return nil;
+            state = StooqTailStateFindTarget;
+        }
+
+        if (state == StooqTailStateFindTarget) {
+            if (date < targetDate) return nil;   // Siamo andati troppo indietro
+            if (date > targetDate) continue;
+            state = StooqTailStateParse;
+        }
+
+        if (fieldCount < 9) continue;
+
+        StooqRawBar bar;
+        bar.date = date;
+        bar.open = StooqParseDouble(fieldStart[4], fieldEnd[4]);
+        bar.high = StooqParseDouble(fieldStart[5], fieldEnd[5]);
+        bar.low = StooqParseDouble(fieldStart[6], fieldEnd[6]);
+        bar.close = StooqParseDouble(fieldStart[7], fieldEnd[7]);
+        bar.volume = (int64_t)StooqParseDouble(fieldStart[8], fieldEnd[8]);
+
+        if (!StooqIsValidBar(&bar)) continue;
+
+        [output appendBytes:&bar length:sizeof(StooqRawBar)];
+        parsedCount++;
+    }
+
+    if (state != StooqTailStateParse) {
+        return nil;
+    }
+
+    // Reverse in place per ordine cronologico (oldest → newest)
+    StooqRawBar *bars = output.mutableBytes;
+    for (NSInteger i = 0, j = parsedCount - 1; i < j; i++, j--) {
+        StooqRawBar tmp = bars[i];
+        bars[i] = bars[j];
+        bars[j] = tmp;
+    }
+
+    return output;
+}
+
++ (BOOL)dateRangeOfFileAtPath:(NSString *)filePath
+                    firstDate:(StooqDate *)firstDate
+                     lastDate:(StooqDate *)lastDate {
+
+    NSData *fileData = [NSData dataWithContentsOfFile:filePath
+                                              options:NSDataReadingMappedAlways
+                                                error:nil];
+    if (!fileData) return NO;
+
+    const char *base = fileData.bytes;
+    const char *limit = base + fileData.length;
+    const char *lineStart, *lineEnd;
+    const char *fieldStart[kStooqMaxFields];
+    const char *fieldEnd[kStooqMaxFields];
+    BOOL foundFirst = NO, foundLast = NO;
+
+    const char *cursor = base;
+    while (!foundFirst && StooqNextLine(limit, &cursor, &lineStart, &lineEnd)) {
+        StooqTrim(&lineStart, &lineEnd);
+        if (lineStart == lineEnd || *lineStart == '<') continue;
+        if (StooqSplitFields(lineStart, lineEnd, fieldStart, fieldEnd) < 3) continue;
+        foundFirst = StooqParseDate(fieldStart[2], fieldEnd[2], firstDate);
+    }
+
+    cursor = limit;
+    while (foundFirst && !foundLast && StooqPreviousLine(base, &cursor, &lineStart, &lineEnd)) {
+        StooqTrim(&lineStart, &lineEnd);
+        if (lineStart == lineEnd || *lineStart == '<') continue;
+        if (StooqSplitFields(lineStart, lineEnd, fieldStart, fieldEnd) < 3) continue;
+        foundLast = StooqParseDate(fieldStart[2], fieldEnd[2], lastDate);
+    }
+
+    return foundFirst && foundLast;
+}
+
+#pragma mark - Date Conversion
+
++ (StooqDate)stooqDateFromDate:(NSDate *)date {
+    NSCalendar *calendar = [NSCalendar currentCalendar];
+    NSDateComponents *components = [calendar components:NSCalendarUnitYear|NSCalendarUnitMonth|NSCalendarUnitDay
+                                               fromDate:date];
+    return (StooqDate)(components.year * 10000 + components.month * 100 + components.day);
+}
+
++ (NSDate *)dateFromStooqDate:(StooqDate)stooqDate {
+    static NSMutableDictionary<NSNumber *, NSDate *> *dateCache = nil;
+    static NSCalendar *calendar = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        dateCache = [NSMutableDictionary dictionary];
+        calendar = [NSCalendar currentCalendar];
+    });
+
+    NSNumber *key = @(stooqDate);
+    @synchronized (dateCache) {
+        NSDate *date = dateCache[key];
+        if (!date) {
+            NSDateComponents *dc = [[NSDateComponents alloc] init];
+            dc.year = stooqDate / 10000;
+            dc.month = (stooqDate / 100) % 100;
+            dc.day = stooqDate % 100;
+            date = [calendar dateFromComponents:dc];
+            dateCache[key] = date;
+        }
+        return date;
+    }
+}
+
+@end
@@ -28,6 +28,8 @@ NS_ASSUME_NONNULL_BEGIN
  * This method loads data from (startDate - maxBars - safetyMargin) to endDate.
  * The cache returned contains ALL bars in this extended range, allowing
  * for efficient slicing at any date within the backtest range.
+ * If cancelLoading is called meanwhile, completion gets a nil cache and an
+ * error with code 1002 instead of partial data.
  */
 - (void)loadExtendedDataForSymbols:(NSArray<NSString *> *)symbols
                          startDate:(NSDate *)startDate
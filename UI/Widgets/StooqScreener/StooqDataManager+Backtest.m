@@ -123,18 +123,26 @@
                  toDate:(NSDate *)toDate
              completion:(void (^)(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *, NSError *))completion {
     
-    NSMutableDictionary<NSString *, NSArray<HistoricalBarModel *> *> *cache = [NSMutableDictionary dictionary];
-    NSInteger loadedCount = 0;
-    NSInteger failedCount = 0;
+    // Giorni Stooq del range: i file che non lo coprono si scartano dall'indice, senza parsing
+    StooqDate fromDay = [StooqCSVReader stooqDateFromDate:fromDate];
+    StooqDate toDay = [StooqCSVReader stooqDateFromDate:toDate];
     
-    for (NSString *symbol in symbols) {
-        @autoreleasepool {
+    // Parsing multi-core (vedi concurrentlyLoadSymbols:usingBlock:progress:cancelled:)
+    BOOL cancelled = NO;
+    NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *cache =
+        [self concurrentlyLoadSymbols:symbols
+                           usingBlock:^NSArray<HistoricalBarModel *> *(NSString *symbol) {
+            StooqDate firstDay = 0, lastDay = 0;
+            if ([self dateRangeForSymbol:symbol firstDate:&firstDay lastDate:&lastDay] &&
+                (lastDay < fromDay || firstDay > toDay)) {
+                return nil;
+            }
+            
             // Load all bars for symbol (using existing method)
             NSArray<HistoricalBarModel *> *allBars = [self loadBarsForSymbol:symbol minBars:0];
             
             if (!allBars || allBars.count == 0) {
-                failedCount++;
-                continue;
+                return nil;
             }
             
             // Filter to requested range
@@ -142,15 +150,26 @@
                                                                    fromDate:fromDate
                                                                      toDate:toDate];
             
-            if (filteredBars.count > 0) {
-                cache[symbol] = filteredBars;
-                loadedCount++;
-            } else {
-                failedCount++;
-            }
+            return filteredBars.count > 0 ? filteredBars : nil;
         }
+                             progress:nil
+                            cancelled:&cancelled];
+    
+    // Cache parziale: il chiamante non deve trattarla come completa
+    if (cancelled) {
+        NSLog(@"🛑 Range loading cancelled after %lu symbols", (unsigned long)cache.count);
+        NSError *error = [NSError errorWithDomain:@"StooqDataManager"
+                                             code:1002
+                                         userInfo:@{NSLocalizedDescriptionKey: @"Data loading cancelled"}];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(nil, error);
+        });
+        return;
     }
     
+    NSInteger loadedCount = cache.count;
+    NSInteger failedCount = symbols.count - cache.count;
+    
     if (cache.count == 0) {
         NSError *error = [NSError errorWithDomain:@"StooqDataManager"
                                              code:-2
@@ -164,7 +183,7 @@
     NSLog(@"   Loaded: %ld symbols, Failed: %ld symbols", (long)loadedCount, (long)failedCount);
     
     dispatch_async(dispatch_get_main_queue(), ^{
-        completion([cache copy], nil);
+        completion(cache, nil);
     });
 }
 
@@ -7,9 +7,18 @@
 
 #import <Foundation/Foundation.h>
 #import "RuntimeModels.h"
+#import "StooqCSVReader.h"
+
+@class StooqBinaryStore;
 
 NS_ASSUME_NONNULL_BEGIN
 
+/// Progress callback for bulk loading (always delivered on main queue)
+typedef void (^StooqLoadProgressBlock)(NSInteger completedSymbols, NSInteger totalSymbols);
+
+/// Per-symbol loader used by the concurrent loading engine
+typedef NSArray<HistoricalBarModel *> * _Nullable (^StooqSymbolLoadBlock)(NSString *symbol);
+
 @interface StooqDataManager : NSObject
 
 #pragma mark - Configuration
@@ -22,6 +31,13 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (nonatomic, strong, nullable) NSDate *targetDate;  // Data target per lo screening
 
+/// Maximum number of files parsed concurrently (0 = one worker per active core)
+@property (nonatomic, assign) NSInteger maxConcurrentLoads;
+
+/// Binary columnar copy of the database, read before the CSV files (nil = CSV only).
+/// Created for dataDirectory by default; entries whose CSV changed are ignored until refreshed.
+@property (nonatomic, strong, nullable) StooqBinaryStore *binaryStore;
+
 
 #pragma mark - Initialization
 
@@ -47,6 +63,15 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (NSDate *)expectedLastCloseDate;
 
+/**
+ * Bring the binary store up to date with the scanned exchanges
+ * Only CSV files added or modified since the last refresh are parsed;
+ * the first call converts the whole database. Refreshes are serialized:
+ * a call made while one is running starts after it (and finds little to do).
+ * @param completion Called on main queue with the number of files re-ingested
+ */
+- (void)refreshBinaryStoreWithCompletion:(nullable void (^)(NSInteger reingestedFiles, NSError *_Nullable error))completion;
+
 #pragma mark - Data Loading
 
 /**
@@ -60,6 +85,42 @@ NS_ASSUME_NONNULL_BEGIN
                    minBars:(NSInteger)minBars
                 completion:(void (^)(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *cache, NSError *_Nullable error))completion;
 
+/**
+ * Load data for specific symbols on multiple cores
+ * @param symbols Array of symbol strings
+ * @param minBars Minimum number of bars to load (from end of file)
+ * @param progress Called on main queue as chunks of symbols complete (optional)
+ * @param completion Called on main queue. If loading was cancelled, cache holds the
+ *                   symbols loaded so far and error has code 1002.
+ *
+ * @discussion
+ * Files are parsed by up to maxConcurrentLoads workers. Each worker fills its own
+ * result buffer; buffers are merged once at the end, so no locking happens per symbol.
+ */
+- (void)loadDataForSymbols:(NSArray<NSString *> *)symbols
+                   minBars:(NSInteger)minBars
+                  progress:(nullable StooqLoadProgressBlock)progress
+                completion:(void (^)(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *cache, NSError *_Nullable error))completion;
+
+/**
+ * Concurrent loading engine (synchronous - call from a background queue)
+ * @param symbols Symbols to load
+ * @param loadBlock Returns bars for a symbol, or nil to skip it. Must be thread-safe.
+ * @param progress Called on main queue as chunks complete (optional)
+ * @param cancelled Set to YES if cancelLoading was called while running (optional)
+ * @return Dictionary: symbol → bars for every symbol the block accepted
+ */
+- (NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)concurrentlyLoadSymbols:(NSArray<NSString *> *)symbols
+                                                                             usingBlock:(StooqSymbolLoadBlock)loadBlock
+                                                                               progress:(nullable StooqLoadProgressBlock)progress
+                                                                              cancelled:(nullable BOOL *)cancelled;
+
+/**
+ * Cancel every load currently in progress
+ * Workers stop at the next symbol; completions still fire with partial data.
+ */
+- (void)cancelLoading;
+
 /**
  * Load data for single symbol
  * @param symbol Symbol to load
@@ -74,10 +135,13 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  * Parse Stooq CSV file
  * Format: <TICKER>,<PER>,<DATE>,<TIME>,<OPEN>,<HIGH>,<LOW>,<CLOSE>,<VOL>,<OPENINT>
+ * The file is memory-mapped and read backwards from EOF (see StooqCSVReader)
  * @param filePath Path to CSV file
  * @param symbol Symbol name
  * @param maxBars Maximum bars to load (from end, 0 = all)
- * @return Array of HistoricalBarModel
+ * @return Array of HistoricalBarModel backed by a columnar BarSeries
+ *         (use +[BarSeries backingSeriesOfBars:] to reach the columns).
+ *         Kept in SharedBarCache, keyed by symbol, target date and maxBars.
  */
 - (nullable NSArray<HistoricalBarModel *> *)parseCSVFile:(NSString *)filePath
                                                   symbol:(NSString *)symbol
@@ -106,6 +170,16 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (NSArray<NSString *> *)symbolsForExchange:(NSString *)exchange;
 
+/**
+ * First and last date of a symbol's file, from the persisted index
+ * (re-read only if the file changed since it was indexed)
+ * Used by the range loaders to skip files that cannot cover the range.
+ * @return NO if the symbol is unknown or its file has no valid bar
+ */
+- (BOOL)dateRangeForSymbol:(NSString *)symbol
+                 firstDate:(StooqDate *)firstDate
+                  lastDate:(StooqDate *)lastDate;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -4,13 +4,29 @@
 //
 
 #import "StooqDataManager.h"
+#import "StooqCSVReader.h"
+#import "BarSeries.h"
+#import "StooqBinaryStore.h"
+#import "StooqSymbolIndex.h"
+#import "SharedBarCache.h"
+#import <sys/stat.h>
 
 @interface StooqDataManager ()
 @property (nonatomic, strong) NSMutableArray<NSString *> *symbolIndex;
 @property (nonatomic, strong) NSMutableDictionary<NSString *, NSString *> *symbolToFilePath;
+/// exchange → CSV paths, filled by the scan (feeds the binary store)
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableArray<NSString *> *> *exchangeSourceFiles;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSString *> *filePathToExchange;
+/// Persisted directory listing: unchanged directories are not enumerated again
+@property (nonatomic, strong) StooqSymbolIndex *directoryIndex;
+/// Incremented by cancelLoading: running loads stop as soon as it changes
+@property (atomic, assign) NSUInteger loadGeneration;
 // StooqDataManager.h
 @end
 
+/// Symbols handed to a worker at a time (also the progress granularity)
+static const NSInteger kStooqLoadChunkSize = 64;
+
 @implementation StooqDataManager
 
 #pragma mark - Initialization
@@ -22,6 +38,10 @@
         _selectedExchanges = @[@"nasdaq", @"nyse"];  // Default US exchanges
         _symbolIndex = [NSMutableArray array];
         _symbolToFilePath = [NSMutableDictionary dictionary];
+        _exchangeSourceFiles = [NSMutableDictionary dictionary];
+        _filePathToExchange = [NSMutableDictionary dictionary];
+        _directoryIndex = [[StooqSymbolIndex alloc] initWithPath:[StooqSymbolIndex defaultPathForDataDirectory:dataDirectory]];
+        _binaryStore = [[StooqBinaryStore alloc] initWithDirectory:[StooqBinaryStore defaultDirectoryForDataDirectory:dataDirectory]];
     }
     return self;
 }
@@ -34,6 +54,9 @@
         
         [self.symbolIndex removeAllObjects];
         [self.symbolToFilePath removeAllObjects];
+        [self.exchangeSourceFiles removeAllObjects];
+        [self.filePathToExchange removeAllObjects];
+        CFAbsoluteTime scanStart = CFAbsoluteTimeGetCurrent();
         
         NSFileManager *fm = [NSFileManager defaultManager];
         
@@ -65,11 +88,10 @@
                 NSLog(@"✅ US directory exists");
                 
                 // Scan all subdirectories in us/
-                NSError *error;
-                NSArray *subdirs = [fm contentsOfDirectoryAtPath:usDir error:&error];
+                NSArray *subdirs = [self.directoryIndex listingOfDirectory:usDir].subdirectories;
                 
                 if (!subdirs) {
-                    NSLog(@"❌ Could not read US directory: %@", error.localizedDescription);
+                    NSLog(@"❌ Could not read US directory: %@", usDir);
                 } else {
                     NSLog(@"📂 Found %lu subdirectories in US", (unsigned long)subdirs.count);
                     
@@ -78,30 +100,26 @@
                         
                         NSString *subdirPath = [usDir stringByAppendingPathComponent:subdir];
                         
-                        if ([fm fileExistsAtPath:subdirPath isDirectory:&isDir] && isDir) {
-                            // Extract exchange type (nasdaq stocks, nyse stocks, etc.)
-                            NSString *exchangeType = [subdir lowercaseString];
-                            
-                            // Only process if it matches selected exchanges
-                            BOOL shouldProcess = NO;
-                            for (NSString *exchange in self.selectedExchanges) {
-                                if ([exchangeType containsString:exchange]) {
-                                    shouldProcess = YES;
-                                    break;
-                                }
-                            }
-                            
-                            NSLog(@"  %@ Should process '%@': %@",
-                                  shouldProcess ? @"✅" : @"⏭️",
-                                  subdir,
-                                  shouldProcess ? @"YES" : @"NO");
-                            
-                            if (shouldProcess) {
-                                NSLog(@"📊 Scanning: %@", subdir);
-                                [self scanExchangeDirectory:subdirPath exchange:subdir];
+                        // Extract exchange type (nasdaq stocks, nyse stocks, etc.)
+                        NSString *exchangeType = [subdir lowercaseString];
+                        
+                        // Only process if it matches selected exchanges
+                        BOOL shouldProcess = NO;
+                        for (NSString *exchange in self.selectedExchanges) {
+                            if ([exchangeType containsString:exchange]) {
+                                shouldProcess = YES;
+                                break;
                             }
-                        } else {
-                            NSLog(@"  ⚠️ Not a directory: %@", subdir);
+                        }
+                        
+                        NSLog(@"  %@ Should process '%@': %@",
+                              shouldProcess ? @"✅" : @"⏭️",
+                              subdir,
+                              shouldProcess ? @"YES" : @"NO");
+                        
+                        if (shouldProcess) {
+                            NSLog(@"📊 Scanning: %@", subdir);
+                            [self scanExchangeDirectory:subdirPath exchange:subdir];
                         }
                     }
                 }
@@ -124,7 +142,13 @@
             }
         }
         
-        NSLog(@"✅ Scan complete. Found %lu symbols", (unsigned long)self.symbolIndex.count);
+        NSError *saveError;
+        if (![self.directoryIndex saveWithError:&saveError]) {
+            NSLog(@"⚠️ Could not save symbol index: %@", saveError.localizedDescription);
+        }
+        
+        NSLog(@"✅ Scan complete. Found %lu symbols in %.2fs",
+              (unsigned long)self.symbolIndex.count, CFAbsoluteTimeGetCurrent() - scanStart);
         
         dispatch_async(dispatch_get_main_queue(), ^{
             completion([self.symbolIndex copy], nil);
@@ -133,99 +157,56 @@
 }
 
 - (void)scanExchangeDirectory:(NSString *)exchangeDir exchange:(NSString *)exchange {
-    NSFileManager *fm = [NSFileManager defaultManager];
-    NSError *error;
-    
     NSLog(@"  🔎 scanExchangeDirectory: %@", exchangeDir);
     
-    // First check if there are .txt files directly in this directory
-    NSArray *filesInRoot = [fm contentsOfDirectoryAtPath:exchangeDir error:&error];
-    if (!filesInRoot) {
-        NSLog(@"  ❌ Could not read directory %@: %@", exchangeDir, error.localizedDescription);
+    // Listing dall'indice persistito: la directory viene enumerata solo se cambiata
+    StooqDirectoryListing *listing = [self.directoryIndex listingOfDirectory:exchangeDir];
+    if (!listing) {
+        NSLog(@"  ❌ Could not read directory %@", exchangeDir);
         return;
     }
     
-    NSLog(@"  📄 Found %lu items in directory", (unsigned long)filesInRoot.count);
-    
-    BOOL hasSubdirectories = NO;
-    NSInteger dirCount = 0;
-    NSInteger fileCount = 0;
+    NSLog(@"  📊 Items breakdown: %lu directories, %lu files",
+          (unsigned long)listing.subdirectories.count, (unsigned long)listing.files.count);
     
     // Check if this directory has subdirectories (numbered folders like 1, 2, 3)
-    for (NSString *item in filesInRoot) {
-        NSString *itemPath = [exchangeDir stringByAppendingPathComponent:item];
-        BOOL isDir;
-        if ([fm fileExistsAtPath:itemPath isDirectory:&isDir]) {
-            if (isDir) {
-                hasSubdirectories = YES;
-                dirCount++;
-            } else {
-                fileCount++;
-            }
-        }
-    }
-    
-    NSLog(@"  📊 Items breakdown: %ld directories, %ld files", (long)dirCount, (long)fileCount);
-    
-    if (hasSubdirectories) {
+    if (listing.subdirectories.count > 0) {
         NSLog(@"  ↪️  Scanning subdirectories...");
         // Scan subdirectories (numbered folders)
-        for (NSString *subdir in filesInRoot) {
+        for (NSString *subdir in listing.subdirectories) {
             NSString *subdirPath = [exchangeDir stringByAppendingPathComponent:subdir];
-            
-            BOOL isDir;
-            if (![fm fileExistsAtPath:subdirPath isDirectory:&isDir] || !isDir) {
+            StooqDirectoryListing *subdirListing = [self.directoryIndex listingOfDirectory:subdirPath];
+            if (!subdirListing) {
+                NSLog(@"      ❌ Could not read directory %@", subdirPath);
                 continue;
             }
             
-            NSLog(@"    📁 Subdirectory: %@", subdir);
-            
             // Scan files in this subdirectory
-            [self scanFilesInDirectory:subdirPath exchange:exchange];
+            [self addFilesOfListing:subdirListing inDirectory:subdirPath exchange:exchange];
         }
     } else {
         NSLog(@"  ↪️  No subdirectories, scanning files directly");
         // No subdirectories, scan files directly
-        [self scanFilesInDirectory:exchangeDir exchange:exchange];
+        [self addFilesOfListing:listing inDirectory:exchangeDir exchange:exchange];
     }
     
     NSLog(@"  ✅ Exchange %@: %lu symbols total", exchange, (unsigned long)self.symbolIndex.count);
 }
 
-- (void)scanFilesInDirectory:(NSString *)directory exchange:(NSString *)exchange {
-    NSFileManager *fm = [NSFileManager defaultManager];
-    NSError *error;
-    
-    NSArray *files = [fm contentsOfDirectoryAtPath:directory error:&error];
-    if (!files) {
-        NSLog(@"      ❌ Could not read directory %@: %@", directory, error.localizedDescription);
-        return;
+- (void)addFilesOfListing:(StooqDirectoryListing *)listing
+              inDirectory:(NSString *)directory
+                 exchange:(NSString *)exchange {
+    NSMutableArray<NSString *> *sourceFiles = self.exchangeSourceFiles[exchange];
+    if (!sourceFiles) {
+        sourceFiles = [NSMutableArray array];
+        self.exchangeSourceFiles[exchange] = sourceFiles;
     }
     
-    NSLog(@"      📄 Found %lu items to check", (unsigned long)files.count);
-    
-    NSInteger txtCount = 0;
-    NSInteger csvCount = 0;
-    NSInteger otherCount = 0;
-    NSInteger symbolsAdded = 0;
-    
-    for (NSString *filename in files) {
-        // Stooq files can be .txt or .csv
-        BOOL isTxt = [filename hasSuffix:@".txt"];
-        BOOL isCsv = [filename hasSuffix:@".csv"];
-        
-        if (isTxt) txtCount++;
-        else if (isCsv) csvCount++;
-        else otherCount++;
-        
-        if (!isTxt && !isCsv) {
-            continue;
-        }
-        
+    for (StooqIndexedFile *file in listing.files) {
         // Extract symbol from filename (e.g., "aapl.us.txt" → "AAPL.US" → "AAPL")
-        NSString *rawSymbol = [[filename stringByDeletingPathExtension] uppercaseString];
+        NSString *rawSymbol = [[file.name stringByDeletingPathExtension] uppercaseString];
         NSString *symbol = [self normalizeSymbol:rawSymbol];  // ✅ NORMALIZE HERE
-        NSString *filePath = [directory stringByAppendingPathComponent:filename];
+        NSString *filePath = [directory stringByAppendingPathComponent:file.name];
         
         [self.symbolIndex addObject:symbol];
         self.symbolToFilePath[symbol] = filePath;
@@ -236,14 +217,13 @@
             self.symbolToFilePath[rawSymbol] = filePath;
         }
         
-        symbolsAdded++;
+        [sourceFiles addObject:filePath];
+        self.filePathToExchange[filePath] = exchange;
     }
     
-    NSLog(@"      📊 Files: %ld .txt, %ld .csv, %ld other", (long)txtCount, (long)csvCount, (long)otherCount);
-    NSLog(@"      ✅ Added %ld symbols (normalized)", (long)symbolsAdded);
+    NSLog(@"      ✅ Added %lu symbols (normalized) from %@", (unsigned long)listing.files.count, directory.lastPathComponent);
 }
 
-
 - (NSArray<NSString *> *)availableSymbols {
     return [self.symbolIndex copy];
 }
@@ -252,41 +232,193 @@
     return self.symbolIndex.count;
 }
 
+#pragma mark - Binary Store
+
+- (void)refreshBinaryStoreWithCompletion:(void (^)(NSInteger, NSError *))completion {
+    StooqBinaryStore *store = self.binaryStore;
+    if (!store) {
+        if (completion) completion(0, nil);
+        return;
+    }
+    
+    NSDictionary<NSString *, NSArray<NSString *> *> *exchanges = [[NSDictionary alloc] initWithDictionary:self.exchangeSourceFiles
+                                                                                                copyItems:YES];
+    
+    // Una refresh alla volta in tutto il processo: ogni scan automatico ne lancia una
+    // e due refresh sullo stesso pack si sovrascriverebbero a vicenda
+    static dispatch_queue_t refreshQueue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        refreshQueue = dispatch_queue_create("com.tradingapp.stooq.binaryrefresh",
+                                             dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
+    });
+    
+    dispatch_async(refreshQueue, ^{
+        NSInteger totalReingested = 0;
+        NSError *error = nil;
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        
+        for (NSString *exchange in exchanges) {
+            NSInteger reingested = 0;
+            if (![store updateExchange:exchange sourceFiles:exchanges[exchange] reingestedCount:&reingested error:&error]) {
+                NSLog(@"❌ Binary store refresh failed for %@: %@", exchange, error.localizedDescription);
+                break;
+            }
+            totalReingested += reingested;
+        }
+        
+        NSLog(@"💾 Binary store refreshed in %.2fs (%ld files re-ingested)",
+              CFAbsoluteTimeGetCurrent() - start, (long)totalReingested);
+        
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completion(totalReingested, error);
+            });
+        }
+    });
+}
+
 #pragma mark - Data Loading
 
 - (void)loadDataForSymbols:(NSArray<NSString *> *)symbols
                    minBars:(NSInteger)minBars
                 completion:(void (^)(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *, NSError *))completion {
+    [self loadDataForSymbols:symbols minBars:minBars progress:nil completion:completion];
+}
+
+- (void)loadDataForSymbols:(NSArray<NSString *> *)symbols
+                   minBars:(NSInteger)minBars
+                  progress:(StooqLoadProgressBlock)progress
+                completion:(void (^)(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *, NSError *))completion {
     
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
         NSLog(@"📥 Loading data for %lu symbols (minBars: %ld)", (unsigned long)symbols.count, (long)minBars);
         
-        NSMutableDictionary *cache = [NSMutableDictionary dictionary];
-        NSInteger loadedCount = 0;
-        NSInteger skippedCount = 0;
+        NSDate *loadStartTime = [NSDate date];
         
-        for (NSString *symbol in symbols) {
-            @autoreleasepool {
-                NSArray<HistoricalBarModel *> *bars = [self loadBarsForSymbol:symbol minBars:minBars];
-                
-                if (bars && bars.count >= minBars) {
-                    cache[symbol] = bars;
-                    loadedCount++;
-                } else {
-                    skippedCount++;
-                }
-            }
+        // Target date calcolata una sola volta per tutto il batch
+        StooqDate targetDate = [StooqCSVReader stooqDateFromDate:self.targetDate ?: [self expectedLastCloseDate]];
+        
+        BOOL cancelled = NO;
+        NSDictionary *cache = [self concurrentlyLoadSymbols:symbols
+                                                 usingBlock:^NSArray<HistoricalBarModel *> *(NSString *symbol) {
+            NSArray<HistoricalBarModel *> *bars = [self loadBarsForSymbol:symbol minBars:minBars targetDate:targetDate];
+            return (bars && bars.count >= minBars) ? bars : nil;
         }
+                                                   progress:progress
+                                                  cancelled:&cancelled];
         
-        NSLog(@"✅ Data loading complete: %ld loaded, %ld skipped (insufficient data)",
-              (long)loadedCount, (long)skippedCount);
+        NSLog(@"✅ Data loading %@: %lu loaded, %lu skipped (insufficient data) in %.2fs",
+              cancelled ? @"cancelled" : @"complete",
+              (unsigned long)cache.count,
+              (unsigned long)(symbols.count - cache.count),
+              [[NSDate date] timeIntervalSinceDate:loadStartTime]);
+        
+        NSError *error = nil;
+        if (cancelled) {
+            error = [NSError errorWithDomain:@"StooqDataManager"
+                                        code:1002
+                                    userInfo:@{NSLocalizedDescriptionKey: @"Data loading cancelled"}];
+        }
         
         dispatch_async(dispatch_get_main_queue(), ^{
-            completion([cache copy], nil);
+            completion(cache, error);
         });
     });
 }
 
+- (NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)concurrentlyLoadSymbols:(NSArray<NSString *> *)symbols
+                                                                             usingBlock:(StooqSymbolLoadBlock)loadBlock
+                                                                               progress:(StooqLoadProgressBlock)progress
+                                                                              cancelled:(BOOL *)cancelled {
+    
+    if (cancelled) *cancelled = NO;
+    
+    NSInteger totalSymbols = symbols.count;
+    if (totalSymbols == 0) {
+        return @{};
+    }
+    
+    NSUInteger generation = self.loadGeneration;
+    
+    NSInteger chunkCount = (totalSymbols + kStooqLoadChunkSize - 1) / kStooqLoadChunkSize;
+    NSInteger workerCount = self.maxConcurrentLoads > 0
+        ? self.maxConcurrentLoads
+        : (NSInteger)[NSProcessInfo processInfo].activeProcessorCount;
+    workerCount = MAX(1, MIN(workerCount, chunkCount));
+    
+    // Un buffer per worker: nessun lock sul percorso caldo, merge alla fine
+    NSMutableArray<NSMutableDictionary *> *buffers = [NSMutableArray arrayWithCapacity:workerCount];
+    for (NSInteger w = 0; w < workerCount; w++) {
+        [buffers addObject:[NSMutableDictionary dictionaryWithCapacity:totalSymbols / workerCount + 1]];
+    }
+    NSArray<NSMutableDictionary *> *workerBuffers = [buffers copy];
+    
+    NSObject *progressLock = [[NSObject alloc] init];
+    __block NSInteger completedSymbols = 0;
+    __block BOOL wasCancelled = NO;
+    
+    dispatch_apply(workerCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t worker) {
+        NSMutableDictionary *buffer = workerBuffers[worker];
+        
+        // Chunk interleaved tra i worker: file piccoli e grandi si distribuiscono uniformemente
+        for (NSInteger chunk = worker; chunk < chunkCount; chunk += workerCount) {
+            if (self.loadGeneration != generation) {
+                @synchronized (progressLock) {
+                    wasCancelled = YES;
+                }
+                return;
+            }
+            
+            NSInteger start = chunk * kStooqLoadChunkSize;
+            NSInteger end = MIN(start + kStooqLoadChunkSize, totalSymbols);
+            
+            for (NSInteger i = start; i < end; i++) {
+                @autoreleasepool {
+                    NSString *symbol = symbols[i];
+                    NSArray<HistoricalBarModel *> *bars = loadBlock(symbol);
+                    if (bars) {
+                        buffer[symbol] = bars;
+                    }
+                }
+            }
+            
+            if (progress) {
+                NSInteger completed;
+                @synchronized (progressLock) {
+                    completedSymbols += end - start;
+                    completed = completedSymbols;
+                }
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    progress(completed, totalSymbols);
+                });
+            }
+        }
+    });
+    
+    NSInteger loadedCount = 0;
+    for (NSDictionary *buffer in workerBuffers) {
+        loadedCount += buffer.count;
+    }
+    
+    NSMutableDictionary<NSString *, NSArray<HistoricalBarModel *> *> *cache =
+        [NSMutableDictionary dictionaryWithCapacity:loadedCount];
+    for (NSDictionary *buffer in workerBuffers) {
+        [cache addEntriesFromDictionary:buffer];
+    }
+    
+    if (cancelled) *cancelled = wasCancelled;
+    
+    return [cache copy];
+}
+
+- (void)cancelLoading {
+    @synchronized (self) {
+        NSLog(@"🛑 StooqDataManager: cancelling running loads");
+        self.loadGeneration = self.loadGeneration + 1;
+    }
+}
+
 - (nullable NSArray<HistoricalBarModel *> *)loadBarsForSymbol:(NSString *)symbol
                                                        minBars:(NSInteger)minBars {
     NSString *filePath = [self filePathForSymbol:symbol];
@@ -297,171 +429,124 @@
     return [self parseCSVFile:filePath symbol:symbol maxBars:minBars];
 }
 
+- (nullable NSArray<HistoricalBarModel *> *)loadBarsForSymbol:(NSString *)symbol
+                                                       minBars:(NSInteger)minBars
+                                                    targetDate:(StooqDate)targetDate {
+    NSString *filePath = [self filePathForSymbol:symbol];
+    if (!filePath) {
+        return nil;
+    }
+    
+    return [self parseCSVFile:filePath symbol:symbol maxBars:minBars targetDate:targetDate];
+}
+
 #pragma mark - CSV Parsing
 
 - (nullable NSArray<HistoricalBarModel *> *)parseCSVFile:(NSString *)filePath
                                                   symbol:(NSString *)symbol
                                                  maxBars:(NSInteger)maxBars {
     
-    NSError *error;
-    NSString *csvContent = [NSString stringWithContentsOfFile:filePath
-                                                      encoding:NSUTF8StringEncoding
-                                                         error:&error];
-    if (!csvContent) {
-        NSLog(@"⚠️ Could not read file %@: %@", filePath, error.localizedDescription);
-        return nil;
-    }
-    
-    NSArray<NSString *> *lines = [csvContent componentsSeparatedByString:@"\n"];
+    // ✅ Target date in formato Stooq YYYYMMDD (confronto interi, niente stringhe)
+    StooqDate targetDate = [StooqCSVReader stooqDateFromDate:self.targetDate ?: [self expectedLastCloseDate]];
     
-    // ✅ STEP 1: Converti target date in stringa formato Stooq YYYYMMDD
-    NSString *targetDateString = [self dateToStooqString:self.targetDate ?: [self expectedLastCloseDate]];
-    
-    // ✅ STEP 2: Trova l'ultima riga valida del file
-    NSInteger lastValidLineIndex = -1;
-    NSString *lastBarDateString = nil;
-    
-    for (NSInteger i = lines.count - 1; i >= 0; i--) {
-        NSString *line = [lines[i] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-        if (line.length == 0 || [line hasPrefix:@"<TICKER>"]) continue;
-        
-        NSArray *components = [line componentsSeparatedByString:@","];
-        if (components.count < 3) continue;
-        
-        NSString *dateStr = components[2];
-        if (dateStr.length != 8) continue;
-        
-        lastBarDateString = dateStr;
-        lastValidLineIndex = i;
-        break;
-    }
+    return [self parseCSVFile:filePath symbol:symbol maxBars:maxBars targetDate:targetDate];
+}
+
+- (nullable NSArray<HistoricalBarModel *> *)parseCSVFile:(NSString *)filePath
+                                                  symbol:(NSString *)symbol
+                                                 maxBars:(NSInteger)maxBars
+                                              targetDate:(StooqDate)targetDate {
     
-    if (lastValidLineIndex == -1 || !lastBarDateString) {
+    // ✅ Cache condivisa con ScoreTable / DataHub: stesso file (path, size, mtime), stessa data, stesse barre.
+    // Il path completo distingue le data directory; un CSV riscritto cambia chiave e viene riletto.
+    struct stat info;
+    if (stat(filePath.fileSystemRepresentation, &info) != 0) {
         return nil;
     }
-    
-    // ✅ STEP 3: Confronto stringhe DIRETTO - se ultima barra < target → exit
-    if ([lastBarDateString compare:targetDateString] == NSOrderedAscending) {
-        // lastBarDateString < targetDateString → file troppo vecchio
-        return nil;
+    SharedBarCache *cache = [SharedBarCache sharedCache];
+    NSString *cacheRange = [NSString stringWithFormat:@"stooq:%@:%lld:%ld.%09ld:%d:%ld",
+                            filePath, (long long)info.st_size,
+                            (long)info.st_mtimespec.tv_sec, (long)info.st_mtimespec.tv_nsec,
+                            targetDate, (long)maxBars];
+    NSArray<HistoricalBarModel *> *cached = [cache barsForSymbol:symbol timeframe:BarTimeframeDaily range:cacheRange];
+    if (cached) {
+        return cached;
     }
     
-    // ✅ STEP 4: Cerca la riga con ESATTAMENTE la target date (confronto stringhe)
-    NSInteger targetLineIndex = -1;
+    // ✅ Pack binario aggiornato: nessun parsing, la serie punta direttamente al file mappato
+    BarSeries *series = [self binarySeriesForFile:filePath symbol:symbol maxBars:maxBars targetDate:targetDate];
     
-    for (NSInteger i = lastValidLineIndex; i >= 0; i--) {
-        NSString *line = [lines[i] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-        if (line.length == 0 || [line hasPrefix:@"<TICKER>"]) continue;
-        
-        NSArray *components = [line componentsSeparatedByString:@","];
-        if (components.count < 3) continue;
-        
-        NSString *dateStr = components[2];
-        if (dateStr.length != 8) continue;
-        
-        // ⚡ CONFRONTO STRINGHE DIRETTO
-        if ([dateStr isEqualToString:targetDateString]) {
-            targetLineIndex = i;
-            break;
+    if (!series) {
+        // ✅ Lettura memory-mapped dalla coda del file: solo le ultime maxBars righe vengono toccate
+        NSData *rawBars = [StooqCSVReader barsFromFileAtPath:filePath
+                                                  targetDate:targetDate
+                                                     maxBars:maxBars];
+        if (!rawBars) {
+            return nil;
         }
         
-        // Se siamo andati troppo indietro, stoppa
-        if ([dateStr compare:targetDateString] == NSOrderedAscending) {
-            break;
-        }
+        // ✅ Storage colonnare: nessun oggetto per barra, HistoricalBarModel materializzati solo on demand
+        series = [self barSeriesFromRawBars:rawBars symbol:symbol];
     }
     
-    if (targetLineIndex == -1) {
+    NSArray<HistoricalBarModel *> *bars = [series bars];
+    [cache setBars:bars forSymbol:symbol timeframe:BarTimeframeDaily range:cacheRange];
+    return bars;
+}
+
+/**
+ * Same bars barsFromFileAtPath:targetDate:maxBars: would return, read from the binary store
+ * @return nil if the store has no fresh entry for the file or it does not contain targetDate
+ */
+- (nullable BarSeries *)binarySeriesForFile:(NSString *)filePath
+                                     symbol:(NSString *)symbol
+                                    maxBars:(NSInteger)maxBars
+                                 targetDate:(StooqDate)targetDate {
+    NSString *exchange = self.filePathToExchange[filePath];
+    if (!self.binaryStore || !exchange) {
         return nil;
     }
     
-    // ✅ STEP 5: Parsa DA target date INDIETRO per maxBars
-    NSMutableArray<HistoricalBarModel *> *bars = [NSMutableArray array];
-    NSInteger parsedCount = 0;
-    NSCalendar *calendar = [NSCalendar currentCalendar];
-    
-    for (NSInteger i = targetLineIndex; i >= 0; i--) {
-        if (maxBars > 0 && parsedCount >= maxBars) {
-            break;
-        }
-        
-        NSString *line = [lines[i] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-        
-        if (line.length == 0) continue;
-        if ([line hasPrefix:@"<TICKER>"]) continue;
-        
-        @try {
-            NSArray<NSString *> *components = [line componentsSeparatedByString:@","];
-            if (components.count < 9) continue;
-            
-            // Parse date
-            NSString *dateStr = components[2];
-            if (dateStr.length != 8) continue;
-            
-            NSInteger year = [[dateStr substringWithRange:NSMakeRange(0, 4)] integerValue];
-            NSInteger month = [[dateStr substringWithRange:NSMakeRange(4, 2)] integerValue];
-            NSInteger day = [[dateStr substringWithRange:NSMakeRange(6, 2)] integerValue];
-            
-            NSDateComponents *dc = [[NSDateComponents alloc] init];
-            dc.year = year;
-            dc.month = month;
-            dc.day = day;
-            NSDate *date = [calendar dateFromComponents:dc];
-            
-            // Parse OHLCV
-            double open = [components[4] doubleValue];
-            double high = [components[5] doubleValue];
-            double low = [components[6] doubleValue];
-            double close = [components[7] doubleValue];
-            long long volume = [components[8] longLongValue];
-            
-            // Validazione base
-            if (open <= 0 || high <= 0 || low <= 0 || close <= 0) {
-                continue;
-            }
-            if (high < low || open < low || close < low || high < open || high < close || low > open || low > close) {
-                continue;
-            }
-            
-            HistoricalBarModel *bar = [[HistoricalBarModel alloc] init];
-            bar.symbol = symbol;
-            bar.date = date;
-            bar.open = open;
-            bar.high = high;
-            bar.low = low;
-            bar.close = close;
-            bar.adjustedClose = close;
-            bar.volume = volume;
-            bar.timeframe = BarTimeframeDaily;
-            bar.isPaddingBar = NO;
-            
-            [bars addObject:bar];
-            parsedCount++;
-            
-        } @catch (NSException *exception) {
-            continue;
-        }
+    BarSeries *series = [self.binaryStore seriesForSourceFile:filePath exchange:exchange symbol:symbol];
+    if (!series) {
+        return nil;
     }
     
-    // ✅ STEP 6: Reverse per ordine cronologico (oldest → newest)
-    NSArray *reversedBars = [[bars reverseObjectEnumerator] allObjects];
+    // Il CSV richiede la data esatta: stessa regola qui
+    NSTimeInterval targetTime = [StooqCSVReader dateFromStooqDate:targetDate].timeIntervalSince1970;
+    NSInteger last = [series indexOfLastBarOnOrBeforeTime:targetTime];
+    if (last < 0 || series.time[last] != targetTime) {
+        return nil;
+    }
     
-    return reversedBars;
+    NSInteger count = (maxBars > 0) ? MIN(maxBars, last + 1) : last + 1;
+    return [series sliceWithRange:NSMakeRange(last + 1 - count, count)];
 }
 
-#pragma mark - Date Helpers
-
-// ✅ NUOVO: Converti NSDate in stringa formato Stooq "YYYYMMDD"
-- (NSString *)dateToStooqString:(NSDate *)date {
-    NSCalendar *calendar = [NSCalendar currentCalendar];
-    NSDateComponents *components = [calendar components:NSCalendarUnitYear|NSCalendarUnitMonth|NSCalendarUnitDay
-                                               fromDate:date];
-    
-    return [NSString stringWithFormat:@"%04ld%02ld%02ld",
-            (long)components.year,
-            (long)components.month,
-            (long)components.day];
+/**
+ * Convert packed StooqRawBar structs into a columnar BarSeries
+ * Dates come from the shared StooqCSVReader cache (one NSDate per trading day)
+ */
+- (BarSeries *)barSeriesFromRawBars:(NSData *)rawBars symbol:(NSString *)symbol {
+    const StooqRawBar *raw = rawBars.bytes;
+    NSInteger count = rawBars.length / sizeof(StooqRawBar);
+    
+    return [BarSeries seriesWithSymbol:symbol
+                             timeframe:BarTimeframeDaily
+                                 count:count
+                           fillColumns:^(BarSeriesMutableColumns columns) {
+        for (NSInteger i = 0; i < count; i++) {
+            columns.time[i] = [StooqCSVReader dateFromStooqDate:raw[i].date].timeIntervalSince1970;
+            columns.open[i] = raw[i].open;
+            columns.high[i] = raw[i].high;
+            columns.low[i] = raw[i].low;
+            columns.close[i] = raw[i].close;
+            columns.adjustedClose[i] = raw[i].close;
+            columns.volume[i] = raw[i].volume;
+        }
+    }];
 }
+
 #pragma mark - File Path Resolution
 
 - (nullable NSString *)filePathForSymbol:(NSString *)symbol {
@@ -519,6 +604,14 @@
     return [filtered copy];
 }
 
+- (BOOL)dateRangeForSymbol:(NSString *)symbol firstDate:(StooqDate *)firstDate lastDate:(StooqDate *)lastDate {
+    NSString *filePath = [self filePathForSymbol:symbol];
+    if (!filePath) {
+        return NO;
+    }
+    return [self.directoryIndex dateRangeOfFileAtPath:filePath firstDate:firstDate lastDate:lastDate];
+}
+
 #pragma mark - Private Methods
 
 /**
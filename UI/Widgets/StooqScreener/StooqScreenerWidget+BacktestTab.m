@@ -350,6 +350,7 @@ static char selectedStatisticMetricKey;
     // Initialize backtest runner
     self.backtestRunner = [[BacktestRunner alloc] init];
     self.backtestRunner.delegate = self;
+    self.backtestRunner.parallelExecution = YES;
     
     NSLog(@"✅ Backtest tab created successfully");
 }
@@ -787,6 +788,12 @@ static char selectedStatisticMetricKey;
                                           completion:^(NSDictionary<NSString *,NSArray<HistoricalBarModel *> *> *cache, NSError *error) {
             
             dispatch_async(dispatch_get_main_queue(), ^{
+                if ([error.domain isEqualToString:@"StooqDataManager"] && error.code == 1002) {
+                    [self updateBacktestUIState:NO];
+                    self.backtestStatusLabel.stringValue = @"🛑 Backtest cancelled";
+                    return;
+                }
+                
                 if (error || !cache || cache.count == 0) {
                     [self updateBacktestUIState:NO];
                     self.backtestStatusLabel.stringValue = @"❌ Failed to load data";
@@ -819,6 +826,8 @@ static char selectedStatisticMetricKey;
 
 - (IBAction)cancelBacktest:(id)sender {
     NSLog(@"🛑 Cancel Backtest button pressed");
+    // Il caricamento dati precede la run: va fermato anche quello
+    [self.dataManager cancelLoading];
     [self.backtestRunner cancel];
 }
 
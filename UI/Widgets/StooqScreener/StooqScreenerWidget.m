@@ -90,6 +90,7 @@
 // Bottom bar (Models tab)
 @property (nonatomic, strong) NSButton *runButton;
 @property (nonatomic, strong) NSButton *refreshButton;
+@property (nonatomic, strong) NSButton *optimizeStepOrderCheckbox;
 @property (nonatomic, strong) NSTextField *universeLabel;
 @property (nonatomic, strong) NSProgressIndicator *progressIndicator;
 
@@ -872,6 +873,16 @@
     self.refreshButton.translatesAutoresizingMaskIntoConstraints = NO;
     [bottomBar addSubview:self.refreshButton];
     
+    // Ordine dei filtri in base a costo/selettività registrati (ScreenerStepStatistics)
+    self.optimizeStepOrderCheckbox = [NSButton checkboxWithTitle:@"Optimize step order"
+                                                          target:self
+                                                          action:@selector(optimizeStepOrderChanged:)];
+    self.optimizeStepOrderCheckbox.translatesAutoresizingMaskIntoConstraints = NO;
+    self.optimizeStepOrderCheckbox.toolTip = @"Run cheap, selective filter steps first. Results are unchanged.";
+    self.optimizeStepOrderCheckbox.state = [[NSUserDefaults standardUserDefaults] boolForKey:ScreenerBatchRunnerOptimizeStepOrderKey]
+                                           ? NSControlStateValueOn : NSControlStateValueOff;
+    [bottomBar addSubview:self.optimizeStepOrderCheckbox];
+    
     self.universeLabel = [[NSTextField alloc] init];
     self.universeLabel.translatesAutoresizingMaskIntoConstraints = NO;
     self.universeLabel.editable = NO;
@@ -897,6 +908,9 @@
         [self.refreshButton.leadingAnchor constraintEqualToAnchor:self.runButton.trailingAnchor constant:10],
         [self.refreshButton.centerYAnchor constraintEqualToAnchor:self.runButton.centerYAnchor],
         
+        [self.optimizeStepOrderCheckbox.leadingAnchor constraintEqualToAnchor:self.refreshButton.trailingAnchor constant:15],
+        [self.optimizeStepOrderCheckbox.centerYAnchor constraintEqualToAnchor:self.runButton.centerYAnchor],
+        
         [self.universeLabel.trailingAnchor constraintEqualToAnchor:bottomBar.trailingAnchor],
         [self.universeLabel.centerYAnchor constraintEqualToAnchor:self.runButton.centerYAnchor],
         
@@ -1000,6 +1014,9 @@
             self.runButton.enabled = YES;
             
             NSLog(@"✅ Auto-scan complete: %lu symbols loaded", (unsigned long)symbols.count);
+
+            // ✅ Converte in background solo i CSV cambiati dall'ultima volta
+            [self.dataManager refreshBinaryStoreWithCompletion:nil];
         }
     }];
 }
@@ -1011,6 +1028,13 @@
     NSLog(@"✅ Loaded %lu models", (unsigned long)self.models.count);
 }
 
+- (void)optimizeStepOrderChanged:(NSButton *)sender {
+    BOOL optimize = (sender.state == NSControlStateValueOn);
+    // Il batch runner legge il valore dai defaults: vale anche per runner creati dopo
+    [[NSUserDefaults standardUserDefaults] setBool:optimize forKey:ScreenerBatchRunnerOptimizeStepOrderKey];
+    NSLog(@"⚙️ Screener step order optimization %@", optimize ? @"enabled" : @"disabled");
+}
+
 - (void)setDataDirectory:(NSString *)path {
     _dataDirectory = path;
     [[NSUserDefaults standardUserDefaults] setObject:path forKey:@"StooqDataDirectory"];
@@ -3314,9 +3338,8 @@
     ScreenerRegistry *registry = [ScreenerRegistry sharedRegistry];
     
     for (ScreenerStep *step in modelResult.steps) {
-        BaseScreener *screener = [registry screenerWithID:step.screenerID];
+        BaseScreener *screener = [registry screenerWithID:step.screenerID parameters:step.parameters];
         if (screener) {
-            screener.parameters = step.parameters;
             NSInteger required = screener.minBarsRequired;
             if (required > maxBars) {
                 maxBars = required;
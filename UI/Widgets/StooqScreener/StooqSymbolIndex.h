@@ -0,0 +1,67 @@
+//
+//  StooqSymbolIndex.h
+//  TradingApp
+//
+//  Persisted listing of the Stooq directory tree.
+//  Every directory is stored with its modification date: as long as it is
+//  unchanged its subdirectories and data files come from disk, without
+//  enumerating it again. File size, mtime and date range are kept per file.
+//
+
+#import <Foundation/Foundation.h>
+#import "StooqCSVReader.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// One .txt/.csv data file
+@interface StooqIndexedFile : NSObject
+@property (nonatomic, readonly) NSString *name;         // e.g. "aapl.us.txt"
+@property (nonatomic, readonly) int64_t fileSize;
+@property (nonatomic, readonly) double modified;        // mtime, seconds since 1970
+@property (nonatomic, readonly) StooqDate firstDate;    // 0 if the file has no valid bar
+@property (nonatomic, readonly) StooqDate lastDate;
+@end
+
+/// Content of one directory
+@interface StooqDirectoryListing : NSObject
+@property (nonatomic, readonly) NSArray<NSString *> *subdirectories;    // Names, sorted
+@property (nonatomic, readonly) NSArray<StooqIndexedFile *> *files;      // Sorted by name
+@end
+
+@interface StooqSymbolIndex : NSObject
+
+/// Plist the index is loaded from and saved to
+@property (nonatomic, readonly) NSString *path;
+
+/// Load the index at path (an empty index if missing or unreadable)
+- (instancetype)initWithPath:(NSString *)path;
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Application Support location of the index for a Stooq data directory
++ (NSString *)defaultPathForDataDirectory:(NSString *)dataDirectory;
+
+/**
+ * Listing of a directory, revalidated by its modification date
+ * @return nil if the directory cannot be read
+ *
+ * @discussion
+ * Unchanged directory: the stored listing, no enumeration. Changed directory:
+ * enumerated again; files whose size and mtime match the stored ones keep their
+ * date range, the others (new or rewritten) have it read from the file.
+ */
+- (nullable StooqDirectoryListing *)listingOfDirectory:(NSString *)directory;
+
+/**
+ * Date range of a file, recomputed if the file changed since it was indexed
+ * Files rewritten in place do not touch the directory mtime: this is where they are caught.
+ */
+- (BOOL)dateRangeOfFileAtPath:(NSString *)filePath
+                    firstDate:(StooqDate *)firstDate
+                     lastDate:(StooqDate *)lastDate;
+
+/// Write the index to path (no-op if nothing changed since it was loaded)
+- (BOOL)saveWithError:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,325 @@
+//
+//  StooqSymbolIndex.m
+//  TradingApp
+//
+
+#import "StooqSymbolIndex.h"
+#import "StooqBinaryStore.h"
+#import <sys/stat.h>
+
+static const NSInteger kStooqSymbolIndexVersion = 1;
+
+static BOOL StooqIndexStat(NSString *path, int64_t *size, double *modified, BOOL *isDirectory) {
+    struct stat info;
+    if (stat(path.fileSystemRepresentation, &info) != 0) {
+        return NO;
+    }
+    if (size) *size = (int64_t)info.st_size;
+    if (modified) *modified = (double)info.st_mtimespec.tv_sec + (double)info.st_mtimespec.tv_nsec / 1e9;
+    if (isDirectory) *isDirectory = S_ISDIR(info.st_mode);
+    return YES;
+}
+
+#pragma mark - StooqIndexedFile
+
+@interface StooqIndexedFile ()
+@property (nonatomic, readwrite) NSString *name;
+@property (nonatomic, readwrite) int64_t fileSize;
+@property (nonatomic, readwrite) double modified;
+@property (nonatomic, readwrite) StooqDate firstDate;
+@property (nonatomic, readwrite) StooqDate lastDate;
+@end
+
+@implementation StooqIndexedFile
+
+/// Plist form: [name, size, mtime, firstDate, lastDate]
++ (nullable instancetype)fileFromPropertyList:(NSArray *)plist {
+    if (![plist isKindOfClass:[NSArray class]] || plist.count != 5) return nil;
+
+    StooqIndexedFile *file = [[StooqIndexedFile alloc] init];
+    file.name = plist[0];
+    file.fileSize = [plist[1] longLongValue];
+    file.modified = [plist[2] doubleValue];
+    file.firstDate = [plist[3] intValue];
+    file.lastDate = [plist[4] intValue];
+    return [file.name isKindOfClass:[NSString class]] ? file : nil;
+}
+
+- (NSArray *)propertyList {
+    return @[self.name, @(self.fileSize), @(self.modified), @(self.firstDate), @(self.lastDate)];
+}
+
+- (void)readDateRangeAtPath:(NSString *)path {
+    StooqDate first = 0;
+    StooqDate last = 0;
+    if (![StooqCSVReader dateRangeOfFileAtPath:path firstDate:&first lastDate:&last]) {
+        first = last = 0;
+    }
+    self.firstDate = first;
+    self.lastDate = last;
+}
+
+@end
+
+#pragma mark - StooqDirectoryListing
+
+@interface StooqDirectoryListing ()
+@property (nonatomic, assign) double modified;
+@property (nonatomic, readwrite) NSArray<NSString *> *subdirectories;
+@property (nonatomic, readwrite) NSArray<StooqIndexedFile *> *files;
+@property (nonatomic, strong, nullable) NSDictionary<NSString *, StooqIndexedFile *> *filesByName;
+@end
+
+@implementation StooqDirectoryListing
+
++ (nullable instancetype)listingFromPropertyList:(NSDictionary *)plist {
+    if (![plist isKindOfClass:[NSDictionary class]]) return nil;
+
+    NSMutableArray<StooqIndexedFile *> *files = [NSMutableArray array];
+    for (NSArray *entry in plist[@"files"]) {
+        StooqIndexedFile *file = [StooqIndexedFile fileFromPropertyList:entry];
+        if (!file) return nil;
+        [files addObject:file];
+    }
+
+    StooqDirectoryListing *listing = [[StooqDirectoryListing alloc] init];
+    listing.modified = [plist[@"modified"] doubleValue];
+    listing.subdirectories = plist[@"subdirectories"] ?: @[];
+    listing.files = [files copy];
+    return listing;
+}
+
+- (NSDictionary *)propertyList {
+    return @{
+        @"modified": @(self.modified),
+        @"subdirectories": self.subdirectories,
+        @"files": [self.files valueForKey:@"propertyList"]
+    };
+}
+
+- (nullable StooqIndexedFile *)fileNamed:(NSString *)name {
+    if (!self.filesByName) {
+        NSMutableDictionary *byName = [NSMutableDictionary dictionaryWithCapacity:self.files.count];
+        for (StooqIndexedFile *file in self.files) {
+            byName[file.name] = file;
+        }
+        self.filesByName = byName;
+    }
+    return self.filesByName[name];
+}
+
+@end
+
+#pragma mark - StooqSymbolIndex
+
+@implementation StooqSymbolIndex {
+    NSMutableDictionary<NSString *, StooqDirectoryListing *> *_directories;
+    BOOL _dirty;
+}
+
+- (instancetype)initWithPath:(NSString *)path {
+    self = [super init];
+    if (self) {
+        _path = [path copy];
+        _directories = [NSMutableDictionary dictionary];
+        [self load];
+    }
+    return self;
+}
+
++ (NSString *)defaultPathForDataDirectory:(NSString *)dataDirectory {
+    // Accanto ai pack binari dello stesso database
+    return [[StooqBinaryStore defaultDirectoryForDataDirectory:dataDirectory]
+            stringByAppendingPathComponent:@"symbol-index.plist"];
+}
+
+#pragma mark - Persistence
+
+- (void)load {
+    NSData *data = [NSData dataWithContentsOfFile:self.path];
+    if (!data) return;
+
+    NSDictionary *plist = [NSPropertyListSerialization propertyListWithData:data
+                                                                    options:NSPropertyListImmutable
+                                                                     format:NULL
+                                                                      error:nil];
+    if (![plist isKindOfClass:[NSDictionary class]] ||
+        [plist[@"version"] integerValue] != kStooqSymbolIndexVersion) {
+        NSLog(@"⚠️ StooqSymbolIndex: discarding index with unknown format");
+        return;
+    }
+
+    NSDictionary *directories = plist[@"directories"];
+    if (![directories isKindOfClass:[NSDictionary class]]) return;
+
+    for (NSString *directory in directories) {
+        StooqDirectoryListing *listing = [StooqDirectoryListing listingFromPropertyList:directories[directory]];
+        if (listing) {
+            _directories[directory] = listing;
+        }
+    }
+
+    NSLog(@"📇 StooqSymbolIndex: loaded %lu directories", (unsigned long)_directories.count);
+}
+
+- (BOOL)saveWithError:(NSError **)error {
+    NSDictionary *plist;
+    @synchronized (self) {
+        if (!_dirty) return YES;
+
+        NSMutableDictionary *directories = [NSMutableDictionary dictionaryWithCapacity:_directories.count];
+        [_directories enumerateKeysAndObjectsUsingBlock:^(NSString *directory, StooqDirectoryListing *listing, BOOL *stop) {
+            directories[directory] = [listing propertyList];
+        }];
+        plist = @{@"version": @(kStooqSymbolIndexVersion), @"directories": directories};
+        _dirty = NO;
+    }
+
+    NSData *data = [NSPropertyListSerialization dataWithPropertyList:plist
+                                                              format:NSPropertyListBinaryFormat_v1_0
+                                                             options:0
+                                                               error:error];
+    if (!data) return NO;
+
+    [[NSFileManager defaultManager] createDirectoryAtPath:[self.path stringByDeletingLastPathComponent]
+                              withIntermediateDirectories:YES
+                                               attributes:nil
+                                                    error:nil];
+    return [data writeToFile:self.path options:NSDataWritingAtomic error:error];
+}
+
+#pragma mark - Listing
+
+- (StooqDirectoryListing *)listingOfDirectory:(NSString *)directory {
+    double modified = 0;
+    BOOL isDirectory = NO;
+    if (!StooqIndexStat(directory, NULL, &modified, &isDirectory) || !isDirectory) {
+        @synchronized (self) {
+            if (_directories[directory]) {
+                [_directories removeObjectForKey:directory];
+                _dirty = YES;
+            }
+        }
+        return nil;
+    }
+
+    StooqDirectoryListing *previous;
+    @synchronized (self) {
+        previous = _directories[directory];
+    }
+    if (previous && previous.modified == modified) {
+        return previous;
+    }
+
+    StooqDirectoryListing *listing = [self enumerateDirectory:directory previous:previous];
+    if (!listing) return nil;
+    listing.modified = modified;
+
+    @synchronized (self) {
+        _directories[directory] = listing;
+        _dirty = YES;
+    }
+    return listing;
+}
+
+- (nullable StooqDirectoryListing *)enumerateDirectory:(NSString *)directory
+                                              previous:(nullable StooqDirectoryListing *)previous {
+    NSError *error;
+    NSArray<NSString *> *names = [[[NSFileManager defaultManager] contentsOfDirectoryAtPath:directory error:&error]
+                                  sortedArrayUsingSelector:@selector(compare:)];
+    if (!names) {
+        NSLog(@"❌ StooqSymbolIndex: could not read %@: %@", directory, error.localizedDescription);
+        return nil;
+    }
+
+    NSMutableArray<NSString *> *subdirectories = [NSMutableArray array];
+    NSMutableArray<StooqIndexedFile *> *files = [NSMutableArray array];
+    NSMutableArray<StooqIndexedFile *> *changed = [NSMutableArray array];
+
+    for (NSString *name in names) {
+        NSString *itemPath = [directory stringByAppendingPathComponent:name];
+        int64_t size = 0;
+        double itemModified = 0;
+        BOOL isDirectory = NO;
+        if (!StooqIndexStat(itemPath, &size, &itemModified, &isDirectory)) continue;
+
+        if (isDirectory) {
+            [subdirectories addObject:name];
+            continue;
+        }
+
+        // Stooq files can be .txt or .csv
+        if (![name hasSuffix:@".txt"] && ![name hasSuffix:@".csv"]) continue;
+
+        StooqIndexedFile *known = [previous fileNamed:name];
+        if (known && known.fileSize == size && known.modified == itemModified) {
+            [files addObject:known];
+            continue;
+        }
+
+        StooqIndexedFile *file = [[StooqIndexedFile alloc] init];
+        file.name = name;
+        file.fileSize = size;
+        file.modified = itemModified;
+        [files addObject:file];
+        [changed addObject:file];
+    }
+
+    // Solo i file nuovi o riscritti vengono aperti (prima e ultima riga)
+    dispatch_apply(changed.count, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^(size_t i) {
+        @autoreleasepool {
+            StooqIndexedFile *file = changed[i];
+            [file readDateRangeAtPath:[directory stringByAppendingPathComponent:file.name]];
+        }
+    });
+
+    if (changed.count > 0) {
+        NSLog(@"📇 StooqSymbolIndex: %@ → %lu files (%lu new or changed)",
+              directory.lastPathComponent, (unsigned long)files.count, (unsigned long)changed.count);
+    }
+
+    StooqDirectoryListing *listing = [[StooqDirectoryListing alloc] init];
+    listing.subdirectories = [subdirectories copy];
+    listing.files = [files copy];
+    return listing;
+}
+
+#pragma mark - Date Range
+
+- (BOOL)dateRangeOfFileAtPath:(NSString *)filePath firstDate:(StooqDate *)firstDate lastDate:(StooqDate *)lastDate {
+    int64_t size = 0;
+    double modified = 0;
+    if (!StooqIndexStat(filePath, &size, &modified, NULL)) return NO;
+
+    StooqDirectoryListing *listing;
+    @synchronized (self) {
+        listing = _directories[[filePath stringByDeletingLastPathComponent]];
+    }
+
+    StooqIndexedFile *file;
+    @synchronized (listing) {
+        file = [listing fileNamed:filePath.lastPathComponent];
+    }
+
+    if (!file) {
+        return [StooqCSVReader dateRangeOfFileAtPath:filePath firstDate:firstDate lastDate:lastDate];
+    }
+
+    @synchronized (file) {
+        if (file.fileSize != size || file.modified != modified) {
+            file.fileSize = size;
+            file.modified = modified;
+            [file readDateRangeAtPath:filePath];
+            @synchronized (self) {
+                _dirty = YES;
+            }
+        }
+
+        if (file.lastDate == 0) return NO;
+        *firstDate = file.firstDate;
+        *lastDate = file.lastDate;
+    }
+    return YES;
+}
+
+@end
@@ -16,7 +16,11 @@
 #import "APTRScreener.h"
 #import "TechnicalIndicatorHelper.h"
 
-@implementation APTRScreener
+@implementation APTRScreener {
+    NSInteger _length;
+    double _minAPTR;
+    double _maxAPTR;
+}
 
 #pragma mark - BaseScreener Overrides
 
@@ -79,6 +83,54 @@
     return [results copy];
 }
 
+#pragma mark - Whole-History Signals
+
+- (BOOL)supportsSignalSeries {
+    return YES;
+}
+
+- (void)prepareForExecution {
+    _length = [self parameterIntegerForKey:@"length" defaultValue:14];
+    _minAPTR = [self parameterDoubleForKey:@"minAPTR" defaultValue:0.0];
+    _maxAPTR = [self parameterDoubleForKey:@"maxAPTR" defaultValue:100.0];
+}
+
+- (NSData *)signalsForSymbol:(NSString *)symbol series:(BarSeries *)series {
+    NSInteger count = series.count;
+    NSMutableData *signals = [NSMutableData dataWithLength:ScreenerSignalWordCount(count) * sizeof(uint64_t)];
+    uint64_t *bits = signals.mutableBytes;
+    if (_length <= 0) return signals;
+    
+    const double *high = series.high;
+    const double *low = series.low;
+    const double *close = series.close;
+    
+    // ptr di ogni barra calcolato una volta sola
+    NSMutableData *ptrData = [NSMutableData dataWithLength:count * sizeof(double)];
+    double *ptr = ptrData.mutableBytes;
+    for (NSInteger i = 1; i < count; i++) {
+        double bottom = fmin(close[i - 1], low[i]);
+        double tr = fmax(high[i] - low[i], fmax(fabs(high[i] - close[i - 1]), fabs(low[i] - close[i - 1])));
+        double denominator = bottom + (tr / 2.0);
+        ptr[i] = (denominator > 0.0) ? (tr / denominator * 100.0) : 0.0;
+    }
+    
+    // Media degli ultimi length ptr, sommati dal più recente come calculateAPTR:length:
+    for (NSInteger i = MAX(self.minBarsRequired - 1, _length); i < count; i++) {
+        double sum = 0.0;
+        for (NSInteger k = 0; k < _length; k++) {
+            sum += ptr[i - k];
+        }
+        double aptr = sum / (double)_length;
+        
+        if (aptr >= _minAPTR && aptr <= _maxAPTR) {
+            ScreenerSignalSetBit(bits, i);
+        }
+    }
+    
+    return signals;
+}
+
 #pragma mark - APTR Calculation
 
 - (double)calculateAPTR:(NSArray<HistoricalBarModel *> *)bars
@@ -6,7 +6,13 @@
 #import "AlignedSMAScreener.h"
 #import "TechnicalIndicatorHelper.h"
 
-@implementation AlignedSMAScreener
+@implementation AlignedSMAScreener {
+    NSInteger _numSMAs;
+    NSInteger _sma1Period;
+    NSInteger _sma2Period;
+    NSInteger _sma3Period;
+    BOOL _requireCloseAbove;
+}
 
 #pragma mark - BaseScreener Overrides
 
@@ -48,100 +54,96 @@
 
 #pragma mark - Execution
 
-
 - (NSArray<NSString *> *)executeOnSymbols:(NSArray<NSString *> *)inputSymbols
                                cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cache {
     
-    // Leggi parametri
-    NSInteger numSMAs = [self parameterIntegerForKey:@"numSMAs" defaultValue:3];
-    NSInteger sma1Period = [self parameterIntegerForKey:@"sma1" defaultValue:5];
-    NSInteger sma2Period = [self parameterIntegerForKey:@"sma2" defaultValue:10];
-    NSInteger sma3Period = [self parameterIntegerForKey:@"sma3" defaultValue:20];
-    BOOL requireCloseAbove = [self parameterBoolForKey:@"requireCloseAbove" defaultValue:NO];
+    [self prepareForExecution];
     
     // Validazione
-    if (numSMAs < 2 || numSMAs > 3) {
-        NSLog(@"⚠️ AlignedSMAScreener: numSMAs deve essere 2 o 3, ricevuto %ld", (long)numSMAs);
+    if (_numSMAs < 2 || _numSMAs > 3) {
+        NSLog(@"⚠️ AlignedSMAScreener: numSMAs deve essere 2 o 3, ricevuto %ld", (long)_numSMAs);
         return @[];
     }
     
-    if (sma1Period >= sma2Period || (numSMAs == 3 && sma2Period >= sma3Period)) {
+    if (_sma1Period <= 0 || _sma1Period >= _sma2Period || (_numSMAs == 3 && _sma2Period >= _sma3Period)) {
         NSLog(@"⚠️ AlignedSMAScreener: I periodi devono essere in ordine crescente (sma1 < sma2 < sma3)");
         return @[];
     }
     
-    NSMutableArray<NSString *> *results = [NSMutableArray array];
+    NSArray<NSString *> *results = [super executeOnSymbols:inputSymbols cachedData:cache];
     
-    for (NSString *symbol in inputSymbols) {
-        NSArray<HistoricalBarModel *> *bars = [self barsForSymbol:symbol inCache:cache];
-        
-        if (!bars || bars.count < self.minBarsRequired) {
-            continue;
-        }
-        
-        // Calcola le SMA sulla barra più recente (index = 0)
-        // NOTA: TechnicalIndicatorHelper usa index=0 per l'ultima barra (più recente)
-        double sma1 = [TechnicalIndicatorHelper sma:bars index:0 period:sma1Period valueKey:@"close"];
-        double sma2 = [TechnicalIndicatorHelper sma:bars index:0 period:sma2Period valueKey:@"close"];
-        double sma3 = 0.0;
-        
-        if (numSMAs == 3) {
-            sma3 = [TechnicalIndicatorHelper sma:bars index:0 period:sma3Period valueKey:@"close"];
-        }
-        
-        // Verifica che i valori siano validi
-        if (sma1 == 0.0 || sma2 == 0.0) {
-            continue;
-        }
-        
-        if (numSMAs == 3 && sma3 == 0.0) {
-            continue;
-        }
-        
-        // Prendi il close più recente
-        HistoricalBarModel *currentBar = bars.lastObject;
-        double currentClose = currentBar.close;
-        
-        // Verifica allineamento
-        BOOL aligned = NO;
-        
-        if (numSMAs == 2) {
-            // Solo 2 medie: SMA1 > SMA2
-            aligned = (sma1 > sma2);
-        } else {
-            // 3 medie: SMA1 > SMA2 > SMA3
-            aligned = (sma1 > sma2) && (sma2 > sma3);
-        }
+    NSLog(@"📊 AlignedSMAScreener: %lu/%lu symbols passed", (unsigned long)results.count, (unsigned long)inputSymbols.count);
+    
+    return results;
+}
+
+- (void)prepareForExecution {
+    _numSMAs = [self parameterIntegerForKey:@"numSMAs" defaultValue:3];
+    _sma1Period = [self parameterIntegerForKey:@"sma1" defaultValue:5];
+    _sma2Period = [self parameterIntegerForKey:@"sma2" defaultValue:10];
+    _sma3Period = [self parameterIntegerForKey:@"sma3" defaultValue:20];
+    _requireCloseAbove = [self parameterBoolForKey:@"requireCloseAbove" defaultValue:NO];
+}
+
+- (BOOL)evaluateSymbol:(NSString *)symbol bars:(NSArray<HistoricalBarModel *> *)bars {
+    NSInteger count = bars.count;
+    NSInteger maxPeriod = (_numSMAs == 3) ? _sma3Period : _sma2Period;
+    if (count < maxPeriod) return NO;
+    
+    double sma1, sma2, sma3;
+    if (self.indicatorMemo) {
+        // SMA condivise con gli altri step della run
+        sma1 = [self smaForSymbol:symbol bars:bars index:0 period:_sma1Period field:IndicatorBarFieldClose];
+        sma2 = [self smaForSymbol:symbol bars:bars index:0 period:_sma2Period field:IndicatorBarFieldClose];
+        sma3 = (_numSMAs == 3) ? [self smaForSymbol:symbol bars:bars index:0 period:_sma3Period field:IndicatorBarFieldClose] : 0.0;
+    } else {
+        // Tutte le SMA in un'unica passata all'indietro sulla coda (periodi crescenti)
+        BarSeries *series = [BarSeries backingSeriesOfBars:bars];
+        const double *closes = series.close;
         
-        // Verifica condizione Close (se richiesta)
-        if (aligned && requireCloseAbove) {
-            aligned = (currentClose > sma1);
+        double sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+        for (NSInteger k = 0; k < maxPeriod; k++) {
+            double close = closes ? closes[count - 1 - k] : bars[count - 1 - k].close;
+            if (k < _sma1Period) sum1 += close;
+            if (k < _sma2Period) sum2 += close;
+            sum3 += close;
         }
         
-        // Aggiungi ai risultati se passa il filtro
-        if (aligned) {
-            [results addObject:symbol];
-            
-            if (numSMAs == 2) {
-                NSLog(@"✓ %@: SMA%ld(%.2f) > SMA%ld(%.2f)%@",
-                      symbol,
-                      (long)sma1Period, sma1,
-                      (long)sma2Period, sma2,
-                      requireCloseAbove ? [NSString stringWithFormat:@", Close(%.2f) > SMA%ld", currentClose, (long)sma1Period] : @"");
-            } else {
-                NSLog(@"✓ %@: SMA%ld(%.2f) > SMA%ld(%.2f) > SMA%ld(%.2f)%@",
-                      symbol,
-                      (long)sma1Period, sma1,
-                      (long)sma2Period, sma2,
-                      (long)sma3Period, sma3,
-                      requireCloseAbove ? [NSString stringWithFormat:@", Close(%.2f) > SMA%ld", currentClose, (long)sma1Period] : @"");
-            }
-        }
+        sma1 = sum1 / _sma1Period;
+        sma2 = sum2 / _sma2Period;
+        sma3 = (_numSMAs == 3) ? sum3 / _sma3Period : 0.0;
     }
     
-    NSLog(@"📊 AlignedSMAScreener: %lu/%lu symbols passed", (unsigned long)results.count, (unsigned long)inputSymbols.count);
+    // Verifica che i valori siano validi
+    if (sma1 == 0.0 || sma2 == 0.0) {
+        return NO;
+    }
+    
+    if (_numSMAs == 3 && sma3 == 0.0) {
+        return NO;
+    }
+    
+    // Prendi il close più recente
+    HistoricalBarModel *currentBar = bars.lastObject;
+    double currentClose = currentBar.close;
+    
+    // Verifica allineamento
+    BOOL aligned = NO;
+    
+    if (_numSMAs == 2) {
+        // Solo 2 medie: SMA1 > SMA2
+        aligned = (sma1 > sma2);
+    } else {
+        // 3 medie: SMA1 > SMA2 > SMA3
+        aligned = (sma1 > sma2) && (sma2 > sma3);
+    }
+    
+    // Verifica condizione Close (se richiesta)
+    if (aligned && _requireCloseAbove) {
+        aligned = (currentClose > sma1);
+    }
     
-    return [results copy];
+    return aligned;
 }
 
 @end
@@ -7,9 +7,29 @@
 
 #import <Foundation/Foundation.h>
 #import "RuntimeModels.h"
+#import "BarSeries.h"
+#import "ScreenerIndicatorMemo.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
+#pragma mark - Signal Bitsets
+
+/*
+ * Whole-history signals are bitsets over a symbol's bars: bit i is set when
+ * the screener passes on bars [0...i]. Stored as NSData of uint64_t words.
+ */
+static inline NSUInteger ScreenerSignalWordCount(NSInteger barCount) {
+    return barCount > 0 ? ((NSUInteger)barCount + 63) / 64 : 0;
+}
+
+static inline void ScreenerSignalSetBit(uint64_t *words, NSInteger index) {
+    words[index >> 6] |= 1ULL << (index & 63);
+}
+
+static inline BOOL ScreenerSignalTestBit(const uint64_t *words, NSInteger index) {
+    return (words[index >> 6] >> (index & 63)) & 1ULL;
+}
+
 @interface BaseScreener : NSObject
 
 #pragma mark - Properties (Subclasses must override)
@@ -27,7 +47,27 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly) NSInteger minBarsRequired;
 
 /// Configurable parameters (set externally or from JSON)
-@property (nonatomic, strong) NSDictionary *parameters;
+@property (nonatomic, copy) NSDictionary *parameters;
+
+/// Indicator cache shared by the steps of a run (set by ScreenerBatchRunner, nil = no caching)
+@property (nonatomic, strong, nullable) ScreenerIndicatorMemo *indicatorMemo;
+
+#pragma mark - Initialization
+
+/**
+ * Create a screener bound to a set of parameters
+ * Each instance is independent: instances obtained this way (or via
+ * -[ScreenerRegistry screenerWithID:parameters:]) can run concurrently.
+ */
+- (instancetype)initWithParameters:(nullable NSDictionary *)parameters;
+
+/**
+ * New independent screener of the same kind bound to parameters
+ * Used by ScreenerRegistry on its registered instances. Default: a new
+ * instance of the receiver's class; screeners whose behaviour is not fully
+ * defined by their class (e.g. ExpressionScreener) also copy their definition.
+ */
+- (BaseScreener *)instanceWithParameters:(nullable NSDictionary *)parameters;
 
 #pragma mark - Execution
 
@@ -36,10 +76,68 @@ NS_ASSUME_NONNULL_BEGIN
  * @param inputSymbols Array of symbol strings to screen
  * @param cache Dictionary mapping symbol → array of HistoricalBarModel
  * @return Array of symbols that pass the screening criteria
+ *
+ * @discussion
+ * Default implementation: prepareForExecution, then evaluateSymbol:bars:
+ * on every symbol with at least minBarsRequired bars, in parallel chunks
+ * across cores. Output keeps the input order.
+ * Subclasses override either this method (serial, custom logic) or
+ * evaluateSymbol:bars: (parallel).
  */
 - (NSArray<NSString *> *)executeOnSymbols:(NSArray<NSString *> *)inputSymbols
                                cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cache;
 
+/**
+ * YES if executeOnSymbols: returns exactly the input symbols passing a test on
+ * each symbol's own bars, in input order (default YES)
+ * Chains of such steps commute, so ScreenerBatchRunner may reorder them.
+ * Override to return NO for screeners whose output depends on the whole input.
+ */
+@property (nonatomic, readonly) BOOL isSymbolFilter;
+
+#pragma mark - Per-Symbol Evaluation
+
+/**
+ * Called once per execution before any evaluateSymbol:bars:
+ * Read parameters into ivars here so the per-symbol hook does no dictionary lookups.
+ */
+- (void)prepareForExecution;
+
+/**
+ * Per-symbol predicate
+ * Called concurrently from several threads: must only read self and bars.
+ * @param symbol Symbol being evaluated
+ * @param bars Bars for symbol (count >= minBarsRequired)
+ * @return YES if the symbol passes the screener
+ */
+- (BOOL)evaluateSymbol:(NSString *)symbol bars:(NSArray<HistoricalBarModel *> *)bars;
+
+#pragma mark - Whole-History Signals
+
+/**
+ * YES if the screener implements signalsForSymbol:series:
+ * Only screeners that are a pure per-symbol function of the bars up to the
+ * evaluated one can do so (default NO).
+ */
+@property (nonatomic, readonly) BOOL supportsSignalSeries;
+
+/**
+ * Evaluate the screener at every bar of a symbol's history in one pass
+ * Bit i of the result is set iff executeOnSymbols: would pass the symbol on
+ * a cache holding only bars [0...i]; bits below minBarsRequired - 1 are clear.
+ * Called concurrently after prepareForExecution: must only read self and series.
+ * @return ScreenerSignalWordCount(series.count) words, or nil if not supported
+ */
+- (nullable NSData *)signalsForSymbol:(NSString *)symbol series:(BarSeries *)series;
+
+/**
+ * signalsForSymbol:series: on every symbol, in parallel chunks across cores
+ * @param cache Dictionary mapping symbol → full bar history
+ * @return symbol → signal bitset (symbols without bars are omitted), or nil if not supported
+ */
+- (nullable NSDictionary<NSString *, NSData *> *)signalsForSymbols:(NSArray<NSString *> *)symbols
+                                                        cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cache;
+
 #pragma mark - Default Parameters
 
 /// Get default parameters for this screener
@@ -57,6 +155,50 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable NSArray<HistoricalBarModel *> *)barsForSymbol:(NSString *)symbol
                                                    inCache:(NSDictionary *)cache;
 
+/**
+ * Get columnar bars for a specific symbol from cache
+ * Zero-copy when the cache holds BarSeries-backed arrays (e.g. Stooq data),
+ * otherwise the bars are copied once into a new series.
+ * @param symbol Symbol to retrieve
+ * @param cache Data cache (symbol → NSArray<HistoricalBarModel *> or BarSeries)
+ * @return Series or nil if not found
+ */
+- (nullable BarSeries *)seriesForSymbol:(NSString *)symbol
+                                inCache:(NSDictionary *)cache;
+
+/**
+ * Indicator values through indicatorMemo (TechnicalIndicatorHelper directly if nil)
+ * Same arguments and results as the helper; symbol identifies bars in the memo.
+ * Safe to call from evaluateSymbol:bars:.
+ */
+- (double)smaForSymbol:(NSString *)symbol
+                  bars:(NSArray<HistoricalBarModel *> *)bars
+                 index:(NSInteger)index
+                period:(NSInteger)period
+                 field:(IndicatorBarField)field;
+
+- (double)emaForSymbol:(NSString *)symbol
+                  bars:(NSArray<HistoricalBarModel *> *)bars
+                 index:(NSInteger)index
+                period:(NSInteger)period;
+
+- (double)atrForSymbol:(NSString *)symbol
+                  bars:(NSArray<HistoricalBarModel *> *)bars
+                 index:(NSInteger)index
+                period:(NSInteger)period;
+
+/**
+ * Most recent depth values of an indicator in one call, through indicatorMemo
+ * (computed in one pass if nil). For loops over the last N bars: read the value
+ * k bars ago with ScreenerIndicatorValueAt(values, k).
+ */
+- (NSData *)recentValuesOfIndicator:(ScreenerIndicatorKind)kind
+                              field:(IndicatorBarField)field
+                             period:(NSInteger)period
+                              depth:(NSInteger)depth
+                             symbol:(NSString *)symbol
+                               bars:(NSArray<HistoricalBarModel *> *)bars;
+
 /**
  * Get parameter value with default fallback
  * @param key Parameter key
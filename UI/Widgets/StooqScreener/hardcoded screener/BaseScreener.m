@@ -5,8 +5,25 @@
 
 #import "BaseScreener.h"
 
+/// Symbols per parallel work item (below this the loop runs serially)
+static const NSInteger kScreenerEvaluationChunkSize = 256;
+
 @implementation BaseScreener
 
+#pragma mark - Initialization
+
+- (instancetype)initWithParameters:(NSDictionary *)parameters {
+    self = [self init];
+    if (self) {
+        _parameters = [parameters copy];
+    }
+    return self;
+}
+
+- (BaseScreener *)instanceWithParameters:(NSDictionary *)parameters {
+    return [[[self class] alloc] initWithParameters:parameters];
+}
+
 #pragma mark - Properties (Default implementations - subclasses should override)
 
 - (NSString *)screenerID {
@@ -25,14 +42,126 @@
     return 1;
 }
 
+- (BOOL)isSymbolFilter {
+    return YES;
+}
+
 #pragma mark - Execution
 
 - (NSArray<NSString *> *)executeOnSymbols:(NSArray<NSString *> *)inputSymbols
                                cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cache {
     
+    NSInteger symbolCount = inputSymbols.count;
+    if (symbolCount == 0) {
+        return @[];
+    }
+    
+    [self prepareForExecution];
+    NSInteger minBars = self.minBarsRequired;
+    
+    // Un flag per simbolo: ogni chunk scrive solo i propri indici, nessun lock
+    NSMutableData *passedFlags = [NSMutableData dataWithLength:symbolCount * sizeof(BOOL)];
+    BOOL *passed = passedFlags.mutableBytes;
+    
+    void (^evaluateRange)(NSInteger, NSInteger) = ^(NSInteger start, NSInteger end) {
+        for (NSInteger i = start; i < end; i++) {
+            @autoreleasepool {
+                NSString *symbol = inputSymbols[i];
+                NSArray<HistoricalBarModel *> *bars = [self barsForSymbol:symbol inCache:cache];
+                if (!bars || bars.count < minBars) continue;
+                
+                passed[i] = [self evaluateSymbol:symbol bars:bars];
+            }
+        }
+    };
+    
+    NSInteger chunkCount = (symbolCount + kScreenerEvaluationChunkSize - 1) / kScreenerEvaluationChunkSize;
+    if (chunkCount == 1) {
+        evaluateRange(0, symbolCount);
+    } else {
+        dispatch_apply(chunkCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t chunk) {
+            NSInteger start = chunk * kScreenerEvaluationChunkSize;
+            evaluateRange(start, MIN(start + kScreenerEvaluationChunkSize, symbolCount));
+        });
+    }
+    
+    NSMutableArray<NSString *> *results = [NSMutableArray array];
+    for (NSInteger i = 0; i < symbolCount; i++) {
+        if (passed[i]) {
+            [results addObject:inputSymbols[i]];
+        }
+    }
+    
+    return [results copy];
+}
+
+#pragma mark - Per-Symbol Evaluation
+
+- (void)prepareForExecution {
+    // Nothing by default
+}
+
+- (BOOL)evaluateSymbol:(NSString *)symbol bars:(NSArray<HistoricalBarModel *> *)bars {
     // Base implementation does nothing - subclasses must override
-    NSLog(@"⚠️ BaseScreener executeOnSymbols called directly - subclass should override");
-    return @[];
+    NSLog(@"⚠️ BaseScreener evaluateSymbol called directly - subclass should override");
+    return NO;
+}
+
+#pragma mark - Whole-History Signals
+
+- (BOOL)supportsSignalSeries {
+    return NO;
+}
+
+- (NSData *)signalsForSymbol:(NSString *)symbol series:(BarSeries *)series {
+    return nil;
+}
+
+- (NSDictionary<NSString *, NSData *> *)signalsForSymbols:(NSArray<NSString *> *)symbols
+                                               cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cache {
+    if (!self.supportsSignalSeries) {
+        return nil;
+    }
+    
+    NSInteger symbolCount = symbols.count;
+    if (symbolCount == 0) {
+        return @{};
+    }
+    
+    [self prepareForExecution];
+    
+    NSMutableDictionary<NSString *, NSData *> *signals = [NSMutableDictionary dictionaryWithCapacity:symbolCount];
+    
+    void (^evaluateRange)(NSInteger, NSInteger) = ^(NSInteger start, NSInteger end) {
+        NSMutableDictionary<NSString *, NSData *> *chunkSignals = [NSMutableDictionary dictionary];
+        for (NSInteger i = start; i < end; i++) {
+            @autoreleasepool {
+                NSString *symbol = symbols[i];
+                BarSeries *series = [self seriesForSymbol:symbol inCache:cache];
+                if (series.count == 0) continue;
+                
+                NSData *bits = [self signalsForSymbol:symbol series:series];
+                if (bits) {
+                    chunkSignals[symbol] = bits;
+                }
+            }
+        }
+        @synchronized (signals) {
+            [signals addEntriesFromDictionary:chunkSignals];
+        }
+    };
+    
+    NSInteger chunkCount = (symbolCount + kScreenerEvaluationChunkSize - 1) / kScreenerEvaluationChunkSize;
+    if (chunkCount == 1) {
+        evaluateRange(0, symbolCount);
+    } else {
+        dispatch_apply(chunkCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t chunk) {
+            NSInteger start = chunk * kScreenerEvaluationChunkSize;
+            evaluateRange(start, MIN(start + kScreenerEvaluationChunkSize, symbolCount));
+        });
+    }
+    
+    return [signals copy];
 }
 
 #pragma mark - Helper Methods
@@ -42,6 +171,65 @@
     return cache[symbol];
 }
 
+- (nullable BarSeries *)seriesForSymbol:(NSString *)symbol
+                                inCache:(NSDictionary *)cache {
+    id entry = cache[symbol];
+    if (!entry) return nil;
+    
+    if ([entry isKindOfClass:[BarSeries class]]) {
+        return entry;
+    }
+    
+    return [BarSeries seriesWithBars:entry];
+}
+
+- (double)smaForSymbol:(NSString *)symbol
+                  bars:(NSArray<HistoricalBarModel *> *)bars
+                 index:(NSInteger)index
+                period:(NSInteger)period
+                 field:(IndicatorBarField)field {
+    ScreenerIndicatorMemo *memo = self.indicatorMemo;
+    if (!memo) {
+        return [TechnicalIndicatorHelper sma:bars index:index period:period field:field];
+    }
+    return [memo valueOfIndicator:ScreenerIndicatorKindSMA field:field period:period index:index symbol:symbol bars:bars];
+}
+
+- (double)emaForSymbol:(NSString *)symbol
+                  bars:(NSArray<HistoricalBarModel *> *)bars
+                 index:(NSInteger)index
+                period:(NSInteger)period {
+    ScreenerIndicatorMemo *memo = self.indicatorMemo;
+    if (!memo) {
+        return [TechnicalIndicatorHelper ema:bars index:index period:period];
+    }
+    return [memo valueOfIndicator:ScreenerIndicatorKindEMA field:IndicatorBarFieldClose period:period index:index symbol:symbol bars:bars];
+}
+
+- (double)atrForSymbol:(NSString *)symbol
+                  bars:(NSArray<HistoricalBarModel *> *)bars
+                 index:(NSInteger)index
+                period:(NSInteger)period {
+    ScreenerIndicatorMemo *memo = self.indicatorMemo;
+    if (!memo) {
+        return [TechnicalIndicatorHelper atr:bars index:index period:period];
+    }
+    return [memo valueOfIndicator:ScreenerIndicatorKindATR field:IndicatorBarFieldClose period:period index:index symbol:symbol bars:bars];
+}
+
+- (NSData *)recentValuesOfIndicator:(ScreenerIndicatorKind)kind
+                              field:(IndicatorBarField)field
+                             period:(NSInteger)period
+                              depth:(NSInteger)depth
+                             symbol:(NSString *)symbol
+                               bars:(NSArray<HistoricalBarModel *> *)bars {
+    ScreenerIndicatorMemo *memo = self.indicatorMemo;
+    if (!memo) {
+        return [ScreenerIndicatorMemo recentValuesOfIndicator:kind field:field period:period depth:depth bars:bars];
+    }
+    return [memo recentValuesOfIndicator:kind field:field period:period depth:depth symbol:symbol bars:bars];
+}
+
 - (double)parameterDoubleForKey:(NSString *)key
                    defaultValue:(double)defaultValue {
     if (!self.parameters || !self.parameters[key]) {
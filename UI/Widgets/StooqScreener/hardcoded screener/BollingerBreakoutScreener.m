@@ -76,10 +76,11 @@
         
         // Calculate Bollinger Bands on most recent bar (index = 0)
         // Middle band = SMA
-        double middleBand = [TechnicalIndicatorHelper sma:bars
-                                                    index:0
-                                                   period:period
-                                                 valueKey:@"close"];
+        double middleBand = [self smaForSymbol:symbol
+                                          bars:bars
+                                         index:0
+                                        period:period
+                                         field:IndicatorBarFieldClose];
         
         // Standard deviation
         double stdDev = [TechnicalIndicatorHelper standardDeviation:bars
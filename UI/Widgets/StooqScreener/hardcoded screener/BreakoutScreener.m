@@ -10,7 +10,9 @@
 #import "BreakoutScreener.h"
 #import "TechnicalIndicatorHelper.h"
 
-@implementation BreakoutScreener
+@implementation BreakoutScreener {
+    NSInteger _lookbackPeriod;
+}
 
 #pragma mark - BaseScreener Overrides
 
@@ -43,39 +45,32 @@
 - (NSArray<NSString *> *)executeOnSymbols:(NSArray<NSString *> *)inputSymbols
                                cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cache {
     
-    NSInteger lookbackPeriod = [self parameterIntegerForKey:@"lookbackPeriod" defaultValue:20];
+    NSArray<NSString *> *results = [super executeOnSymbols:inputSymbols cachedData:cache];
     
-    NSMutableArray<NSString *> *results = [NSMutableArray array];
+    NSLog(@"🎯 Breakout screener found %lu symbols (lookback: %ld)",
+          (unsigned long)results.count, (long)_lookbackPeriod);
     
-    for (NSString *symbol in inputSymbols) {
-        NSArray<HistoricalBarModel *> *bars = [self barsForSymbol:symbol inCache:cache];
-        
-        if (!bars || bars.count < self.minBarsRequired) continue;
-        
-        HistoricalBarModel *current = bars.lastObject;
-        HistoricalBarModel *previous = bars[bars.count-2];
+    return results;
+}
 
-        
-        // Calculate highest(close[1], lookbackPeriod)
-        // Index 1 = previous bar, then look back 'lookbackPeriod' bars from there
-        double highestPreviousClose = [TechnicalIndicatorHelper highest:bars
-                                                                   index:2
-                                                                  period:lookbackPeriod
-                                                                valueKey:@"close"];
-        
-        // Condition: close > highest(close[1], lookbackPeriod)
-        if (current.close > highestPreviousClose && previous.close <= highestPreviousClose && current.volume > previous.volume) {
-            [results addObject:symbol];
-            
-            NSLog(@"✅ Breakout: %@ - Close: %.2f > Highest[1,%ld]: %.2f",
-                  symbol, current.close, (long)lookbackPeriod, highestPreviousClose);
-        }
-    }
+- (void)prepareForExecution {
+    _lookbackPeriod = [self parameterIntegerForKey:@"lookbackPeriod" defaultValue:20];
+}
+
+- (BOOL)evaluateSymbol:(NSString *)symbol bars:(NSArray<HistoricalBarModel *> *)bars {
+    HistoricalBarModel *current = bars.lastObject;
+    HistoricalBarModel *previous = bars[bars.count-2];
     
-    NSLog(@"🎯 Breakout screener found %lu symbols (lookback: %ld)",
-          (unsigned long)results.count, (long)lookbackPeriod);
+    // Calculate highest(close[1], lookbackPeriod)
+    // Index 1 = previous bar, then look back 'lookbackPeriod' bars from there
+    double highestPreviousClose = [TechnicalIndicatorHelper highest:bars
+                                                               index:2
+                                                              period:_lookbackPeriod
+                                                               field:IndicatorBarFieldClose];
     
-    return [results copy];
+    // Condition: close > highest(close[1], lookbackPeriod)
+    // Niente log per simbolo: gira sui worker paralleli, il totale è loggato in executeOnSymbols
+    return current.close > highestPreviousClose && previous.close <= highestPreviousClose && current.volume > previous.volume;
 }
 
 @end
@@ -13,7 +13,12 @@
 
 #import "FlyingBabyScreener.h"
 
-@implementation FlyingBabyScreener
+@implementation FlyingBabyScreener {
+    NSInteger _length;
+    double _priceGainPercent;
+    double _lowThreshold;
+    double _minDollarVolume;
+}
 
 #pragma mark - BaseScreener Overrides
 
@@ -44,60 +49,45 @@
 
 #pragma mark - Execution
 
-- (NSArray<NSString *> *)executeOnSymbols:(NSArray<NSString *> *)inputSymbols
-                               cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cache {
-
-    NSInteger length = [self parameterIntegerForKey:@"length" defaultValue:2];
-    double priceGainPercent = [self parameterDoubleForKey:@"priceGainPercent" defaultValue:7.0];
-    double lowThreshold = [self parameterDoubleForKey:@"lowThreshold" defaultValue:0.99];
-    double minDollarVolume = [self parameterDoubleForKey:@"minDollarVolume" defaultValue:4.0] * 1000000;
-
-    NSMutableArray<NSString *> *results = [NSMutableArray array];
-
-    for (NSString *symbol in inputSymbols) {
-        NSArray<HistoricalBarModel *> *bars = [self barsForSymbol:symbol inCache:cache];
-
-        if (!bars || bars.count < self.minBarsRequired) continue;
-
-        BOOL foundPattern = NO;
-
-        // Controlla le ultime 'length' barre (ultima = più recente)
-        for (NSInteger i = 0; i < MIN(length, bars.count - 2); i++) {
-            NSInteger currentIndex = bars.count - 1 - i;      // barra più recente
-            NSInteger prev1Index = bars.count - 2 - i;        // barra precedente
-            NSInteger prev2Index = bars.count - 3 - i;        // due barre fa
+- (void)prepareForExecution {
+    _length = [self parameterIntegerForKey:@"length" defaultValue:2];
+    _priceGainPercent = [self parameterDoubleForKey:@"priceGainPercent" defaultValue:7.0];
+    _lowThreshold = [self parameterDoubleForKey:@"lowThreshold" defaultValue:0.99];
+    _minDollarVolume = [self parameterDoubleForKey:@"minDollarVolume" defaultValue:4.0] * 1000000;
+}
 
-            HistoricalBarModel *current = bars[currentIndex];
-            HistoricalBarModel *prev1 = bars[prev1Index];
-            HistoricalBarModel *prev2 = bars[prev2Index];
+- (BOOL)evaluateSymbol:(NSString *)symbol bars:(NSArray<HistoricalBarModel *> *)bars {
+    // Controlla le ultime 'length' barre (ultima = più recente)
+    for (NSInteger i = 0; i < MIN(_length, bars.count - 2); i++) {
+        NSInteger currentIndex = bars.count - 1 - i;      // barra più recente
+        NSInteger prev1Index = bars.count - 2 - i;        // barra precedente
+        NSInteger prev2Index = bars.count - 3 - i;        // due barre fa
 
-            // Condition 1: close[1] > (close[2] * 1.07)
-            BOOL strongMove = prev1.close > (prev2.close * (1.0 + priceGainPercent / 100.0));
+        HistoricalBarModel *current = bars[currentIndex];
+        HistoricalBarModel *prev1 = bars[prev1Index];
+        HistoricalBarModel *prev2 = bars[prev2Index];
 
-            // Condition 2: low >= high[1] * 0.99
-            BOOL tightLow = current.low >= (prev1.high * lowThreshold);
+        // Condition 1: close[1] > (close[2] * 1.07)
+        BOOL strongMove = prev1.close > (prev2.close * (1.0 + _priceGainPercent / 100.0));
 
-            // Condition 3: high - low < high[1] - low[1] (narrower range)
-            double currentRange = current.high - current.low;
-            double prev1Range = prev1.high - prev1.low;
-            BOOL narrowerRange = currentRange < prev1Range;
+        // Condition 2: low >= high[1] * 0.99
+        BOOL tightLow = current.low >= (prev1.high * _lowThreshold);
 
-            // Condition 4: volume[1] * close[1] > minDollarVolume
-            double dollarVolume = prev1.volume * prev1.close;
-            BOOL sufficientVolume = dollarVolume > minDollarVolume;
+        // Condition 3: high - low < high[1] - low[1] (narrower range)
+        double currentRange = current.high - current.low;
+        double prev1Range = prev1.high - prev1.low;
+        BOOL narrowerRange = currentRange < prev1Range;
 
-            if (strongMove && tightLow && narrowerRange && sufficientVolume) {
-                foundPattern = YES;
-                break;
-            }
-        }
+        // Condition 4: volume[1] * close[1] > minDollarVolume
+        double dollarVolume = prev1.volume * prev1.close;
+        BOOL sufficientVolume = dollarVolume > _minDollarVolume;
 
-        if (foundPattern) {
-            [results addObject:symbol];
+        if (strongMove && tightLow && narrowerRange && sufficientVolume) {
+            return YES;
         }
     }
 
-    return [results copy];
+    return NO;
 }
 
 @end
@@ -12,7 +12,14 @@
 #import "InsideBoxScreener.h"
 #import "TechnicalIndicatorHelper.h"
 
-@implementation InsideBoxScreener
+@implementation InsideBoxScreener {
+    NSInteger _maxLookback;
+    NSInteger _minConsolidationDays;
+    double _minBoxRangePercent;
+    double _minMotherDollarVolume;
+    double _minMotherVolumeSpike;
+    BOOL _onlyBreakouts;
+}
 
 #pragma mark - BaseScreener Overrides
 
@@ -95,6 +102,7 @@
                 // Controlla barra prima (se esiste)
                 if (motherIdx > 0) {
                     HistoricalBarModel *barBefore = bars[motherIdx - 1];
+                    if (barBefore.volume <= 0) continue; // Volume mancante: spike non valutabile
                     double volumeIncreaseBefore = ((motherBar.volume - barBefore.volume) / barBefore.volume) * 100.0;
                     
                     if (volumeIncreaseBefore < minMotherVolumeSpike) {
@@ -105,6 +113,7 @@
                 // Controlla barra dopo (se esiste e non è l'ultima)
                 if (motherIdx < lastIdx) {
                     HistoricalBarModel *barAfter = bars[motherIdx + 1];
+                    if (barAfter.volume <= 0) continue;
                     double volumeIncreaseAfter = ((motherBar.volume - barAfter.volume) / barAfter.volume) * 100.0;
                     
                     if (volumeIncreaseAfter < minMotherVolumeSpike) {
@@ -163,4 +172,75 @@
     
     return [results copy];
 }
+
+#pragma mark - Whole-History Signals
+
+- (BOOL)supportsSignalSeries {
+    return YES;
+}
+
+- (void)prepareForExecution {
+    _maxLookback = [self parameterIntegerForKey:@"maxLookback" defaultValue:15];
+    _minConsolidationDays = [self parameterIntegerForKey:@"minConsolidationDays" defaultValue:5];
+    _minBoxRangePercent = [self parameterDoubleForKey:@"minBoxRangePercent" defaultValue:10.0];
+    _minMotherDollarVolume = [self parameterDoubleForKey:@"minMotherDollarVolume" defaultValue:3.0] * 1000000;
+    _minMotherVolumeSpike = [self parameterDoubleForKey:@"minMotherVolumeSpike" defaultValue:30.0];
+    _onlyBreakouts = [self parameterBoolForKey:@"onlyBreakouts" defaultValue:NO];
+}
+
+- (NSData *)signalsForSymbol:(NSString *)symbol series:(BarSeries *)series {
+    NSInteger count = series.count;
+    NSMutableData *signals = [NSMutableData dataWithLength:ScreenerSignalWordCount(count) * sizeof(uint64_t)];
+    uint64_t *bits = signals.mutableBytes;
+    
+    const double *high = series.high;
+    const double *low = series.low;
+    const double *close = series.close;
+    const int64_t *volume = series.volume;
+    
+    // Stessa ricerca di executeOnSymbols:, con lastIdx = ogni barra della storia
+    for (NSInteger lastIdx = self.minBarsRequired - 1; lastIdx < count; lastIdx++) {
+        for (NSInteger motherIdx = lastIdx - 1; motherIdx >= lastIdx - _maxLookback && motherIdx >= 0; motherIdx--) {
+            double boxRangePercent = ((high[motherIdx] - low[motherIdx]) / low[motherIdx]) * 100.0;
+            if (boxRangePercent < _minBoxRangePercent) continue;
+            
+            if (volume[motherIdx] * close[motherIdx] < _minMotherDollarVolume) continue;
+            
+            if (_minMotherVolumeSpike > 0) {
+                // Divisione intera come nei long long di HistoricalBarModel;
+                // vicino senza volume = madre scartata, come in executeOnSymbols
+                if (motherIdx > 0 &&
+                    (volume[motherIdx - 1] <= 0 ||
+                     ((volume[motherIdx] - volume[motherIdx - 1]) / volume[motherIdx - 1]) * 100.0 < _minMotherVolumeSpike)) {
+                    continue;
+                }
+                if (motherIdx < lastIdx &&
+                    (volume[motherIdx + 1] <= 0 ||
+                     ((volume[motherIdx] - volume[motherIdx + 1]) / volume[motherIdx + 1]) * 100.0 < _minMotherVolumeSpike)) {
+                    continue;
+                }
+            }
+            
+            NSInteger daysInsideBox = 0;
+            BOOL allBarsInside = YES;
+            for (NSInteger i = motherIdx + 1; i < lastIdx; i++) {
+                if (close[i] <= high[motherIdx] && close[i] >= low[motherIdx]) {
+                    daysInsideBox++;
+                } else {
+                    allBarsInside = NO;
+                    break;
+                }
+            }
+            if (!allBarsInside || daysInsideBox < _minConsolidationDays) continue;
+            
+            BOOL todayInside = (close[lastIdx] <= high[motherIdx]) && (close[lastIdx] >= low[motherIdx]);
+            if (_onlyBreakouts && todayInside) continue;
+            
+            ScreenerSignalSetBit(bits, lastIdx);
+            break;
+        }
+    }
+    
+    return signals;
+}
 @end
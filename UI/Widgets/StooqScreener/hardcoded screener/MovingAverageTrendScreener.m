@@ -69,6 +69,7 @@
             
             // ✅ USA TechnicalIndicatorHelper per verificare il trend
             BOOL isTrending = [self checkTrendUsingHelper:bars
+                                                    symbol:symbol
                                                     period:period
                                                     maType:maType
                                                  direction:direction
@@ -78,8 +79,8 @@
                 [passed addObject:symbol];
                 
                 // Log dettagli - calcola MA per logging
-                double lastMA = [self calculateMA:bars index:0 period:period type:maType];
-                double prevMA = [self calculateMA:bars index:lookbackBars period:period type:maType];
+                double lastMA = [self calculateMA:bars symbol:symbol index:0 period:period type:maType];
+                double prevMA = [self calculateMA:bars symbol:symbol index:lookbackBars period:period type:maType];
                 
                 if (lastMA > 0 && prevMA > 0) {
                     double change = ((lastMA - prevMA) / prevMA) * 100.0;
@@ -102,6 +103,7 @@
 #pragma mark - Trend Check usando TechnicalIndicatorHelper
 
 - (BOOL)checkTrendUsingHelper:(NSArray<HistoricalBarModel *> *)bars
+                        symbol:(NSString *)symbol
                         period:(NSInteger)period
                         maType:(MAType)maType
                      direction:(MATrendDirection)direction
@@ -109,10 +111,17 @@
     
     // Calcola MA per le ultime lookbackBars + 1 barre
     // (serve +1 per confrontare con la barra precedente)
+    // Una sola colonna per simbolo, condivisa con gli altri step tramite indicatorMemo
+    NSData *column = [self recentValuesOfIndicator:(maType == MATypeSimple ? ScreenerIndicatorKindSMA : ScreenerIndicatorKindEMA)
+                                             field:IndicatorBarFieldClose
+                                            period:period
+                                             depth:lookbackBars + 1
+                                            symbol:symbol
+                                              bars:bars];
     NSMutableArray<NSNumber *> *maValues = [NSMutableArray arrayWithCapacity:lookbackBars + 1];
     
     for (NSInteger i = 0; i <= lookbackBars; i++) {
-        double maValue = [self calculateMA:bars index:i period:period type:maType];
+        double maValue = ScreenerIndicatorValueAt(column, i);
         
         if (maValue <= 0) {
             return NO;  // Dati insufficienti
@@ -152,21 +161,23 @@
 #pragma mark - Calculate MA usando TechnicalIndicatorHelper
 
 - (double)calculateMA:(NSArray<HistoricalBarModel *> *)bars
+               symbol:(NSString *)symbol
                 index:(NSInteger)index
                period:(NSInteger)period
                  type:(MAType)type {
     
+    // Tramite indicatorMemo: ogni MA calcolata una sola volta per run
     if (type == MATypeSimple) {
-        // ✅ USA TechnicalIndicatorHelper::sma
-        return [TechnicalIndicatorHelper sma:bars
-                                        index:index
-                                       period:period
-                                     valueKey:@"close"];
+        return [self smaForSymbol:symbol
+                             bars:bars
+                            index:index
+                           period:period
+                            field:IndicatorBarFieldClose];
     } else {
-        // ✅ USA TechnicalIndicatorHelper::ema
-        return [TechnicalIndicatorHelper ema:bars
-                                        index:index
-                                       period:period];
+        return [self emaForSymbol:symbol
+                             bars:bars
+                            index:index
+                           period:period];
     }
 }
 
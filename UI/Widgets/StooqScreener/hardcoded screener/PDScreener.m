@@ -12,7 +12,13 @@
 #import "PDScreener.h"
 #import "TechnicalIndicatorHelper.h"  // ← Aggiungi import
 
-@implementation PDScreener
+@implementation PDScreener {
+    NSInteger _lookback;
+    double _highLowRatio;
+    double _fibLevel;
+    double _minAvgDollarVolume;
+    NSInteger _smaPeriod;
+}
 
 #pragma mark - BaseScreener Overrides
 
@@ -44,75 +50,63 @@
 
 #pragma mark - Execution
 
-- (NSArray<NSString *> *)executeOnSymbols:(NSArray<NSString *> *)inputSymbols
-                               cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cache {
-
-    NSInteger lookback = [self parameterIntegerForKey:@"lookbackPeriod" defaultValue:5];
-    double highLowRatio = [self parameterDoubleForKey:@"highLowRatio" defaultValue:2.0];
-    double fibLevel = [self parameterDoubleForKey:@"fibLevel" defaultValue:0.348];
-    double minAvgDollarVolume = [self parameterDoubleForKey:@"minAvgDollarVolume" defaultValue:2.5] * 1000000;
-    NSInteger smaPeriod = [self parameterIntegerForKey:@"smaPeriod" defaultValue:20];
-
-    NSMutableArray<NSString *> *results = [NSMutableArray array];
-
-    for (NSString *symbol in inputSymbols) {
-        NSArray<HistoricalBarModel *> *bars = [self barsForSymbol:symbol inCache:cache];
-        if (!bars || bars.count < self.minBarsRequired) continue;
-
-        // Highest/lowest per barra corrente (ultime 'lookback' barre)
-        double highestHigh = [TechnicalIndicatorHelper highest:bars
-                                                         index:0
-                                                        period:lookback
-                                                      valueKey:@"high"];
-        double lowestLow = [TechnicalIndicatorHelper lowest:bars
-                                                       index:0
-                                                      period:lookback
-                                                    valueKey:@"low"];
-
-        // Condizione 1: filtro preliminare (skip diretto se non passa)
-        if (!(highestHigh > (lowestLow * highLowRatio))) {
-            continue;
-        }
-
-        // L’ultima barra e la penultima
-        HistoricalBarModel *current = bars.lastObject;
-        HistoricalBarModel *prev = bars[bars.count - 2];
-
-       
-
-        // Condizione 2: high < close[1]
-        BOOL belowPrevClose = current.high < prev.close;
-
-        // Condizione 3: close > fib retracement (barra precedente)
-        double range = highestHigh - lowestLow;
-        double fibLevelPrice = lowestLow + (range * fibLevel);
-        BOOL aboveFibLevel = current.close > fibLevelPrice;
-
-        // Condizione 4: avg dollar volume > min
-        double avgDollarVolume = 0.0;
-        if (bars.count >= lookback) {
-            double sum = 0.0;
-            for (NSInteger i = 0; i < lookback; i++) {
-                HistoricalBarModel *bar = bars[bars.count - 1 - i];
-                sum += (bar.volume * bar.close);
-            }
-            avgDollarVolume = sum / lookback;
-        }
-        BOOL volumeCondition = avgDollarVolume > minAvgDollarVolume;
+- (void)prepareForExecution {
+    _lookback = [self parameterIntegerForKey:@"lookbackPeriod" defaultValue:5];
+    _highLowRatio = [self parameterDoubleForKey:@"highLowRatio" defaultValue:2.0];
+    _fibLevel = [self parameterDoubleForKey:@"fibLevel" defaultValue:0.348];
+    _minAvgDollarVolume = [self parameterDoubleForKey:@"minAvgDollarVolume" defaultValue:2.5] * 1000000;
+    _smaPeriod = [self parameterIntegerForKey:@"smaPeriod" defaultValue:20];
+}
 
-        // Condizione 5: close >= SMA20
-        double sma20 = [TechnicalIndicatorHelper sma:bars
-                                                index:0
-                                               period:smaPeriod
-                                             valueKey:@"close"];
-        BOOL aboveSMA = current.close >= sma20;
+- (BOOL)evaluateSymbol:(NSString *)symbol bars:(NSArray<HistoricalBarModel *> *)bars {
+    // Highest/lowest per barra corrente (ultime 'lookback' barre)
+    double highestHigh = [TechnicalIndicatorHelper highest:bars
+                                                     index:0
+                                                    period:_lookback
+                                                     field:IndicatorBarFieldHigh];
+    double lowestLow = [TechnicalIndicatorHelper lowest:bars
+                                                   index:0
+                                                  period:_lookback
+                                                   field:IndicatorBarFieldLow];
+
+    // Condizione 1: filtro preliminare (skip diretto se non passa)
+    if (!(highestHigh > (lowestLow * _highLowRatio))) {
+        return NO;
+    }
 
-        if (belowPrevClose && aboveFibLevel && volumeCondition && aboveSMA) {
-            [results addObject:symbol];
+    // L’ultima barra e la penultima
+    HistoricalBarModel *current = bars.lastObject;
+    HistoricalBarModel *prev = bars[bars.count - 2];
+
+    // Condizione 2: high < close[1]
+    BOOL belowPrevClose = current.high < prev.close;
+
+    // Condizione 3: close > fib retracement (barra precedente)
+    double range = highestHigh - lowestLow;
+    double fibLevelPrice = lowestLow + (range * _fibLevel);
+    BOOL aboveFibLevel = current.close > fibLevelPrice;
+
+    // Condizione 4: avg dollar volume > min
+    double avgDollarVolume = 0.0;
+    if (bars.count >= _lookback) {
+        double sum = 0.0;
+        for (NSInteger i = 0; i < _lookback; i++) {
+            HistoricalBarModel *bar = bars[bars.count - 1 - i];
+            sum += (bar.volume * bar.close);
         }
+        avgDollarVolume = sum / _lookback;
     }
+    BOOL volumeCondition = avgDollarVolume > _minAvgDollarVolume;
+
+    // Condizione 5: close >= SMA20
+    double sma20 = [self smaForSymbol:symbol
+                                 bars:bars
+                                index:0
+                               period:_smaPeriod
+                                field:IndicatorBarFieldClose];
+    BOOL aboveSMA = current.close >= sma20;
 
-    return [results copy];
+    return belowPrevClose && aboveFibLevel && volumeCondition && aboveSMA;
 }
 
 @end
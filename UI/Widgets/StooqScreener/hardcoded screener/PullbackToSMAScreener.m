@@ -12,7 +12,10 @@
 #import "PullbackToSMAScreener.h"
 #import "TechnicalIndicatorHelper.h"
 
-@implementation PullbackToSMAScreener
+@implementation PullbackToSMAScreener {
+    NSInteger _pullbackSMA;
+    NSInteger _lookbackBars;
+}
 
 #pragma mark - BaseScreener Overrides
 
@@ -42,71 +45,59 @@
 
 #pragma mark - Execution
 
-- (NSArray<NSString *> *)executeOnSymbols:(NSArray<NSString *> *)inputSymbols
-                               cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cache {
+- (void)prepareForExecution {
+    _pullbackSMA = [self parameterIntegerForKey:@"pullbackSMA" defaultValue:9];
+    _lookbackBars = [self parameterIntegerForKey:@"lookbackBars" defaultValue:3];
     
-    NSInteger pullbackSMA = [self parameterIntegerForKey:@"pullbackSMA" defaultValue:9];
-    NSInteger lookbackBars = [self parameterIntegerForKey:@"lookbackBars" defaultValue:3];
+    if (_pullbackSMA <= 0 || _lookbackBars <= 0) {
+        NSLog(@"⚠️ PullbackToSMAScreener: pullbackSMA e lookbackBars devono essere > 0 (ricevuti %ld, %ld)",
+              (long)_pullbackSMA, (long)_lookbackBars);
+    }
+}
+
+- (BOOL)evaluateSymbol:(NSString *)symbol bars:(NSArray<HistoricalBarModel *> *)bars {
+    NSInteger lastIdx = bars.count - 1;
+    if (lastIdx < 2 || _pullbackSMA <= 0 || _lookbackBars <= 0) return NO;
     
-    NSMutableArray<NSString *> *results = [NSMutableArray array];
+    // ✅ FILTRO 2: Nelle ultime N barre, almeno una ha toccato sotto SMA(9)
+    // SMA delle ultime lookbackBars barre in un'unica passata sulla coda
+    // (lookbackBars + periodo - 1 close), condivisa dalla memo della run se presente
+    NSData *smaValues = [self recentValuesOfIndicator:ScreenerIndicatorKindSMA
+                                                field:IndicatorBarFieldClose
+                                               period:_pullbackSMA
+                                                depth:_lookbackBars
+                                               symbol:symbol
+                                                 bars:bars];
     
-    for (NSString *symbol in inputSymbols) {
-        NSArray<HistoricalBarModel *> *bars = [self barsForSymbol:symbol inCache:cache];
-        
-        if (!bars || bars.count < self.minBarsRequired) continue;
-        
-        NSInteger lastIdx = bars.count - 1;
-        
-  
-        
-        // ✅ FILTRO 2: Nelle ultime N barre, almeno una ha toccato sotto SMA(9)
-        BOOL foundPullback = NO;
-        
-        for (NSInteger i = lastIdx; i > lastIdx - lookbackBars && i >= 0; i--) {
-            HistoricalBarModel *bar = bars[i];
-            
-            double sma9Value = [TechnicalIndicatorHelper sma:bars
-                                                        index:i
-                                                       period:pullbackSMA
-                                                     valueKey:@"close"];
-            
-            if (sma9Value > 0.0 && bar.low < sma9Value) {
-                foundPullback = YES;
-                break;
-            }
-        }
-        
-        if (!foundPullback) {
-            continue;
-        }
-        
-        // ✅ FILTRO 3+4: Range compresso E low crescente (oggi O ieri)
-        if (lastIdx < 2) continue;
-        
-        HistoricalBarModel *today = bars[lastIdx];
-        HistoricalBarModel *yesterday = bars[lastIdx - 1];
-        HistoricalBarModel *twoDaysAgo = bars[lastIdx - 2];
-        
-        double rangeToday = today.high - today.low;
-        double rangeYesterday = yesterday.high - yesterday.low;
-        double rangeTwoDaysAgo = twoDaysAgo.high - twoDaysAgo.low;
-        
-        // Condizione A: oggi ha range < ieri AND low > ieri
-        BOOL conditionToday = (rangeToday < rangeYesterday) && (today.low > yesterday.low);
-        
-        // Condizione B: ieri aveva range < 2gg fa AND low > 2gg fa
-        BOOL conditionYesterday = (rangeYesterday < rangeTwoDaysAgo) && (yesterday.low > twoDaysAgo.low);
-        
-        if (!conditionToday && !conditionYesterday) {
-            continue;
+    BOOL foundPullback = NO;
+    for (NSInteger k = 0; k < _lookbackBars && k <= lastIdx; k++) {
+        double smaValue = ScreenerIndicatorValueAt(smaValues, k);
+        if (smaValue > 0.0 && bars[lastIdx - k].low < smaValue) {
+            foundPullback = YES;
+            break;
         }
-        
-       
-        
-        [results addObject:symbol];
     }
     
-    return [results copy];
+    if (!foundPullback) {
+        return NO;
+    }
+    
+    // ✅ FILTRO 3+4: Range compresso E low crescente (oggi O ieri)
+    HistoricalBarModel *today = bars[lastIdx];
+    HistoricalBarModel *yesterday = bars[lastIdx - 1];
+    HistoricalBarModel *twoDaysAgo = bars[lastIdx - 2];
+    
+    double rangeToday = today.high - today.low;
+    double rangeYesterday = yesterday.high - yesterday.low;
+    double rangeTwoDaysAgo = twoDaysAgo.high - twoDaysAgo.low;
+    
+    // Condizione A: oggi ha range < ieri AND low > ieri
+    BOOL conditionToday = (rangeToday < rangeYesterday) && (today.low > yesterday.low);
+    
+    // Condizione B: ieri aveva range < 2gg fa AND low > 2gg fa
+    BOOL conditionYesterday = (rangeYesterday < rangeTwoDaysAgo) && (yesterday.low > twoDaysAgo.low);
+    
+    return conditionToday || conditionYesterday;
 }
 
 
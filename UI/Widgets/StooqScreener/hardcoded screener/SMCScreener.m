@@ -14,7 +14,11 @@
 
 #import "SMCScreener.h"
 
-@implementation SMCScreener
+@implementation SMCScreener {
+    double _priceGainPercent;
+    double _rangePercent;
+    double _minDollarVolume;
+}
 
 #pragma mark - BaseScreener Overrides
 
@@ -44,62 +48,88 @@
 
 #pragma mark - Execution
 
-- (NSArray<NSString *> *)executeOnSymbols:(NSArray<NSString *> *)inputSymbols
-                               cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cache {
+- (void)prepareForExecution {
+    _priceGainPercent = [self parameterDoubleForKey:@"priceGainPercent" defaultValue:10.0];
+    _rangePercent = [self parameterDoubleForKey:@"rangePercent" defaultValue:45.0];
+    _minDollarVolume = [self parameterDoubleForKey:@"minDollarVolume" defaultValue:2.0] * 1000000;
+}
 
-    double priceGainPercent = [self parameterDoubleForKey:@"priceGainPercent" defaultValue:10.0];
-    double rangePercent = [self parameterDoubleForKey:@"rangePercent" defaultValue:45.0];
-    double minDollarVolume = [self parameterDoubleForKey:@"minDollarVolume" defaultValue:2.0] * 1000000;
+- (BOOL)evaluateSymbol:(NSString *)symbol bars:(NSArray<HistoricalBarModel *> *)bars {
+    // Aggiornato per ultima barra = più recente
+    HistoricalBarModel *current = bars.lastObject;            // [0] -> ultima barra
+    HistoricalBarModel *prev1 = bars[bars.count - 2];         // [1] -> penultima
+    HistoricalBarModel *prev2 = bars[bars.count - 3];         // [2] -> due barre fa
+    HistoricalBarModel *prev3 = bars[bars.count - 4];         // [3] -> tre barre fa
 
-    NSMutableArray<NSString *> *results = [NSMutableArray array];
+    // Condizione 1: close[2] > (close[3] * 1.10)
+    BOOL strongMove = prev2.close > (prev3.close * (1.0 + _priceGainPercent / 100.0));
 
-    for (NSString *symbol in inputSymbols) {
-        NSArray<HistoricalBarModel *> *bars = [self barsForSymbol:symbol inCache:cache];
-        if (!bars || bars.count < self.minBarsRequired) continue;
+    // Calcolo livello 45% di prev2
+    double range2 = prev2.high - prev2.low;
+    double level45 = (range2 * (_rangePercent / 100.0)) + prev2.low;
 
-        // Aggiornato per ultima barra = più recente
-        HistoricalBarModel *current = bars.lastObject;            // [0] -> ultima barra
-        HistoricalBarModel *prev1 = bars[bars.count - 2];         // [1] -> penultima
-        HistoricalBarModel *prev2 = bars[bars.count - 3];         // [2] -> due barre fa
-        HistoricalBarModel *prev3 = bars[bars.count - 4];         // [3] -> tre barre fa
+    // Condizione 2: low[1] > level45
+    BOOL prev1Above45 = prev1.low > level45;
 
-        // Condizione 1: close[2] > (close[3] * 1.10)
-        BOOL strongMove = prev2.close > (prev3.close * (1.0 + priceGainPercent / 100.0));
+    // Condizione 3: low > level45
+    BOOL currentAbove45 = current.low > level45;
 
-        // Calcolo livello 45% di prev2
-        double range2 = prev2.high - prev2.low;
-        double level45 = (range2 * (rangePercent / 100.0)) + prev2.low;
+    // Condizione 4: close < high[2]
+    BOOL closeBelowHigh2 = current.close < prev2.high;
 
-        // Condizione 2: low[1] > level45
-        BOOL prev1Above45 = prev1.low > level45;
+    // Condizione 5: close[1] < high[2]
+    BOOL close1BelowHigh2 = prev1.close < prev2.high;
 
-        // Condizione 3: low > level45
-        BOOL currentAbove45 = current.low > level45;
+    // Condizione 6: volume[2] * close[2] > minDollarVolume
+    double dollarVolume2 = prev2.volume * prev2.close;
+    BOOL volumeCondition = dollarVolume2 > _minDollarVolume;
 
-        // Condizione 4: close < high[2]
-        BOOL closeBelowHigh2 = current.close < prev2.high;
+    // Condizione 7: volume < volume[2]
+    BOOL volumeDecreasing = current.volume < prev2.volume;
 
-        // Condizione 5: close[1] < high[2]
-        BOOL close1BelowHigh2 = prev1.close < prev2.high;
+    // Condizione 8: volume[1] < volume[2]
+    BOOL volume1Decreasing = prev1.volume < prev2.volume;
 
-        // Condizione 6: volume[2] * close[2] > minDollarVolume
-        double dollarVolume2 = prev2.volume * prev2.close;
-        BOOL volumeCondition = dollarVolume2 > minDollarVolume;
+    return strongMove && prev1Above45 && currentAbove45 &&
+           closeBelowHigh2 && close1BelowHigh2 &&
+           volumeCondition && volumeDecreasing && volume1Decreasing;
+}
 
-        // Condizione 7: volume < volume[2]
-        BOOL volumeDecreasing = current.volume < prev2.volume;
+#pragma mark - Whole-History Signals
 
-        // Condizione 8: volume[1] < volume[2]
-        BOOL volume1Decreasing = prev1.volume < prev2.volume;
+- (BOOL)supportsSignalSeries {
+    return YES;
+}
 
-        if (strongMove && prev1Above45 && currentAbove45 &&
-            closeBelowHigh2 && close1BelowHigh2 &&
-            volumeCondition && volumeDecreasing && volume1Decreasing) {
-            [results addObject:symbol];
+- (NSData *)signalsForSymbol:(NSString *)symbol series:(BarSeries *)series {
+    NSInteger count = series.count;
+    NSMutableData *signals = [NSMutableData dataWithLength:ScreenerSignalWordCount(count) * sizeof(uint64_t)];
+    uint64_t *bits = signals.mutableBytes;
+    
+    const double *high = series.high;
+    const double *low = series.low;
+    const double *close = series.close;
+    const int64_t *volume = series.volume;
+    double gainFactor = 1.0 + _priceGainPercent / 100.0;
+    double rangeFactor = _rangePercent / 100.0;
+    
+    // Stesse condizioni di evaluateSymbol:bars: con i = barra corrente
+    for (NSInteger i = 3; i < count; i++) {
+        double level45 = ((high[i - 2] - low[i - 2]) * rangeFactor) + low[i - 2];
+        
+        if (close[i - 2] > close[i - 3] * gainFactor &&
+            low[i - 1] > level45 &&
+            low[i] > level45 &&
+            close[i] < high[i - 2] &&
+            close[i - 1] < high[i - 2] &&
+            volume[i - 2] * close[i - 2] > _minDollarVolume &&
+            volume[i] < volume[i - 2] &&
+            volume[i - 1] < volume[i - 2]) {
+            ScreenerSignalSetBit(bits, i);
         }
     }
-
-    return [results copy];
+    
+    return signals;
 }
 
 @end
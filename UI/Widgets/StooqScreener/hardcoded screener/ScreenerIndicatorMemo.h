@@ -0,0 +1,80 @@
+//
+//  ScreenerIndicatorMemo.h
+//  TradingApp
+//
+//  Per-run cache of indicator columns shared by every screener step of a batch.
+//  One column per (symbol, indicator, field, period) holds the most recent
+//  values returned by TechnicalIndicatorHelper: SMA(20) of close is computed
+//  in one pass even if three steps of two models ask for it at several bars.
+//
+
+#import <Foundation/Foundation.h>
+#import "TechnicalIndicatorHelper.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, ScreenerIndicatorKind) {
+    ScreenerIndicatorKindSMA = 0,     // +sma:index:period:field:
+    ScreenerIndicatorKindEMA,         // +ema:index:period: (close)
+    ScreenerIndicatorKindATR          // +atr:index:period:
+};
+
+/**
+ * Value `index` bars ago in a column returned by recentValuesOfIndicator
+ * (0 = last bar), 0.0 beyond the values it holds
+ */
+double ScreenerIndicatorValueAt(NSData *values, NSInteger index);
+
+@interface ScreenerIndicatorMemo : NSObject
+
+/**
+ * Most recent values of an indicator, computed in one pass and not cached
+ * @param depth Number of recent bars needed (1 = last bar only)
+ * @return min(depth, bars.count) values, oldest → newest; bars without enough
+ *         history get 0.0 as in TechnicalIndicatorHelper. Read them with
+ *         ScreenerIndicatorValueAt.
+ * @discussion Cost is O(depth + period) (O(depth * period) for EMA, which is
+ *         seeded per bar like +ema:index:period:).
+ */
++ (NSData *)recentValuesOfIndicator:(ScreenerIndicatorKind)kind
+                              field:(IndicatorBarField)field
+                             period:(NSInteger)period
+                              depth:(NSInteger)depth
+                               bars:(NSArray<HistoricalBarModel *> *)bars;
+
+/**
+ * Same values, cached for symbol
+ * A column is reused by every later request up to its depth; a deeper request
+ * recomputes it (at least doubling the depth).
+ * @param bars Bars of symbol for this run. A request with a different bar count
+ *        (e.g. a backtest window) is computed without being cached.
+ * Thread-safe.
+ */
+- (NSData *)recentValuesOfIndicator:(ScreenerIndicatorKind)kind
+                              field:(IndicatorBarField)field
+                             period:(NSInteger)period
+                              depth:(NSInteger)depth
+                             symbol:(NSString *)symbol
+                               bars:(NSArray<HistoricalBarModel *> *)bars;
+
+/**
+ * Single value through the cached column
+ * @param index Bars ago, as in TechnicalIndicatorHelper (0 = last bar)
+ */
+- (double)valueOfIndicator:(ScreenerIndicatorKind)kind
+                     field:(IndicatorBarField)field
+                    period:(NSInteger)period
+                     index:(NSInteger)index
+                    symbol:(NSString *)symbol
+                      bars:(NSArray<HistoricalBarModel *> *)bars;
+
+/// Columns computed / requests served from the cache so far
+@property (nonatomic, readonly) NSInteger computedCount;
+@property (nonatomic, readonly) NSInteger hitCount;
+
+/// Drop every cached column (data for the run changed)
+- (void)removeAllValues;
+
+@end
+
+NS_ASSUME_NONNULL_END
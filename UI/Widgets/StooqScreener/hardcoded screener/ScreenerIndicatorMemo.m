@@ -0,0 +1,261 @@
+//
+//  ScreenerIndicatorMemo.m
+//  TradingApp
+//
+
+#import "ScreenerIndicatorMemo.h"
+
+double ScreenerIndicatorValueAt(NSData *values, NSInteger index) {
+    NSInteger count = (NSInteger)(values.length / sizeof(double));
+    if (index < 0 || index >= count) return 0.0;
+    return ((const double *)values.bytes)[count - 1 - index];
+}
+
+/// Colonne memorizzate per un simbolo (lock proprio: i simboli sono valutati in parallelo)
+@interface ScreenerIndicatorSymbolColumns : NSObject {
+@public
+    NSInteger _barCount;
+    NSInteger _computedCount;
+    NSInteger _hitCount;
+    NSMutableDictionary<NSNumber *, NSData *> *_columns;
+}
+@end
+
+@implementation ScreenerIndicatorSymbolColumns
+@end
+
+@implementation ScreenerIndicatorMemo {
+    NSMutableDictionary<NSString *, ScreenerIndicatorSymbolColumns *> *_columnsBySymbol;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _columnsBySymbol = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+#pragma mark - Computation
+
+/*
+ * Tutte le varianti lavorano sulla coda [from, count) che basta a coprire le
+ * ultime depth barre, con gli stessi risultati degli helper per-indice:
+ * la coda di un array BarSeries è zero-copy, le colonne si leggono una volta.
+ */
+
+static void ScreenerIndicatorRecentSMA(NSArray<HistoricalBarModel *> *bars, IndicatorBarField field,
+                                       NSInteger period, NSInteger depth, double *output) {
+    NSInteger count = bars.count;
+    NSInteger from = MAX(0, count - depth - period + 1);
+    NSInteger length = count - from;
+
+    NSMutableData *buffer = [NSMutableData dataWithLength:(NSUInteger)length * 2 * sizeof(double)];
+    double *inputs = buffer.mutableBytes;
+    double *sma = inputs + length;
+
+    [TechnicalIndicatorHelper extractValues:[bars subarrayWithRange:NSMakeRange(from, length)]
+                                      field:field
+                                     output:inputs];
+    [TechnicalIndicatorHelper smaSeries:inputs count:length period:period output:sma];
+    memcpy(output, sma + (length - depth), (size_t)depth * sizeof(double));
+}
+
+/// Media semplice del true range, come +atr:index:period: (prima barra = high - low)
+static void ScreenerIndicatorRecentATR(NSArray<HistoricalBarModel *> *bars,
+                                       NSInteger period, NSInteger depth, double *output) {
+    NSInteger count = bars.count;
+    NSInteger from = MAX(0, count - depth - period + 1);
+    NSInteger length = count - from;
+    NSInteger previous = from > 0 ? 1 : 0;     // close precedente per il primo true range
+    NSInteger sliceLength = length + previous;
+
+    NSMutableData *buffer = [NSMutableData dataWithLength:(NSUInteger)(sliceLength * 3 + length * 2) * sizeof(double)];
+    double *high = buffer.mutableBytes;
+    double *low = high + sliceLength;
+    double *close = low + sliceLength;
+    double *trueRange = close + sliceLength;
+    double *atr = trueRange + length;
+
+    NSArray<HistoricalBarModel *> *slice = [bars subarrayWithRange:NSMakeRange(from - previous, sliceLength)];
+    [TechnicalIndicatorHelper extractValues:slice field:IndicatorBarFieldHigh output:high];
+    [TechnicalIndicatorHelper extractValues:slice field:IndicatorBarFieldLow output:low];
+    [TechnicalIndicatorHelper extractValues:slice field:IndicatorBarFieldClose output:close];
+
+    for (NSInteger i = 0; i < length; i++) {
+        NSInteger j = i + previous;
+        double range = high[j] - low[j];
+        if (j > 0) {
+            range = fmax(range, fmax(fabs(high[j] - close[j - 1]), fabs(low[j] - close[j - 1])));
+        }
+        trueRange[i] = range;
+    }
+
+    [TechnicalIndicatorHelper smaSeries:trueRange count:length period:period output:atr];
+    memcpy(output, atr + (length - depth), (size_t)depth * sizeof(double));
+}
+
+/// EMA a finestra come +ema:index:period:: seme = SMA period barre prima, poi period passi
+static void ScreenerIndicatorRecentEMA(NSArray<HistoricalBarModel *> *bars,
+                                       NSInteger period, NSInteger depth, double *output) {
+    NSInteger count = bars.count;
+    NSInteger from = MAX(0, count - depth - 2 * period + 2);
+    NSInteger length = count - from;
+
+    NSMutableData *buffer = [NSMutableData dataWithLength:(NSUInteger)length * 2 * sizeof(double)];
+    double *closes = buffer.mutableBytes;
+    double *sma = closes + length;
+
+    [TechnicalIndicatorHelper extractValues:[bars subarrayWithRange:NSMakeRange(from, length)]
+                                      field:IndicatorBarFieldClose
+                                     output:closes];
+    [TechnicalIndicatorHelper smaSeries:closes count:length period:period output:sma];
+
+    double multiplier = 2.0 / (period + 1.0);
+    for (NSInteger k = 0; k < depth; k++) {
+        NSInteger target = length - depth + k;
+        if (from + target < period - 1) {
+            output[k] = 0.0;  // Dati insufficienti
+            continue;
+        }
+
+        NSInteger start = target - period + 1;
+        double ema = sma[start];
+        for (NSInteger i = start; i <= target; i++) {
+            ema = (closes[i] - ema) * multiplier + ema;
+        }
+        output[k] = ema;
+    }
+}
+
++ (NSData *)recentValuesOfIndicator:(ScreenerIndicatorKind)kind
+                              field:(IndicatorBarField)field
+                             period:(NSInteger)period
+                              depth:(NSInteger)depth
+                               bars:(NSArray<HistoricalBarModel *> *)bars {
+
+    depth = MIN(MAX(depth, 1), (NSInteger)bars.count);
+    NSMutableData *values = [NSMutableData dataWithLength:(NSUInteger)MAX(depth, 0) * sizeof(double)];
+    if (depth <= 0 || period <= 0) {
+        return values;
+    }
+
+    switch (kind) {
+        case ScreenerIndicatorKindSMA:
+            ScreenerIndicatorRecentSMA(bars, field, period, depth, values.mutableBytes);
+            break;
+        case ScreenerIndicatorKindEMA:
+            ScreenerIndicatorRecentEMA(bars, period, depth, values.mutableBytes);
+            break;
+        case ScreenerIndicatorKindATR:
+            ScreenerIndicatorRecentATR(bars, period, depth, values.mutableBytes);
+            break;
+    }
+    return values;
+}
+
+#pragma mark - Lookup
+
+- (NSData *)recentValuesOfIndicator:(ScreenerIndicatorKind)kind
+                              field:(IndicatorBarField)field
+                             period:(NSInteger)period
+                              depth:(NSInteger)depth
+                             symbol:(NSString *)symbol
+                               bars:(NSArray<HistoricalBarModel *> *)bars {
+
+    // ema e atr non hanno campo: stessa colonna qualunque field venga passato
+    if (kind != ScreenerIndicatorKindSMA) field = IndicatorBarFieldClose;
+
+    NSInteger count = bars.count;
+    depth = MIN(MAX(depth, 1), count);
+
+    ScreenerIndicatorSymbolColumns *entry;
+    @synchronized (self) {
+        entry = _columnsBySymbol[symbol];
+        if (!entry) {
+            entry = [[ScreenerIndicatorSymbolColumns alloc] init];
+            entry->_barCount = count;
+            entry->_columns = [NSMutableDictionary dictionary];
+            _columnsBySymbol[symbol] = entry;
+        }
+    }
+
+    // Barre diverse da quelle della run: calcolo diretto, niente cache
+    if (entry->_barCount != count || period <= 0 || depth <= 0) {
+        return [ScreenerIndicatorMemo recentValuesOfIndicator:kind field:field period:period depth:depth bars:bars];
+    }
+
+    // kind 4 bit | field 4 bit | period: resta un NSNumber tagged, nessuna allocazione
+    NSNumber *key = @(((uint64_t)period << 8) | (((uint64_t)field & 0xF) << 4) | ((uint64_t)kind & 0xF));
+
+    NSInteger cachedDepth = 0;
+    @synchronized (entry) {
+        NSData *cached = entry->_columns[key];
+        cachedDepth = (NSInteger)(cached.length / sizeof(double));
+        if (cachedDepth >= depth) {
+            entry->_hitCount++;
+            return cached;
+        }
+    }
+
+    // Chi scorre gli indici uno alla volta ricalcola la colonna O(log n) volte
+    NSData *values = [ScreenerIndicatorMemo recentValuesOfIndicator:kind
+                                                              field:field
+                                                             period:period
+                                                              depth:MAX(depth, cachedDepth * 2)
+                                                               bars:bars];
+
+    @synchronized (entry) {
+        if (entry->_columns[key].length < values.length) {
+            entry->_columns[key] = values;
+        }
+        entry->_computedCount++;
+    }
+    return values;
+}
+
+- (double)valueOfIndicator:(ScreenerIndicatorKind)kind
+                     field:(IndicatorBarField)field
+                    period:(NSInteger)period
+                     index:(NSInteger)index
+                    symbol:(NSString *)symbol
+                      bars:(NSArray<HistoricalBarModel *> *)bars {
+    if (index < 0) return 0.0;
+
+    NSData *values = [self recentValuesOfIndicator:kind field:field period:period depth:index + 1 symbol:symbol bars:bars];
+    return ScreenerIndicatorValueAt(values, index);
+}
+
+#pragma mark - Statistics
+
+- (NSInteger)computedCount {
+    NSInteger total = 0;
+    @synchronized (self) {
+        for (ScreenerIndicatorSymbolColumns *entry in _columnsBySymbol.objectEnumerator) {
+            @synchronized (entry) {
+                total += entry->_computedCount;
+            }
+        }
+    }
+    return total;
+}
+
+- (NSInteger)hitCount {
+    NSInteger total = 0;
+    @synchronized (self) {
+        for (ScreenerIndicatorSymbolColumns *entry in _columnsBySymbol.objectEnumerator) {
+            @synchronized (entry) {
+                total += entry->_hitCount;
+            }
+        }
+    }
+    return total;
+}
+
+- (void)removeAllValues {
+    @synchronized (self) {
+        [_columnsBySymbol removeAllObjects];
+    }
+}
+
+@end
@@ -30,15 +30,40 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)registerScreenerClass:(Class)screenerClass;
 
+/**
+ * Remove a screener registered at runtime (e.g. an expression screener deleted from disk)
+ * @param screenerID Screener identifier
+ * @discussion Built-in screeners cannot be removed.
+ */
+- (void)unregisterScreenerWithID:(NSString *)screenerID;
+
 #pragma mark - Access
 
 /**
  * Get screener by ID
  * @param screenerID Screener identifier
- * @return Screener instance or nil if not found
+ * @return Shared screener instance or nil if not found
+ *
+ * @discussion
+ * The returned instance is shared by every caller: use it for metadata
+ * (displayName, defaultParameters, ...). To execute a screener use
+ * screenerWithID:parameters:, never mutate parameters on the shared instance.
  */
 - (nullable BaseScreener *)screenerWithID:(NSString *)screenerID;
 
+/**
+ * Create a new screener instance bound to the given parameters
+ * @param screenerID Screener identifier
+ * @param parameters Parameters for this execution (copied)
+ * @return New instance owned by the caller, or nil if not found
+ *
+ * @discussion
+ * Instances are independent, so several models / backtest days can run
+ * concurrently. Thread-safe.
+ */
+- (nullable BaseScreener *)screenerWithID:(NSString *)screenerID
+                               parameters:(nullable NSDictionary *)parameters;
+
 /**
  * Get all registered screener IDs
  * @return Array of screener IDs
@@ -58,6 +83,13 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (BOOL)isScreenerRegistered:(NSString *)screenerID;
 
+/**
+ * Check if screener is one of the screeners compiled into the app
+ * @param screenerID Screener identifier
+ * @return YES for the IDs registered by registerDefaultScreeners
+ */
+- (BOOL)isBuiltInScreener:(NSString *)screenerID;
+
 #pragma mark - Information
 
 /**
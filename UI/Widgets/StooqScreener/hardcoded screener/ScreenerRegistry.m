@@ -21,6 +21,8 @@
 
 @interface ScreenerRegistry ()
 @property (nonatomic, strong) NSMutableDictionary<NSString *, BaseScreener *> *screeners;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, Class> *screenerClasses;
+@property (nonatomic, copy) NSSet<NSString *> *builtInScreenerIDs;
 
 @end
 
@@ -41,6 +43,7 @@
     self = [super init];
     if (self) {
         _screeners = [NSMutableDictionary dictionary];
+        _screenerClasses = [NSMutableDictionary dictionary];
         [self registerDefaultScreeners];
     }
     return self;
@@ -62,6 +65,11 @@
     [self registerScreenerClass:[MovingAverageTrendScreener class]];  // ✅ NEW
     [self registerScreenerClass:[BollingerBreakoutScreener class]];  // ✅ NEW
 
+    // Gli screener da JSON non possono prendere questi ID
+    @synchronized (self) {
+        self.builtInScreenerIDs = [NSSet setWithArray:self.screeners.allKeys];
+    }
+
     NSLog(@"✅ Registered %lu default screeners", (unsigned long)self.screeners.count);
 }
 
@@ -73,7 +81,10 @@
         return;
     }
     
-    self.screeners[screener.screenerID] = screener;
+    @synchronized (self) {
+        self.screeners[screener.screenerID] = screener;
+        self.screenerClasses[screener.screenerID] = [screener class];
+    }
     NSLog(@"✅ Registered screener: %@ (%@)", screener.displayName, screener.screenerID);
 }
 
@@ -87,22 +98,64 @@
     [self registerScreener:instance];
 }
 
+- (void)unregisterScreenerWithID:(NSString *)screenerID {
+    if (!screenerID) return;
+    
+    @synchronized (self) {
+        if ([self.builtInScreenerIDs containsObject:screenerID]) {
+            NSLog(@"⚠️ Cannot unregister built-in screener: %@", screenerID);
+            return;
+        }
+        if (!self.screeners[screenerID]) return;
+        
+        [self.screeners removeObjectForKey:screenerID];
+        [self.screenerClasses removeObjectForKey:screenerID];
+    }
+    NSLog(@"🗑️ Unregistered screener: %@", screenerID);
+}
+
 #pragma mark - Access
 
 - (nullable BaseScreener *)screenerWithID:(NSString *)screenerID {
-    return self.screeners[screenerID];
+    @synchronized (self) {
+        return self.screeners[screenerID];
+    }
+}
+
+- (nullable BaseScreener *)screenerWithID:(NSString *)screenerID
+                               parameters:(nullable NSDictionary *)parameters {
+    BaseScreener *prototype;
+    @synchronized (self) {
+        prototype = self.screeners[screenerID];
+    }
+    if (!prototype) return nil;
+    
+    // Il prototipo registrato porta anche la definizione (screener da JSON)
+    return [prototype instanceWithParameters:parameters];
 }
 
 - (NSArray<NSString *> *)allScreenerIDs {
-    return [self.screeners allKeys];
+    @synchronized (self) {
+        return [self.screeners allKeys];
+    }
 }
 
 - (NSArray<BaseScreener *> *)allScreeners {
-    return [self.screeners allValues];
+    @synchronized (self) {
+        return [self.screeners allValues];
+    }
 }
 
 - (BOOL)isScreenerRegistered:(NSString *)screenerID {
-    return self.screeners[screenerID] != nil;
+    @synchronized (self) {
+        return self.screeners[screenerID] != nil;
+    }
+}
+
+- (BOOL)isBuiltInScreener:(NSString *)screenerID {
+    @synchronized (self) {
+        return [self.builtInScreenerIDs containsObject:screenerID];
+    }
 }
 
 #pragma mark - Information
@@ -74,23 +74,28 @@
         NSInteger startIdx = bars.count - 1;
         NSInteger endIdx = MAX(0, bars.count - 1 - lookbackDays);
         
+        // SMA(volume, smaPeriod) e SMA(close, 5) di tutto il lookback in una chiamata
+        NSData *smaVolumes = [self recentValuesOfIndicator:ScreenerIndicatorKindSMA
+                                                     field:IndicatorBarFieldVolume
+                                                    period:smaPeriod
+                                                     depth:startIdx - endIdx
+                                                    symbol:symbol
+                                                      bars:bars];
+        NSData *smaCloses5 = [self recentValuesOfIndicator:ScreenerIndicatorKindSMA
+                                                     field:IndicatorBarFieldClose
+                                                    period:5
+                                                     depth:startIdx - endIdx
+                                                    symbol:symbol
+                                                      bars:bars];
+        
         for (NSInteger i = startIdx; i > endIdx; i--) {
             HistoricalBarModel *bar = bars[i];
             HistoricalBarModel *prevBar = (i > 0) ? bars[i-1] : nil;
             
             if (!prevBar) continue;
             
-            // Calculate SMA(volume, smaPeriod) at position i
-            double smaVolume = [TechnicalIndicatorHelper sma:bars
-                                                        index:(bars.count - 1 - i)
-                                                       period:smaPeriod
-                                                     valueKey:@"volume"];
-            
-            // Calculate SMA(close, 5) at position i
-            double smaClose5 = [TechnicalIndicatorHelper sma:bars
-                                                        index:(bars.count - 1 - i)
-                                                       period:5
-                                                     valueKey:@"close"];
+            double smaVolume = ScreenerIndicatorValueAt(smaVolumes, startIdx - i);
+            double smaClose5 = ScreenerIndicatorValueAt(smaCloses5, startIdx - i);
             
             // Condition 1: volume >= SMA(volume, 50) * multiplier
             BOOL volumeCondition = bar.volume >= (smaVolume * volumeMultiplier);
@@ -127,10 +132,11 @@
         HistoricalBarModel *today = bars[todayIdx];
         HistoricalBarModel *yesterday = bars[yesterdayIdx];
         
-        double sma20Today = [TechnicalIndicatorHelper sma:bars
-                                                     index:0
-                                                    period:20
-                                                  valueKey:@"close"];
+        double sma20Today = [self smaForSymbol:symbol
+                                          bars:bars
+                                         index:0
+                                        period:20
+                                         field:IndicatorBarFieldClose];
         
         BOOL finalCondition = (today.close > sma20Today) || (yesterday.close > sma20Today);
         
@@ -142,15 +148,17 @@
             double middleBand = 0.0;
             
             if ([bbBasisType isEqualToString:@"ema"]) {
-                middleBand = [TechnicalIndicatorHelper ema:bars
-                                                      index:0
-                                                     period:bbPeriod];
+                middleBand = [self emaForSymbol:symbol
+                                           bars:bars
+                                          index:0
+                                         period:bbPeriod];
             } else {
                 // Default to SMA
-                middleBand = [TechnicalIndicatorHelper sma:bars
-                                                      index:0
-                                                     period:bbPeriod
-                                                   valueKey:@"close"];
+                middleBand = [self smaForSymbol:symbol
+                                           bars:bars
+                                          index:0
+                                         period:bbPeriod
+                                          field:IndicatorBarFieldClose];
             }
             
             if (middleBand == 0.0) continue;  // Invalid calculation
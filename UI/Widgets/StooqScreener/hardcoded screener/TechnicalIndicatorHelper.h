@@ -11,6 +11,78 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+#pragma mark - Bar Fields
+
+/// Bar field selector, resolved once instead of comparing valueKey strings per bar
+typedef NS_ENUM(NSInteger, IndicatorBarField) {
+    IndicatorBarFieldOpen = 0,
+    IndicatorBarFieldHigh,
+    IndicatorBarFieldLow,
+    IndicatorBarFieldClose,
+    IndicatorBarFieldVolume,
+    IndicatorBarFieldTypical,
+    IndicatorBarFieldRange,
+    IndicatorBarFieldUnknown      // value 0.0, like an unknown valueKey
+};
+
+/// "open", "high", "low", "close", "volume", "typical", "range" → field
+IndicatorBarField IndicatorBarFieldFromKey(NSString *key);
+
+#pragma mark - Rolling Kernels (O(1) per bar)
+
+/*
+ * Stateful kernels for streaming bars oldest → newest.
+ * Each Push returns the indicator at the bar just pushed, or 0.0 while
+ * fewer than `period` bars have been seen (same convention as the helpers).
+ */
+
+/// Simple moving average over a ring buffer. Call RollingSMAFree when done.
+typedef struct {
+    NSInteger period;
+    NSInteger count;      // values pushed so far
+    double sum;
+    double *window;       // period slots, owned
+} RollingSMAState;
+
+RollingSMAState RollingSMAMake(NSInteger period);
+double RollingSMAPush(RollingSMAState *state, double value);
+void RollingSMAFree(RollingSMAState *state);
+
+/// Recursive moving average seeded with the SMA of the first `period` values
+typedef struct {
+    NSInteger period;
+    NSInteger count;
+    double alpha;         // 2/(period+1) for EMA, 1/period for Wilders
+    double value;         // running average (seed sum while count < period)
+} RollingEMAState;
+
+RollingEMAState RollingEMAMake(NSInteger period);
+RollingEMAState RollingWildersMake(NSInteger period);
+double RollingEMAPush(RollingEMAState *state, double value);
+
+/// RSI on simple averages of gains/losses (same formula as +rsi:index:period:)
+typedef struct {
+    RollingSMAState gains;
+    RollingSMAState losses;
+    double previousClose;
+    BOOL hasPrevious;
+} RollingRSIState;
+
+RollingRSIState RollingRSIMake(NSInteger period);
+double RollingRSIPush(RollingRSIState *state, double close);
+void RollingRSIFree(RollingRSIState *state);
+
+/// ATR as simple average of true ranges (same formula as +atr:index:period:)
+typedef struct {
+    RollingSMAState trueRanges;
+    double previousClose;
+    BOOL hasPrevious;
+} RollingATRState;
+
+RollingATRState RollingATRMake(NSInteger period);
+double RollingATRPush(RollingATRState *state, double high, double low, double close);
+void RollingATRFree(RollingATRState *state);
+
 @interface TechnicalIndicatorHelper : NSObject
 
 #pragma mark - Moving Averages
@@ -28,6 +100,12 @@ NS_ASSUME_NONNULL_BEGIN
        period:(NSInteger)period
      valueKey:(NSString *)valueKey;
 
+/// Same as sma:index:period:valueKey: with a pre-resolved field (preferred in loops)
++ (double)sma:(NSArray<HistoricalBarModel *> *)bars
+        index:(NSInteger)index
+       period:(NSInteger)period
+        field:(IndicatorBarField)field;
+
 /**
  * Exponential Moving Average (EMA)
  * @param bars Array of HistoricalBarModel objects
@@ -133,6 +211,11 @@ NS_ASSUME_NONNULL_BEGIN
            period:(NSInteger)period
          valueKey:(NSString *)valueKey;
 
++ (double)highest:(NSArray<HistoricalBarModel *> *)bars
+            index:(NSInteger)index
+           period:(NSInteger)period
+            field:(IndicatorBarField)field;
+
 /**
  * Lowest value over period
  * @param bars Array of HistoricalBarModel objects
@@ -146,6 +229,11 @@ NS_ASSUME_NONNULL_BEGIN
           period:(NSInteger)period
         valueKey:(NSString *)valueKey;
 
++ (double)lowest:(NSArray<HistoricalBarModel *> *)bars
+           index:(NSInteger)index
+          period:(NSInteger)period
+           field:(IndicatorBarField)field;
+
 /**
  * Index of highest bar over period
  * @param bars Array of HistoricalBarModel objects
@@ -159,6 +247,11 @@ NS_ASSUME_NONNULL_BEGIN
                       period:(NSInteger)period
                     valueKey:(NSString *)valueKey;
 
++ (NSInteger)highestBarIndex:(NSArray<HistoricalBarModel *> *)bars
+                       index:(NSInteger)index
+                      period:(NSInteger)period
+                       field:(IndicatorBarField)field;
+
 /**
  * Index of lowest bar over period
  * @param bars Array of HistoricalBarModel objects
@@ -172,6 +265,11 @@ NS_ASSUME_NONNULL_BEGIN
                      period:(NSInteger)period
                    valueKey:(NSString *)valueKey;
 
++ (NSInteger)lowestBarIndex:(NSArray<HistoricalBarModel *> *)bars
+                      index:(NSInteger)index
+                     period:(NSInteger)period
+                      field:(IndicatorBarField)field;
+
 #pragma mark - Pattern Detection
 
 /**
@@ -250,6 +348,10 @@ NS_ASSUME_NONNULL_BEGIN
 + (double)valueFromBar:(HistoricalBarModel *)bar
                 forKey:(NSString *)key;
 
+/// Same as valueFromBar:forKey: with a pre-resolved field
++ (double)valueFromBar:(HistoricalBarModel *)bar
+                 field:(IndicatorBarField)field;
+
 /**
  * Check if bars array has sufficient data for calculation
  * @param bars Array of bars
@@ -275,6 +377,59 @@ NS_ASSUME_NONNULL_BEGIN
            period:(NSInteger)period
          valueKey:(NSString *)valueKey;
 
++ (double)wilders:(NSArray<HistoricalBarModel *> *)bars
+            index:(NSInteger)index
+           period:(NSInteger)period
+            field:(IndicatorBarField)field;
+
+#pragma mark - Whole-Series Variants
+
+/*
+ * One linear pass over a column (oldest → newest), writing one value per bar
+ * into a caller-provided buffer of `count` doubles. Bars without enough
+ * history get 0.0. Columns come straight from BarSeries (close, high, ...)
+ * or from +extractValues:valueKey:output:.
+ */
+
++ (void)smaSeries:(const double *)values
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output;
+
++ (void)emaSeries:(const double *)values
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output;
+
++ (void)wildersSeries:(const double *)values
+                count:(NSInteger)count
+               period:(NSInteger)period
+               output:(double *)output;
+
++ (void)rsiSeries:(const double *)closes
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output;
+
++ (void)atrSeriesWithHigh:(const double *)high
+                      low:(const double *)low
+                    close:(const double *)close
+                    count:(NSInteger)count
+                   period:(NSInteger)period
+                   output:(double *)output;
+
+/**
+ * Copy one field of every bar into a buffer of bars.count doubles
+ * @param valueKey Same keys as valueFromBar:forKey:
+ */
++ (void)extractValues:(NSArray<HistoricalBarModel *> *)bars
+             valueKey:(NSString *)valueKey
+               output:(double *)output;
+
++ (void)extractValues:(NSArray<HistoricalBarModel *> *)bars
+                field:(IndicatorBarField)field
+               output:(double *)output;
+
 
 @end
 
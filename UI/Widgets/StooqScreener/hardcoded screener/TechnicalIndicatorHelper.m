@@ -9,6 +9,181 @@
 //
 
 #import "TechnicalIndicatorHelper.h"
+#import "BarSeries.h"
+
+#pragma mark - Rolling Kernels
+
+RollingSMAState RollingSMAMake(NSInteger period) {
+    RollingSMAState state;
+    state.period = MAX(period, 1);
+    state.count = 0;
+    state.sum = 0.0;
+    state.window = calloc((size_t)state.period, sizeof(double));
+    return state;
+}
+
+double RollingSMAPush(RollingSMAState *state, double value) {
+    NSInteger slot = state->count % state->period;
+    if (state->count >= state->period) {
+        state->sum -= state->window[slot];
+    }
+    state->window[slot] = value;
+    state->sum += value;
+    state->count++;
+
+    return state->count >= state->period ? state->sum / state->period : 0.0;
+}
+
+void RollingSMAFree(RollingSMAState *state) {
+    free(state->window);
+    state->window = NULL;
+}
+
+RollingEMAState RollingEMAMake(NSInteger period) {
+    RollingEMAState state;
+    state.period = MAX(period, 1);
+    state.count = 0;
+    state.alpha = 2.0 / (state.period + 1.0);
+    state.value = 0.0;
+    return state;
+}
+
+RollingEMAState RollingWildersMake(NSInteger period) {
+    RollingEMAState state = RollingEMAMake(period);
+    state.alpha = 1.0 / state.period;
+    return state;
+}
+
+double RollingEMAPush(RollingEMAState *state, double value) {
+    state->count++;
+
+    if (state->count < state->period) {
+        state->value += value;  // accumulo per il seed SMA
+        return 0.0;
+    }
+    if (state->count == state->period) {
+        state->value = (state->value + value) / state->period;
+        return state->value;
+    }
+
+    state->value += (value - state->value) * state->alpha;
+    return state->value;
+}
+
+RollingRSIState RollingRSIMake(NSInteger period) {
+    RollingRSIState state;
+    state.gains = RollingSMAMake(period);
+    state.losses = RollingSMAMake(period);
+    state.previousClose = 0.0;
+    state.hasPrevious = NO;
+    return state;
+}
+
+double RollingRSIPush(RollingRSIState *state, double close) {
+    if (!state->hasPrevious) {
+        state->previousClose = close;
+        state->hasPrevious = YES;
+        return 0.0;
+    }
+
+    double change = close - state->previousClose;
+    state->previousClose = close;
+
+    RollingSMAPush(&state->gains, change > 0 ? change : 0.0);
+    RollingSMAPush(&state->losses, change > 0 ? 0.0 : -change);
+
+    if (state->gains.count < state->gains.period) return 0.0;
+
+    double avgGain = state->gains.sum / state->gains.period;
+    double avgLoss = state->losses.sum / state->losses.period;
+    if (avgLoss == 0.0) return 100.0;
+
+    return 100.0 - (100.0 / (1.0 + avgGain / avgLoss));
+}
+
+void RollingRSIFree(RollingRSIState *state) {
+    RollingSMAFree(&state->gains);
+    RollingSMAFree(&state->losses);
+}
+
+RollingATRState RollingATRMake(NSInteger period) {
+    RollingATRState state;
+    state.trueRanges = RollingSMAMake(period);
+    state.previousClose = 0.0;
+    state.hasPrevious = NO;
+    return state;
+}
+
+double RollingATRPush(RollingATRState *state, double high, double low, double close) {
+    double trueRange = high - low;
+    if (state->hasPrevious) {
+        trueRange = fmax(trueRange, fmax(fabs(high - state->previousClose), fabs(low - state->previousClose)));
+    }
+    state->previousClose = close;
+    state->hasPrevious = YES;
+
+    return RollingSMAPush(&state->trueRanges, trueRange);
+}
+
+void RollingATRFree(RollingATRState *state) {
+    RollingSMAFree(&state->trueRanges);
+}
+
+#pragma mark - Field Access
+
+IndicatorBarField IndicatorBarFieldFromKey(NSString *key) {
+    if ([key isEqualToString:@"close"]) return IndicatorBarFieldClose;
+    if ([key isEqualToString:@"high"]) return IndicatorBarFieldHigh;
+    if ([key isEqualToString:@"low"]) return IndicatorBarFieldLow;
+    if ([key isEqualToString:@"open"]) return IndicatorBarFieldOpen;
+    if ([key isEqualToString:@"volume"]) return IndicatorBarFieldVolume;
+    if ([key isEqualToString:@"typical"]) return IndicatorBarFieldTypical;
+    if ([key isEqualToString:@"range"]) return IndicatorBarFieldRange;
+    return IndicatorBarFieldUnknown;
+}
+
+/// Double column for a field of a columnar series (NULL for volume and derived fields)
+static inline const double *IndicatorColumn(BarSeries *series, IndicatorBarField field) {
+    if (!series) return NULL;
+    switch (field) {
+        case IndicatorBarFieldOpen:  return series.open;
+        case IndicatorBarFieldHigh:  return series.high;
+        case IndicatorBarFieldLow:   return series.low;
+        case IndicatorBarFieldClose: return series.close;
+        default:                     return NULL;
+    }
+}
+
+// Accessors by bar index (expect `bars` / `column` in scope)
+#define INDICATOR_VALUE_COLUMN(i)   (column[i])
+#define INDICATOR_VALUE_OPEN(i)     (bars[i].open)
+#define INDICATOR_VALUE_HIGH(i)     (bars[i].high)
+#define INDICATOR_VALUE_LOW(i)      (bars[i].low)
+#define INDICATOR_VALUE_CLOSE(i)    (bars[i].close)
+#define INDICATOR_VALUE_VOLUME(i)   ((double)bars[i].volume)
+#define INDICATOR_VALUE_TYPICAL(i)  (bars[i].typicalPrice)
+#define INDICATOR_VALUE_RANGE(i)    (bars[i].range)
+#define INDICATOR_VALUE_NONE(i)     (0.0)
+
+/*
+ * Expands LOOP(VALUE) once per field with a statically known accessor:
+ * the field is switched on once per call, never per bar. Columnar
+ * (BarSeries-backed) arrays read the raw column instead of bar objects.
+ */
+#define INDICATOR_FIELD_LOOP(field, LOOP) do { \
+    const double *column = IndicatorColumn([BarSeries backingSeriesOfBars:bars], (field)); \
+    if (column) { LOOP(INDICATOR_VALUE_COLUMN); break; } \
+    switch (field) { \
+        case IndicatorBarFieldOpen:    LOOP(INDICATOR_VALUE_OPEN);    break; \
+        case IndicatorBarFieldHigh:    LOOP(INDICATOR_VALUE_HIGH);    break; \
+        case IndicatorBarFieldLow:     LOOP(INDICATOR_VALUE_LOW);     break; \
+        case IndicatorBarFieldClose:   LOOP(INDICATOR_VALUE_CLOSE);   break; \
+        case IndicatorBarFieldVolume:  LOOP(INDICATOR_VALUE_VOLUME);  break; \
+        case IndicatorBarFieldTypical: LOOP(INDICATOR_VALUE_TYPICAL); break; \
+        case IndicatorBarFieldRange:   LOOP(INDICATOR_VALUE_RANGE);   break; \
+        default:                       LOOP(INDICATOR_VALUE_NONE);    break; \
+    } \
+} while (0)
 
 @implementation TechnicalIndicatorHelper
 
@@ -18,6 +193,13 @@
         index:(NSInteger)index
        period:(NSInteger)period
      valueKey:(NSString *)valueKey {
+    return [self sma:bars index:index period:period field:IndicatorBarFieldFromKey(valueKey)];
+}
+
++ (double)sma:(NSArray<HistoricalBarModel *> *)bars
+        index:(NSInteger)index
+       period:(NSInteger)period
+        field:(IndicatorBarField)field {
     
     if (![self hasSufficientData:bars index:index requiredBars:period]) {
         return 0.0;
@@ -28,9 +210,9 @@
     NSInteger endIndex = startIndex - period + 1;
     
     double sum = 0.0;
-    for (NSInteger i = startIndex; i >= endIndex; i--) {
-        sum += [self valueFromBar:bars[i] forKey:valueKey];
-    }
+#define SMA_LOOP(VALUE) for (NSInteger i = startIndex; i >= endIndex; i--) { sum += VALUE(i); }
+    INDICATOR_FIELD_LOOP(field, SMA_LOOP);
+#undef SMA_LOOP
     
     return sum / period;
 }
@@ -48,7 +230,7 @@
     NSInteger startIndex = targetIndex - period + 1;
     
     // Calculate initial SMA
-    double initialSMA = [self sma:bars index:index + period - 1 period:period valueKey:@"close"];
+    double initialSMA = [self sma:bars index:index + period - 1 period:period field:IndicatorBarFieldClose];
     
     // Calculate multiplier
     double multiplier = 2.0 / (period + 1.0);
@@ -91,6 +273,13 @@
             index:(NSInteger)index
            period:(NSInteger)period
          valueKey:(NSString *)valueKey {
+    return [self wilders:bars index:index period:period field:IndicatorBarFieldFromKey(valueKey)];
+}
+
++ (double)wilders:(NSArray<HistoricalBarModel *> *)bars
+            index:(NSInteger)index
+           period:(NSInteger)period
+            field:(IndicatorBarField)field {
     
     if (![self hasSufficientData:bars index:index requiredBars:period]) {
         return 0.0;
@@ -101,22 +290,110 @@
     NSInteger startIndex = targetIndex - period + 1;
     
     // Calculate initial SMA for first Wilders value
-    double sum = 0.0;
-    for (NSInteger i = targetIndex; i >= startIndex; i--) {
-        sum += [self valueFromBar:bars[i] forKey:valueKey];
-    }
-    double wilders = sum / (double)period;
-    
     // Apply Wilders smoothing formula: SMMA[i] = (SMMA[i-1] * (period-1) + value[i]) / period
     // Moving forward from oldest to newest for iterative calculation
-    for (NSInteger i = startIndex; i <= targetIndex; i++) {
-        double value = [self valueFromBar:bars[i] forKey:valueKey];
-        wilders = (wilders * (period - 1) + value) / (double)period;
+    double wilders = 0.0;
+#define WILDERS_LOOP(VALUE) { \
+        double sum = 0.0; \
+        for (NSInteger i = targetIndex; i >= startIndex; i--) { sum += VALUE(i); } \
+        wilders = sum / (double)period; \
+        for (NSInteger i = startIndex; i <= targetIndex; i++) { \
+            wilders = (wilders * (period - 1) + VALUE(i)) / (double)period; \
+        } \
     }
+    INDICATOR_FIELD_LOOP(field, WILDERS_LOOP);
+#undef WILDERS_LOOP
     
     return wilders;
 }
 
+#pragma mark - Whole-Series Variants
+
++ (void)smaSeries:(const double *)values
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output {
+    
+    if (period <= 0) {
+        memset(output, 0, (size_t)MAX(count, 0) * sizeof(double));
+        return;
+    }
+    
+    // Somma scorrevole: nessun ring buffer, l'input è già in memoria
+    double sum = 0.0;
+    for (NSInteger i = 0; i < count; i++) {
+        sum += values[i];
+        if (i >= period) {
+            sum -= values[i - period];
+        }
+        output[i] = (i >= period - 1) ? sum / period : 0.0;
+    }
+}
+
++ (void)emaSeries:(const double *)values
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output {
+    
+    RollingEMAState state = RollingEMAMake(period);
+    for (NSInteger i = 0; i < count; i++) {
+        output[i] = RollingEMAPush(&state, values[i]);
+    }
+}
+
++ (void)wildersSeries:(const double *)values
+                count:(NSInteger)count
+               period:(NSInteger)period
+               output:(double *)output {
+    
+    RollingEMAState state = RollingWildersMake(period);
+    for (NSInteger i = 0; i < count; i++) {
+        output[i] = RollingEMAPush(&state, values[i]);
+    }
+}
+
++ (void)rsiSeries:(const double *)closes
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output {
+    
+    RollingRSIState state = RollingRSIMake(period);
+    for (NSInteger i = 0; i < count; i++) {
+        output[i] = RollingRSIPush(&state, closes[i]);
+    }
+    RollingRSIFree(&state);
+}
+
++ (void)atrSeriesWithHigh:(const double *)high
+                      low:(const double *)low
+                    close:(const double *)close
+                    count:(NSInteger)count
+                   period:(NSInteger)period
+                   output:(double *)output {
+    
+    RollingATRState state = RollingATRMake(period);
+    for (NSInteger i = 0; i < count; i++) {
+        output[i] = RollingATRPush(&state, high[i], low[i], close[i]);
+    }
+    RollingATRFree(&state);
+}
+
++ (void)extractValues:(NSArray<HistoricalBarModel *> *)bars
+             valueKey:(NSString *)valueKey
+               output:(double *)output {
+    [self extractValues:bars field:IndicatorBarFieldFromKey(valueKey) output:output];
+}
+
++ (void)extractValues:(NSArray<HistoricalBarModel *> *)bars
+                field:(IndicatorBarField)field
+               output:(double *)output {
+    
+    NSInteger count = bars.count;
+#define EXTRACT_LOOP(VALUE) for (NSInteger i = 0; i < count; i++) { output[i] = VALUE(i); }
+    INDICATOR_FIELD_LOOP(field, EXTRACT_LOOP);
+#undef EXTRACT_LOOP
+}
+
 #pragma mark - Momentum Indicators
 
 + (double)rsi:(NSArray<HistoricalBarModel *> *)bars
@@ -243,7 +520,7 @@
     }
     
     // Calculate mean
-    double mean = [self sma:bars index:index period:period valueKey:@"close"];
+    double mean = [self sma:bars index:index period:period field:IndicatorBarFieldClose];
     
     // Converti index
     NSInteger startIndex = bars.count - 1 - index;
@@ -266,6 +543,13 @@
             index:(NSInteger)index
            period:(NSInteger)period
          valueKey:(NSString *)valueKey {
+    return [self highest:bars index:index period:period field:IndicatorBarFieldFromKey(valueKey)];
+}
+
++ (double)highest:(NSArray<HistoricalBarModel *> *)bars
+            index:(NSInteger)index
+           period:(NSInteger)period
+            field:(IndicatorBarField)field {
     
     if (![self hasSufficientData:bars index:index requiredBars:period]) {
         return 0.0;
@@ -282,12 +566,12 @@
     }
     
     // Loop da startIndex a endIndex (indietro nel tempo)
-    for (NSInteger i = startIndex; i >= endIndex; i--) {
-        double value = [self valueFromBar:bars[i] forKey:valueKey];
-        if (value > highest) {
-            highest = value;
-        }
+#define HIGHEST_LOOP(VALUE) for (NSInteger i = startIndex; i >= endIndex; i--) { \
+        double value = VALUE(i); \
+        if (value > highest) highest = value; \
     }
+    INDICATOR_FIELD_LOOP(field, HIGHEST_LOOP);
+#undef HIGHEST_LOOP
     
     return highest;
 }
@@ -296,6 +580,13 @@
            index:(NSInteger)index
           period:(NSInteger)period
         valueKey:(NSString *)valueKey {
+    return [self lowest:bars index:index period:period field:IndicatorBarFieldFromKey(valueKey)];
+}
+
++ (double)lowest:(NSArray<HistoricalBarModel *> *)bars
+           index:(NSInteger)index
+          period:(NSInteger)period
+           field:(IndicatorBarField)field {
     
     if (![self hasSufficientData:bars index:index requiredBars:period]) {
         return 0.0;
@@ -310,12 +601,12 @@
         endIndex = 0;
     }
     
-    for (NSInteger i = startIndex; i >= endIndex; i--) {
-        double value = [self valueFromBar:bars[i] forKey:valueKey];
-        if (value < lowest) {
-            lowest = value;
-        }
+#define LOWEST_LOOP(VALUE) for (NSInteger i = startIndex; i >= endIndex; i--) { \
+        double value = VALUE(i); \
+        if (value < lowest) lowest = value; \
     }
+    INDICATOR_FIELD_LOOP(field, LOWEST_LOOP);
+#undef LOWEST_LOOP
     
     return lowest;
 }
@@ -324,6 +615,13 @@
                        index:(NSInteger)index
                       period:(NSInteger)period
                     valueKey:(NSString *)valueKey {
+    return [self highestBarIndex:bars index:index period:period field:IndicatorBarFieldFromKey(valueKey)];
+}
+
++ (NSInteger)highestBarIndex:(NSArray<HistoricalBarModel *> *)bars
+                       index:(NSInteger)index
+                      period:(NSInteger)period
+                       field:(IndicatorBarField)field {
     
     if (![self hasSufficientData:bars index:index requiredBars:period]) {
         return -1;
@@ -339,13 +637,12 @@
         endIndex = 0;
     }
     
-    for (NSInteger i = startIndex; i >= endIndex; i--) {
-        double value = [self valueFromBar:bars[i] forKey:valueKey];
-        if (value > highest) {
-            highest = value;
-            highestIndex = i;
-        }
+#define HIGHEST_INDEX_LOOP(VALUE) for (NSInteger i = startIndex; i >= endIndex; i--) { \
+        double value = VALUE(i); \
+        if (value > highest) { highest = value; highestIndex = i; } \
     }
+    INDICATOR_FIELD_LOOP(field, HIGHEST_INDEX_LOOP);
+#undef HIGHEST_INDEX_LOOP
     
     return highestIndex;
 }
@@ -354,6 +651,13 @@
                       index:(NSInteger)index
                      period:(NSInteger)period
                    valueKey:(NSString *)valueKey {
+    return [self lowestBarIndex:bars index:index period:period field:IndicatorBarFieldFromKey(valueKey)];
+}
+
++ (NSInteger)lowestBarIndex:(NSArray<HistoricalBarModel *> *)bars
+                      index:(NSInteger)index
+                     period:(NSInteger)period
+                      field:(IndicatorBarField)field {
     
     if (![self hasSufficientData:bars index:index requiredBars:period]) {
         return -1;
@@ -369,13 +673,12 @@
         endIndex = 0;
     }
     
-    for (NSInteger i = startIndex; i >= endIndex; i--) {
-        double value = [self valueFromBar:bars[i] forKey:valueKey];
-        if (value < lowest) {
-            lowest = value;
-            lowestIndex = i;
-        }
+#define LOWEST_INDEX_LOOP(VALUE) for (NSInteger i = startIndex; i >= endIndex; i--) { \
+        double value = VALUE(i); \
+        if (value < lowest) { lowest = value; lowestIndex = i; } \
     }
+    INDICATOR_FIELD_LOOP(field, LOWEST_INDEX_LOOP);
+#undef LOWEST_INDEX_LOOP
     
     return lowestIndex;
 }
@@ -417,23 +720,29 @@
 + (double)averageVolume:(NSArray<HistoricalBarModel *> *)bars
                   index:(NSInteger)index
                  period:(NSInteger)period {
-    return [self sma:bars index:index period:period valueKey:@"volume"];
+    return [self sma:bars index:index period:period field:IndicatorBarFieldVolume];
 }
 
 #pragma mark - Utility Methods
 
 + (double)valueFromBar:(HistoricalBarModel *)bar
                 forKey:(NSString *)key {
-    
-    if ([key isEqualToString:@"open"]) return bar.open;
-    if ([key isEqualToString:@"high"]) return bar.high;
-    if ([key isEqualToString:@"low"]) return bar.low;
-    if ([key isEqualToString:@"close"]) return bar.close;
-    if ([key isEqualToString:@"volume"]) return (double)bar.volume;
-    if ([key isEqualToString:@"typical"]) return bar.typicalPrice;
-    if ([key isEqualToString:@"range"]) return bar.range;
-    
-    return 0.0;
+    return [self valueFromBar:bar field:IndicatorBarFieldFromKey(key)];
+}
+
++ (double)valueFromBar:(HistoricalBarModel *)bar
+                 field:(IndicatorBarField)field {
+    
+    switch (field) {
+        case IndicatorBarFieldOpen:    return bar.open;
+        case IndicatorBarFieldHigh:    return bar.high;
+        case IndicatorBarFieldLow:     return bar.low;
+        case IndicatorBarFieldClose:   return bar.close;
+        case IndicatorBarFieldVolume:  return (double)bar.volume;
+        case IndicatorBarFieldTypical: return bar.typicalPrice;
+        case IndicatorBarFieldRange:   return bar.range;
+        default:                       return 0.0;
+    }
 }
 
 + (BOOL)hasSufficientData:(NSArray<HistoricalBarModel *> *)bars
@@ -8,7 +8,9 @@
 #import "WIRScreener.h"
 #import "TechnicalIndicatorHelper.h"
 
-@implementation WIRScreener
+@implementation WIRScreener {
+    NSInteger _lookbackDays;
+}
 
 #pragma mark - Properties
 
@@ -32,66 +34,54 @@
 
 #pragma mark - Execution
 
-- (NSArray<NSString *> *)executeOnSymbols:(NSArray<NSString *> *)inputSymbols
-                               cachedData:(NSDictionary<NSString *, NSArray<HistoricalBarModel *> *> *)cache {
+- (void)prepareForExecution {
+    _lookbackDays = [self parameterIntegerForKey:@"lookback_days" defaultValue:5];
+}
+
+- (BOOL)evaluateSymbol:(NSString *)symbol bars:(NSArray<HistoricalBarModel *> *)bars {
+    NSInteger todayIdx = bars.count - 1;
+    NSInteger yesterdayIdx = todayIdx - 1;
     
-    NSMutableArray *results = [NSMutableArray array];
+    HistoricalBarModel *today = bars[todayIdx];
+    HistoricalBarModel *yesterday = bars[yesterdayIdx];
     
-    // Get parameters
-    NSInteger lookbackDays = [self parameterIntegerForKey:@"lookback_days" defaultValue:5];
+    // Condition 1: Inside bar (high <= prev high AND low >= prev low)
+    BOOL insideBar = [TechnicalIndicatorHelper isInsideBar:today previous:yesterday];
     
-    for (NSString *symbol in inputSymbols) {
-        NSArray<HistoricalBarModel *> *bars = [self barsForSymbol:symbol inCache:cache];
-        
-        if (!bars || bars.count < self.minBarsRequired) continue;
-        
-        NSInteger todayIdx = bars.count - 1;
-        NSInteger yesterdayIdx = todayIdx - 1;
-        
-        HistoricalBarModel *today = bars[todayIdx];
-        HistoricalBarModel *yesterday = bars[yesterdayIdx];
-        
-        // Condition 1: Inside bar (high <= prev high AND low >= prev low)
-        BOOL insideBar = [TechnicalIndicatorHelper isInsideBar:today previous:yesterday];
-        
-        // Condition 2: Yesterday was red candle (open >= close)
-        BOOL yesterdayRed = yesterday.open >= yesterday.close;
-        
-        if (!insideBar || !yesterdayRed) continue;
-        
-        // Condition 3: within(low < low[1], lookbackDays)
-        // Check if in the last N days there was a day where low broke previous low
-        BOOL foundLowBreak = NO;
-        
-        NSInteger startIdx = todayIdx;
-        NSInteger endIdx = MAX(0, todayIdx - lookbackDays);
-        
-        for (NSInteger i = startIdx; i > endIdx; i--) {
-            if (i == 0) continue;  // Need previous bar for comparison
-            
-            HistoricalBarModel *bar = bars[i];
-            HistoricalBarModel *prevBar = bars[i-1];
-            
-            if (bar.low < prevBar.low) {
-                foundLowBreak = YES;
-                break;
-            }
-        }
-        
-        if (!foundLowBreak) continue;
+    // Condition 2: Yesterday was red candle (open >= close)
+    BOOL yesterdayRed = yesterday.open >= yesterday.close;
+    
+    if (!insideBar || !yesterdayRed) return NO;
+    
+    // Condition 3: within(low < low[1], lookbackDays)
+    // Check if in the last N days there was a day where low broke previous low
+    BOOL foundLowBreak = NO;
+    
+    NSInteger startIdx = todayIdx;
+    NSInteger endIdx = MAX(0, todayIdx - _lookbackDays);
+    
+    for (NSInteger i = startIdx; i > endIdx; i--) {
+        if (i == 0) continue;  // Need previous bar for comparison
         
-        // Condition 4: close > SMA(close, 20)
-        double sma20 = [TechnicalIndicatorHelper sma:bars
-                                                index:todayIdx
-                                               period:20
-                                             valueKey:@"close"];
+        HistoricalBarModel *bar = bars[i];
+        HistoricalBarModel *prevBar = bars[i-1];
         
-        if (today.close > sma20) {
-            [results addObject:symbol];
+        if (bar.low < prevBar.low) {
+            foundLowBreak = YES;
+            break;
         }
     }
     
-    return [results copy];
+    if (!foundLowBreak) return NO;
+    
+    // Condition 4: close > SMA(close, 20)
+    double sma20 = [self smaForSymbol:symbol
+                                 bars:bars
+                                index:todayIdx
+                               period:20
+                                field:IndicatorBarFieldClose];
+    
+    return today.close > sma20;
 }
 
 
@@ -0,0 +1,53 @@
+//
+//  SavedChartData+SegmentLog.h
+//  TradingApp
+//
+//  Append-only log for continuous storages. Each update appends one small
+//  segment (new bars + schedule metadata) next to the base .chartdata file
+//  instead of rewriting it; the log is replayed on load and folded back into
+//  the base file by compaction once it grows.
+//
+
+#import "SavedChartData.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface SavedChartData (SegmentLog)
+
+/// Log path for a storage file: Segments/<chartID>.chartlog in the same directory
+/// Keyed by chartID so it survives filename updates. nil if the storage has no chartID.
+- (nullable NSString *)segmentLogPathForFile:(NSString *)filePath;
+
+/// Log path for a storage file whose SavedChartData is not loaded
++ (NSString *)segmentLogPathForFile:(NSString *)filePath chartID:(NSString *)chartID;
+
+/// Append one segment with bars (may be empty) and the current update/schedule metadata
+/// Cost is proportional to bars.count, the base file is not touched. A truncated tail
+/// left by an interrupted append is cut off first, so replay reaches the new segment.
+- (BOOL)appendSegmentWithBars:(NSArray<HistoricalBarModel *> *)bars
+                 toLogForFile:(NSString *)filePath
+                        error:(NSError **)error;
+
+/// Merge every segment of the log into the loaded bars and metadata
+/// A truncated last segment (interrupted append) is ignored.
+/// @return Number of segments applied
+- (NSInteger)replaySegmentLogForFile:(NSString *)filePath;
+
+/// Metadata of the last complete segment of a storage's log, without decoding bars
+/// Holds barCount (after the update, when written by this version), endDate,
+/// lastUpdateDate, hasGaps and appendedAt. nil if there is no log or no complete segment.
++ (nullable NSDictionary *)segmentLogMetadataForFile:(NSString *)filePath chartID:(NSString *)chartID;
+
+/// YES when the log is large enough relative to the base file to be compacted
+- (BOOL)segmentLogNeedsCompactionForFile:(NSString *)filePath;
+
+/// Rewrite the base file (with filename update) and delete the log
+/// @return Updated file path, or nil if the base file could not be written (log kept)
+- (nullable NSString *)compactSegmentLogForFile:(NSString *)filePath error:(NSError **)error;
+
+/// Delete the log of a storage file, if any
+- (void)removeSegmentLogForFile:(NSString *)filePath;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,292 @@
+//
+//  SavedChartData+SegmentLog.m
+//  TradingApp
+//
+
+#import "SavedChartData+SegmentLog.h"
+#import "SavedChartData+FilenameUpdate.h"
+#import "HistoricalBarBlobCodec.h"
+#import "HistoricalBarMerge.h"
+#import "BarSeries.h"
+
+/*
+ * Segmento (little-endian), ripetuto fino a fine file:
+ *   magic "SCDS" | metadataLength u32 | payloadLength u32 | barCount u32
+ *   metadati (binary plist) | barre (HistoricalBarBlobCodec, vuoto se barCount == 0)
+ */
+static const uint32_t kSegmentMagic = 0x53444353;          // "SCDS"
+static const NSUInteger kSegmentHeaderSize = 16;
+static const uint32_t kSegmentMaxMetadataLength = 64 * 1024;
+static NSString *const kSegmentDirectoryName = @"Segments";
+static NSString *const kSegmentLogExtension = @"chartlog";
+
+/// Il log si compatta quando supera questa soglia o un quarto del file base
+static const unsigned long long kSegmentLogMinCompactionBytes = 64 * 1024;
+
+/// Header del segmento a offset, se valido e il segmento è completo nel log
+static BOOL SavedChartSegmentHeaderAt(NSData *logData, NSUInteger offset, uint32_t header[4]) {
+    if (offset + kSegmentHeaderSize > logData.length) return NO;
+    memcpy(header, (const uint8_t *)logData.bytes + offset, kSegmentHeaderSize);
+    return header[0] == kSegmentMagic && header[1] <= kSegmentMaxMetadataLength &&
+           (uint64_t)offset + kSegmentHeaderSize + header[1] + header[2] <= logData.length;
+}
+
+/// Fine dell'ultimo segmento completo; lastMetadataRange = metadati di quel segmento (length 0 se nessuno)
+static NSUInteger SavedChartSegmentLogValidLength(NSData *logData, NSRange *lastMetadataRange) {
+    NSUInteger offset = 0;
+    uint32_t header[4];
+    if (lastMetadataRange) *lastMetadataRange = NSMakeRange(0, 0);
+    while (SavedChartSegmentHeaderAt(logData, offset, header)) {
+        if (lastMetadataRange) *lastMetadataRange = NSMakeRange(offset + kSegmentHeaderSize, header[1]);
+        offset += kSegmentHeaderSize + header[1] + header[2];
+    }
+    return offset;
+}
+
+@implementation SavedChartData (SegmentLog)
+
+#pragma mark - Paths
+
+- (NSString *)segmentLogPathForFile:(NSString *)filePath {
+    if (self.chartID.length == 0) return nil;
+    return [SavedChartData segmentLogPathForFile:filePath chartID:self.chartID];
+}
+
++ (NSString *)segmentLogPathForFile:(NSString *)filePath chartID:(NSString *)chartID {
+    NSString *directory = [[filePath stringByDeletingLastPathComponent] stringByAppendingPathComponent:kSegmentDirectoryName];
+    NSString *filename = [chartID stringByAppendingPathExtension:kSegmentLogExtension];
+    return [directory stringByAppendingPathComponent:filename];
+}
+
+#pragma mark - Append
+
+- (NSDictionary *)segmentMetadata {
+    NSMutableDictionary *metadata = [NSMutableDictionary dictionary];
+    metadata[@"appendedAt"] = [NSDate date];
+    metadata[@"hasGaps"] = @(self.hasGaps);
+    metadata[@"barCount"] = @(self.barCount);   // totale dopo l'update, per chi legge solo i metadati
+    if (self.endDate) metadata[@"endDate"] = self.endDate;
+    if (self.lastUpdateDate) metadata[@"lastUpdateDate"] = self.lastUpdateDate;
+    if (self.lastSuccessfulUpdate) metadata[@"lastSuccessfulUpdate"] = self.lastSuccessfulUpdate;
+    if (self.nextScheduledUpdate) metadata[@"nextScheduledUpdate"] = self.nextScheduledUpdate;
+    return metadata;
+}
+
+- (BOOL)appendSegmentWithBars:(NSArray<HistoricalBarModel *> *)bars
+                 toLogForFile:(NSString *)filePath
+                        error:(NSError **)error {
+    NSString *logPath = [self segmentLogPathForFile:filePath];
+    if (!logPath) {
+        if (error) {
+            *error = [NSError errorWithDomain:@"SavedChartData"
+                                         code:1010
+                                     userInfo:@{NSLocalizedDescriptionKey: @"Storage has no chartID for its segment log"}];
+        }
+        return NO;
+    }
+
+    NSData *metadataData = [NSPropertyListSerialization dataWithPropertyList:[self segmentMetadata]
+                                                                      format:NSPropertyListBinaryFormat_v1_0
+                                                                     options:0
+                                                                       error:error];
+    if (!metadataData) return NO;
+
+    NSData *payload = bars.count > 0 ? [HistoricalBarBlobCodec encodeBars:bars] : nil;
+
+    // Un solo write per segmento: un'interruzione lascia al massimo una coda troncata
+    uint32_t header[4] = { kSegmentMagic, (uint32_t)metadataData.length, (uint32_t)payload.length, (uint32_t)bars.count };
+    NSMutableData *segment = [NSMutableData dataWithCapacity:kSegmentHeaderSize + metadataData.length + payload.length];
+    [segment appendBytes:header length:kSegmentHeaderSize];
+    [segment appendData:metadataData];
+    if (payload) [segment appendData:payload];
+
+    NSFileManager *fm = [NSFileManager defaultManager];
+    if (![fm fileExistsAtPath:logPath]) {
+        if (![fm createDirectoryAtPath:[logPath stringByDeletingLastPathComponent]
+           withIntermediateDirectories:YES
+                            attributes:nil
+                                 error:error]) {
+            return NO;
+        }
+        if (![fm createFileAtPath:logPath contents:nil attributes:nil]) {
+            if (error) {
+                *error = [NSError errorWithDomain:@"SavedChartData"
+                                             code:1011
+                                         userInfo:@{NSLocalizedDescriptionKey: @"Failed to create segment log"}];
+            }
+            return NO;
+        }
+    }
+
+    NSFileHandle *handle = [NSFileHandle fileHandleForWritingAtPath:logPath];
+    if (!handle) {
+        if (error) {
+            *error = [NSError errorWithDomain:@"SavedChartData"
+                                         code:1011
+                                     userInfo:@{NSLocalizedDescriptionKey: @"Failed to open segment log"}];
+        }
+        return NO;
+    }
+
+    // Coda troncata da un append interrotto: si riparte dalla fine dell'ultimo segmento completo,
+    // altrimenti il replay si fermerebbe lì e ignorerebbe tutto quello che segue
+    NSData *logData = [NSData dataWithContentsOfFile:logPath options:NSDataReadingMappedIfSafe error:nil];
+    NSUInteger validLength = SavedChartSegmentLogValidLength(logData, NULL);
+    BOOL success = YES;
+    if (validLength < logData.length) {
+        NSLog(@"⚠️ Segment log %@: dropping %lu bytes of truncated tail before append",
+              [logPath lastPathComponent], (unsigned long)(logData.length - validLength));
+        success = [handle truncateAtOffset:validLength error:error];
+    }
+    logData = nil;
+
+    success = success &&
+              [handle seekToEndReturningOffset:nil error:error] &&
+              [handle writeData:segment error:error] &&
+              [handle synchronizeAndReturnError:error];
+    [handle closeAndReturnError:nil];
+
+    if (success) {
+        NSLog(@"🧾 Appended segment to %@: %ld bars (%.1f KB)",
+              [logPath lastPathComponent], (long)bars.count, segment.length / 1024.0);
+    }
+    return success;
+}
+
+#pragma mark - Replay
+
+- (NSInteger)replaySegmentLogForFile:(NSString *)filePath {
+    NSString *logPath = [self segmentLogPathForFile:filePath];
+    if (!logPath) return 0;
+
+    NSData *logData = [NSData dataWithContentsOfFile:logPath options:NSDataReadingMappedIfSafe error:nil];
+    if (logData.length == 0) return 0;
+
+    NSUInteger offset = 0;
+    NSInteger segmentCount = 0;
+    NSMutableArray<NSArray<HistoricalBarModel *> *> *segmentBars = [NSMutableArray array];
+    NSDictionary *lastMetadata = nil;
+
+    while (offset < logData.length) {
+        uint32_t header[4];
+        if (!SavedChartSegmentHeaderAt(logData, offset, header)) {
+            NSLog(@"⚠️ Segment log %@: ignoring truncated tail at offset %lu",
+                  [logPath lastPathComponent], (unsigned long)offset);
+            break;
+        }
+        uint32_t metadataLength = header[1];
+        uint32_t payloadLength = header[2];
+        offset += kSegmentHeaderSize;
+
+        NSDictionary *metadata = [NSPropertyListSerialization propertyListWithData:[logData subdataWithRange:NSMakeRange(offset, metadataLength)]
+                                                                           options:NSPropertyListImmutable
+                                                                            format:NULL
+                                                                             error:nil];
+        offset += metadataLength;
+
+        BarSeries *series = nil;
+        if (payloadLength > 0) {
+            series = [HistoricalBarBlobCodec decodeData:[logData subdataWithRange:NSMakeRange(offset, payloadLength)]
+                                                 symbol:self.symbol
+                                              timeframe:self.timeframe
+                                           lastBarCount:0];
+        }
+        offset += payloadLength;
+
+        if (![metadata isKindOfClass:[NSDictionary class]] || (payloadLength > 0 && !series)) {
+            NSLog(@"⚠️ Segment log %@: corrupted segment, replay stopped", [logPath lastPathComponent]);
+            break;
+        }
+
+        if (series) [segmentBars addObject:[series bars]];
+        lastMetadata = metadata;
+        segmentCount++;
+    }
+
+    if (segmentCount == 0) return 0;
+
+    // Segmenti dal più recente: a parità di data il merge tiene la prima occorrenza
+    if (segmentBars.count > 0) {
+        NSArray<HistoricalBarModel *> *incoming = segmentBars.firstObject;
+        if (segmentBars.count > 1) {
+            NSMutableArray<HistoricalBarModel *> *concatenated = [NSMutableArray array];
+            for (NSArray<HistoricalBarModel *> *bars in segmentBars.reverseObjectEnumerator) {
+                [concatenated addObjectsFromArray:bars];
+            }
+            incoming = concatenated;
+        }
+        self.historicalBars = [HistoricalBarMerge mergeBars:self.historicalBars
+                                                   withBars:incoming
+                                                  tolerance:0
+                                             preferIncoming:YES];
+        NSDate *lastDate = self.historicalBars.lastObject.date;
+        if (lastDate && (!self.endDate || [lastDate compare:self.endDate] == NSOrderedDescending)) {
+            self.endDate = lastDate;
+        }
+    }
+
+    // Metadati dell'ultimo segmento, salvo che il file base sia stato riscritto dopo
+    NSDate *appendedAt = lastMetadata[@"appendedAt"];
+    if (!self.lastUpdateDate || !appendedAt || [appendedAt compare:self.lastUpdateDate] != NSOrderedAscending) {
+        self.hasGaps = [lastMetadata[@"hasGaps"] boolValue];
+        if (lastMetadata[@"lastUpdateDate"]) self.lastUpdateDate = lastMetadata[@"lastUpdateDate"];
+        if (lastMetadata[@"lastSuccessfulUpdate"]) self.lastSuccessfulUpdate = lastMetadata[@"lastSuccessfulUpdate"];
+        if (lastMetadata[@"nextScheduledUpdate"]) self.nextScheduledUpdate = lastMetadata[@"nextScheduledUpdate"];
+    }
+
+    NSLog(@"🧾 Replayed %ld segments from %@ (%.1f KB) → %ld bars",
+          (long)segmentCount, [logPath lastPathComponent], logData.length / 1024.0, (long)self.barCount);
+    return segmentCount;
+}
+
+#pragma mark - Metadata
+
++ (NSDictionary *)segmentLogMetadataForFile:(NSString *)filePath chartID:(NSString *)chartID {
+    if (chartID.length == 0) return nil;
+
+    NSString *logPath = [self segmentLogPathForFile:filePath chartID:chartID];
+    NSData *logData = [NSData dataWithContentsOfFile:logPath options:NSDataReadingMappedIfSafe error:nil];
+    if (logData.length == 0) return nil;
+
+    // Solo gli header e i metadati dell'ultimo segmento completo: le barre non vengono decodificate
+    NSRange metadataRange;
+    SavedChartSegmentLogValidLength(logData, &metadataRange);
+    if (metadataRange.length == 0) return nil;
+
+    NSDictionary *metadata = [NSPropertyListSerialization propertyListWithData:[logData subdataWithRange:metadataRange]
+                                                                       options:NSPropertyListImmutable
+                                                                        format:NULL
+                                                                         error:nil];
+    return [metadata isKindOfClass:[NSDictionary class]] ? metadata : nil;
+}
+
+#pragma mark - Compaction
+
+- (BOOL)segmentLogNeedsCompactionForFile:(NSString *)filePath {
+    NSString *logPath = [self segmentLogPathForFile:filePath];
+    if (!logPath) return NO;
+
+    NSFileManager *fm = [NSFileManager defaultManager];
+    unsigned long long logSize = [[fm attributesOfItemAtPath:logPath error:nil] fileSize];
+    unsigned long long baseSize = [[fm attributesOfItemAtPath:filePath error:nil] fileSize];
+    return logSize >= MAX(kSegmentLogMinCompactionBytes, baseSize / 4);
+}
+
+- (NSString *)compactSegmentLogForFile:(NSString *)filePath error:(NSError **)error {
+    // Le barre in memoria includono già il log: basta riscrivere il base
+    NSString *updatedFilePath = [self saveToFileWithFilenameUpdate:filePath error:error];
+    if (updatedFilePath) {
+        [self removeSegmentLogForFile:updatedFilePath];
+        NSLog(@"🗜️ Compacted segment log for %@ into %@", self.symbol, [updatedFilePath lastPathComponent]);
+    }
+    return updatedFilePath;
+}
+
+- (void)removeSegmentLogForFile:(NSString *)filePath {
+    NSString *logPath = [self segmentLogPathForFile:filePath];
+    if (logPath && [[NSFileManager defaultManager] fileExistsAtPath:logPath]) {
+        [[NSFileManager defaultManager] removeItemAtPath:logPath error:nil];
+    }
+}
+
+@end
@@ -1057,6 +1057,7 @@
     // ✅ OTTIMIZZAZIONE: Get metadata from filename instead of loading savedData
     NSString *filename = [storageItem.filePath lastPathComponent];
     NSString *symbol, *timeframeStr, *typeStr;
+    NSDictionary *headerMetadata = nil;
     
     if ([SavedChartData isNewFormatFilename:filename]) {
         // ✅ FAST: Use filename parsing
@@ -1068,6 +1069,11 @@
         symbol = storageItem.savedData.symbol ?: @"Unknown";
         timeframeStr = storageItem.savedData.timeframeDescription ?: @"Unknown";
         typeStr = storageItem.savedData.dataType == SavedChartDataTypeContinuous ? @"CONTINUOUS" : @"SNAPSHOT";
+    } else if ((headerMetadata = [SavedChartData headerMetadataFromFile:storageItem.filePath])) {
+        // ✅ FAST: Header del container binario, senza decomprimere le barre
+        symbol = headerMetadata[@"symbol"] ?: @"Unknown";
+        timeframeStr = [SavedChartData canonicalTimeframeString:[headerMetadata[@"timeframe"] integerValue]];
+        typeStr = [headerMetadata[@"dataType"] integerValue] == SavedChartDataTypeContinuous ? @"CONTINUOUS" : @"SNAPSHOT";
     } else {
         // ❌ ULTIMATE FALLBACK: Load file (rare case)
         NSLog(@"⚠️ Loading file for window title (old format): %@", filename);
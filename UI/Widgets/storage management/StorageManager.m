@@ -12,6 +12,7 @@
 #import "datahub+marketdata.h"
 #import "SavedChartData+FilenameParsing.h"
 #import "SavedChartData+FilenameUpdate.h"
+#import "SavedChartData+SegmentLog.h"
 #import "StorageMetadataCache.h"
 
 
@@ -544,21 +545,10 @@
                 // Update next scheduled time even if no new data
                 storage.nextScheduledUpdate = [self calculateNextUpdateDateForStorage:storage];
                 
-                // Save the updated schedule
+                // Save the updated schedule (metadata-only segment, no file rewrite)
                 NSError *saveError;
-                NSString *updatedFilePath = [storage saveToFileWithFilenameUpdate:item.filePath error:&saveError];
-                
-                if (updatedFilePath) {
-                    // Update file path if filename changed
-                    if (![updatedFilePath isEqualToString:item.filePath]) {
-                        [self.metadataCache handleFileRenamed:item.filePath newPath:updatedFilePath];
-                        item.filePath = updatedFilePath;
-                    } else {
-                        [self.metadataCache handleFileUpdated:updatedFilePath];
-                    }
-                    
-                    // Save cache
-                    [self.metadataCache saveToUserDefaults];
+                if (![self persistUpdateForItem:item newBars:@[] error:&saveError]) {
+                    NSLog(@"⚠️ Failed to save schedule for %@: %@", storage.symbol, saveError.localizedDescription);
                 }
                 
                 [self postUpdateNotification:@"up_to_date" forStorage:storage];
@@ -586,6 +576,7 @@
             }
             
             // Merge new bars with existing data
+            NSInteger previousBarCount = storage.barCount;
             BOOL mergeSuccess = [storage mergeWithNewBars:bars overlapBarCount:3];
             
             if (!mergeSuccess) {
@@ -605,28 +596,20 @@
             storage.lastSuccessfulUpdate = [NSDate date];
             storage.nextScheduledUpdate = [self calculateNextUpdateDateForStorage:storage];
             
-            // Save updated storage to file with filename update
-            NSError *saveError;
-            NSString *updatedFilePath = [storage saveToFileWithFilenameUpdate:item.filePath error:&saveError];
+            // Append only the bars the merge added (they follow the previous end date)
+            NSArray<HistoricalBarModel *> *addedBars = @[];
+            if (storage.barCount > previousBarCount) {
+                addedBars = [storage.historicalBars subarrayWithRange:NSMakeRange(previousBarCount, storage.barCount - previousBarCount)];
+            }
             
-            if (updatedFilePath) {
-                NSLog(@"✅ Update completed for %@ - added %ld bars", storage.symbol, (long)bars.count);
+            NSError *saveError;
+            if ([self persistUpdateForItem:item newBars:addedBars error:&saveError]) {
+                NSLog(@"✅ Update completed for %@ - added %ld bars", storage.symbol, (long)addedBars.count);
                 
                 // Reset failure count on success
                 item.failureCount = 0;
                 item.lastFailureDate = nil;
                 
-                // Update file path if filename changed
-                if (![updatedFilePath isEqualToString:item.filePath]) {
-                    [self.metadataCache handleFileRenamed:item.filePath newPath:updatedFilePath];
-                    item.filePath = updatedFilePath;
-                } else {
-                    [self.metadataCache handleFileUpdated:updatedFilePath];
-                }
-                
-                // Save cache
-                [self.metadataCache saveToUserDefaults];
-                
                 [self postUpdateNotification:@"completed" forStorage:storage];
                 
                 dispatch_async(dispatch_get_main_queue(), ^{
@@ -650,6 +633,72 @@
 }
 
 
+#pragma mark - Segment Log
+
+/**
+ * Persist an update of a continuous storage
+ * Appends a segment to the storage's log (cost ∝ new bars); once the log is
+ * large enough it is folded into the base file. Falls back to a full rewrite
+ * if the append fails.
+ */
+- (BOOL)persistUpdateForItem:(ActiveStorageItem *)item
+                     newBars:(NSArray<HistoricalBarModel *> *)newBars
+                       error:(NSError **)error {
+    SavedChartData *storage = item.savedData;
+    
+    // Il log è indicizzato per chartID: file legacy senza chartID persistito vanno prima riscritti
+    NSString *persistedChartID = [SavedChartData headerMetadataFromFile:item.filePath][@"chartID"];
+    if (![persistedChartID isEqualToString:storage.chartID]) {
+        return [self compactStorageItem:item error:error];
+    }
+    
+    NSError *appendError;
+    if (![storage appendSegmentWithBars:newBars toLogForFile:item.filePath error:&appendError]) {
+        NSLog(@"⚠️ Segment append failed for %@ (%@), rewriting file", storage.symbol, appendError.localizedDescription);
+        return [self compactStorageItem:item error:error];
+    }
+    
+    if ([storage segmentLogNeedsCompactionForFile:item.filePath]) {
+        NSError *compactionError;
+        if (![self compactStorageItem:item error:&compactionError]) {
+            // I dati sono già nel log: si riprova al prossimo update
+            NSLog(@"⚠️ Compaction failed for %@: %@", storage.symbol, compactionError.localizedDescription);
+        }
+        return YES;
+    }
+    
+    // Il file base non cambia: aggiorna in memoria la cache dei metadati
+    StorageMetadataItem *cachedItem = [self.metadataCache itemForPath:item.filePath];
+    if (cachedItem) {
+        cachedItem.barCount = storage.barCount;
+        cachedItem.endDate = storage.endDate;
+        cachedItem.lastUpdate = storage.lastSuccessfulUpdate;
+        cachedItem.hasGaps = storage.hasGaps;
+        [self.metadataCache saveToUserDefaults];
+    }
+    return YES;
+}
+
+/// Rewrite the base file with everything in memory and drop the segment log
+- (BOOL)compactStorageItem:(ActiveStorageItem *)item error:(NSError **)error {
+    NSString *updatedFilePath = [item.savedData compactSegmentLogForFile:item.filePath error:error];
+    if (!updatedFilePath) {
+        return NO;
+    }
+    
+    // Update file path if filename changed
+    if (![updatedFilePath isEqualToString:item.filePath]) {
+        [self.metadataCache handleFileRenamed:item.filePath newPath:updatedFilePath];
+        item.filePath = updatedFilePath;
+    } else {
+        [self.metadataCache handleFileUpdated:updatedFilePath];
+    }
+    
+    // Save cache
+    [self.metadataCache saveToUserDefaults];
+    return YES;
+}
+
 - (NSTimeInterval)timeframeToSeconds:(BarTimeframe)timeframe {
     switch (timeframe) {
         case BarTimeframe1Min:
@@ -926,6 +975,9 @@
             BOOL success = [item.savedData saveToFile:filePath error:&error];
             
             if (success) {
+                // Il file riscritto contiene già i segmenti del log
+                [item.savedData removeSegmentLogForFile:filePath];
+                
                 // Stop automatic updates for this storage
                 [item.updateTimer invalidate];
                 item.updateTimer = nil;
@@ -973,7 +1025,12 @@
     // 1. Remove from continuous registry if needed
     [self unregisterContinuousStorage:filePath];
     
-    // 2. Delete the file
+    // 2. Delete the segment log, then the file
+    NSString *chartID = [SavedChartData headerMetadataFromFile:filePath][@"chartID"];
+    if (chartID.length > 0) {
+        [[NSFileManager defaultManager] removeItemAtPath:[SavedChartData segmentLogPathForFile:filePath chartID:chartID] error:nil];
+    }
+    
     NSError *error;
     BOOL deleted = [[NSFileManager defaultManager] removeItemAtPath:filePath error:&error];
     
@@ -1131,7 +1188,14 @@
 
 // Helper method to convert cached items to UnifiedStorageItems
 - (NSArray<UnifiedStorageItem *> *)createUnifiedStorageItemsFromCachedItems:(NSArray<StorageMetadataItem *> *)cachedItems {
-    NSMutableArray<UnifiedStorageItem *> *unifiedItems = [NSMutableArray array];
+    NSMutableArray<UnifiedStorageItem *> *unifiedItems = [NSMutableArray arrayWithCapacity:cachedItems.count];
+    
+    // Lookup per path costruiti una volta sola (migliaia di storage)
+    NSMutableDictionary<NSString *, ActiveStorageItem *> *activeByPath = [NSMutableDictionary dictionary];
+    for (ActiveStorageItem *activeItem in self.mutableActiveStorages) {
+        if (activeItem.filePath) activeByPath[activeItem.filePath] = activeItem;
+    }
+    NSMutableDictionary<NSString *, NSDate *> *creationByPath = [NSMutableDictionary dictionaryWithCapacity:cachedItems.count];
     
     for (StorageMetadataItem *cachedItem in cachedItems) {
         UnifiedStorageItem *unifiedItem = [[UnifiedStorageItem alloc] init];
@@ -1141,24 +1205,19 @@
         
         // Link to ActiveStorageItem if it's continuous
         if (cachedItem.isContinuous) {
-            for (ActiveStorageItem *activeItem in self.mutableActiveStorages) {
-                if ([activeItem.filePath isEqualToString:cachedItem.filePath]) {
-                    unifiedItem.activeItem = activeItem;
-                    break;
-                }
-            }
+            unifiedItem.activeItem = activeByPath[cachedItem.filePath];
         }
         
+        if (cachedItem.filePath) {
+            creationByPath[cachedItem.filePath] = cachedItem.creationDate ?: [NSDate distantPast];
+        }
         [unifiedItems addObject:unifiedItem];
     }
     
     // Sort by creation date (newest first)
     [unifiedItems sortUsingComparator:^NSComparisonResult(UnifiedStorageItem *obj1, UnifiedStorageItem *obj2) {
-        StorageMetadataItem *item1 = [self.metadataCache itemForPath:obj1.filePath];
-        StorageMetadataItem *item2 = [self.metadataCache itemForPath:obj2.filePath];
-        
-        NSDate *date1 = item1.creationDate ?: [NSDate distantPast];
-        NSDate *date2 = item2.creationDate ?: [NSDate distantPast];
+        NSDate *date1 = creationByPath[obj1.filePath] ?: [NSDate distantPast];
+        NSDate *date2 = creationByPath[obj2.filePath] ?: [NSDate distantPast];
         
         return [date2 compare:date1];
     }];
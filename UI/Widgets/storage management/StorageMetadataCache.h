@@ -32,6 +32,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 // Runtime info
 @property (nonatomic, assign) BOOL isNewFormat;
+@property (nonatomic, assign) BOOL metadataFromHeader;  // Letti dall'header del container binario
 @property (nonatomic, assign) NSTimeInterval cacheTime;
 
 // Convenience properties
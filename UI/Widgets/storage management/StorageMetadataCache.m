@@ -4,6 +4,7 @@
 
 #import "StorageMetadataCache.h"
 #import "SavedChartData+FilenameParsing.h"
+#import "SavedChartData+SegmentLog.h"
 
 @implementation StorageMetadataItem
 
@@ -22,8 +23,9 @@
         item.fileSizeBytes = [attrs[NSFileSize] integerValue];
     }
     
-    // Parse metadata from filename
+    // Filename + header del file (poche centinaia di byte, nessuna decompressione)
     [item parseMetadataFromFilename];
+    [item applyHeaderMetadata];
     
     item.cacheTime = [[NSDate date] timeIntervalSince1970];
     
@@ -60,6 +62,7 @@
     item.includesExtendedHours = [dict[@"includesExtendedHours"] boolValue];
     item.hasGaps = [dict[@"hasGaps"] boolValue];
     item.isNewFormat = [dict[@"isNewFormat"] boolValue];
+    item.metadataFromHeader = [dict[@"metadataFromHeader"] boolValue];
     item.cacheTime = [dict[@"cacheTime"] doubleValue];
     
     return item;
@@ -82,6 +85,7 @@
         @"includesExtendedHours": @(self.includesExtendedHours),
         @"hasGaps": @(self.hasGaps),
         @"isNewFormat": @(self.isNewFormat),
+        @"metadataFromHeader": @(self.metadataFromHeader),
         @"cacheTime": @(self.cacheTime)
     };
 }
@@ -121,6 +125,47 @@
     }
 }
 
+/**
+ * Overlay metadata stored in the file header (binary container files only)
+ * Counts and dates come from the header; symbol, timeframe, type and extended
+ * hours keep the filename as authoritative source, as in SavedChartData loadFromFile:.
+ * For continuous storages the last segment of the log (updates not yet compacted
+ * into the file) wins, with the same rule as replaySegmentLogForFile:.
+ */
+- (void)applyHeaderMetadata {
+    NSDictionary *header = [SavedChartData headerMetadataFromFile:self.filePath];
+    self.metadataFromHeader = (header != nil);
+    if (!header) return;
+    
+    if (!self.isNewFormat) {
+        self.symbol = header[@"symbol"] ?: @"Unknown";
+        self.timeframe = [header[@"timeframe"] integerValue];
+        self.dataType = [header[@"dataType"] integerValue];
+        self.includesExtendedHours = [header[@"includesExtendedHours"] boolValue];
+    }
+    
+    self.barCount = [header[@"barCount"] integerValue];
+    self.startDate = header[@"startDate"] ?: self.startDate;
+    self.endDate = header[@"endDate"] ?: self.endDate;
+    self.creationDate = header[@"creationDate"] ?: self.creationDate;
+    self.lastUpdate = header[@"lastUpdateDate"] ?: self.lastUpdate;
+    self.hasGaps = [header[@"hasGaps"] boolValue];
+    
+    if (self.dataType != SavedChartDataTypeContinuous) return;
+    
+    // 🧾 Segmenti appesi dopo l'ultima riscrittura: solo i metadati dell'ultimo, barre non lette
+    NSDictionary *segment = [SavedChartData segmentLogMetadataForFile:self.filePath chartID:header[@"chartID"]];
+    NSDate *appendedAt = segment[@"appendedAt"];
+    if (!segment || (self.lastUpdate && appendedAt && [appendedAt compare:self.lastUpdate] == NSOrderedAscending)) {
+        return;
+    }
+    if (segment[@"barCount"]) self.barCount = [segment[@"barCount"] integerValue];
+    if (segment[@"endDate"]) self.endDate = segment[@"endDate"];
+    // Come StorageManager dopo un append: lastUpdate = ultimo update riuscito
+    self.lastUpdate = segment[@"lastSuccessfulUpdate"] ?: segment[@"lastUpdateDate"] ?: self.lastUpdate;
+    self.hasGaps = [segment[@"hasGaps"] boolValue];
+}
+
 #pragma mark - Update Methods
 
 - (BOOL)updateFromFilesystem {
@@ -136,6 +181,7 @@
         self.fileModificationTime = newModTime;
         self.fileSizeBytes = newSize;
         [self parseMetadataFromFilename];
+        [self applyHeaderMetadata];
         self.cacheTime = [[NSDate date] timeIntervalSince1970];
         return YES;
     }
@@ -228,29 +274,44 @@
 
 #pragma mark - Cache Management
 
+/// Items for every .chartdata file in directory, read in parallel
+- (NSArray<StorageMetadataItem *> *)itemsFromDirectory:(NSString *)directory {
+    NSArray<NSString *> *files = [[[NSFileManager defaultManager] contentsOfDirectoryAtPath:directory error:nil]
+                                  filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"SELF ENDSWITH '.chartdata'"]];
+    
+    NSMutableArray<StorageMetadataItem *> *items = [NSMutableArray arrayWithCapacity:files.count];
+    
+    // Ogni file costa uno stat e la lettura dell'header: il lock serve solo all'append
+    dispatch_apply(files.count, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^(size_t i) {
+        @autoreleasepool {
+            NSString *filePath = [directory stringByAppendingPathComponent:files[i]];
+            StorageMetadataItem *item = [StorageMetadataItem itemFromFilePath:filePath];
+            if (item) {
+                @synchronized (items) {
+                    [items addObject:item];
+                }
+            }
+        }
+    });
+    
+    return items;
+}
+
 - (void)buildCacheFromDirectory:(NSString *)directory {
     NSLog(@"📦 Building storage metadata cache from: %@", directory);
     
-    dispatch_barrier_async(self.cacheQueue, ^{
-        NSFileManager *fm = [NSFileManager defaultManager];
-        NSArray<NSString *> *files = [fm contentsOfDirectoryAtPath:directory error:nil];
-        
-        NSMutableDictionary *newCache = [NSMutableDictionary dictionary];
-        NSInteger processed = 0;
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        NSArray<StorageMetadataItem *> *items = [self itemsFromDirectory:directory];
         
-        for (NSString *filename in files) {
-            if ([filename hasSuffix:@".chartdata"]) {
-                NSString *filePath = [directory stringByAppendingPathComponent:filename];
-                StorageMetadataItem *item = [StorageMetadataItem itemFromFilePath:filePath];
-                
-                if (item) {
-                    newCache[filePath] = item;
-                    processed++;
-                }
-            }
+        NSMutableDictionary *newCache = [NSMutableDictionary dictionaryWithCapacity:items.count];
+        for (StorageMetadataItem *item in items) {
+            newCache[item.filePath] = item;
         }
+        NSInteger processed = items.count;
         
-        self.cache = newCache;
+        dispatch_barrier_sync(self.cacheQueue, ^{
+            self.cache = newCache;
+        });
         
         dispatch_async(dispatch_get_main_queue(), ^{
             NSLog(@"✅ Metadata cache built: %ld items processed", (long)processed);
@@ -442,33 +503,20 @@
         });
         NSLog(@"✅ Cleared in-memory cache");
         
-        // 3. Scan all files and rebuild from filenames
-        NSFileManager *fm = [NSFileManager defaultManager];
-        NSArray<NSString *> *filesOnDisk = [fm contentsOfDirectoryAtPath:directory error:nil];
+        // 3. Scan all files in parallel (filename + file header)
+        NSArray<StorageMetadataItem *> *items = [self itemsFromDirectory:directory];
         
-        NSMutableDictionary *newCache = [NSMutableDictionary dictionary];
+        NSMutableDictionary *newCache = [NSMutableDictionary dictionaryWithCapacity:items.count];
         NSInteger processed = 0;
         NSInteger skipped = 0;
         
-        for (NSString *filename in filesOnDisk) {
-            if ([filename hasSuffix:@".chartdata"]) {
-                NSString *filePath = [directory stringByAppendingPathComponent:filename];
-                
-                // Create item by parsing filename only
-                StorageMetadataItem *item = [StorageMetadataItem itemFromFilePath:filePath];
-                
-                if (item && item.isNewFormat) {
-                    newCache[filePath] = item;
-                    processed++;
-                    
-                    NSLog(@"   ✅ %@ [%@] - %ld bars",
-                          item.symbol,
-                          item.timeframeDisplayString,
-                          (long)item.barCount);
-                } else {
-                    skipped++;
-                    NSLog(@"   ⚠️ Skipped old format: %@", filename);
-                }
+        for (StorageMetadataItem *item in items) {
+            if (item.isNewFormat || item.metadataFromHeader) {
+                newCache[item.filePath] = item;
+                processed++;
+            } else {
+                skipped++;
+                NSLog(@"   ⚠️ Skipped old format: %@", item.filename);
             }
         }
         
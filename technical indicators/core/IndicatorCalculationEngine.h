@@ -79,6 +79,66 @@ NS_ASSUME_NONNULL_BEGIN
                              valuesY:(NSArray<NSNumber *> *)valuesY
                               period:(NSInteger)period;
 
+#pragma mark - Buffer API (double *)
+
+/*
+ * Same math as the NSArray API above, over raw double buffers: `output`
+ * holds `count` doubles and gets the same NaN padding. Window sums,
+ * variance and correlation are vectorized (Accelerate when available,
+ * plain C loops otherwise). Return NO, leaving `output` untouched, where
+ * the NSArray variant would return an empty array.
+ */
+
++ (BOOL)smaSeries:(const double *)values
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output;
+
++ (BOOL)emaSeries:(const double *)values
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output;
+
++ (BOOL)wmaSeries:(const double *)values
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output;
+
++ (BOOL)rsiSeries:(const double *)closes
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output;
+
++ (BOOL)rocSeries:(const double *)values
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output;
+
++ (BOOL)atrSeriesWithHigh:(const double *)high
+                      low:(const double *)low
+                    close:(const double *)close
+                    count:(NSInteger)count
+                   period:(NSInteger)period
+                   output:(double *)output;
+
++ (BOOL)stdevSeries:(const double *)values
+              count:(NSInteger)count
+             period:(NSInteger)period
+             output:(double *)output;
+
++ (BOOL)correlationSeries:(const double *)valuesX
+                  valuesY:(const double *)valuesY
+                    count:(NSInteger)count
+                   period:(NSInteger)period
+                   output:(double *)output;
+
+/// Copy a price column into a buffer of bars.count doubles
+/// (plain copy of the column when bars are BarSeries-backed)
+/// @param priceType Same values as extractPriceSeries:priceType:
++ (void)extractPriceSeries:(NSArray<HistoricalBarModel *> *)bars
+                 priceType:(NSString *)priceType
+                    output:(double *)output;
+
 #pragma mark - Utility Functions
 
 /// Extract price series from bars
@@ -3,113 +3,150 @@
 //
 
 #import "IndicatorCalculationEngine.h"
+#import "BarSeries.h"
 
-@implementation IndicatorCalculationEngine
+#if __has_include(<Accelerate/Accelerate.h>)
+#import <Accelerate/Accelerate.h>
+#define INDICATOR_ENGINE_USE_ACCELERATE 1
+#else
+#define INDICATOR_ENGINE_USE_ACCELERATE 0
+#endif
 
-#pragma mark - Moving Averages
+#pragma mark - Vector Primitives
 
-+ (NSArray<NSNumber *> *)sma:(NSArray<NSNumber *> *)values period:(NSInteger)period {
-    if (!values || values.count == 0 || period <= 0) {
-        return @[];
+/// out[k] = in[k] + ... + in[k + period - 1] for k in [0, count - period]
+static void EngineWindowSums(const double *in, NSInteger count, NSInteger period, double *out) {
+#if INDICATOR_ENGINE_USE_ACCELERATE
+    vDSP_vswsumD(in, 1, out, 1, (vDSP_Length)(count - period + 1), (vDSP_Length)period);
+#else
+    double sum = 0.0;
+    for (NSInteger i = 0; i < period; i++) {
+        sum += in[i];
     }
-    
-    NSMutableArray<NSNumber *> *result = [[NSMutableArray alloc] initWithCapacity:values.count];
-    
-    // Pad initial values with NaN
-    for (NSInteger i = 0; i < period - 1 && i < values.count; i++) {
-        [result addObject:@(NAN)];
+    out[0] = sum;
+    for (NSInteger k = 1; k <= count - period; k++) {
+        sum += in[k + period - 1] - in[k - 1];
+        out[k] = sum;
     }
-    
-    // Calculate SMA values
-    for (NSInteger i = period - 1; i < values.count; i++) {
-        double sum = 0.0;
-        NSInteger validCount = 0;
-        
-        for (NSInteger j = i - period + 1; j <= i; j++) {
-            double value = [values[j] doubleValue];
-            if ([self isValidNumber:value]) {
-                sum += value;
-                validCount++;
-            }
-        }
-        
-        if (validCount >= period * 0.8) {  // Require at least 80% valid values
-            [result addObject:@(sum / validCount)];
-        } else {
-            [result addObject:@(NAN)];
-        }
+#endif
+}
+
+/// out[i] = a[i] * b[i]
+static void EngineMultiply(const double *a, const double *b, double *out, NSInteger count) {
+#if INDICATOR_ENGINE_USE_ACCELERATE
+    vDSP_vmulD(a, 1, b, 1, out, 1, (vDSP_Length)count);
+#else
+    for (NSInteger i = 0; i < count; i++) {
+        out[i] = a[i] * b[i];
     }
-    
-    return [result copy];
+#endif
 }
 
-+ (NSArray<NSNumber *> *)ema:(NSArray<NSNumber *> *)values period:(NSInteger)period {
-    if (!values || values.count == 0 || period <= 0) {
-        return @[];
+static void EngineFillNaN(double *out, NSInteger count) {
+    for (NSInteger i = 0; i < count; i++) {
+        out[i] = NAN;
     }
-    
-    NSMutableArray<NSNumber *> *result = [[NSMutableArray alloc] initWithCapacity:values.count];
+}
+
+static double EngineFirstValidValue(const double *values, NSInteger count) {
+    for (NSInteger i = 0; i < count; i++) {
+        if (isfinite(values[i])) return values[i];
+    }
+    return 0.0;
+}
+
+/*
+ * Split a series into (value - reference, 0 for NaN/inf) and a 1/0 validity
+ * mask, so windows with missing values reduce to plain sums. Centering on
+ * the first valid value keeps sums of squares small for price series.
+ */
+static void EngineSplitValid(const double *values, NSInteger count, double reference,
+                             double *clean, double *mask) {
+    for (NSInteger i = 0; i < count; i++) {
+        BOOL valid = isfinite(values[i]);
+        clean[i] = valid ? values[i] - reference : 0.0;
+        mask[i] = valid ? 1.0 : 0.0;
+    }
+}
+
+/// EMA seeded with the first valid value; invalid inputs give NaN and keep the state
+static void EngineEMA(const double *values, NSInteger count, NSInteger period, double *output) {
     double multiplier = 2.0 / (period + 1.0);
     double ema = NAN;
     
-    for (NSInteger i = 0; i < values.count; i++) {
-        double currentValue = [values[i] doubleValue];
-        
-        if (![self isValidNumber:currentValue]) {
-            [result addObject:@(NAN)];
+    for (NSInteger i = 0; i < count; i++) {
+        double value = values[i];
+        if (!isfinite(value)) {
+            output[i] = NAN;
             continue;
         }
-        
-        if (isnan(ema)) {
-            // First valid value becomes initial EMA
-            ema = currentValue;
-        } else {
-            // EMA formula: (Current * multiplier) + (Previous EMA * (1 - multiplier))
-            ema = (currentValue * multiplier) + (ema * (1.0 - multiplier));
-        }
-        
-        [result addObject:@(ema)];
+        ema = isnan(ema) ? value : (value * multiplier) + (ema * (1.0 - multiplier));
+        output[i] = ema;
+    }
+}
+
+#pragma mark - NSNumber Bridging
+
+static NSMutableData *EngineBufferFromNumbers(NSArray<NSNumber *> *values) {
+    NSMutableData *buffer = [NSMutableData dataWithLength:values.count * sizeof(double)];
+    double *out = buffer.mutableBytes;
+    NSInteger i = 0;
+    for (NSNumber *value in values) {
+        out[i++] = value.doubleValue;
+    }
+    return buffer;
+}
+
+static NSArray<NSNumber *> *EngineArrayFromBuffer(const double *values, NSInteger count) {
+    NSMutableArray<NSNumber *> *result = [[NSMutableArray alloc] initWithCapacity:count];
+    for (NSInteger i = 0; i < count; i++) {
+        [result addObject:@(values[i])];
     }
-    
     return [result copy];
 }
 
-+ (NSArray<NSNumber *> *)wma:(NSArray<NSNumber *> *)values period:(NSInteger)period {
+/// Run a single-input buffer kernel on an NSNumber array
+static NSArray<NSNumber *> *EngineApply(NSArray<NSNumber *> *values,
+                                        BOOL (^kernel)(const double *input, NSInteger count, double *output)) {
+    NSInteger count = values.count;
+    NSMutableData *input = EngineBufferFromNumbers(values);
+    NSMutableData *output = [NSMutableData dataWithLength:count * sizeof(double)];
+    
+    if (!kernel(input.bytes, count, output.mutableBytes)) {
+        return @[];
+    }
+    return EngineArrayFromBuffer(output.bytes, count);
+}
+
+@implementation IndicatorCalculationEngine
+
+#pragma mark - Moving Averages
+
++ (NSArray<NSNumber *> *)sma:(NSArray<NSNumber *> *)values period:(NSInteger)period {
     if (!values || values.count == 0 || period <= 0) {
         return @[];
     }
-    
-    NSMutableArray<NSNumber *> *result = [[NSMutableArray alloc] initWithCapacity:values.count];
-    
-    // Pad initial values with NaN
-    for (NSInteger i = 0; i < period - 1 && i < values.count; i++) {
-        [result addObject:@(NAN)];
+    return EngineApply(values, ^BOOL(const double *input, NSInteger count, double *output) {
+        return [self smaSeries:input count:count period:period output:output];
+    });
+}
+
++ (NSArray<NSNumber *> *)ema:(NSArray<NSNumber *> *)values period:(NSInteger)period {
+    if (!values || values.count == 0 || period <= 0) {
+        return @[];
     }
-    
-    // Calculate WMA values
-    NSInteger totalWeight = period * (period + 1) / 2;  // Sum of 1+2+...+period
-    
-    for (NSInteger i = period - 1; i < values.count; i++) {
-        double weightedSum = 0.0;
-        NSInteger validCount = 0;
-        
-        for (NSInteger j = 0; j < period; j++) {
-            double value = [values[i - j] doubleValue];
-            if ([self isValidNumber:value]) {
-                NSInteger weight = period - j;  // Most recent gets highest weight
-                weightedSum += value * weight;
-                validCount++;
-            }
-        }
-        
-        if (validCount >= period * 0.8) {
-            [result addObject:@(weightedSum / totalWeight)];
-        } else {
-            [result addObject:@(NAN)];
-        }
+    return EngineApply(values, ^BOOL(const double *input, NSInteger count, double *output) {
+        return [self emaSeries:input count:count period:period output:output];
+    });
+}
+
++ (NSArray<NSNumber *> *)wma:(NSArray<NSNumber *> *)values period:(NSInteger)period {
+    if (!values || values.count == 0 || period <= 0) {
+        return @[];
     }
-    
-    return [result copy];
+    return EngineApply(values, ^BOOL(const double *input, NSInteger count, double *output) {
+        return [self wmaSeries:input count:count period:period output:output];
+    });
 }
 
 #pragma mark - Momentum Indicators
@@ -118,80 +155,18 @@
     if (!closes || closes.count < 2 || period <= 0) {
         return @[];
     }
-    
-    NSMutableArray<NSNumber *> *result = [[NSMutableArray alloc] initWithCapacity:closes.count];
-    NSMutableArray<NSNumber *> *gains = [[NSMutableArray alloc] init];
-    NSMutableArray<NSNumber *> *losses = [[NSMutableArray alloc] init];
-    
-    // Calculate price changes
-    [result addObject:@(NAN)];  // First value has no previous price
-    
-    for (NSInteger i = 1; i < closes.count; i++) {
-        double current = [closes[i] doubleValue];
-        double previous = [closes[i-1] doubleValue];
-        
-        if ([self isValidNumber:current] && [self isValidNumber:previous]) {
-            double change = current - previous;
-            [gains addObject:@(change > 0 ? change : 0.0)];
-            [losses addObject:@(change < 0 ? -change : 0.0)];
-        } else {
-            [gains addObject:@(0.0)];
-            [losses addObject:@(0.0)];
-        }
-    }
-    
-    // Calculate RSI using EMA of gains and losses
-    NSArray<NSNumber *> *avgGains = [self ema:gains period:period];
-    NSArray<NSNumber *> *avgLosses = [self ema:losses period:period];
-    
-    for (NSInteger i = 1; i < closes.count; i++) {
-        if (i-1 < avgGains.count && i-1 < avgLosses.count) {
-            double avgGain = [avgGains[i-1] doubleValue];
-            double avgLoss = [avgLosses[i-1] doubleValue];
-            
-            if ([self isValidNumber:avgGain] && [self isValidNumber:avgLoss] && avgLoss > 0) {
-                double rs = avgGain / avgLoss;
-                double rsi = 100.0 - (100.0 / (1.0 + rs));
-                [result addObject:@(rsi)];
-            } else if (avgLoss == 0 && avgGain > 0) {
-                [result addObject:@(100.0)];  // All gains, no losses
-            } else {
-                [result addObject:@(50.0)];   // Default middle value
-            }
-        } else {
-            [result addObject:@(NAN)];
-        }
-    }
-    
-    return [result copy];
+    return EngineApply(closes, ^BOOL(const double *input, NSInteger count, double *output) {
+        return [self rsiSeries:input count:count period:period output:output];
+    });
 }
 
 + (NSArray<NSNumber *> *)roc:(NSArray<NSNumber *> *)values period:(NSInteger)period {
     if (!values || values.count <= period || period <= 0) {
         return @[];
     }
-    
-    NSMutableArray<NSNumber *> *result = [[NSMutableArray alloc] initWithCapacity:values.count];
-    
-    // Pad initial values
-    for (NSInteger i = 0; i < period && i < values.count; i++) {
-        [result addObject:@(NAN)];
-    }
-    
-    // Calculate ROC
-    for (NSInteger i = period; i < values.count; i++) {
-        double current = [values[i] doubleValue];
-        double previous = [values[i - period] doubleValue];
-        
-        if ([self isValidNumber:current] && [self isValidNumber:previous] && previous != 0) {
-            double roc = [self percentageChange:current previous:previous];
-            [result addObject:@(roc)];
-        } else {
-            [result addObject:@(NAN)];
-        }
-    }
-    
-    return [result copy];
+    return EngineApply(values, ^BOOL(const double *input, NSInteger count, double *output) {
+        return [self rocSeries:input count:count period:period output:output];
+    });
 }
 
 #pragma mark - Volatility Indicators
@@ -201,19 +176,21 @@
         return @[];
     }
     
-    NSMutableArray<NSNumber *> *trueRanges = [[NSMutableArray alloc] init];
+    NSInteger count = bars.count;
+    NSMutableData *columns = [NSMutableData dataWithLength:4 * count * sizeof(double)];
+    double *high = columns.mutableBytes;
+    double *low = high + count;
+    double *close = low + count;
+    double *output = close + count;
     
-    // Calculate True Range for each bar
-    for (NSInteger i = 0; i < bars.count; i++) {
-        HistoricalBarModel *current = bars[i];
-        HistoricalBarModel *previous = (i > 0) ? bars[i-1] : nil;
-        
-        double tr = [self trueRange:current previous:previous];
-        [trueRanges addObject:@(tr)];
-    }
+    [self extractPriceSeries:bars priceType:@"high" output:high];
+    [self extractPriceSeries:bars priceType:@"low" output:low];
+    [self extractPriceSeries:bars priceType:@"close" output:close];
     
-    // ATR is EMA of True Range
-    return [self ema:trueRanges period:period];
+    if (![self atrSeriesWithHigh:high low:low close:close count:count period:period output:output]) {
+        return @[];
+    }
+    return EngineArrayFromBuffer(output, count);
 }
 
 + (double)trueRange:(HistoricalBarModel *)current previous:(nullable HistoricalBarModel *)previous {
@@ -234,105 +211,322 @@
     if (!values || values.count == 0 || period <= 1) {
         return @[];
     }
+    return EngineApply(values, ^BOOL(const double *input, NSInteger count, double *output) {
+        return [self stdevSeries:input count:count period:period output:output];
+    });
+}
+
++ (NSArray<NSNumber *> *)correlation:(NSArray<NSNumber *> *)valuesX
+                             valuesY:(NSArray<NSNumber *> *)valuesY
+                              period:(NSInteger)period {
+    if (!valuesX || !valuesY || valuesX.count != valuesY.count || period <= 1) {
+        return @[];
+    }
     
-    NSMutableArray<NSNumber *> *result = [[NSMutableArray alloc] initWithCapacity:values.count];
+    NSInteger count = valuesX.count;
+    NSMutableData *inputX = EngineBufferFromNumbers(valuesX);
+    NSMutableData *inputY = EngineBufferFromNumbers(valuesY);
+    NSMutableData *output = [NSMutableData dataWithLength:count * sizeof(double)];
     
-    // Pad initial values
-    for (NSInteger i = 0; i < period - 1 && i < values.count; i++) {
-        [result addObject:@(NAN)];
+    if (![self correlationSeries:inputX.bytes valuesY:inputY.bytes count:count period:period output:output.mutableBytes]) {
+        return @[];
+    }
+    return EngineArrayFromBuffer(output.bytes, count);
+}
+
+#pragma mark - Buffer API
+
++ (BOOL)smaSeries:(const double *)values
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output {
+    if (!values || count <= 0 || period <= 0) {
+        return NO;
     }
     
-    // Calculate rolling standard deviation
-    for (NSInteger i = period - 1; i < values.count; i++) {
+    EngineFillNaN(output, count);
+    if (period > count) {
+        return YES;
+    }
+    
+    NSInteger windows = count - period + 1;
+    NSMutableData *scratch = [NSMutableData dataWithLength:(2 * count + 2 * windows) * sizeof(double)];
+    double *clean = scratch.mutableBytes;
+    double *mask = clean + count;
+    double *sums = mask + count;
+    double *validCounts = sums + windows;
+    
+    double reference = EngineFirstValidValue(values, count);
+    EngineSplitValid(values, count, reference, clean, mask);
+    EngineWindowSums(clean, count, period, sums);
+    EngineWindowSums(mask, count, period, validCounts);
+    
+    double minValid = period * 0.8;  // Require at least 80% valid values
+    for (NSInteger k = 0; k < windows; k++) {
+        if (validCounts[k] >= minValid) {
+            output[k + period - 1] = reference + sums[k] / validCounts[k];
+        }
+    }
+    return YES;
+}
+
++ (BOOL)emaSeries:(const double *)values
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output {
+    if (!values || count <= 0 || period <= 0) {
+        return NO;
+    }
+    
+    // Ricorsiva: non vettorizzabile, ma senza boxing
+    EngineEMA(values, count, period, output);
+    return YES;
+}
+
++ (BOOL)wmaSeries:(const double *)values
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output {
+    if (!values || count <= 0 || period <= 0) {
+        return NO;
+    }
+    
+    EngineFillNaN(output, count);
+    if (period > count) {
+        return YES;
+    }
+    
+    NSInteger windows = count - period + 1;
+    NSMutableData *scratch = [NSMutableData dataWithLength:(2 * count + 2 * windows + period) * sizeof(double)];
+    double *clean = scratch.mutableBytes;
+    double *mask = clean + count;
+    double *weightedSums = mask + count;
+    double *validCounts = weightedSums + windows;
+    double *weights = validCounts + windows;
+    
+    // Pesi non centrabili: somma pesata sui valori grezzi
+    EngineSplitValid(values, count, 0.0, clean, mask);
+    EngineWindowSums(mask, count, period, validCounts);
+    
+    for (NSInteger j = 0; j < period; j++) {
+        weights[j] = j + 1;  // Most recent gets highest weight
+    }
+
+#if INDICATOR_ENGINE_USE_ACCELERATE
+    vDSP_convD(clean, 1, weights, 1, weightedSums, 1, (vDSP_Length)windows, (vDSP_Length)period);
+#else
+    for (NSInteger k = 0; k < windows; k++) {
         double sum = 0.0;
-        NSInteger validCount = 0;
-        
-        // Calculate mean
-        for (NSInteger j = i - period + 1; j <= i; j++) {
-            double value = [values[j] doubleValue];
-            if ([self isValidNumber:value]) {
-                sum += value;
-                validCount++;
-            }
+        for (NSInteger j = 0; j < period; j++) {
+            sum += clean[k + j] * weights[j];
         }
-        
-        if (validCount < period * 0.8) {
-            [result addObject:@(NAN)];
-            continue;
+        weightedSums[k] = sum;
+    }
+#endif
+
+    double totalWeight = period * (period + 1) / 2;  // Sum of 1+2+...+period
+    double minValid = period * 0.8;
+    for (NSInteger k = 0; k < windows; k++) {
+        if (validCounts[k] >= minValid) {
+            output[k + period - 1] = weightedSums[k] / totalWeight;
         }
-        
-        double mean = sum / validCount;
-        double sumSquaredDiffs = 0.0;
-        
-        // Calculate variance
-        for (NSInteger j = i - period + 1; j <= i; j++) {
-            double value = [values[j] doubleValue];
-            if ([self isValidNumber:value]) {
-                double diff = value - mean;
-                sumSquaredDiffs += diff * diff;
-            }
+    }
+    return YES;
+}
+
++ (BOOL)rsiSeries:(const double *)closes
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output {
+    if (!closes || count < 2 || period <= 0) {
+        return NO;
+    }
+    
+    NSInteger changes = count - 1;
+    NSMutableData *scratch = [NSMutableData dataWithLength:4 * changes * sizeof(double)];
+    double *gains = scratch.mutableBytes;
+    double *losses = gains + changes;
+    double *avgGains = losses + changes;
+    double *avgLosses = avgGains + changes;
+    
+    // Price changes
+    for (NSInteger i = 1; i < count; i++) {
+        double current = closes[i];
+        double previous = closes[i - 1];
+        double change = (isfinite(current) && isfinite(previous)) ? current - previous : 0.0;
+        gains[i - 1] = change > 0 ? change : 0.0;
+        losses[i - 1] = change < 0 ? -change : 0.0;
+    }
+    
+    // RSI using EMA of gains and losses
+    EngineEMA(gains, changes, period, avgGains);
+    EngineEMA(losses, changes, period, avgLosses);
+    
+    output[0] = NAN;  // First value has no previous price
+    for (NSInteger i = 1; i < count; i++) {
+        double avgGain = avgGains[i - 1];
+        double avgLoss = avgLosses[i - 1];
+    
+        if (isfinite(avgGain) && isfinite(avgLoss) && avgLoss > 0) {
+            double rs = avgGain / avgLoss;
+            output[i] = 100.0 - (100.0 / (1.0 + rs));
+        } else if (avgLoss == 0 && avgGain > 0) {
+            output[i] = 100.0;  // All gains, no losses
+        } else {
+            output[i] = 50.0;   // Default middle value
         }
-        
-        double variance = sumSquaredDiffs / (validCount - 1);  // Sample variance
-        double stdev = sqrt(variance);
-        
-        [result addObject:@(stdev)];
+    }
+    return YES;
+}
+
++ (BOOL)rocSeries:(const double *)values
+            count:(NSInteger)count
+           period:(NSInteger)period
+           output:(double *)output {
+    if (!values || count <= period || period <= 0) {
+        return NO;
     }
     
-    return [result copy];
+    EngineFillNaN(output, period);
+    for (NSInteger i = period; i < count; i++) {
+        double current = values[i];
+        double previous = values[i - period];
+        BOOL valid = isfinite(current) && isfinite(previous) && previous != 0;
+        output[i] = valid ? ((current - previous) / previous) * 100.0 : NAN;
+    }
+    return YES;
 }
 
-+ (NSArray<NSNumber *> *)correlation:(NSArray<NSNumber *> *)valuesX
-                             valuesY:(NSArray<NSNumber *> *)valuesY
-                              period:(NSInteger)period {
-    if (!valuesX || !valuesY || valuesX.count != valuesY.count || period <= 1) {
-        return @[];
++ (BOOL)atrSeriesWithHigh:(const double *)high
+                      low:(const double *)low
+                    close:(const double *)close
+                    count:(NSInteger)count
+                   period:(NSInteger)period
+                   output:(double *)output {
+    if (!high || !low || !close || count < 2 || period <= 0) {
+        return NO;
     }
     
-    NSMutableArray<NSNumber *> *result = [[NSMutableArray alloc] initWithCapacity:valuesX.count];
+    NSMutableData *scratch = [NSMutableData dataWithLength:count * sizeof(double)];
+    double *trueRanges = scratch.mutableBytes;
     
-    // Pad initial values
-    for (NSInteger i = 0; i < period - 1 && i < valuesX.count; i++) {
-        [result addObject:@(NAN)];
+    for (NSInteger i = 0; i < count; i++) {
+        double prevClose = (i > 0) ? close[i - 1] : close[i];
+        double range1 = high[i] - low[i];
+        double range2 = fabs(high[i] - prevClose);
+        double range3 = fabs(low[i] - prevClose);
+        trueRanges[i] = MAX(range1, MAX(range2, range3));
     }
     
-    // Calculate rolling correlation
-    for (NSInteger i = period - 1; i < valuesX.count; i++) {
-        double sumX = 0.0, sumY = 0.0, sumXY = 0.0, sumX2 = 0.0, sumY2 = 0.0;
-        NSInteger validCount = 0;
-        
-        for (NSInteger j = i - period + 1; j <= i; j++) {
-            double x = [valuesX[j] doubleValue];
-            double y = [valuesY[j] doubleValue];
-            
-            if ([self isValidNumber:x] && [self isValidNumber:y]) {
-                sumX += x;
-                sumY += y;
-                sumXY += x * y;
-                sumX2 += x * x;
-                sumY2 += y * y;
-                validCount++;
-            }
-        }
-        
-        if (validCount < period * 0.8) {
-            [result addObject:@(NAN)];
-            continue;
-        }
-        
-        double n = validCount;
-        double numerator = n * sumXY - sumX * sumY;
-        double denominator = sqrt((n * sumX2 - sumX * sumX) * (n * sumY2 - sumY * sumY));
-        
-        if (denominator != 0) {
-            double correlation = numerator / denominator;
-            [result addObject:@(correlation)];
+    // ATR is EMA of True Range
+    EngineEMA(trueRanges, count, period, output);
+    return YES;
+}
+
++ (BOOL)stdevSeries:(const double *)values
+              count:(NSInteger)count
+             period:(NSInteger)period
+             output:(double *)output {
+    if (!values || count <= 0 || period <= 1) {
+        return NO;
+    }
+    
+    EngineFillNaN(output, count);
+    if (period > count) {
+        return YES;
+    }
+    
+    NSInteger windows = count - period + 1;
+    NSMutableData *scratch = [NSMutableData dataWithLength:(3 * count + 3 * windows) * sizeof(double)];
+    double *clean = scratch.mutableBytes;
+    double *mask = clean + count;
+    double *squares = mask + count;
+    double *sums = squares + count;
+    double *squareSums = sums + windows;
+    double *validCounts = squareSums + windows;
+    
+    EngineSplitValid(values, count, EngineFirstValidValue(values, count), clean, mask);
+    EngineMultiply(clean, clean, squares, count);
+    EngineWindowSums(clean, count, period, sums);
+    EngineWindowSums(squares, count, period, squareSums);
+    EngineWindowSums(mask, count, period, validCounts);
+    
+    double minValid = period * 0.8;
+    for (NSInteger k = 0; k < windows; k++) {
+        double n = validCounts[k];
+        if (n < minValid) continue;
+    
+        // Sample variance; clamp rounding noise on flat windows
+        double variance = (squareSums[k] - sums[k] * sums[k] / n) / (n - 1);
+        output[k + period - 1] = sqrt(MAX(variance, 0.0));
+    }
+    return YES;
+}
+
++ (BOOL)correlationSeries:(const double *)valuesX
+                  valuesY:(const double *)valuesY
+                    count:(NSInteger)count
+                   period:(NSInteger)period
+                   output:(double *)output {
+    if (!valuesX || !valuesY || count <= 0 || period <= 1) {
+        return NO;
+    }
+    
+    EngineFillNaN(output, count);
+    if (period > count) {
+        return YES;
+    }
+    
+    NSInteger windows = count - period + 1;
+    NSMutableData *scratch = [NSMutableData dataWithLength:(4 * count + 6 * windows) * sizeof(double)];
+    double *cleanX = scratch.mutableBytes;
+    double *cleanY = cleanX + count;
+    double *mask = cleanY + count;
+    double *products = mask + count;
+    double *sumX = products + count;
+    double *sumY = sumX + windows;
+    double *sumXY = sumY + windows;
+    double *sumX2 = sumXY + windows;
+    double *sumY2 = sumX2 + windows;
+    double *validCounts = sumY2 + windows;
+    
+    // Solo le coppie con entrambi i valori validi; la correlazione è invariante alla traslazione
+    double referenceX = EngineFirstValidValue(valuesX, count);
+    double referenceY = EngineFirstValidValue(valuesY, count);
+    for (NSInteger i = 0; i < count; i++) {
+        BOOL valid = isfinite(valuesX[i]) && isfinite(valuesY[i]);
+        cleanX[i] = valid ? valuesX[i] - referenceX : 0.0;
+        cleanY[i] = valid ? valuesY[i] - referenceY : 0.0;
+        mask[i] = valid ? 1.0 : 0.0;
+    }
+    
+    EngineWindowSums(cleanX, count, period, sumX);
+    EngineWindowSums(cleanY, count, period, sumY);
+    EngineWindowSums(mask, count, period, validCounts);
+    EngineMultiply(cleanX, cleanY, products, count);
+    EngineWindowSums(products, count, period, sumXY);
+    EngineMultiply(cleanX, cleanX, products, count);
+    EngineWindowSums(products, count, period, sumX2);
+    EngineMultiply(cleanY, cleanY, products, count);
+    EngineWindowSums(products, count, period, sumY2);
+    
+    double minValid = period * 0.8;
+    for (NSInteger k = 0; k < windows; k++) {
+        double n = validCounts[k];
+        if (n < minValid) continue;
+    
+        double numerator = n * sumXY[k] - sumX[k] * sumY[k];
+        double varianceX = n * sumX2[k] - sumX[k] * sumX[k];
+        double varianceY = n * sumY2[k] - sumY[k] * sumY[k];
+    
+        if (varianceX > 0 && varianceY > 0) {
+            double correlation = numerator / sqrt(varianceX * varianceY);
+            output[k + period - 1] = MAX(-1.0, MIN(1.0, correlation));
         } else {
-            [result addObject:@(0.0)];
+            output[k + period - 1] = 0.0;
         }
     }
-    
-    return [result copy];
+    return YES;
 }
 
 #pragma mark - Utility Functions
@@ -343,30 +537,55 @@
         return @[];
     }
     
-    NSMutableArray<NSNumber *> *result = [[NSMutableArray alloc] initWithCapacity:bars.count];
+    NSMutableData *buffer = [NSMutableData dataWithLength:bars.count * sizeof(double)];
+    [self extractPriceSeries:bars priceType:priceType output:buffer.mutableBytes];
+    return EngineArrayFromBuffer(buffer.bytes, bars.count);
+}
+
++ (void)extractPriceSeries:(NSArray<HistoricalBarModel *> *)bars
+                 priceType:(NSString *)priceType
+                    output:(double *)output {
+    NSInteger count = bars.count;
+    if (count == 0) return;
+    
+    BOOL isVolume = [priceType isEqualToString:@"volume"];
+    
+    // Array colonnare: la colonna è già contigua
+    BarSeries *series = [BarSeries backingSeriesOfBars:bars];
+    if (series) {
+        if (isVolume) {
+            const int64_t *volume = series.volume;
+            for (NSInteger i = 0; i < count; i++) {
+                output[i] = (double)volume[i];
+            }
+            return;
+        }
     
-    for (HistoricalBarModel *bar in bars) {
-        double value = 0.0;
-        
+        const double *column = series.close;  // Default to close
         if ([priceType isEqualToString:@"open"]) {
-            value = bar.open;
+            column = series.open;
         } else if ([priceType isEqualToString:@"high"]) {
-            value = bar.high;
+            column = series.high;
         } else if ([priceType isEqualToString:@"low"]) {
-            value = bar.low;
-        } else if ([priceType isEqualToString:@"close"]) {
-            value = bar.close;
-        } else if ([priceType isEqualToString:@"volume"]) {
-            value = bar.volume;
-        } else {
-            // Default to close
-            value = bar.close;
+            column = series.low;
         }
-        
-        [result addObject:@(value)];
+        memcpy(output, column, count * sizeof(double));
+        return;
     }
     
-    return [result copy];
+    NSInteger i = 0;
+    if (isVolume) {
+        for (HistoricalBarModel *bar in bars) output[i++] = bar.volume;
+    } else if ([priceType isEqualToString:@"open"]) {
+        for (HistoricalBarModel *bar in bars) output[i++] = bar.open;
+    } else if ([priceType isEqualToString:@"high"]) {
+        for (HistoricalBarModel *bar in bars) output[i++] = bar.high;
+    } else if ([priceType isEqualToString:@"low"]) {
+        for (HistoricalBarModel *bar in bars) output[i++] = bar.low;
+    } else {
+        // Default to close
+        for (HistoricalBarModel *bar in bars) output[i++] = bar.close;
+    }
 }
 
 + (double)percentageChange:(double)current previous:(double)previous {
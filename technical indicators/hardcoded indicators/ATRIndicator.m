@@ -55,8 +55,19 @@
     NSInteger period = [self.parameters[@"period"] integerValue];
     
     // Calculate ATR using the calculation engine
-    NSArray<NSNumber *> *atrValues = [IndicatorCalculationEngine atr:bars period:period];
-    if (!atrValues || atrValues.count != bars.count) {
+    NSInteger count = bars.count;
+    NSMutableData *buffers = [NSMutableData dataWithLength:4 * count * sizeof(double)];
+    double *high = buffers.mutableBytes;
+    double *low = high + count;
+    double *close = low + count;
+    double *atrValues = close + count;
+    
+    [IndicatorCalculationEngine extractPriceSeries:bars priceType:@"high" output:high];
+    [IndicatorCalculationEngine extractPriceSeries:bars priceType:@"low" output:low];
+    [IndicatorCalculationEngine extractPriceSeries:bars priceType:@"close" output:close];
+    
+    if (![IndicatorCalculationEngine atrSeriesWithHigh:high low:low close:close
+                                                 count:count period:period output:atrValues]) {
         self.lastError = [NSError errorWithDomain:@"ATRIndicator"
                                          code:1004
                                      userInfo:@{NSLocalizedDescriptionKey: @"ATR calculation failed"}];
@@ -69,7 +80,7 @@
     
     for (NSInteger i = 0; i < bars.count; i++) {
         HistoricalBarModel *bar = bars[i];
-        double atrValue = [atrValues[i] doubleValue];
+        double atrValue = atrValues[i];
         
         IndicatorDataModel *dataPoint = [IndicatorDataModel dataWithTimestamp:bar.date
                                                                          value:atrValue
@@ -69,23 +69,19 @@
     double multiplier = [self.parameters[@"multiplier"] doubleValue] ?: 2.0;
     NSString *source = self.parameters[@"source"] ?: @"close";
     
-    // Extract price series
-    NSArray<NSNumber *> *prices = [IndicatorCalculationEngine extractPriceSeries:bars priceType:source];
-    if (!prices || prices.count == 0) {
-        self.lastError = [NSError errorWithDomain:@"BollingerBandsIndicator"
-                                         code:1003
-                                     userInfo:@{NSLocalizedDescriptionKey: @"Failed to extract price series"}];
-        return;
-    }
-    
-    // Calculate SMA (middle band)
-    NSArray<NSNumber *> *smaValues = [IndicatorCalculationEngine sma:prices period:period];
+    // Extract price series (raw buffers, no NSNumber boxing)
+    NSInteger count = bars.count;
+    NSMutableData *buffers = [NSMutableData dataWithLength:3 * count * sizeof(double)];
+    double *prices = buffers.mutableBytes;
+    double *smaValues = prices + count;
+    double *stdevValues = smaValues + count;
+    [IndicatorCalculationEngine extractPriceSeries:bars priceType:source output:prices];
     
-    // Calculate Standard Deviation
-    NSArray<NSNumber *> *stdevValues = [IndicatorCalculationEngine stdev:prices period:period];
+    // Calculate SMA (middle band) and Standard Deviation
+    BOOL smaOK = [IndicatorCalculationEngine smaSeries:prices count:count period:period output:smaValues];
+    BOOL stdevOK = [IndicatorCalculationEngine stdevSeries:prices count:count period:period output:stdevValues];
     
-    if (!smaValues || !stdevValues ||
-        smaValues.count != bars.count || stdevValues.count != bars.count) {
+    if (!smaOK || !stdevOK) {
         self.lastError = [NSError errorWithDomain:@"BollingerBandsIndicator"
                                          code:1004
                                      userInfo:@{NSLocalizedDescriptionKey: @"Bollinger Bands calculation failed"}];
@@ -97,8 +93,8 @@
     
     for (NSInteger i = 0; i < bars.count; i++) {
         HistoricalBarModel *bar = bars[i];
-        double sma = [smaValues[i] doubleValue];
-        double stdev = [stdevValues[i] doubleValue];
+        double sma = smaValues[i];
+        double stdev = stdevValues[i];
         
         // Calculate bands
         double upperBand = sma + (stdev * multiplier);
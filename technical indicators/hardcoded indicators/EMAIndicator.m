@@ -83,18 +83,15 @@
         return;
     }
     
-    // Extract price series from bars
-    NSArray<NSNumber *> *prices = [IndicatorCalculationEngine extractPriceSeries:bars priceType:source];
-    if (!prices || prices.count == 0) {
-        self.lastError = [NSError errorWithDomain:@"EMAIndicator"
-                                         code:1003
-                                     userInfo:@{NSLocalizedDescriptionKey: @"Failed to extract price series"}];
-        return;
-    }
+    // Extract price series from bars (raw buffers, no NSNumber boxing)
+    NSInteger count = bars.count;
+    NSMutableData *buffers = [NSMutableData dataWithLength:2 * count * sizeof(double)];
+    double *prices = buffers.mutableBytes;
+    double *emaValues = prices + count;
+    [IndicatorCalculationEngine extractPriceSeries:bars priceType:source output:prices];
     
     // Calculate EMA using the calculation engine
-    NSArray<NSNumber *> *emaValues = [IndicatorCalculationEngine ema:prices period:period];
-    if (!emaValues || emaValues.count != bars.count) {
+    if (![IndicatorCalculationEngine emaSeries:prices count:count period:period output:emaValues]) {
         self.lastError = [NSError errorWithDomain:@"EMAIndicator"
                                          code:1004
                                      userInfo:@{NSLocalizedDescriptionKey: @"EMA calculation failed"}];
@@ -107,7 +104,7 @@
     
     for (NSInteger i = 0; i < bars.count; i++) {
         HistoricalBarModel *bar = bars[i];
-        double emaValue = [emaValues[i] doubleValue];
+        double emaValue = emaValues[i];
         
         IndicatorDataModel *dataPoint = [IndicatorDataModel dataWithTimestamp:bar.date
                                                                          value:emaValue
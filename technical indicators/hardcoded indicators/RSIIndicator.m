@@ -75,18 +75,15 @@
     NSInteger period = [self.parameters[@"period"] integerValue];
     NSString *source = self.parameters[@"source"] ?: @"close";
     
-    // Extract price series
-    NSArray<NSNumber *> *prices = [IndicatorCalculationEngine extractPriceSeries:bars priceType:source];
-    if (!prices || prices.count == 0) {
-        self.lastError = [NSError errorWithDomain:@"RSIIndicator"
-                                         code:1003
-                                     userInfo:@{NSLocalizedDescriptionKey: @"Failed to extract price series"}];
-        return;
-    }
+    // Extract price series (raw buffers, no NSNumber boxing)
+    NSInteger count = bars.count;
+    NSMutableData *buffers = [NSMutableData dataWithLength:2 * count * sizeof(double)];
+    double *prices = buffers.mutableBytes;
+    double *rsiValues = prices + count;
+    [IndicatorCalculationEngine extractPriceSeries:bars priceType:source output:prices];
     
     // Calculate RSI
-    NSArray<NSNumber *> *rsiValues = [IndicatorCalculationEngine rsi:prices period:period];
-    if (!rsiValues || rsiValues.count != bars.count) {
+    if (![IndicatorCalculationEngine rsiSeries:prices count:count period:period output:rsiValues]) {
         self.lastError = [NSError errorWithDomain:@"RSIIndicator"
                                          code:1004
                                      userInfo:@{NSLocalizedDescriptionKey: @"RSI calculation failed"}];
@@ -103,7 +100,7 @@
     
     for (NSInteger i = 0; i < bars.count; i++) {
         HistoricalBarModel *bar = bars[i];
-        double rsiValue = [rsiValues[i] doubleValue];
+        double rsiValue = rsiValues[i];
         
         // Main RSI line
         IndicatorDataModel *dataPoint = [IndicatorDataModel dataWithTimestamp:bar.date
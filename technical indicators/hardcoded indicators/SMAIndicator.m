@@ -71,18 +71,15 @@
         return;
     }
     
-    // Extract price series from bars
-    NSArray<NSNumber *> *prices = [IndicatorCalculationEngine extractPriceSeries:bars priceType:source];
-    if (!prices || prices.count == 0) {
-        self.lastError = [NSError errorWithDomain:@"SMAIndicator"
-                                         code:1003
-                                     userInfo:@{NSLocalizedDescriptionKey: @"Failed to extract price series"}];
-        return;
-    }
+    // Extract price series from bars (raw buffers, no NSNumber boxing)
+    NSInteger count = bars.count;
+    NSMutableData *buffers = [NSMutableData dataWithLength:2 * count * sizeof(double)];
+    double *prices = buffers.mutableBytes;
+    double *smaValues = prices + count;
+    [IndicatorCalculationEngine extractPriceSeries:bars priceType:source output:prices];
     
     // Calculate SMA using the calculation engine
-    NSArray<NSNumber *> *smaValues = [IndicatorCalculationEngine sma:prices period:period];
-    if (!smaValues || smaValues.count != bars.count) {
+    if (![IndicatorCalculationEngine smaSeries:prices count:count period:period output:smaValues]) {
         self.lastError = [NSError errorWithDomain:@"SMAIndicator"
                                          code:1004
                                      userInfo:@{NSLocalizedDescriptionKey: @"SMA calculation failed"}];
@@ -95,7 +92,7 @@
     
     for (NSInteger i = 0; i < bars.count; i++) {
         HistoricalBarModel *bar = bars[i];
-        double smaValue = [smaValues[i] doubleValue];
+        double smaValue = smaValues[i];
         
         IndicatorDataModel *dataPoint = [IndicatorDataModel dataWithTimestamp:bar.date
                                                                          value:smaValue